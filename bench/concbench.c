@@ -0,0 +1,292 @@
+/*
+ * concbench.c - how indexing scales with threads: one shared concurrent
+ *   index against a private index per thread merged at the end
+ *
+ * usage: ./concbench pageDirectory maxThreads indexPrefix
+ *
+ * Every page is read into memory first, so only indexing is timed. Then
+ *   for 1, 2, 4... up to maxThreads threads, taking pages from a shared
+ *   counter, we build the index both ways:
+ *     shared  every thread flushes its pages into one concindex, which is
+ *             saved as it is
+ *     merge   every thread index_inserts into an index_t of its own; the
+ *             indexes are then merged into the first, one thread's at a
+ *             time, which is saved
+ *   and report the build, merge and save times, and the speedup of each
+ *   way's total over its own single thread. Both files are written to
+ *   indexPrefix.shared and indexPrefix.merge, and must be the same.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include <time.h>
+#include "../common/index.h"
+#include "../common/concindex.h"
+#include "../common/pagedir.h"
+#include "../common/word.h"
+#include "../libcs50/webpage.h"
+#include "../libcs50/counters.h"
+
+// the crawl, in memory
+typedef struct corpus {
+  webpage_t** pages;
+  int* docIDs;
+  int count;
+  int cap;
+} corpus_t;
+
+// what one thread of one run works on
+typedef struct job {
+  pthread_t thread;
+  const corpus_t* corpus;
+  atomic_int* next;     // next page to take, shared
+  concindex_t* conc;    // shared, or NULL
+  index_t* index;       // this thread's own, or NULL
+} job_t;
+
+// a word's counts merged into another index
+typedef struct mergeWord {
+  index_t* into;
+  const char* word;
+} mergeWord_t;
+
+// function prototypes
+static double nowSeconds(void);
+static void keepPage(void* arg, webpage_t* page, const int docID);
+static double runThreads(job_t* jobs, const int threads);
+static void* buildShared(void* arg);
+static void* buildPrivate(void* arg);
+static void mergeIndex(void* arg, const char* word, counters_t* ctrs);
+static void mergeCount(void* arg, const int docID, const int count);
+static bool sameFiles(const char* a, const char* b);
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4) {
+    fprintf(stderr, "Usage: %s pageDirectory maxThreads indexPrefix\n", argv[0]);
+    exit(1);
+  }
+  int maxThreads = atoi(argv[2]);
+  if (maxThreads < 1 || maxThreads > 256) {
+    fprintf(stderr, "maxThreads must be 1 to 256\n");
+    exit(1);
+  }
+  char sharedName[1024], mergeName[1024];
+  snprintf(sharedName, sizeof(sharedName), "%s.shared", argv[3]);
+  snprintf(mergeName, sizeof(mergeName), "%s.merge", argv[3]);
+
+  corpus_t corpus = { NULL, NULL, 0, 0 };
+  double start = nowSeconds();
+  pagedir_scan(argv[1], &corpus, keepPage);
+  if (corpus.count == 0) {
+    fprintf(stderr, "no pages in '%s'\n", argv[1]);
+    exit(2);
+  }
+  printf("%d pages read in %.3f s\n", corpus.count, nowSeconds() - start);
+  printf("%7s | %10s %8s %8s | %10s %8s %8s %8s\n", "threads",
+         "shared", "save", "speedup", "private", "merge", "save", "speedup");
+
+  job_t* jobs = calloc(maxThreads, sizeof(job_t));
+  double sharedBase = 0, mergeBase = 0;
+  int mismatches = 0;
+  for (int threads = 1; threads <= maxThreads;
+       threads = (threads * 2 > maxThreads && threads < maxThreads)
+                 ? maxThreads : threads * 2) {
+    atomic_int next;
+
+    // one shared concurrent index
+    atomic_init(&next, 0);
+    concindex_t* conc = concindex_new(0);
+    for (int t = 0; t < threads; t++) {
+      jobs[t] = (job_t){ 0, &corpus, &next, conc, NULL };
+    }
+    double sharedBuild = runThreads(jobs, threads);
+    start = nowSeconds();
+    concindex_save(conc, sharedName);
+    double sharedSave = nowSeconds() - start;
+    concindex_delete(conc);
+
+    // an index per thread, merged
+    atomic_init(&next, 0);
+    for (int t = 0; t < threads; t++) {
+      jobs[t] = (job_t){ 0, &corpus, &next, NULL, index_new(500) };
+    }
+    double privateBuild = runThreads(jobs, threads);
+    start = nowSeconds();
+    for (int t = 1; t < threads; t++) {
+      index_iterate(jobs[t].index, jobs[0].index, mergeIndex);
+      index_delete(jobs[t].index);
+    }
+    double merge = nowSeconds() - start;
+    start = nowSeconds();
+    index_save(jobs[0].index, mergeName);
+    double mergeSave = nowSeconds() - start;
+    index_delete(jobs[0].index);
+
+    double sharedTotal = sharedBuild + sharedSave;
+    double mergeTotal = privateBuild + merge + mergeSave;
+    if (threads == 1) {
+      sharedBase = sharedTotal;
+      mergeBase = mergeTotal;
+    }
+    printf("%7d | %9.3fs %7.3fs %7.2fx | %9.3fs %7.3fs %7.3fs %7.2fx\n",
+           threads, sharedBuild, sharedSave, sharedBase / sharedTotal,
+           privateBuild, merge, mergeSave, mergeBase / mergeTotal);
+    if (!sameFiles(sharedName, mergeName)) {
+      fprintf(stderr, "MISMATCH: %s and %s differ with %d threads\n",
+              sharedName, mergeName, threads);
+      mismatches++;
+    }
+    if (threads == maxThreads) {
+      break;
+    }
+  }
+
+  free(jobs);
+  for (int p = 0; p < corpus.count; p++) {
+    webpage_delete(corpus.pages[p]);
+  }
+  free(corpus.pages);
+  free(corpus.docIDs);
+  return (mismatches == 0) ? 0 : 3;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// pagedir_scan's callback; the page is deleted after it, so keep a copy
+static void keepPage(void* arg, webpage_t* page, const int docID)
+{
+  corpus_t* corpus = arg;
+  if (corpus->count == corpus->cap) {
+    corpus->cap = (corpus->cap == 0) ? 1024 : corpus->cap * 2;
+    corpus->pages = realloc(corpus->pages, corpus->cap * sizeof(webpage_t*));
+    corpus->docIDs = realloc(corpus->docIDs, corpus->cap * sizeof(int));
+    if (corpus->pages == NULL || corpus->docIDs == NULL) {
+      fprintf(stderr, "out of memory\n");
+      exit(2);
+    }
+  }
+  char* url = strdup(webpage_getURL(page));
+  char* html = strdup(webpage_getHTML(page));
+  webpage_t* copy = webpage_new(url, webpage_getDepth(page), html);
+  if (copy == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(2);
+  }
+  corpus->pages[corpus->count] = copy;
+  corpus->docIDs[corpus->count] = docID;
+  corpus->count++;
+}
+
+// start the jobs' threads and wait for them all; the seconds it took
+static double runThreads(job_t* jobs, const int threads)
+{
+  double start = nowSeconds();
+  for (int t = 0; t < threads; t++) {
+    if (pthread_create(&jobs[t].thread, NULL,
+                       (jobs[t].conc != NULL) ? buildShared : buildPrivate,
+                       &jobs[t]) != 0) {
+      fprintf(stderr, "cannot start thread %d\n", t + 1);
+      exit(2);
+    }
+  }
+  for (int t = 0; t < threads; t++) {
+    pthread_join(jobs[t].thread, NULL);
+  }
+  return nowSeconds() - start;
+}
+
+// a thread of the shared way: count a page in its buffer, then flush it
+static void* buildShared(void* arg)
+{
+  job_t* job = arg;
+  concbuffer_t* buf = concbuffer_new();
+  int p;
+  while ((p = atomic_fetch_add(job->next, 1)) < job->corpus->count) {
+    int pos = 0;
+    char* word;
+    while ((word = webpage_getNextWord(job->corpus->pages[p], &pos)) != NULL) {
+      if (normalizeWord(word)) {
+        concbuffer_add(buf, word);
+      }
+      free(word);
+    }
+    concindex_flush(job->conc, buf, job->corpus->docIDs[p]);
+  }
+  concbuffer_delete(buf);
+  return NULL;
+}
+
+// a thread of the merge way: into its own index
+static void* buildPrivate(void* arg)
+{
+  job_t* job = arg;
+  int p;
+  while ((p = atomic_fetch_add(job->next, 1)) < job->corpus->count) {
+    int pos = 0;
+    char* word;
+    while ((word = webpage_getNextWord(job->corpus->pages[p], &pos)) != NULL) {
+      if (normalizeWord(word)) {
+        index_insert(job->index, word, job->corpus->docIDs[p]);
+      }
+      free(word);
+    }
+  }
+  return NULL;
+}
+
+// index_iterate helper: every count of a word into the other index
+static void mergeIndex(void* arg, const char* word, counters_t* ctrs)
+{
+  mergeWord_t merge = { arg, word };
+  counters_iterate(ctrs, &merge, mergeCount);
+}
+
+// counters_iterate helper: a page is in one thread's index only
+static void mergeCount(void* arg, const int docID, const int count)
+{
+  mergeWord_t* merge = arg;
+  counters_t* into = index_find(merge->into, merge->word);
+  if (into == NULL) {
+    index_insert(merge->into, merge->word, docID);
+    into = index_find(merge->into, merge->word);
+  }
+  counters_set(into, docID, count);
+}
+
+// same bytes?
+static bool sameFiles(const char* a, const char* b)
+{
+  FILE* fa = fopen(a, "r");
+  FILE* fb = fopen(b, "r");
+  bool same = (fa != NULL && fb != NULL);
+  while (same) {
+    int ca = getc(fa);
+    int cb = getc(fb);
+    same = (ca == cb);
+    if (ca == EOF) {
+      break;
+    }
+  }
+  if (fa != NULL) {
+    fclose(fa);
+  }
+  if (fb != NULL) {
+    fclose(fb);
+  }
+  return same;
+}
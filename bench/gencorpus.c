@@ -0,0 +1,556 @@
+/*
+ * gencorpus.c - a synthetic page directory, and a query log to match, for
+ *   testing the TSE at scale without crawling
+ *
+ * usage: ./gencorpus [--pages N] [--words N] [--vocab N] [--zipf S]
+ *                    [--fanout N] [--links N] [--seed N] [--packed]
+ *                    [--compress CODEC] [--queries N] [--query-log file]
+ *                    pageDirectory
+ *
+ * Writes --pages (default 10000) pages to pageDirectory, which it creates
+ *   if need be, as the crawler would: docIDs 1 to N, each a URL, a depth
+ *   and HTML, saved with pagedir_save (--packed and --compress as the
+ *   crawler's), so the indexer and tsebench take it as a crawl.
+ *
+ *   vocabulary  --vocab (default 100000) words, word r (from 0) made of
+ *               consonant-vowel syllables spelling r, so every run agrees
+ *               on them; words are drawn with Zipf's law, word r's chance
+ *               going as 1 / (r + 1)^S for --zipf S (default 1.0)
+ *   pages       --words (default 300) words each on average, from half to
+ *               one and a half times that, as a title, a heading and
+ *               paragraphs
+ *   links       the pages form the tree of a breadth-first crawl from page
+ *               1: each page links to its children, 1 to 2 * --fanout - 1
+ *               (default 10 on average) of the next docIDs not yet linked,
+ *               whose depth is one more than its own. Each page also links
+ *               to --links (default 5) pages anywhere, drawn with Zipf's
+ *               law over docIDs, so the pages near the root are linked to
+ *               most, as a site's front pages are.
+ *
+ * With --query-log, --queries (default 1000) queries are written there as
+ *   well, one a line, from the same vocabulary: 1 to 5 words (1 about a
+ *   third of the time, 2.4 on average), most joined by nothing (an 'and'),
+ *   some by 'and' or 'or'. Words are chosen as people search rather than as
+ *   they write: a fifth from the head of the vocabulary (its 100 commonest
+ *   words), half from the torso (up to --vocab / 10) and the rest from the
+ *   tail, each by Zipf's law within its band; 1 in 20 is a prefix wildcard
+ *   and 1 in 50 a word no page has.
+ *
+ * A generator of its own (splitmix64) makes the same pages and queries from
+ *   the same options and --seed (default 50) on any machine. Exit status
+ *   is 1 for bad options, 2 if pageDirectory or the log cannot be written
+ *   or memory runs out.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../common/pagedir.h"
+#include "../libcs50/webpage.h"
+
+// letters words are spelled with: a consonant then a vowel per syllable
+static const char CONSONANTS[] = "bdfghjklmnprstvz";
+static const char VOWELS[] = "aeiou";
+#define NCONSONANTS 16
+#define NVOWELS 5
+#define NSYLLABLES (NCONSONANTS * NVOWELS)
+
+// longest word: enough syllables for any rank an int holds
+#define MAX_WORD 16
+
+// words in a paragraph, on average
+#define PARAGRAPH 40
+
+// the query log's bands of the vocabulary: the head is the commonest words
+#define HEAD 100
+
+// what the user asked for
+typedef struct options {
+  int pages;
+  int words;
+  int vocab;
+  double zipf;
+  int fanout;
+  int links;
+  uint64_t seed;
+  bool packed;
+  const char* codec;
+  int queries;
+  const char* queryLog;
+  const char* pageDir;
+} options_t;
+
+/*
+ * Walker's alias table: draws 0 to n - 1 by given weights in O(1), a
+ *   uniform pick then one comparison against that slot's threshold
+ */
+typedef struct alias {
+  int n;
+  uint32_t* threshold;  // keep the slot if a 32-bit draw is below this
+  int* other;           // else take this
+} alias_t;
+
+// function prototypes
+static void parseArgs(int argc, char* argv[], options_t* options);
+static double nowSeconds(void);
+static uint64_t nextRandom(uint64_t* state);
+static int randomBelow(uint64_t* state, const int n);
+static alias_t* alias_new(const int n, const double exponent, const int skip);
+static int alias_draw(const alias_t* alias, uint64_t* state);
+static void alias_delete(alias_t* alias);
+static int spellWord(const int rank, char* word);
+static bool writePages(const options_t* options);
+static char* makeHTML(const options_t* options, const int firstChild,
+                      const int children, const alias_t* words,
+                      const alias_t* targets, uint64_t* state);
+static bool writeQueries(const options_t* options);
+static void appendURL(char* buf, size_t* len, const int docID);
+
+int main(int argc, char* argv[])
+{
+  options_t options;
+  parseArgs(argc, argv, &options);
+
+  double start = nowSeconds();
+  if (!writePages(&options)) {
+    exit(2);
+  }
+  printf("%d pages in %s, %.1f s\n", options.pages, options.pageDir,
+         nowSeconds() - start);
+  if (options.queryLog != NULL) {
+    if (!writeQueries(&options)) {
+      fprintf(stderr, "cannot write '%s'\n", options.queryLog);
+      exit(2);
+    }
+    printf("%d queries in %s\n", options.queries, options.queryLog);
+  }
+  return 0;
+}
+
+// the options, then pageDirectory
+static void parseArgs(int argc, char* argv[], options_t* options)
+{
+  options->pages = 10000;
+  options->words = 300;
+  options->vocab = 100000;
+  options->zipf = 1.0;
+  options->fanout = 10;
+  options->links = 5;
+  options->seed = 50;
+  options->packed = false;
+  options->codec = NULL;
+  options->queries = 1000;
+  options->queryLog = NULL;
+  int arg = 1;
+  while (arg < argc - 1 && strncmp(argv[arg], "--", 2) == 0) {
+    if (strcmp(argv[arg], "--packed") == 0) {
+      options->packed = true;
+      arg++;
+      continue;
+    }
+    const char* value = argv[arg + 1];
+    if (strcmp(argv[arg], "--pages") == 0) {
+      options->pages = atoi(value);
+    } else if (strcmp(argv[arg], "--words") == 0) {
+      options->words = atoi(value);
+    } else if (strcmp(argv[arg], "--vocab") == 0) {
+      options->vocab = atoi(value);
+    } else if (strcmp(argv[arg], "--zipf") == 0) {
+      options->zipf = atof(value);
+    } else if (strcmp(argv[arg], "--fanout") == 0) {
+      options->fanout = atoi(value);
+    } else if (strcmp(argv[arg], "--links") == 0) {
+      options->links = atoi(value);
+    } else if (strcmp(argv[arg], "--seed") == 0) {
+      options->seed = strtoull(value, NULL, 10);
+    } else if (strcmp(argv[arg], "--compress") == 0) {
+      options->codec = value;
+    } else if (strcmp(argv[arg], "--queries") == 0) {
+      options->queries = atoi(value);
+    } else if (strcmp(argv[arg], "--query-log") == 0) {
+      options->queryLog = value;
+    } else {
+      break; // unknown, so the usage below
+    }
+    arg += 2;
+  }
+  if (argc - arg != 1 || options->pages <= 0 || options->words <= 0
+      || options->vocab <= 0 || options->zipf < 0 || options->fanout <= 0
+      || options->links < 0 || options->queries <= 0) {
+    fprintf(stderr, "Usage: %s [--pages N] [--words N] [--vocab N] "
+            "[--zipf S] [--fanout N] [--links N] [--seed N] [--packed] "
+            "[--compress CODEC] [--queries N] [--query-log file] "
+            "pageDirectory\n", argv[0]);
+    exit(1);
+  }
+  if (options->codec != NULL && !pagedir_setCompression(options->codec)) {
+    fprintf(stderr, "Error: invalid --compress '%s'\n", options->codec);
+    exit(1);
+  }
+  options->pageDir = argv[arg];
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// splitmix64: the next of a sequence, the same everywhere for a seed
+static uint64_t nextRandom(uint64_t* state)
+{
+  uint64_t z = (*state += 0x9e3779b97f4a7c15ULL);
+  z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+  z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+  return z ^ (z >> 31);
+}
+
+// 0 to n - 1, evenly (n is far below 2^32, so the bias is negligible)
+static int randomBelow(uint64_t* state, const int n)
+{
+  return (int)(((nextRandom(state) >> 32) * (uint64_t)n) >> 32);
+}
+
+/*
+ * Makes an alias table for 0 to n - 1, i drawn with weight
+ *   1 / (i + skip + 1)^exponent: Zipf's law from rank skip on.
+ * We return NULL if memory runs out.
+ */
+static alias_t* alias_new(const int n, const double exponent, const int skip)
+{
+  alias_t* alias = malloc(sizeof(alias_t));
+  double* scaled = malloc(n * sizeof(double));
+  int* small = malloc(n * sizeof(int));
+  int* large = malloc(n * sizeof(int));
+  if (alias != NULL) {
+    alias->n = n;
+    alias->threshold = malloc(n * sizeof(uint32_t));
+    alias->other = malloc(n * sizeof(int));
+  }
+  if (alias == NULL || scaled == NULL || small == NULL || large == NULL
+      || alias->threshold == NULL || alias->other == NULL) {
+    alias_delete(alias);
+    free(scaled);
+    free(small);
+    free(large);
+    return NULL;
+  }
+
+  // weights scaled to average 1, split into those below 1 and the rest
+  double total = 0;
+  for (int i = 0; i < n; i++) {
+    scaled[i] = pow(i + skip + 1, -exponent);
+    total += scaled[i];
+  }
+  int nsmall = 0;
+  int nlarge = 0;
+  for (int i = 0; i < n; i++) {
+    scaled[i] *= n / total;
+    if (scaled[i] < 1.0) {
+      small[nsmall++] = i;
+    } else {
+      large[nlarge++] = i;
+    }
+  }
+  // each small slot is topped up from a large one, which may become small
+  while (nsmall > 0 && nlarge > 0) {
+    int s = small[--nsmall];
+    int l = large[--nlarge];
+    alias->threshold[s] = (uint32_t)(scaled[s] * 4294967295.0);
+    alias->other[s] = l;
+    scaled[l] -= 1.0 - scaled[s];
+    if (scaled[l] < 1.0) {
+      small[nsmall++] = l;
+    } else {
+      large[nlarge++] = l;
+    }
+  }
+  // what is left is 1 but for rounding: always kept
+  while (nlarge > 0) {
+    int l = large[--nlarge];
+    alias->threshold[l] = UINT32_MAX;
+    alias->other[l] = l;
+  }
+  while (nsmall > 0) {
+    int s = small[--nsmall];
+    alias->threshold[s] = UINT32_MAX;
+    alias->other[s] = s;
+  }
+  free(scaled);
+  free(small);
+  free(large);
+  return alias;
+}
+
+// a draw from the table: its slot from the high bits, the test from the low
+static int alias_draw(const alias_t* alias, uint64_t* state)
+{
+  uint64_t r = nextRandom(state);
+  int slot = (int)(((r >> 32) * (uint64_t)alias->n) >> 32);
+  return ((uint32_t)r < alias->threshold[slot]) ? slot : alias->other[slot];
+}
+
+// frees what alias_new made; NULL is fine
+static void alias_delete(alias_t* alias)
+{
+  if (alias != NULL) {
+    free(alias->threshold);
+    free(alias->other);
+    free(alias);
+  }
+}
+
+/*
+ * Spells word rank as syllables, the lowest digit (in base NSYLLABLES) first
+ *   so that common words differ from their first letters, and at least two
+ *   syllables so that every word has four letters or more and none is
+ *   'and' or 'or'. Different ranks give different words.
+ * We return the word's length; word needs MAX_WORD + 1 chars.
+ */
+static int spellWord(const int rank, char* word)
+{
+  long value = (long)rank + NSYLLABLES; // two syllables at least
+  int len = 0;
+  while (value > 0) {
+    int syllable = value % NSYLLABLES;
+    word[len++] = CONSONANTS[syllable / NVOWELS];
+    word[len++] = VOWELS[syllable % NVOWELS];
+    value /= NSYLLABLES;
+  }
+  word[len] = '\0';
+  return len;
+}
+
+/*
+ * Writes every page: the crawl tree first (each page's children, a run of
+ *   docIDs, and its depth), then the pages in docID order
+ * Returns false, having said why, on failure
+ */
+static bool writePages(const options_t* options)
+{
+  const int n = options->pages;
+  mkdir(options->pageDir, 0755); // it may be there already
+  if (!pagedir_init(options->pageDir)
+      || !pagedir_setLayout(options->pageDir, options->packed)) {
+    fprintf(stderr, "cannot write pages in '%s'\n", options->pageDir);
+    return false;
+  }
+  // index docID: page docID's first child, its count of them, and its depth
+  int* firstChild = calloc(n + 1, sizeof(int));
+  int* children = calloc(n + 1, sizeof(int));
+  int* depth = calloc(n + 1, sizeof(int));
+  alias_t* words = alias_new(options->vocab, options->zipf, 0);
+  alias_t* targets = alias_new(n, options->zipf, 0);
+  if (firstChild == NULL || children == NULL || depth == NULL
+      || words == NULL || targets == NULL) {
+    fprintf(stderr, "out of memory\n");
+    free(firstChild);
+    free(children);
+    free(depth);
+    alias_delete(words);
+    alias_delete(targets);
+    return false;
+  }
+  uint64_t state = options->seed;
+
+  // breadth first: the pages linked next are the next parent's children
+  int parent = 1;
+  firstChild[1] = 2;
+  children[1] = 0;
+  int quota = 1 + randomBelow(&state, 2 * options->fanout - 1);
+  for (int docID = 2; docID <= n; docID++) {
+    while (children[parent] == quota) {
+      parent++;
+      firstChild[parent] = docID;
+      quota = 1 + randomBelow(&state, 2 * options->fanout - 1);
+    }
+    children[parent]++;
+    depth[docID] = depth[parent] + 1;
+  }
+
+  bool ok = true;
+  for (int docID = 1; docID <= n && ok; docID++) {
+    char* html = makeHTML(options, firstChild[docID], children[docID], words,
+                          targets, &state);
+    char* url = malloc(64);
+    if (html == NULL || url == NULL) {
+      fprintf(stderr, "out of memory\n");
+      free(html);
+      free(url);
+      ok = false;
+      break;
+    }
+    size_t len = 0;
+    appendURL(url, &len, docID);
+    webpage_t* page = webpage_new(url, depth[docID], html);
+    if (page == NULL) {
+      fprintf(stderr, "out of memory\n");
+      free(html);
+      free(url);
+      ok = false;
+      break;
+    }
+    pagedir_save(page, options->pageDir, docID);
+    webpage_delete(page);
+  }
+  pagedir_close();
+
+  free(firstChild);
+  free(children);
+  free(depth);
+  alias_delete(words);
+  alias_delete(targets);
+  return ok;
+}
+
+// the URL of page docID, appended at buf + *len
+static void appendURL(char* buf, size_t* len, const int docID)
+{
+  *len += sprintf(buf + *len, "http://synthetic.example/page/%d.html", docID);
+}
+
+/*
+ * Makes one page's HTML: a title and heading of a few words, then its words
+ *   in paragraphs, with a link to each child and each other target after
+ *   the paragraph it falls in.
+ * We return a new string, which the caller must free, or NULL if memory
+ *   runs out.
+ */
+static char* makeHTML(const options_t* options, const int firstChild,
+                      const int children, const alias_t* words,
+                      const alias_t* targets, uint64_t* state)
+{
+  // half to one and a half times the words asked for
+  int count = options->words / 2 + randomBelow(state, options->words + 1);
+  if (count < 1) {
+    count = 1;
+  }
+  int links = children + options->links;
+  // each word and space, each link's tags and URL, and the rest
+  size_t size = count * (MAX_WORD + 1) + links * (MAX_WORD + 96)
+                + (count / PARAGRAPH + 2) * 16 + 256;
+  char* html = malloc(size);
+  if (html == NULL) {
+    return NULL;
+  }
+  char word[MAX_WORD + 1];
+  size_t len = 0;
+  len += sprintf(html + len, "<html>\n<head><title>");
+  for (int i = 0; i < 3; i++) {
+    spellWord(alias_draw(words, state), word);
+    len += sprintf(html + len, (i == 0) ? "%s" : " %s", word);
+  }
+  len += sprintf(html + len, "</title></head>\n<body>\n<h1>");
+  spellWord(alias_draw(words, state), word);
+  len += sprintf(html + len, "%s</h1>\n", word);
+
+  int paragraphs = (count + PARAGRAPH - 1) / PARAGRAPH;
+  int written = 0;
+  int linked = 0;
+  for (int p = 0; p < paragraphs; p++) {
+    len += sprintf(html + len, "<p>");
+    int end = (p + 1 == paragraphs) ? count : (p + 1) * PARAGRAPH;
+    for (int i = written; i < end; i++) {
+      spellWord(alias_draw(words, state), word);
+      len += sprintf(html + len, (i == written) ? "%s" : " %s", word);
+    }
+    written = end;
+    len += sprintf(html + len, "</p>\n");
+    // this paragraph's share of the links
+    int share = (p + 1 == paragraphs) ? links
+                                      : (int)((long)links * (p + 1) / paragraphs);
+    for (; linked < share; linked++) {
+      int target = (linked < children) ? firstChild + linked
+                                       : 1 + alias_draw(targets, state);
+      len += sprintf(html + len, "<a href=\"");
+      appendURL(html, &len, target);
+      spellWord(alias_draw(words, state), word);
+      len += sprintf(html + len, "\">%s</a>\n", word);
+    }
+  }
+  len += sprintf(html + len, "</body>\n</html>\n");
+  return html;
+}
+
+/*
+ * Writes the query log: shapes and bands as the top of this file says
+ * Returns false if the file cannot be written or memory runs out
+ */
+static bool writeQueries(const options_t* options)
+{
+  // the bands, each drawn from by Zipf's law within it
+  int head = (options->vocab < HEAD) ? options->vocab : HEAD;
+  int torso = options->vocab / 10;
+  if (torso <= head) {
+    torso = options->vocab;
+  }
+  alias_t* bands[3];
+  int starts[3] = { 0, head, torso };
+  int ends[3] = { head, torso, options->vocab };
+  bool ok = true;
+  for (int b = 0; b < 3; b++) {
+    bands[b] = NULL;
+    if (ends[b] > starts[b]) {
+      bands[b] = alias_new(ends[b] - starts[b], options->zipf, starts[b]);
+      ok = ok && bands[b] != NULL;
+    }
+  }
+  FILE* fp = ok ? fopen(options->queryLog, "w") : NULL;
+  if (fp == NULL) {
+    for (int b = 0; b < 3; b++) {
+      alias_delete(bands[b]);
+    }
+    return false;
+  }
+
+  // queries follow the pages' draws, so seed apart from them
+  uint64_t state = options->seed ^ 0x5175657279ULL;
+  // chance of 1 to 5 words, in percent
+  static const int SHAPES[] = { 30, 35, 20, 10, 5 };
+  char word[MAX_WORD + 1];
+  for (int q = 0; q < options->queries; q++) {
+    int terms = 1;
+    for (int r = randomBelow(&state, 100); r >= SHAPES[terms - 1]; terms++) {
+      r -= SHAPES[terms - 1];
+    }
+    for (int t = 0; t < terms; t++) {
+      if (t > 0) {
+        int join = randomBelow(&state, 100);
+        fprintf(fp, (join < 15) ? " or " : (join < 25) ? " and " : " ");
+      }
+      int r = randomBelow(&state, 100);
+      int b = (r < 20) ? 0 : (r < 70) ? 1 : 2;
+      if (bands[b] == NULL) {
+        b = (bands[1] != NULL) ? 1 : 0;
+      }
+      int rank = starts[b] + alias_draw(bands[b], &state);
+      int kind = randomBelow(&state, 100);
+      if (kind < 2) {
+        rank = options->vocab + randomBelow(&state, options->vocab) + 1;
+      }
+      int len = spellWord(rank, word);
+      if (kind >= 2 && kind < 7 && len > 4) {
+        fprintf(fp, "%.4s*", word);
+      } else {
+        fprintf(fp, "%s", word);
+      }
+    }
+    fprintf(fp, "\n");
+  }
+  fclose(fp);
+  for (int b = 0; b < 3; b++) {
+    alias_delete(bands[b]);
+  }
+  return true;
+}
@@ -0,0 +1,263 @@
+/*
+ * hashbench.c - compares string hashes on the vocabulary of an index
+ *
+ * usage: ./hashbench indexFilename [rounds]
+ *
+ * The words are the first token of each line of the index. Each hash runs
+ *   over every word, rounds times (default 20), and we report ns per word
+ *   and MB of words per second. Then each hash places the words in a table
+ *   of 2^k buckets, one per word rounded up, and we report:
+ *     chi2   the sum of squared bucket sizes over what a truly random hash
+ *            would give on average (1.00 is ideal, higher means clumping)
+ *     max    the longest chain
+ *     empty  the fraction of empty buckets (ideally about e^(-words/buckets))
+ *
+ * The hashes are libcs50's hash_jenkins (one byte at a time, strlen and %),
+ *   the FNV-1a that urlset used before, dedup_hash (XXH64) and fasthash.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <limits.h>
+#include <math.h>
+#include <time.h>
+#include "../common/fasthash.h"
+#include "../common/dedup.h"
+#include "../libcs50/hash.h"
+
+// one word of the vocabulary, NUL-terminated in the file's buffer
+typedef struct word {
+  const char* str;
+  size_t len;
+} word_t;
+
+// a hash under test
+typedef struct hasher {
+  const char* name;
+  uint64_t (*fn)(const char* str, const size_t len, const uint64_t buckets);
+} hasher_t;
+
+// function prototypes
+static double nowSeconds(void);
+static char* readFile(const char* filename, size_t* size);
+static word_t* splitWords(char* text, const size_t size, int* nwords);
+static uint64_t jenkinsFn(const char* str, const size_t len,
+                          const uint64_t buckets);
+static uint64_t fnvFn(const char* str, const size_t len,
+                      const uint64_t buckets);
+static uint64_t xxhFn(const char* str, const size_t len,
+                      const uint64_t buckets);
+static uint64_t fastFn(const char* str, const size_t len,
+                       const uint64_t buckets);
+
+static const hasher_t HASHERS[] = {
+  { "hash_jenkins", jenkinsFn },
+  { "fnv1a", fnvFn },
+  { "xxh64", xxhFn },
+  { "fasthash", fastFn },
+};
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s indexFilename [rounds]\n", argv[0]);
+    exit(1);
+  }
+  int rounds = (argc == 3) ? atoi(argv[2]) : 20;
+  if (rounds <= 0) {
+    fprintf(stderr, "rounds must be a positive integer\n");
+    exit(1);
+  }
+  size_t size;
+  char* text = readFile(argv[1], &size);
+  if (text == NULL) {
+    fprintf(stderr, "cannot read index '%s'\n", argv[1]);
+    exit(2);
+  }
+  int nwords;
+  word_t* words = splitWords(text, size, &nwords);
+  if (words == NULL || nwords == 0) {
+    fprintf(stderr, "no words in '%s'\n", argv[1]);
+    exit(2);
+  }
+
+  size_t bytes = 0;
+  for (int w = 0; w < nwords; w++) {
+    bytes += words[w].len;
+  }
+  uint64_t buckets = 1;
+  while (buckets < (uint64_t)nwords) {
+    buckets *= 2;
+  }
+  printf("%d words, %.1f bytes on average, %d rounds, %llu buckets\n",
+         nwords, (double)bytes / nwords, rounds, (unsigned long long)buckets);
+  printf("%-14s %9s %9s %7s %5s %7s\n",
+         "hash", "ns/word", "MB/s", "chi2", "max", "empty");
+
+  int* counts = malloc(buckets * sizeof(int));
+  if (counts == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(2);
+  }
+  for (size_t h = 0; h < sizeof(HASHERS) / sizeof(HASHERS[0]); h++) {
+    const hasher_t* hasher = &HASHERS[h];
+
+    // throughput: full hashes, the sum kept so none is optimized away
+    volatile uint64_t sink = 0;
+    double start = nowSeconds();
+    for (int r = 0; r < rounds; r++) {
+      uint64_t sum = 0;
+      for (int w = 0; w < nwords; w++) {
+        sum += hasher->fn(words[w].str, words[w].len, 0);
+      }
+      sink += sum;
+    }
+    double secs = nowSeconds() - start;
+
+    // distribution over the buckets
+    memset(counts, 0, buckets * sizeof(int));
+    for (int w = 0; w < nwords; w++) {
+      counts[hasher->fn(words[w].str, words[w].len, buckets)]++;
+    }
+    double squares = 0;
+    int max = 0;
+    uint64_t empty = 0;
+    for (uint64_t b = 0; b < buckets; b++) {
+      squares += (double)counts[b] * counts[b];
+      max = (counts[b] > max) ? counts[b] : max;
+      empty += (counts[b] == 0);
+    }
+    double expected = nwords + (double)nwords * (nwords - 1) / buckets;
+
+    printf("%-14s %9.2f %9.1f %7.3f %5d %6.1f%%\n", hasher->name,
+           secs * 1e9 / ((double)nwords * rounds),
+           (double)bytes * rounds / secs / 1e6,
+           squares / expected, max, 100.0 * empty / buckets);
+  }
+  printf("%-14s %9s %9s %7s %5s %6.1f%%\n", "(random)", "", "", "1.000", "",
+         100.0 * exp(-(double)nwords / buckets));
+
+  free(counts);
+  free(words);
+  free(text);
+  return 0;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// the whole file, NUL-terminated, or NULL if it cannot be read
+static char* readFile(const char* filename, size_t* size)
+{
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return NULL;
+  }
+  size_t cap = 1 << 16;
+  char* text = malloc(cap);
+  *size = 0;
+  size_t n;
+  while (text != NULL && (n = fread(text + *size, 1, cap - *size - 1, fp)) > 0) {
+    *size += n;
+    if (cap - *size - 1 == 0) {
+      cap *= 2;
+      char* grown = realloc(text, cap);
+      if (grown == NULL) {
+        free(text);
+      }
+      text = grown;
+    }
+  }
+  fclose(fp);
+  if (text != NULL) {
+    text[*size] = '\0';
+  }
+  return text;
+}
+
+// the first token of every line, each ended in place with a NUL
+static word_t* splitWords(char* text, const size_t size, int* nwords)
+{
+  int cap = 1024;
+  word_t* words = malloc(cap * sizeof(word_t));
+  *nwords = 0;
+  char* p = text;
+  char* end = text + size;
+  while (words != NULL && p < end) {
+    char* line = p;
+    char* eol = memchr(p, '\n', end - p);
+    eol = (eol == NULL) ? end : eol;
+    char* space = memchr(line, ' ', eol - line);
+    char* wordEnd = (space == NULL) ? eol : space;
+    p = (eol == end) ? end : eol + 1;
+    if (wordEnd == line) {
+      continue; // blank line
+    }
+    *wordEnd = '\0';
+    if (*nwords == cap) {
+      cap *= 2;
+      word_t* grown = realloc(words, cap * sizeof(word_t));
+      if (grown == NULL) {
+        free(words);
+        return NULL;
+      }
+      words = grown;
+    }
+    words[(*nwords)++] = (word_t){ line, wordEnd - line };
+  }
+  return words;
+}
+
+/**************** the hashes ****************/
+// buckets is a power of 2, or 0 for the full hash
+
+// libcs50's, which finds the length itself and takes a modulus
+static uint64_t jenkinsFn(const char* str, const size_t len,
+                          const uint64_t buckets)
+{
+  return hash_jenkins(str, (buckets == 0) ? ULONG_MAX : buckets);
+}
+
+// 64-bit FNV-1a with a murmur3 finish, one byte at a time
+static uint64_t fnvFn(const char* str, const size_t len,
+                      const uint64_t buckets)
+{
+  uint64_t h = 0xcbf29ce484222325ULL;
+  for (size_t i = 0; i < len; i++) {
+    h ^= (unsigned char)str[i];
+    h *= 0x100000001b3ULL;
+  }
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return (buckets == 0) ? h : (h & (buckets - 1));
+}
+
+// XXH64, as dedup uses
+static uint64_t xxhFn(const char* str, const size_t len,
+                      const uint64_t buckets)
+{
+  uint64_t h = dedup_hash(str, len);
+  return (buckets == 0) ? h : (h & (buckets - 1));
+}
+
+// word at a time
+static uint64_t fastFn(const char* str, const size_t len,
+                       const uint64_t buckets)
+{
+  uint64_t h = fasthash(str, len);
+  return (buckets == 0) ? h : (h & (buckets - 1));
+}
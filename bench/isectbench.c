@@ -0,0 +1,315 @@
+/*
+ * isectbench.c - the intersection kernels of intersect.h, checked and timed
+ *
+ * usage: ./isectbench [--check] [trials [rounds]]
+ *
+ * First it checks every method against a plain reference (each value of a
+ *   looked up in a table of b's values) on trials (default 20000) random
+ *   pairs of arrays: lengths 0 to 4096 (an array container's most), of
+ *   every ratio, from ranges of values small enough that many match or
+ *   large enough that few do, and some made to test the edges (block
+ *   lengths, one array inside the other, 65535). Out has only the room
+ *   intersect.h asks for. Any mismatch is reported and the exit status is 3.
+ *
+ * Then it times, for ratios of lengths 1 to 1024 (the longer array 4096
+ *   values from 16384, the shorter 4096 / ratio), merge, gallop, each
+ *   vector kernel the CPU has (ssse3, avx2), and intersect's own choice,
+ *   averaged over rounds (default 200) passes of 32 pairs, and reports ns
+ *   per intersection. With --check it stops after the checks, for
+ *   testing.sh, so a broken kernel fails make test.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <time.h>
+#include "../common/intersect.h"
+
+// most values in an array container
+#define MAX_LEN 4096
+// pairs timed in each pass
+#define PAIRS 32
+
+static const char* KERNELS[] = { "ssse3", "avx2" };
+static const int NKERNELS = 2;
+
+// function prototypes
+static double nowSeconds(void);
+static int randomArray(uint16_t* values, const int n, const int range,
+                       bool* seen);
+static int reference(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, uint16_t* out, bool* seen);
+static int checkPair(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, bool* seen);
+static int checkMethod(const char* name, const int got, const uint16_t* out,
+                       const int n, const uint16_t* expect, const int na,
+                       const int nb);
+static double timeMethod(int (*method)(const uint16_t*, const int,
+                                       const uint16_t*, const int, uint16_t*),
+                         uint16_t (*as)[MAX_LEN], const int* na,
+                         uint16_t (*bs)[MAX_LEN], const int* nb,
+                         uint16_t* out, const int rounds);
+
+int main(int argc, char* argv[])
+{
+  const char* program = argv[0];
+  bool checkOnly = (argc >= 2 && strcmp(argv[1], "--check") == 0);
+  if (checkOnly) {
+    argc--;
+    argv++;
+  }
+  if (argc > 3) {
+    fprintf(stderr, "Usage: %s [--check] [trials [rounds]]\n", program);
+    exit(1);
+  }
+  int trials = (argc >= 2) ? atoi(argv[1]) : 20000;
+  int rounds = (argc == 3) ? atoi(argv[2]) : 200;
+  if (trials < 0 || rounds <= 0) {
+    fprintf(stderr, "trials and rounds must be positive integers\n");
+    exit(1);
+  }
+  const char* start = intersect_kernel();
+  bool* seen = calloc(65536, sizeof(bool));
+  uint16_t* a = malloc(MAX_LEN * sizeof(uint16_t));
+  uint16_t* b = malloc(MAX_LEN * sizeof(uint16_t));
+  if (seen == NULL || a == NULL || b == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(2);
+  }
+  srand(47);
+  int mismatches = 0;
+
+  // the edges: block lengths, a inside b, the last value
+  static const int lengths[] = { 1, 7, 8, 9, 15, 16, 17, 31, 32, 33, 4096 };
+  const int nlengths = sizeof(lengths) / sizeof(lengths[0]);
+  for (int x = 0; x < nlengths; x++) {
+    for (int y = 0; y < nlengths; y++) {
+      int na = lengths[x];
+      int nb = lengths[y];
+      for (int i = 0; i < na; i++) {
+        a[i] = 65536 - na + i;    // a's last values are 65535
+      }
+      for (int i = 0; i < nb; i++) {
+        b[i] = 65536 - nb + i;
+      }
+      mismatches += checkPair(a, na, b, nb, seen);
+      for (int i = 0; i < nb; i++) {
+        b[i] = 2 * i;             // every other value of a range
+      }
+      for (int i = 0; i < na; i++) {
+        a[i] = i;
+      }
+      mismatches += checkPair(a, na, b, nb, seen);
+    }
+  }
+
+  // random pairs
+  for (int t = 0; t < trials; t++) {
+    int na = rand() % (MAX_LEN + 1);
+    int ratio = 1 << (rand() % 11);
+    int nb = (rand() % 2 == 0) ? na / ratio : na * ratio;
+    if (nb > MAX_LEN) {
+      nb = MAX_LEN;
+    }
+    int longer = (na > nb) ? na : nb;
+    int range = longer + rand() % (65536 - longer + 1);
+    if (rand() % 4 == 0) {
+      range = longer + rand() % (longer + 1);   // most values match
+    }
+    if (range > 65536) {
+      range = 65536;
+    }
+    randomArray(a, na, range, seen);
+    randomArray(b, nb, range, seen);
+    mismatches += checkPair(a, na, b, nb, seen);
+  }
+  printf("checked %d pairs: %d mismatches\n",
+         trials + 2 * nlengths * nlengths, mismatches);
+  if (checkOnly) {
+    free(a);
+    free(b);
+    free(seen);
+    return (mismatches == 0) ? 0 : 3;
+  }
+
+  // timing, by ratio of lengths
+  uint16_t (*as)[MAX_LEN] = malloc(PAIRS * sizeof(*as));
+  uint16_t (*bs)[MAX_LEN] = malloc(PAIRS * sizeof(*bs));
+  uint16_t* out = malloc((MAX_LEN + INTERSECT_SLACK) * sizeof(uint16_t));
+  if (as == NULL || bs == NULL || out == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(2);
+  }
+  printf("\n%-6s %6s %6s %7s %8s %8s", "ratio", "short", "long", "result",
+         "merge", "gallop");
+  for (int k = 0; k < NKERNELS; k++) {
+    printf(" %8s", KERNELS[k]);
+  }
+  printf(" %10s   (ns per intersection)\n", "intersect");
+  for (int ratio = 1; ratio <= 1024; ratio *= 2) {
+    int na[PAIRS];
+    int nb[PAIRS];
+    long matched = 0;
+    for (int p = 0; p < PAIRS; p++) {
+      na[p] = MAX_LEN / ratio;
+      nb[p] = MAX_LEN;
+      randomArray(as[p], na[p], 16384, seen);
+      randomArray(bs[p], nb[p], 16384, seen);
+      matched += intersect_merge(as[p], na[p], bs[p], nb[p], out);
+    }
+    printf("%-6d %6d %6d %7ld", ratio, MAX_LEN / ratio, MAX_LEN,
+           matched / PAIRS);
+    printf(" %8.0f", timeMethod(intersect_merge, as, na, bs, nb, out, rounds));
+    printf(" %8.0f", timeMethod(intersect_gallop, as, na, bs, nb, out, rounds));
+    for (int k = 0; k < NKERNELS; k++) {
+      if (intersect_useKernel(KERNELS[k])) {
+        printf(" %8.0f", timeMethod(intersect_vector, as, na, bs, nb, out,
+                                    rounds));
+      } else {
+        printf(" %8s", "-");
+      }
+    }
+    intersect_useKernel(start);
+    printf(" %10.0f\n", timeMethod(intersect, as, na, bs, nb, out, rounds));
+  }
+  printf("(intersect: gallop at a ratio of %d or more, else %s)\n",
+         INTERSECT_SKEW, start);
+
+  free(as);
+  free(bs);
+  free(out);
+  free(a);
+  free(b);
+  free(seen);
+  return (mismatches == 0) ? 0 : 3;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// n different values below range, in increasing order; seen is left clear
+static int randomArray(uint16_t* values, const int n, const int range,
+                       bool* seen)
+{
+  int chosen = 0;
+  if (2 * n > range) {
+    // most of the range: take each value with the chance still needed
+    for (int v = 0; v < range && chosen < n; v++) {
+      if (rand() % (range - v) < n - chosen) {
+        values[chosen++] = v;
+      }
+    }
+    return chosen;
+  }
+  while (chosen < n) {
+    int v = rand() % range;
+    if (!seen[v]) {
+      seen[v] = true;
+      chosen++;
+    }
+  }
+  chosen = 0;
+  for (int v = 0; v < range && chosen < n; v++) {
+    if (seen[v]) {
+      values[chosen++] = v;
+      seen[v] = false;
+    }
+  }
+  return chosen;
+}
+
+// each value of a looked up in a table of b's
+static int reference(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, uint16_t* out, bool* seen)
+{
+  for (int j = 0; j < nb; j++) {
+    seen[b[j]] = true;
+  }
+  int n = 0;
+  for (int i = 0; i < na; i++) {
+    if (seen[a[i]]) {
+      out[n++] = a[i];
+    }
+  }
+  for (int j = 0; j < nb; j++) {
+    seen[b[j]] = false;
+  }
+  return n;
+}
+
+// every method, both ways round, against the reference
+static int checkPair(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, bool* seen)
+{
+  uint16_t expect[MAX_LEN];
+  int n = reference(a, na, b, nb, expect, seen);
+  // just the room intersect.h asks for
+  int room = ((na < nb) ? na : nb) + INTERSECT_SLACK;
+  uint16_t* out = malloc(room * sizeof(uint16_t));
+  if (out == NULL) {
+    return 1;
+  }
+  const char* start = intersect_kernel();
+  int bad = 0;
+  for (int swap = 0; swap < 2; swap++) {
+    const uint16_t* x = (swap == 0) ? a : b;
+    const uint16_t* y = (swap == 0) ? b : a;
+    int nx = (swap == 0) ? na : nb;
+    int ny = (swap == 0) ? nb : na;
+    bad += checkMethod("merge", intersect_merge(x, nx, y, ny, out),
+                       out, n, expect, nx, ny);
+    bad += checkMethod("gallop", intersect_gallop(x, nx, y, ny, out),
+                       out, n, expect, nx, ny);
+    bad += checkMethod("intersect", intersect(x, nx, y, ny, out),
+                       out, n, expect, nx, ny);
+    for (int k = 0; k < NKERNELS; k++) {
+      if (intersect_useKernel(KERNELS[k])) {
+        bad += checkMethod(KERNELS[k], intersect_vector(x, nx, y, ny, out),
+                           out, n, expect, nx, ny);
+      }
+    }
+    intersect_useKernel(start);
+  }
+  free(out);
+  return bad;
+}
+
+// 1 (and a report) if a method's result is not the reference's
+static int checkMethod(const char* name, const int got, const uint16_t* out,
+                       const int n, const uint16_t* expect, const int na,
+                       const int nb)
+{
+  if (got == n && memcmp(out, expect, n * sizeof(uint16_t)) == 0) {
+    return 0;
+  }
+  fprintf(stderr, "%s: %d values of %d and %d, not %d\n", name, got, na, nb, n);
+  return 1;
+}
+
+// ns per intersection of the pairs
+static double timeMethod(int (*method)(const uint16_t*, const int,
+                                       const uint16_t*, const int, uint16_t*),
+                         uint16_t (*as)[MAX_LEN], const int* na,
+                         uint16_t (*bs)[MAX_LEN], const int* nb,
+                         uint16_t* out, const int rounds)
+{
+  volatile long sink = 0;
+  double start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int p = 0; p < PAIRS; p++) {
+      sink += method(as[p], na[p], bs[p], nb[p], out);
+    }
+  }
+  return (nowSeconds() - start) / ((double)rounds * PAIRS) * 1e9;
+}
@@ -0,0 +1,413 @@
+/*
+ * lexbench.c - the lexicon file against the in-memory hash table of words
+ *
+ * usage: ./lexbench indexFilename [rounds]
+ *
+ * Builds indexFilename.lex (see lexicon.h) and checks it against the
+ *   index's own words: every word's number, spelling and line offset, a
+ *   miss for each word with its last letter cut off (unless that is a word
+ *   too), the prefixes of every word, and ranges between random words.
+ *   Any mismatch is reported and the exit status is 3.
+ *
+ * Then it times, over rounds passes (default 5) of the words in shuffled
+ *   order, looking each word up (hit) and each word with "zq" after it
+ *   (miss), and the words starting with each word's first three letters
+ *   (prefix), in three lexicons:
+ *     hash table  a strarena of the words, as index_load builds (no prefix
+ *                 lookup: a prefix means walking every word)
+ *     sorted      binary search in an array of (word, length), as lazyindex
+ *                 builds when there is no lexicon file
+ *     lexicon     the mapped lexicon file
+ *   and reports the time to get each ready, its size, and ns per lookup.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../common/lexicon.h"
+#include "../common/strarena.h"
+
+// one word of the index, NUL-terminated in the file's buffer
+typedef struct word {
+  const char* str;
+  size_t len;
+} word_t;
+
+// function prototypes
+static double nowSeconds(void);
+static char* readFile(const char* filename, size_t* size);
+static word_t* splitWords(char* text, const size_t size, int* nwords);
+static int compareWord(const word_t* a, const char* str, const size_t len);
+static int lowerBound(const word_t* words, const int nwords,
+                      const char* str, const size_t len);
+static int sortedFind(const word_t* words, const int nwords,
+                      const char* str, const size_t len);
+static int sortedPrefix(const word_t* words, const int nwords,
+                        const char* prefix, int* first);
+static int checkLexicon(lexicon_t* lex, const char* text, const word_t* words,
+                        const int nwords);
+static void printRow(const char* name, const double ready, const size_t bytes,
+                     const int nwords, const double hit, const double miss,
+                     const double prefix);
+
+int main(int argc, char* argv[])
+{
+  if (argc < 2 || argc > 3) {
+    fprintf(stderr, "Usage: %s indexFilename [rounds]\n", argv[0]);
+    exit(1);
+  }
+  int rounds = (argc == 3) ? atoi(argv[2]) : 5;
+  if (rounds <= 0) {
+    fprintf(stderr, "rounds must be a positive integer\n");
+    exit(1);
+  }
+
+  double start = nowSeconds();
+  if (!lexicon_build(argv[1])) {
+    fprintf(stderr, "cannot build a lexicon of '%s' (unsorted?)\n", argv[1]);
+    exit(2);
+  }
+  double built = nowSeconds() - start;
+  start = nowSeconds();
+  lexicon_t* lex = lexicon_open(argv[1]);
+  double opened = nowSeconds() - start;
+  size_t size;
+  char* text = readFile(argv[1], &size);
+  int nwords;
+  word_t* words = (text == NULL) ? NULL : splitWords(text, size, &nwords);
+  if (lex == NULL || words == NULL) {
+    fprintf(stderr, "cannot read '%s' or its lexicon\n", argv[1]);
+    exit(2);
+  }
+  printf("%d words, %.1f MB index, lexicon built in %.3f s\n",
+         nwords, size / 1e6, built);
+
+  int mismatches = checkLexicon(lex, text, words, nwords);
+  printf("checked: %d mismatches\n", mismatches);
+
+  // the lookups, shuffled, and a miss for each
+  srand(44);
+  word_t* order = malloc(nwords * sizeof(word_t));
+  char** misses = malloc(nwords * sizeof(char*));
+  for (int i = 0; i < nwords; i++) {
+    order[i] = words[i];
+  }
+  for (int i = nwords - 1; i > 0; i--) {
+    int j = rand() % (i + 1);
+    word_t swap = order[i];
+    order[i] = order[j];
+    order[j] = swap;
+  }
+  for (int i = 0; i < nwords; i++) {
+    misses[i] = malloc(order[i].len + 3);
+    memcpy(misses[i], order[i].str, order[i].len);
+    strcpy(misses[i] + order[i].len, "zq");
+  }
+  double lookups = (double)nwords * rounds;
+  volatile long sink = 0;
+
+  // hash table
+  start = nowSeconds();
+  strarena_t* arena = strarena_new(nwords);
+  for (int i = 0; i < nwords; i++) {
+    strarena_intern(arena, words[i].str, words[i].len);
+  }
+  double ready = nowSeconds() - start;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      sink += strarena_find(arena, order[i].str, order[i].len);
+    }
+  }
+  double hit = (nowSeconds() - start) / lookups * 1e9;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      sink += strarena_find(arena, misses[i], order[i].len + 2);
+    }
+  }
+  double miss = (nowSeconds() - start) / lookups * 1e9;
+  start = nowSeconds();
+  for (int i = 0; i < strarena_count(arena); i++) {
+    sink += (strncmp(strarena_get(arena, i), "com", 3) == 0);
+  }
+  double prefix = (nowSeconds() - start) * 1e9;
+  printf("%-11s %9s %10s %9s %8s %8s %10s\n", "lexicon", "ready",
+         "bytes", "per word", "hit", "miss", "prefix");
+  printRow("hash table", ready, strarena_memory(arena), nwords, hit, miss, prefix);
+  strarena_delete(arena);
+
+  // sorted array, as split from the file
+  start = nowSeconds();
+  word_t* sorted = malloc(nwords * sizeof(word_t));
+  memcpy(sorted, words, nwords * sizeof(word_t));
+  ready = nowSeconds() - start;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      sink += sortedFind(sorted, nwords, order[i].str, order[i].len);
+    }
+  }
+  hit = (nowSeconds() - start) / lookups * 1e9;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      sink += sortedFind(sorted, nwords, misses[i], order[i].len + 2);
+    }
+  }
+  miss = (nowSeconds() - start) / lookups * 1e9;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      char pre[4] = { 0 };
+      memcpy(pre, order[i].str, (order[i].len < 3) ? order[i].len : 3);
+      int first;
+      sink += sortedPrefix(sorted, nwords, pre, &first);
+    }
+  }
+  prefix = (nowSeconds() - start) / lookups * 1e9;
+  printRow("sorted", ready, nwords * sizeof(word_t), nwords, hit, miss, prefix);
+  free(sorted);
+
+  // lexicon file
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      sink += lexicon_find(lex, order[i].str, order[i].len);
+    }
+  }
+  hit = (nowSeconds() - start) / lookups * 1e9;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      sink += lexicon_find(lex, misses[i], order[i].len + 2);
+    }
+  }
+  miss = (nowSeconds() - start) / lookups * 1e9;
+  start = nowSeconds();
+  for (int r = 0; r < rounds; r++) {
+    for (int i = 0; i < nwords; i++) {
+      char pre[4] = { 0 };
+      memcpy(pre, order[i].str, (order[i].len < 3) ? order[i].len : 3);
+      int first;
+      sink += lexicon_prefix(lex, pre, &first);
+    }
+  }
+  prefix = (nowSeconds() - start) / lookups * 1e9;
+  printRow("lexicon", opened, lexicon_bytes(lex), nwords, hit, miss, prefix);
+  printf("(hash table prefix: one walk over every word; ready: build from "
+         "words in memory, or open the file)\n");
+
+  for (int i = 0; i < nwords; i++) {
+    free(misses[i]);
+  }
+  free(misses);
+  free(order);
+  free(words);
+  free(text);
+  lexicon_close(lex);
+  return (mismatches == 0) ? 0 : 3;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// the whole file, NUL-terminated; NULL on error
+static char* readFile(const char* filename, size_t* size)
+{
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return NULL;
+  }
+  size_t cap = 1 << 16;
+  char* text = malloc(cap);
+  *size = 0;
+  size_t n;
+  while (text != NULL && (n = fread(text + *size, 1, cap - *size - 1, fp)) > 0) {
+    *size += n;
+    if (cap - *size - 1 == 0) {
+      cap *= 2;
+      char* grown = realloc(text, cap);
+      if (grown == NULL) {
+        free(text);
+      }
+      text = grown;
+    }
+  }
+  fclose(fp);
+  if (text != NULL) {
+    text[*size] = '\0';
+  }
+  return text;
+}
+
+// the first token of every line, NUL-terminated in place
+static word_t* splitWords(char* text, const size_t size, int* nwords)
+{
+  int cap = 1024;
+  word_t* words = malloc(cap * sizeof(word_t));
+  *nwords = 0;
+  char* p = text;
+  char* end = text + size;
+  while (words != NULL && p < end) {
+    char* line = p;
+    char* eol = memchr(p, '\n', end - p);
+    eol = (eol == NULL) ? end : eol;
+    char* space = memchr(line, ' ', eol - line);
+    char* wordEnd = (space == NULL) ? eol : space;
+    p = (eol == end) ? end : eol + 1;
+    if (wordEnd == line) {
+      continue; // blank line
+    }
+    *wordEnd = '\0';
+    if (*nwords == cap) {
+      cap *= 2;
+      word_t* grown = realloc(words, cap * sizeof(word_t));
+      if (grown == NULL) {
+        free(words);
+        return NULL;
+      }
+      words = grown;
+    }
+    words[(*nwords)++] = (word_t){ line, wordEnd - line };
+  }
+  return words;
+}
+
+// strcmp of a word with str of len bytes
+static int compareWord(const word_t* a, const char* str, const size_t len)
+{
+  size_t common = (a->len < len) ? a->len : len;
+  int c = memcmp(a->str, str, common);
+  return (c != 0) ? c : (a->len > len) - (a->len < len);
+}
+
+// the first word not before str
+static int lowerBound(const word_t* words, const int nwords,
+                      const char* str, const size_t len)
+{
+  int lo = 0;
+  int hi = nwords;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (compareWord(&words[mid], str, len) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// the number of str, or -1
+static int sortedFind(const word_t* words, const int nwords,
+                      const char* str, const size_t len)
+{
+  int lo = lowerBound(words, nwords, str, len);
+  return (lo < nwords && compareWord(&words[lo], str, len) == 0) ? lo : -1;
+}
+
+// how many words start with prefix, from *first on
+static int sortedPrefix(const word_t* words, const int nwords,
+                        const char* prefix, int* first)
+{
+  size_t len = strlen(prefix);
+  int lo = lowerBound(words, nwords, prefix, len);
+  // the words from lo on that start with prefix come first
+  int hi = nwords;
+  int from = lo;
+  while (from < hi) {
+    int mid = from + (hi - from) / 2;
+    if (words[mid].len >= len && memcmp(words[mid].str, prefix, len) == 0) {
+      from = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  *first = lo;
+  return hi - lo;
+}
+
+// every lookup of the lexicon against the sorted words; the mismatches
+static int checkLexicon(lexicon_t* lex, const char* text, const word_t* words,
+                        const int nwords)
+{
+  int bad = 0;
+  char buf[1024];
+  if (lexicon_words(lex) != nwords) {
+    fprintf(stderr, "MISMATCH: %d words in the lexicon, %d in the index\n",
+            lexicon_words(lex), nwords);
+    return 1;
+  }
+  for (int i = 0; i < nwords; i++) {
+    const word_t* w = &words[i];
+    int len = lexicon_word(lex, i, buf, sizeof(buf));
+    if (lexicon_find(lex, w->str, w->len) != i
+        || lexicon_offset(lex, i) != (size_t)(w->str - text)
+        || len != (int)w->len
+        || (w->len < sizeof(buf) && strcmp(buf, w->str) != 0)) {
+      fprintf(stderr, "MISMATCH: word %d '%s'\n", i, w->str);
+      bad++;
+    }
+    if (lexicon_find(lex, w->str, w->len - 1)
+        != sortedFind(words, nwords, w->str, w->len - 1)) {
+      fprintf(stderr, "MISMATCH: '%.*s' found wrongly\n", (int)w->len - 1, w->str);
+      bad++;
+    }
+    for (size_t p = 0; p <= 4 && p <= w->len && p < sizeof(buf); p++) {
+      memcpy(buf, w->str, p);
+      buf[p] = '\0';
+      int first, wantFirst;
+      int count = lexicon_prefix(lex, buf, &first);
+      int want = sortedPrefix(words, nwords, buf, &wantFirst);
+      if (count != want || (count > 0 && first != wantFirst)) {
+        fprintf(stderr, "MISMATCH: prefix '%s': %d at %d, want %d at %d\n",
+                buf, count, first, want, wantFirst);
+        bad++;
+      }
+    }
+  }
+  for (int r = 0; r < 1000 && nwords > 0; r++) {
+    int a = rand() % nwords;
+    int b = rand() % nwords;
+    int first;
+    int count = lexicon_range(lex, words[a].str, words[b].str, &first);
+    int want = (a <= b) ? b - a + 1 : 0;
+    if (count != want || (count > 0 && first != a)) {
+      fprintf(stderr, "MISMATCH: range '%s'..'%s': %d at %d, want %d at %d\n",
+              words[a].str, words[b].str, count, first, want, a);
+      bad++;
+    }
+    // ends that are not words: just after a, just before b's successor
+    snprintf(buf, sizeof(buf), "%sa", words[a].str);
+    int lo = lowerBound(words, nwords, buf, strlen(buf));
+    count = lexicon_range(lex, buf, words[b].str, &first);
+    want = (lo <= b) ? b - lo + 1 : 0;
+    if (count != want || (count > 0 && first != lo)) {
+      fprintf(stderr, "MISMATCH: range '%s'..'%s': %d, want %d\n",
+              buf, words[b].str, count, want);
+      bad++;
+    }
+  }
+  return bad;
+}
+
+// one line of the table
+static void printRow(const char* name, const double ready, const size_t bytes,
+                     const int nwords, const double hit, const double miss,
+                     const double prefix)
+{
+  printf("%-11s %8.3fs %10zu %9.1f %6.1fns %6.1fns %8.1fns\n", name, ready,
+         bytes, (nwords > 0) ? (double)bytes / nwords : 0.0, hit, miss, prefix);
+}
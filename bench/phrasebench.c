@@ -0,0 +1,191 @@
+/*
+ * phrasebench.c - compares phrase queries on the positional index with a
+ *   naive rescan of every page in pageDirectory
+ *
+ * usage: ./phrasebench pageDirectory indexFilename "some phrase" [repeats]
+ *
+ * indexFilename must have been built with 'indexer --positions'. We print the
+ *   size of the index and of its positional layer, then the average latency of
+ *   the phrase query both ways, and check that both find the same documents.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../common/index.h"
+#include "../common/pagedir.h"
+#include "../common/word.h"
+#include "../libcs50/webpage.h"
+#include "../libcs50/counters.h"
+
+#define MAX_PHRASE_WORDS 32
+
+// function prototypes
+static double nowSeconds(void);
+static long fileSize(const char* filename);
+static counters_t* rescanPhrase(const char* pageDirectory, char** words, int nwords);
+static int countInPage(webpage_t* page, char** words, int nwords);
+static void sumFn(void* arg, const int key, const int count);
+
+int main(int argc, char* argv[])
+{
+  if (argc != 4 && argc != 5) {
+    fprintf(stderr, "Usage: %s pageDirectory indexFilename \"phrase\" [repeats]\n",
+            argv[0]);
+    exit(1);
+  }
+  const char* pageDirectory = argv[1];
+  const char* indexFilename = argv[2];
+  int repeats = (argc == 5) ? atoi(argv[4]) : 10;
+  if (repeats < 1) {
+    repeats = 1;
+  }
+
+  // split the phrase into normalized words
+  char* phrase = malloc(strlen(argv[3]) + 1);
+  strcpy(phrase, argv[3]);
+  char* words[MAX_PHRASE_WORDS];
+  int nwords = 0;
+  for (char* w = strtok(phrase, " \t"); w != NULL && nwords < MAX_PHRASE_WORDS;
+       w = strtok(NULL, " \t")) {
+    if (normalizeWord(w)) {
+      words[nwords++] = w;
+    }
+  }
+  if (nwords < 2) {
+    fprintf(stderr, "phrase needs at least two words of 3+ letters\n");
+    exit(2);
+  }
+
+  double start = nowSeconds();
+  index_t* index = index_load(indexFilename);
+  double loadTime = nowSeconds() - start;
+  if (index == NULL || !index_hasPositions(index)) {
+    fprintf(stderr, "cannot load positional index '%s'\n", indexFilename);
+    exit(3);
+  }
+
+  char posFilename[1024];
+  snprintf(posFilename, sizeof(posFilename), "%s.pos", indexFilename);
+  printf("index size:       %ld bytes\n", fileSize(indexFilename));
+  printf("positions size:   %ld bytes\n", fileSize(posFilename));
+  printf("index load:       %.3f ms\n", loadTime * 1e3);
+
+  // positional intersection
+  int posMatches = 0;
+  start = nowSeconds();
+  for (int r = 0; r < repeats; r++) {
+    counters_t* result = index_findPhrase(index, words, nwords);
+    posMatches = 0;
+    counters_iterate(result, &posMatches, sumFn);
+    counters_delete(result);
+  }
+  double posTime = (nowSeconds() - start) / repeats;
+
+  // re-read every page
+  int scanMatches = 0;
+  start = nowSeconds();
+  for (int r = 0; r < repeats; r++) {
+    counters_t* result = rescanPhrase(pageDirectory, words, nwords);
+    scanMatches = 0;
+    counters_iterate(result, &scanMatches, sumFn);
+    counters_delete(result);
+  }
+  double scanTime = (nowSeconds() - start) / repeats;
+
+  printf("positional query: %.3f ms (%d occurrences)\n", posTime * 1e3, posMatches);
+  printf("page rescan:      %.3f ms (%d occurrences)\n", scanTime * 1e3, scanMatches);
+  if (posTime > 0) {
+    printf("speedup:          %.1fx\n", scanTime / posTime);
+  }
+
+  index_delete(index);
+  free(phrase);
+  if (posMatches != scanMatches) {
+    fprintf(stderr, "MISMATCH between positional index and rescan\n");
+    return 4;
+  }
+  return 0;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// size of a file, or -1 if it cannot be read
+static long fileSize(const char* filename)
+{
+  struct stat st;
+  return (stat(filename, &st) == 0) ? (long)st.st_size : -1;
+}
+
+// load every page in turn and count phrase occurrences the slow way
+static counters_t* rescanPhrase(const char* pageDirectory, char** words, int nwords)
+{
+  counters_t* result = counters_new();
+  webpage_t* page;
+  for (int docID = 1; (page = pagedir_load(pageDirectory, docID)) != NULL; docID++) {
+    int count = countInPage(page, words, nwords);
+    if (count > 0) {
+      counters_set(result, docID, count);
+    }
+    webpage_delete(page);
+  }
+  return result;
+}
+
+// number of places where the page's words match the phrase
+static int countInPage(webpage_t* page, char** words, int nwords)
+{
+  // collect all words of the page, normalized; short ones are kept as gaps
+  int ntokens = 0;
+  int maxtokens = 1024;
+  char** tokens = malloc(maxtokens * sizeof(char*));
+  int pos = 0;
+  char* word;
+  while ((word = webpage_getNextWord(page, &pos)) != NULL) {
+    if (!normalizeWord(word)) {
+      word[0] = '\0';
+    }
+    if (ntokens == maxtokens) {
+      maxtokens *= 2;
+      tokens = realloc(tokens, maxtokens * sizeof(char*));
+    }
+    tokens[ntokens++] = word;
+  }
+
+  int count = 0;
+  for (int i = 0; i + nwords <= ntokens; i++) {
+    int k = 0;
+    while (k < nwords && strcmp(tokens[i + k], words[k]) == 0) {
+      k++;
+    }
+    if (k == nwords) {
+      count++;
+    }
+  }
+
+  for (int i = 0; i < ntokens; i++) {
+    free(tokens[i]);
+  }
+  free(tokens);
+  return count;
+}
+
+// adds up all counts
+static void sumFn(void* arg, const int key, const int count)
+{
+  int* sum = arg;
+  *sum += count;
+}
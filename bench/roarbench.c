@@ -0,0 +1,304 @@
+/*
+ * roarbench.c - docID sets for 'and' and 'or': counters, sorted arrays,
+ *   and roaring bitmaps
+ *
+ * usage: ./roarbench [docs [rounds]]
+ *
+ * Makes sets of docIDs below docs (default 1000000) of mixed density: a
+ *   rare word (1 doc in 1000), a middling one (1 in 50), a common one (3 in
+ *   10), one in nearly every doc (9 in 10), and one whose docs come in runs
+ *   of about 1000 (a site crawled in order). Then for pairs of them it
+ *   finds the docIDs in both ('and') and in either ('or') with
+ *     counters  as the querier did before: for each docID of one, a
+ *               counters_get on the other, a walk down its list (only run
+ *               when the two sizes multiplied are at most 50 million)
+ *     arrays    a merge of the two sorted docID arrays
+ *     roaring   roaring_and or roaring_or, with each of the kernels the CPU
+ *               has (scalar, sse2, avx2)
+ *   and reports microseconds per operation, averaged over rounds (default
+ *   20). Every result is checked against the arrays' result; any mismatch
+ *   is reported and the exit status is 3.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include "../common/roaring.h"
+#include "../libcs50/counters.h"
+
+// a set of docIDs, three ways
+typedef struct docset {
+  const char* name;
+  int* docIDs;          // increasing
+  int n;
+  counters_t* ctrs;     // NULL unless small enough to time
+  roaring_t* set;
+} docset_t;
+
+// sets up to this size get counters, and pairs up to this product are timed
+static const int COUNTERS_BUILD = 25000;
+static const long COUNTERS_MAX = 50000000;
+
+static const char* KERNELS[] = { "scalar", "sse2", "avx2" };
+static const int NKERNELS = 3;
+
+// function prototypes
+static double nowSeconds(void);
+static void makeSet(docset_t* ds, const char* name, const int docs,
+                    const double density, const int run);
+static void deleteSet(docset_t* ds);
+static int arraysAnd(const docset_t* a, const docset_t* b, int* out);
+static int arraysOr(const docset_t* a, const docset_t* b, int* out);
+static int countersAnd(const docset_t* a, const docset_t* b);
+static void countDoc(void* arg, const int docID, const int count);
+static int checkRoaring(roaring_t* set, const int* expect, const int n);
+
+int main(int argc, char* argv[])
+{
+  if (argc > 3) {
+    fprintf(stderr, "Usage: %s [docs [rounds]]\n", argv[0]);
+    exit(1);
+  }
+  int docs = (argc >= 2) ? atoi(argv[1]) : 1000000;
+  int rounds = (argc == 3) ? atoi(argv[2]) : 20;
+  if (docs <= 0 || rounds <= 0) {
+    fprintf(stderr, "docs and rounds must be positive integers\n");
+    exit(1);
+  }
+  const char* start = roaring_kernel();
+
+  srand(46);
+  docset_t sets[5];
+  makeSet(&sets[0], "rare", docs, 0.001, 1);
+  makeSet(&sets[1], "middling", docs, 0.02, 1);
+  makeSet(&sets[2], "common", docs, 0.3, 1);
+  makeSet(&sets[3], "everywhere", docs, 0.9, 1);
+  makeSet(&sets[4], "runs", docs, 0.2, 1000);
+  printf("%d docs; kernels: %s\n", docs, start);
+  for (int i = 0; i < 5; i++) {
+    if (sets[i].docIDs == NULL || sets[i].set == NULL) {
+      fprintf(stderr, "out of memory\n");
+      exit(2);
+    }
+    printf("%-10s %8d docIDs, %9zu bytes as an array; ", sets[i].name,
+           sets[i].n, sets[i].n * sizeof(int));
+    roaring_print(sets[i].set, stdout);
+  }
+
+  // the pairs: rare with others, then dense with dense
+  static const int pairs[][2] = {
+    { 0, 1 }, { 0, 3 }, { 1, 2 }, { 2, 3 }, { 4, 2 }, { 4, 3 },
+  };
+  const int npairs = sizeof(pairs) / sizeof(pairs[0]);
+  int* out = malloc((2 * docs + 1) * sizeof(int));
+  int* got = malloc((docs + 1) * sizeof(int));
+  if (out == NULL || got == NULL) {
+    fprintf(stderr, "out of memory\n");
+    exit(2);
+  }
+  volatile long sink = 0;
+  int mismatches = 0;
+
+  printf("\n%-4s %-22s %8s %10s %10s", "op", "sets", "result", "counters",
+         "arrays");
+  for (int k = 0; k < NKERNELS; k++) {
+    printf(" %10s", KERNELS[k]);
+  }
+  printf("   (us per op)\n");
+  for (int op = 0; op < 2; op++) {
+    for (int p = 0; p < npairs; p++) {
+      docset_t* a = &sets[pairs[p][0]];
+      docset_t* b = &sets[pairs[p][1]];
+      char label[64];
+      snprintf(label, sizeof(label), "%s %s", a->name, b->name);
+
+      // arrays: the reference result
+      double t0 = nowSeconds();
+      int n = 0;
+      for (int r = 0; r < rounds; r++) {
+        n = (op == 0) ? arraysAnd(a, b, out) : arraysOr(a, b, out);
+        sink += n;
+      }
+      double arrays = (nowSeconds() - t0) / rounds * 1e6;
+
+      // counters: 'and' only, as 'or' walked the lists the same way
+      char counters[16] = "-";
+      if (op == 0 && a->ctrs != NULL && b->ctrs != NULL
+          && (long)a->n * b->n <= COUNTERS_MAX) {
+        t0 = nowSeconds();
+        int c = countersAnd(a, b);
+        snprintf(counters, sizeof(counters), "%.1f",
+                 (nowSeconds() - t0) * 1e6);
+        if (c != n) {
+          fprintf(stderr, "counters %s: %d docIDs, not %d\n", label, c, n);
+          mismatches++;
+        }
+      }
+      printf("%-4s %-22s %8d %10s %10.1f", (op == 0) ? "and" : "or",
+             label, n, counters, arrays);
+
+      for (int k = 0; k < NKERNELS; k++) {
+        if (!roaring_useKernel(KERNELS[k])) {
+          printf(" %10s", "-");
+          continue;
+        }
+        roaring_t* result = NULL;
+        t0 = nowSeconds();
+        for (int r = 0; r < rounds; r++) {
+          roaring_delete(result);
+          result = (op == 0) ? roaring_and(a->set, b->set)
+                             : roaring_or(a->set, b->set);
+          sink += roaring_count(result);
+        }
+        printf(" %10.1f", (nowSeconds() - t0) / rounds * 1e6);
+        if (result == NULL || roaring_count(result) != n
+            || roaring_toArray(result, got) != n
+            || memcmp(got, out, n * sizeof(int)) != 0
+            || checkRoaring(result, out, n) != 0) {
+          fprintf(stderr, "\n%s %s with %s: wrong docIDs\n",
+                  (op == 0) ? "and" : "or", label, KERNELS[k]);
+          mismatches++;
+        }
+        roaring_delete(result);
+      }
+      printf("\n");
+    }
+  }
+  roaring_useKernel(start);
+  printf("checked: %d mismatches\n", mismatches);
+
+  for (int i = 0; i < 5; i++) {
+    deleteSet(&sets[i]);
+  }
+  free(out);
+  free(got);
+  return (mismatches == 0) ? 0 : 3;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/*
+ * Fills ds with docIDs below docs, in runs of run consecutive docIDs, each
+ *   run chosen with probability density; docIDs start at 1, as the crawler's
+ */
+static void makeSet(docset_t* ds, const char* name, const int docs,
+                    const double density, const int run)
+{
+  ds->name = name;
+  ds->n = 0;
+  ds->ctrs = NULL;
+  ds->set = NULL;
+  ds->docIDs = malloc((docs + 1) * sizeof(int));
+  if (ds->docIDs == NULL) {
+    return;
+  }
+  for (int first = 1; first < docs; first += run) {
+    if (rand() < density * ((double)RAND_MAX + 1)) {
+      for (int docID = first; docID < first + run && docID < docs; docID++) {
+        ds->docIDs[ds->n++] = docID;
+      }
+    }
+  }
+  ds->set = roaring_fromSorted(ds->docIDs, ds->n);
+  if (ds->n <= COUNTERS_BUILD) {
+    ds->ctrs = counters_new();
+    for (int i = 0; i < ds->n && ds->ctrs != NULL; i++) {
+      counters_set(ds->ctrs, ds->docIDs[i], 1);
+    }
+  }
+}
+
+// frees what makeSet made
+static void deleteSet(docset_t* ds)
+{
+  free(ds->docIDs);
+  counters_delete(ds->ctrs);
+  roaring_delete(ds->set);
+}
+
+// merge: docIDs in both
+static int arraysAnd(const docset_t* a, const docset_t* b, int* out)
+{
+  int i = 0, j = 0, n = 0;
+  while (i < a->n && j < b->n) {
+    if (a->docIDs[i] < b->docIDs[j]) {
+      i++;
+    } else if (a->docIDs[i] > b->docIDs[j]) {
+      j++;
+    } else {
+      out[n++] = a->docIDs[i];
+      i++;
+      j++;
+    }
+  }
+  return n;
+}
+
+// merge: docIDs in either
+static int arraysOr(const docset_t* a, const docset_t* b, int* out)
+{
+  int i = 0, j = 0, n = 0;
+  while (i < a->n || j < b->n) {
+    if (j == b->n || (i < a->n && a->docIDs[i] < b->docIDs[j])) {
+      out[n++] = a->docIDs[i++];
+    } else if (i == a->n || a->docIDs[i] > b->docIDs[j]) {
+      out[n++] = b->docIDs[j++];
+    } else {
+      out[n++] = a->docIDs[i];
+      i++;
+      j++;
+    }
+  }
+  return n;
+}
+
+// for the counters_iterate helper: the counters looked up, and a tally
+struct andCount {
+  counters_t* other;
+  int n;
+};
+
+// as the querier did: each docID of a looked up in b
+static int countersAnd(const docset_t* a, const docset_t* b)
+{
+  struct andCount arg = { b->ctrs, 0 };
+  counters_iterate(a->ctrs, &arg, countDoc);
+  return arg.n;
+}
+
+// counters_iterate helper: count docID if the other counters has it
+static void countDoc(void* arg, const int docID, const int count)
+{
+  struct andCount* ac = arg;
+  if (count > 0 && counters_get(ac->other, docID) > 0) {
+    ac->n++;
+  }
+}
+
+// roaring_contains agrees with the expected docIDs, and their neighbors
+static int checkRoaring(roaring_t* set, const int* expect, const int n)
+{
+  int bad = 0;
+  for (int i = 0; i < n; i++) {
+    if (!roaring_contains(set, expect[i])) {
+      bad++;
+    }
+    int next = expect[i] + 1;
+    if ((i + 1 == n || expect[i + 1] != next) && roaring_contains(set, next)) {
+      bad++;
+    }
+  }
+  return bad;
+}
@@ -0,0 +1,134 @@
+/*
+ * startbench.c - compares the time to the first query with an index loaded
+ *   whole (index_load) and opened lazily (lazyindex_open)
+ *
+ * usage: ./startbench indexFilename cacheMB word [word...]
+ *
+ * Each way we time opening the index, then looking up the first word (the
+ *   time to the first query is the sum), then looking up all the words. The
+ *   lazy index goes first, so it is the one that finds the file out of the
+ *   page cache if it is not there already. Both must find the same docIDs
+ *   and counts for every word.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <sys/stat.h>
+#include "../common/index.h"
+#include "../common/lazyindex.h"
+#include "../common/postings.h"
+#include "../libcs50/counters.h"
+
+// function prototypes
+static double nowSeconds(void);
+static long fileSize(const char* filename);
+static bool samePostings(postings_t* a, postings_t* b);
+
+int main(int argc, char* argv[])
+{
+  if (argc < 4) {
+    fprintf(stderr, "Usage: %s indexFilename cacheMB word [word...]\n", argv[0]);
+    exit(1);
+  }
+  const char* indexFilename = argv[1];
+  size_t cacheBytes = (size_t)atol(argv[2]) << 20;
+  char** words = argv + 3;
+  int nwords = argc - 3;
+  printf("index size:        %ld bytes\n", fileSize(indexFilename));
+
+  // lazily: the lexicon now, each word when first asked for
+  double start = nowSeconds();
+  lazyindex_t* lazy = lazyindex_open(indexFilename, cacheBytes);
+  double lazyOpen = nowSeconds() - start;
+  if (lazy == NULL) {
+    fprintf(stderr, "cannot open index '%s'\n", indexFilename);
+    exit(2);
+  }
+  start = nowSeconds();
+  lazyindex_find(lazy, words[0]);
+  double lazyFirst = nowSeconds() - start;
+  start = nowSeconds();
+  for (int w = 0; w < nwords; w++) {
+    lazyindex_find(lazy, words[w]);
+  }
+  double lazyAll = nowSeconds() - start;
+
+  // the whole index up front
+  start = nowSeconds();
+  index_t* index = index_load(indexFilename);
+  double loadOpen = nowSeconds() - start;
+  if (index == NULL) {
+    fprintf(stderr, "cannot load index '%s'\n", indexFilename);
+    exit(2);
+  }
+  start = nowSeconds();
+  index_find(index, words[0]);
+  double loadFirst = nowSeconds() - start;
+  start = nowSeconds();
+  for (int w = 0; w < nwords; w++) {
+    index_find(index, words[w]);
+  }
+  double loadAll = nowSeconds() - start;
+
+  printf("index_load:        open %.3f ms, first query %.3f ms, "
+         "%d lookups %.3f ms\n", loadOpen * 1e3, (loadOpen + loadFirst) * 1e3,
+         nwords, loadAll * 1e3);
+  printf("lazyindex_open:    open %.3f ms, first query %.3f ms, "
+         "%d lookups %.3f ms\n", lazyOpen * 1e3, (lazyOpen + lazyFirst) * 1e3,
+         nwords, lazyAll * 1e3);
+  if (lazyOpen + lazyFirst > 0) {
+    printf("speedup to first:  %.1fx\n",
+           (loadOpen + loadFirst) / (lazyOpen + lazyFirst));
+  }
+  lazyindex_printStats(lazy, stdout);
+
+  // every word the same both ways
+  int mismatches = 0;
+  for (int w = 0; w < nwords; w++) {
+    postings_t* loaded = postings_fromCounters(index_find(index, words[w]));
+    if (!samePostings(loaded, lazyindex_find(lazy, words[w]))) {
+      fprintf(stderr, "MISMATCH on '%s'\n", words[w]);
+      mismatches++;
+    }
+    postings_delete(loaded);
+  }
+
+  index_delete(index);
+  lazyindex_delete(lazy);
+  return (mismatches == 0) ? 0 : 3;
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// size of a file, or -1 if it cannot be read
+static long fileSize(const char* filename)
+{
+  struct stat st;
+  return (stat(filename, &st) == 0) ? (long)st.st_size : -1;
+}
+
+// same docIDs with the same counts; NULL is the same as empty
+static bool samePostings(postings_t* a, postings_t* b)
+{
+  int n = postings_count(a);
+  if (postings_count(b) != n) {
+    return false;
+  }
+  return n == 0
+         || (memcmp(postings_docIDs(a), postings_docIDs(b), n * sizeof(int)) == 0
+             && memcmp(postings_counts(a), postings_counts(b),
+                       n * sizeof(int)) == 0);
+}
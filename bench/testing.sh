@@ -0,0 +1,26 @@
+#!/bin/bash
+# testing.sh - TSE benchmark checks
+#
+# The benchmarks themselves only measure; this runs the checks some of them
+#   make, without the timing:
+#
+# 1. isectbench --check: every intersection kernel the CPU has (merge,
+#    gallop, SSSE3, AVX2 and intersect's own choice) against a plain
+#    reference, on the edge cases and 20000 random pairs of arrays
+#
+# Any mismatch is printed and makes the script exit with status 3
+#
+# Usage:
+#   make test   (outputs to testing.out)
+#
+# Author: Jacob Bacus
+# October 2026
+
+status=0
+
+# 1. intersection kernels
+echo
+echo "-----INTERSECTION KERNELS-----"
+./isectbench --check || status=$?
+
+exit $status
@@ -0,0 +1,594 @@
+/*
+ * tsebench.c - the TSE benchmark suite, as JSON to compare across commits
+ *
+ * usage: ./tsebench [--label L] [--json file] [--rounds N] [--queries N]
+ *                   [--seed N] [--query-log file] [--indexer path]
+ *                   [--querier path] [--memory-mb N]
+ *                   pageDirectory workDirectory
+ *
+ * Measures, on the pages of pageDirectory (a crawl, or a synthetic corpus):
+ *   tokenizer  webpage_getNextWord and normalizeWord over every page, as
+ *              the indexer reads them: bytes and words per second, timed
+ *              per page as pagedir_scan loads them, so the corpus need not
+ *              fit in memory
+ *   build      the indexer (../indexer/indexer) run on pageDirectory, wall
+ *              time, writing workDirectory/tsebench.index; with --memory-mb
+ *              N the indexer is given it, to build by sorted runs (which
+ *              scales to many more pages than its counters do)
+ *   load       index_load of that index, and index_open (lazy), the best
+ *              of rounds (default 3)
+ *   query      the querier (../querier/querier) answering a query log with
+ *              --stats: latency percentiles (p50, p90, p99, nearest rank)
+ *              and the mean of each phase, from the querier's own timings
+ *
+ * The query log is workDirectory/tsebench.queries, unless --query-log names
+ *   one: --queries (default 1000) queries made from the index's words with
+ *   --seed (default 49), so the same corpus gives the same log. Half the
+ *   words are drawn by document frequency and half uniformly; a query is
+ *   one word, two joined by 'and' or 'or', three, or a prefix wildcard.
+ *
+ * The JSON goes to stdout, and to --json file as well; --label (default
+ *   "local") names the run, e.g. the commit. Exit status is 2 if a step
+ *   cannot be run.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _POSIX_C_SOURCE 200809L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include "../common/index.h"
+#include "../common/pagedir.h"
+#include "../common/word.h"
+#include "../common/roaring.h"
+#include "../common/intersect.h"
+#include "../libcs50/counters.h"
+#include "../libcs50/webpage.h"
+
+// the phases the querier's --stats file times, in its column order
+static const char* PHASES[] = { "parse", "lookup", "sets", "match", "score",
+                                "print" };
+#define NPHASES 6
+
+// what the user asked for
+typedef struct options {
+  const char* label;
+  const char* json;
+  int rounds;
+  int queries;
+  unsigned seed;
+  const char* queryLog;
+  const char* indexer;
+  const char* querier;
+  int memoryMB;         // for the indexer, or 0
+  const char* pageDir;
+  const char* workDir;
+} options_t;
+
+// every number the suite reports
+typedef struct results {
+  int pages;
+  long bytes;           // of HTML
+  long words;           // tokens the tokenizer gave, short ones too
+  double tokenizeSeconds;
+  double buildSeconds;
+  long indexBytes;
+  int vocabulary;
+  double loadSeconds;
+  double openSeconds;
+  int queries;
+  double queryWallSeconds;
+  long p50, p90, p99, max, mean;
+  long phaseMean[NPHASES];
+} results_t;
+
+// a word of the index and its document frequency
+typedef struct vocab {
+  char** words;
+  int* df;
+  int n;
+  int cap;
+} vocab_t;
+
+// function prototypes
+static void parseArgs(int argc, char* argv[], options_t* options);
+static double nowSeconds(void);
+static void tokenizePage(void* arg, webpage_t* page, const int docID);
+static bool runProgram(const char* program, char* const args[],
+                       const char* input, double* seconds);
+static void addWord(void* arg, const char* word, counters_t* ctrs);
+static void countDoc(void* arg, const int docID, const int count);
+static int compareWords(const void* a, const void* b);
+static bool writeQueries(const char* filename, vocab_t* vocab, const int n,
+                         const unsigned seed);
+static const char* pickWord(vocab_t* vocab, const long* cumulative);
+static bool readStats(const char* filename, results_t* results);
+static int compareLong(const void* a, const void* b);
+static void printJson(FILE* fp, options_t* options, results_t* results);
+static void printString(FILE* fp, const char* str);
+
+int main(int argc, char* argv[])
+{
+  options_t options;
+  parseArgs(argc, argv, &options);
+  results_t results;
+  memset(&results, 0, sizeof(results));
+  char indexFile[1024];
+  char queryFile[1024];
+  char statsFile[1024];
+  snprintf(indexFile, sizeof(indexFile), "%s/tsebench.index", options.workDir);
+  snprintf(queryFile, sizeof(queryFile), "%s/tsebench.queries", options.workDir);
+  snprintf(statsFile, sizeof(statsFile), "%s/tsebench.stats", options.workDir);
+
+  // tokenizer
+  fprintf(stderr, "tokenizer: %s\n", options.pageDir);
+  results.pages = pagedir_scan(options.pageDir, &results, tokenizePage);
+  pagedir_close();
+  if (results.pages == 0) {
+    fprintf(stderr, "no pages in '%s'\n", options.pageDir);
+    exit(2);
+  }
+
+  // build, with the indexer itself
+  fprintf(stderr, "build: %s\n", options.indexer);
+  char* buildArgs[] = { (char*)options.indexer, (char*)options.pageDir,
+                        indexFile, NULL, NULL, NULL };
+  char memoryMB[16];
+  if (options.memoryMB > 0) {
+    snprintf(memoryMB, sizeof(memoryMB), "%d", options.memoryMB);
+    buildArgs[1] = "--memory-mb";
+    buildArgs[2] = memoryMB;
+    buildArgs[3] = (char*)options.pageDir;
+    buildArgs[4] = indexFile;
+  }
+  struct stat st;
+  if (!runProgram(options.indexer, buildArgs, NULL, &results.buildSeconds)
+      || stat(indexFile, &st) != 0) {
+    fprintf(stderr, "cannot build '%s' with %s\n", indexFile, options.indexer);
+    exit(2);
+  }
+  results.indexBytes = st.st_size;
+
+  // load, whole and lazily; the last whole one is kept for its words
+  fprintf(stderr, "load: %s\n", indexFile);
+  index_t* idx = NULL;
+  for (int r = 0; r < options.rounds; r++) {
+    index_delete(idx);
+    double start = nowSeconds();
+    idx = index_load(indexFile);
+    double seconds = nowSeconds() - start;
+    if (idx == NULL) {
+      fprintf(stderr, "cannot load '%s'\n", indexFile);
+      exit(2);
+    }
+    if (r == 0 || seconds < results.loadSeconds) {
+      results.loadSeconds = seconds;
+    }
+    start = nowSeconds();
+    index_t* lazy = index_open(indexFile, 64 << 20);
+    seconds = nowSeconds() - start;
+    index_delete(lazy);
+    if (r == 0 || seconds < results.openSeconds) {
+      results.openSeconds = seconds;
+    }
+  }
+
+  // the query log
+  vocab_t vocab = { NULL, NULL, 0, 0 };
+  index_iterate(idx, &vocab, addWord);
+  results.vocabulary = vocab.n;
+  const char* log = options.queryLog;
+  if (log == NULL) {
+    log = queryFile;
+    if (!writeQueries(queryFile, &vocab, options.queries, options.seed)) {
+      fprintf(stderr, "cannot write '%s'\n", queryFile);
+      exit(2);
+    }
+  }
+  for (int i = 0; i < vocab.n; i++) {
+    free(vocab.words[i]);
+  }
+  free(vocab.words);
+  free(vocab.df);
+  index_delete(idx);
+
+  // queries, timed by the querier
+  fprintf(stderr, "query: %s\n", log);
+  char* queryArgs[] = { (char*)options.querier, "--stats", statsFile,
+                        (char*)options.pageDir, indexFile, NULL };
+  if (!runProgram(options.querier, queryArgs, log, &results.queryWallSeconds)
+      || !readStats(statsFile, &results)) {
+    fprintf(stderr, "cannot run queries with %s\n", options.querier);
+    exit(2);
+  }
+
+  printJson(stdout, &options, &results);
+  if (options.json != NULL) {
+    FILE* fp = fopen(options.json, "w");
+    if (fp == NULL) {
+      fprintf(stderr, "cannot write '%s'\n", options.json);
+      exit(2);
+    }
+    printJson(fp, &options, &results);
+    fclose(fp);
+  }
+  return 0;
+}
+
+// the options, then pageDirectory and workDirectory
+static void parseArgs(int argc, char* argv[], options_t* options)
+{
+  options->label = "local";
+  options->json = NULL;
+  options->rounds = 3;
+  options->queries = 1000;
+  options->seed = 49;
+  options->queryLog = NULL;
+  options->indexer = "../indexer/indexer";
+  options->querier = "../querier/querier";
+  options->memoryMB = 0;
+  int arg = 1;
+  while (arg + 1 < argc && strncmp(argv[arg], "--", 2) == 0) {
+    const char* value = argv[arg + 1];
+    if (strcmp(argv[arg], "--label") == 0) {
+      options->label = value;
+    } else if (strcmp(argv[arg], "--json") == 0) {
+      options->json = value;
+    } else if (strcmp(argv[arg], "--rounds") == 0) {
+      options->rounds = atoi(value);
+    } else if (strcmp(argv[arg], "--queries") == 0) {
+      options->queries = atoi(value);
+    } else if (strcmp(argv[arg], "--seed") == 0) {
+      options->seed = strtoul(value, NULL, 10);
+    } else if (strcmp(argv[arg], "--query-log") == 0) {
+      options->queryLog = value;
+    } else if (strcmp(argv[arg], "--indexer") == 0) {
+      options->indexer = value;
+    } else if (strcmp(argv[arg], "--querier") == 0) {
+      options->querier = value;
+    } else if (strcmp(argv[arg], "--memory-mb") == 0) {
+      options->memoryMB = atoi(value);
+    } else {
+      break; // unknown, so the usage below
+    }
+    arg += 2;
+  }
+  if (argc - arg != 2 || options->rounds <= 0 || options->queries <= 0
+      || options->memoryMB < 0) {
+    fprintf(stderr, "Usage: %s [--label L] [--json file] [--rounds N] "
+            "[--queries N] [--seed N] [--query-log file] [--indexer path] "
+            "[--querier path] [--memory-mb N] pageDirectory workDirectory\n", argv[0]);
+    exit(1);
+  }
+  options->pageDir = argv[arg];
+  options->workDir = argv[arg + 1];
+  mkdir(options->workDir, 0755); // it may be there already
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// pagedir_scan helper: tokenize a page as the indexer does, timing it alone
+static void tokenizePage(void* arg, webpage_t* page, const int docID)
+{
+  results_t* results = arg;
+  char* html = webpage_getHTML(page);
+  results->bytes += (html == NULL) ? 0 : strlen(html);
+  double start = nowSeconds();
+  int pos = 0;
+  char* word;
+  while ((word = webpage_getNextWord(page, &pos)) != NULL) {
+    normalizeWord(word);
+    results->words++;
+    free(word);
+  }
+  results->tokenizeSeconds += nowSeconds() - start;
+}
+
+/*
+ * Runs program with args, stdin from input (or /dev/null) and stdout to
+ *   /dev/null, and waits for it; *seconds is its wall time
+ * Returns false if it cannot be run or does not exit 0
+ */
+static bool runProgram(const char* program, char* const args[],
+                       const char* input, double* seconds)
+{
+  fflush(NULL);
+  double start = nowSeconds();
+  pid_t pid = fork();
+  if (pid < 0) {
+    return false;
+  }
+  if (pid == 0) {
+    int in = open((input == NULL) ? "/dev/null" : input, O_RDONLY);
+    int out = open("/dev/null", O_WRONLY);
+    if (in < 0 || out < 0 || dup2(in, 0) < 0 || dup2(out, 1) < 0) {
+      _exit(127);
+    }
+    execv(program, args);
+    _exit(127);
+  }
+  int status;
+  if (waitpid(pid, &status, 0) != pid) {
+    return false;
+  }
+  *seconds = nowSeconds() - start;
+  return WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+// index_iterate helper: keep a word and its document frequency
+static void addWord(void* arg, const char* word, counters_t* ctrs)
+{
+  vocab_t* vocab = arg;
+  if (vocab->n == vocab->cap) {
+    int cap = (vocab->cap == 0) ? 1024 : 2 * vocab->cap;
+    char** words = realloc(vocab->words, cap * sizeof(char*));
+    if (words != NULL) {
+      vocab->words = words;
+    }
+    int* df = realloc(vocab->df, cap * sizeof(int));
+    if (df != NULL) {
+      vocab->df = df;
+    }
+    if (words == NULL || df == NULL) {
+      return; // the log is made from fewer words
+    }
+    vocab->cap = cap;
+  }
+  int df = 0;
+  counters_iterate(ctrs, &df, countDoc);
+  char* copy = malloc(strlen(word) + 1);
+  if (copy == NULL) {
+    return;
+  }
+  strcpy(copy, word);
+  vocab->words[vocab->n] = copy;
+  vocab->df[vocab->n] = df;
+  vocab->n++;
+}
+
+// counters_iterate helper: count a doc
+static void countDoc(void* arg, const int docID, const int count)
+{
+  if (count > 0) {
+    (*(int*)arg)++;
+  }
+}
+
+// qsort comparison of two words with their df, by word
+static int compareWords(const void* a, const void* b)
+{
+  return strcmp(((const char* const*)a)[0], ((const char* const*)b)[0]);
+}
+
+/*
+ * Writes n queries made from the vocabulary's words, the same for the same
+ *   words and seed: the words are sorted first, as index_iterate gives
+ *   them in no particular order
+ * Returns false if the file cannot be written or there are no words
+ */
+static bool writeQueries(const char* filename, vocab_t* vocab, const int n,
+                         const unsigned seed)
+{
+  if (vocab->n == 0) {
+    return false;
+  }
+  // sort (word, df) pairs together
+  struct { char* word; int df; } *pairs = malloc(vocab->n * sizeof(*pairs));
+  long* cumulative = malloc(vocab->n * sizeof(long));
+  if (pairs == NULL || cumulative == NULL) {
+    free(pairs);
+    free(cumulative);
+    return false;
+  }
+  for (int i = 0; i < vocab->n; i++) {
+    pairs[i].word = vocab->words[i];
+    pairs[i].df = vocab->df[i];
+  }
+  qsort(pairs, vocab->n, sizeof(*pairs), compareWords);
+  long total = 0;
+  for (int i = 0; i < vocab->n; i++) {
+    vocab->words[i] = pairs[i].word;
+    vocab->df[i] = pairs[i].df;
+    total += pairs[i].df;
+    cumulative[i] = total;
+  }
+  free(pairs);
+
+  FILE* fp = fopen(filename, "w");
+  if (fp == NULL) {
+    free(cumulative);
+    return false;
+  }
+  srand(seed);
+  for (int q = 0; q < n; q++) {
+    int shape = rand() % 100;
+    const char* a = pickWord(vocab, cumulative);
+    const char* b = pickWord(vocab, cumulative);
+    const char* c = pickWord(vocab, cumulative);
+    if (shape < 40) {
+      fprintf(fp, "%s\n", a);
+    } else if (shape < 70) {
+      fprintf(fp, "%s and %s\n", a, b);
+    } else if (shape < 85) {
+      fprintf(fp, "%s or %s\n", a, b);
+    } else if (shape < 95) {
+      fprintf(fp, "%s %s or %s\n", a, b, c);
+    } else {
+      fprintf(fp, "%.3s*\n", a);
+    }
+  }
+  fclose(fp);
+  free(cumulative);
+  return true;
+}
+
+// a word, drawn by document frequency or uniformly, as a coin says
+static const char* pickWord(vocab_t* vocab, const long* cumulative)
+{
+  if (rand() % 2 == 0) {
+    return vocab->words[rand() % vocab->n];
+  }
+  long total = cumulative[vocab->n - 1];
+  long r = (((long)rand() << 31) | rand()) % total;
+  int lo = 0;
+  int hi = vocab->n - 1;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (cumulative[mid] <= r) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return vocab->words[lo];
+}
+
+/*
+ * Reads the querier's --stats file: a tab-separated line per query whose
+ *   last NPHASES + 1 columns are the phases' times and their total
+ * Returns false if it cannot be read or holds no queries
+ */
+static bool readStats(const char* filename, results_t* results)
+{
+  FILE* fp = fopen(filename, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  int cap = 1024;
+  long* totals = malloc(cap * sizeof(long));
+  long sums[NPHASES + 1] = { 0 };
+  int n = 0;
+  char line[4096];
+  while (totals != NULL && fgets(line, sizeof(line), fp) != NULL) {
+    if (line[0] == '#' || strncmp(line, "query\t", 6) == 0) {
+      continue;
+    }
+    // the numbers, from the last column back
+    long values[NPHASES + 1];
+    char* end = line + strlen(line);
+    int got = 0;
+    while (got < NPHASES + 1) {
+      char* tab = end - 1;
+      while (tab > line && *tab != '\t') {
+        tab--;
+      }
+      if (tab <= line) {
+        break;
+      }
+      values[NPHASES - got] = atol(tab + 1);
+      *tab = '\0';
+      end = tab;
+      got++;
+    }
+    if (got < NPHASES + 1) {
+      continue; // not a query's line
+    }
+    if (n == cap) {
+      cap *= 2;
+      long* grown = realloc(totals, cap * sizeof(long));
+      if (grown == NULL) {
+        break;
+      }
+      totals = grown;
+    }
+    totals[n++] = values[NPHASES];
+    for (int p = 0; p <= NPHASES; p++) {
+      sums[p] += values[p];
+    }
+  }
+  fclose(fp);
+  if (totals == NULL || n == 0) {
+    free(totals);
+    return false;
+  }
+  qsort(totals, n, sizeof(long), compareLong);
+  results->queries = n;
+  results->p50 = totals[(50 * n + 99) / 100 - 1];
+  results->p90 = totals[(90 * n + 99) / 100 - 1];
+  results->p99 = totals[(99 * n + 99) / 100 - 1];
+  results->max = totals[n - 1];
+  results->mean = sums[NPHASES] / n;
+  for (int p = 0; p < NPHASES; p++) {
+    results->phaseMean[p] = sums[p] / n;
+  }
+  free(totals);
+  return true;
+}
+
+// qsort comparison of two longs
+static int compareLong(const void* a, const void* b)
+{
+  long x = *(const long*)a;
+  long y = *(const long*)b;
+  return (x > y) - (x < y);
+}
+
+// the results as one JSON object
+static void printJson(FILE* fp, options_t* options, results_t* results)
+{
+  fprintf(fp, "{\n  \"label\": ");
+  printString(fp, options->label);
+  fprintf(fp, ",\n  \"kernels\": { \"roaring\": ");
+  printString(fp, roaring_kernel());
+  fprintf(fp, ", \"intersect\": ");
+  printString(fp, intersect_kernel());
+  fprintf(fp, " },\n  \"corpus\": { \"pageDirectory\": ");
+  printString(fp, options->pageDir);
+  fprintf(fp, ", \"pages\": %d, \"bytes\": %ld },\n", results->pages,
+          results->bytes);
+  double seconds = results->tokenizeSeconds;
+  fprintf(fp, "  \"tokenizer\": { \"words\": %ld, \"seconds\": %.6f, "
+          "\"bytes_per_sec\": %.0f, \"words_per_sec\": %.0f },\n",
+          results->words, seconds,
+          (seconds > 0) ? results->bytes / seconds : 0.0,
+          (seconds > 0) ? results->words / seconds : 0.0);
+  fprintf(fp, "  \"build\": { \"seconds\": %.6f, \"index_bytes\": %ld, "
+          "\"words\": %d, \"memory_mb\": %d },\n", results->buildSeconds,
+          results->indexBytes, results->vocabulary, options->memoryMB);
+  fprintf(fp, "  \"load\": { \"rounds\": %d, \"load_seconds\": %.6f, "
+          "\"lazy_open_seconds\": %.6f },\n", options->rounds,
+          results->loadSeconds, results->openSeconds);
+  fprintf(fp, "  \"query\": { \"log\": ");
+  printString(fp, (options->queryLog != NULL) ? options->queryLog : "generated");
+  fprintf(fp, ", \"seed\": %u, \"queries\": %d, \"wall_seconds\": %.6f,\n"
+          "    \"p50_ns\": %ld, \"p90_ns\": %ld, \"p99_ns\": %ld, "
+          "\"max_ns\": %ld, \"mean_ns\": %ld,\n    \"phase_mean_ns\": {",
+          options->seed, results->queries, results->queryWallSeconds,
+          results->p50, results->p90, results->p99, results->max,
+          results->mean);
+  for (int p = 0; p < NPHASES; p++) {
+    fprintf(fp, "%s \"%s\": %ld", (p > 0) ? "," : "", PHASES[p],
+            results->phaseMean[p]);
+  }
+  fprintf(fp, " } }\n}\n");
+}
+
+// a JSON string, with quotes, backslashes and control characters escaped
+static void printString(FILE* fp, const char* str)
+{
+  fputc('"', fp);
+  for (const char* c = str; *c != '\0'; c++) {
+    if (*c == '"' || *c == '\\') {
+      fprintf(fp, "\\%c", *c);
+    } else if ((unsigned char)*c < 0x20) {
+      fprintf(fp, "\\u%04x", *c);
+    } else {
+      fputc(*c, fp);
+    }
+  }
+  fputc('"', fp);
+}
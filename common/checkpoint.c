@@ -0,0 +1,205 @@
+/* checkpoint.c - CS50 TSE crawl checkpoints
+ *
+ * A lines are written through stdio as URLs are found; a C line is written
+ *   every few pages, then the log is flushed and fsync'ed, so everything up to
+ *   a C line on disk is consistent. On resume, the log is cut back to the end
+ *   of its last complete C line before new lines are appended.
+ *
+ * Full and extensive documentation is in checkpoint.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <time.h>
+#include <unistd.h>
+#include "checkpoint.h"
+
+// defines a checkpoint log
+typedef struct checkpoint {
+  FILE* fp;
+  int every;            // pages between checkpoints
+  int sinceLast;        // pages done since the last checkpoint
+  int pagesDone;        // queued URLs dealt with
+  int nextDocID;
+  int checkpoints;      // C lines written
+  double seconds;       // time spent on the log
+  double opened;        // clock at checkpoint_open
+} checkpoint_t;
+
+// function prototypes
+static double nowSeconds(void);
+static bool writeCheckpoint(checkpoint_t* cp);
+
+// open the log, emptying it unless resuming
+checkpoint_t* checkpoint_open(const char* pageDirectory, const bool resume,
+                              const int every)
+{
+  if (pageDirectory == NULL || every < 1) {
+    return NULL;
+  }
+
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.checkpoint", pageDirectory);
+
+  // "a+" keeps the old log for replay; "w+" starts a new one
+  FILE* fp = fopen(filename, resume ? "a+" : "w+");
+  if (fp == NULL) {
+    fprintf(stderr, "checkpoint: cannot open '%s'\n", filename);
+    return NULL;
+  }
+
+  checkpoint_t* cp = calloc(1, sizeof(checkpoint_t));
+  if (cp == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+  cp->fp = fp;
+  cp->every = every;
+  cp->nextDocID = 1;
+  cp->opened = nowSeconds();
+  return cp;
+}
+
+// read back the log up to its last checkpoint
+bool checkpoint_replay(checkpoint_t* cp, void* arg,
+                       void (*itemfunc)(void* arg, const char* url,
+                                        const int depth, const bool visited),
+                       int* pagesDone, int* nextDocID)
+{
+  if (cp == NULL || itemfunc == NULL || pagesDone == NULL || nextDocID == NULL) {
+    return false;
+  }
+  double start = nowSeconds();
+
+  // first pass: find the end of the last complete C line
+  long goodEnd = 0;
+  int done = 0;
+  int docID = 1;
+  bool found = false;
+  char* line = NULL;
+  size_t lineSize = 0;
+  ssize_t len;
+  rewind(cp->fp);
+  while ((len = getline(&line, &lineSize, cp->fp)) > 0) {
+    int d, id;
+    if (line[len - 1] == '\n' && sscanf(line, "C %d %d", &d, &id) == 2) {
+      done = d;
+      docID = id;
+      goodEnd = ftell(cp->fp);
+      found = true;
+    }
+  }
+
+  // second pass: hand back every queued URL before that point
+  if (found) {
+    rewind(cp->fp);
+    int queued = 0;
+    while (ftell(cp->fp) < goodEnd
+           && (len = getline(&line, &lineSize, cp->fp)) > 0) {
+      int depth, urlStart;
+      line[len - 1] = '\0';
+      if (sscanf(line, "A %d %n", &depth, &urlStart) == 1) {
+        (*itemfunc)(arg, line + urlStart, depth, queued < done);
+        queued++;
+      }
+    }
+  }
+  free(line);
+
+  // drop anything after the checkpoint; appends continue from there
+  fflush(cp->fp);
+  if (ftruncate(fileno(cp->fp), goodEnd) != 0) {
+    fprintf(stderr, "checkpoint: cannot truncate log\n");
+  }
+  fseek(cp->fp, 0, SEEK_END);
+
+  cp->pagesDone = done;
+  cp->nextDocID = docID;
+  cp->seconds += nowSeconds() - start;
+  *pagesDone = done;
+  *nextDocID = docID;
+  return found;
+}
+
+// log a newly queued url
+bool checkpoint_added(checkpoint_t* cp, const char* url, const int depth)
+{
+  if (cp == NULL || url == NULL) {
+    return false;
+  }
+  double start = nowSeconds();
+  bool ok = fprintf(cp->fp, "A %d %s\n", depth, url) > 0;
+  cp->seconds += nowSeconds() - start;
+  return ok;
+}
+
+// one more page done; checkpoint every so often
+bool checkpoint_pageDone(checkpoint_t* cp, const int nextDocID)
+{
+  if (cp == NULL) {
+    return false;
+  }
+  cp->pagesDone++;
+  cp->nextDocID = nextDocID;
+  if (++cp->sinceLast < cp->every) {
+    return true;
+  }
+  return writeCheckpoint(cp);
+}
+
+// report how much the log cost
+void checkpoint_printStats(checkpoint_t* cp, FILE* fp)
+{
+  if (cp == NULL || fp == NULL) {
+    return;
+  }
+  double crawlSeconds = nowSeconds() - cp->opened;
+  fprintf(fp, "checkpoint: %d checkpoints, %.3f ms of %.3f s crawl (%.3f%%)\n",
+          cp->checkpoints, cp->seconds * 1e3, crawlSeconds,
+          crawlSeconds > 0 ? 100.0 * cp->seconds / crawlSeconds : 0.0);
+}
+
+// last checkpoint, then close
+void checkpoint_close(checkpoint_t* cp)
+{
+  if (cp == NULL) {
+    return;
+  }
+  if (cp->sinceLast > 0) {
+    writeCheckpoint(cp);
+  }
+  fclose(cp->fp);
+  free(cp);
+}
+
+/**************** helpers ****************/
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// write a C line and push the whole log to disk
+static bool writeCheckpoint(checkpoint_t* cp)
+{
+  double start = nowSeconds();
+  bool ok = fprintf(cp->fp, "C %d %d\n", cp->pagesDone, cp->nextDocID) > 0
+            && fflush(cp->fp) == 0
+            && fsync(fileno(cp->fp)) == 0;
+  if (!ok) {
+    fprintf(stderr, "checkpoint: cannot write log\n");
+  }
+  cp->sinceLast = 0;
+  cp->checkpoints++;
+  cp->seconds += nowSeconds() - start;
+  return ok;
+}
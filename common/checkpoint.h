@@ -0,0 +1,80 @@
+/* checkpoint.h - header file for CS50 TSE crawl checkpoints
+ *
+ * The crawler keeps an append-only log, pageDirectory/.checkpoint, from which
+ *   an interrupted crawl can be resumed. The log holds two kinds of lines:
+ *
+ *   A depth url         url was seen for the first time and queued at depth
+ *   C pagesDone docID   checkpoint: the first pagesDone queued URLs have been
+ *                       visited and the next page will be saved as docID
+ *
+ * The frontier is first-in first-out, so URLs are visited in the order they
+ *   were queued; the seen set is every A line, and the frontier is the A lines
+ *   after the first pagesDone. Anything after the last C line is discarded on
+ *   resume, and the pages it covered are fetched again.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __CHECKPOINT_H
+#define __CHECKPOINT_H
+
+#include <stdio.h>
+#include <stdbool.h>
+
+// opaque checkpoint log
+typedef struct checkpoint checkpoint_t;
+
+/*
+ * Opens the log in pageDirectory, committing to disk every `every` pages (>= 1).
+ *
+ * With resume false any old log is emptied. With resume true the log is
+ *   kept, and must then be read back with checkpoint_replay before new lines
+ *   are added.
+ *
+ * We return a pointer to the log, or NULL if it cannot be opened.
+ */
+checkpoint_t* checkpoint_open(const char* pageDirectory, const bool resume,
+                              const int every);
+
+/*
+ * Reads the log up to its last checkpoint, calling itemfunc(arg, url, depth,
+ *   visited) once for each queued URL in order; visited is true for URLs whose
+ *   pages were already dealt with. Lines after the last checkpoint are cut off.
+ *
+ * We return true and set *pagesDone and *nextDocID if a checkpoint was found,
+ *   or false (with nothing called) if the crawl has to start over.
+ */
+bool checkpoint_replay(checkpoint_t* cp, void* arg,
+                       void (*itemfunc)(void* arg, const char* url,
+                                        const int depth, const bool visited),
+                       int* pagesDone, int* nextDocID);
+
+/*
+ * Records that url was seen for the first time and queued at depth.
+ *
+ * We return false if the log could not be written.
+ */
+bool checkpoint_added(checkpoint_t* cp, const char* url, const int depth);
+
+/*
+ * Records that one more queued URL has been dealt with, and that the next
+ *   page will be saved as nextDocID. Every `every` calls (see checkpoint_open)
+ *   a checkpoint line is written and the log is flushed to disk.
+ *
+ * We return false if the log could not be written.
+ */
+bool checkpoint_pageDone(checkpoint_t* cp, const int nextDocID);
+
+/*
+ * Prints the number of checkpoints and the time spent on the log, as a
+ *   fraction of the time since checkpoint_open (the crawl time).
+ */
+void checkpoint_printStats(checkpoint_t* cp, FILE* fp);
+
+/*
+ * Writes a final checkpoint, closes the log and frees its memory
+ */
+void checkpoint_close(checkpoint_t* cp);
+
+#endif // __CHECKPOINT_H
@@ -0,0 +1,329 @@
+/* codec.c - CS50 TSE page compression
+ *
+ * LZ4 blocks are made of sequences: a token byte (literal count in the high
+ *   nibble, match length - 4 in the low), extra length bytes when a nibble
+ *   is 15, the literals, and a 2-byte offset back to the match. The last
+ *   sequence has literals only. The compressor finds matches through a hash
+ *   table of 4-byte strings, moving on faster the longer it goes without one.
+ *
+ * Full and extensive documentation is in codec.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <zlib.h>
+#include "codec.h"
+
+static const unsigned char MAGIC[4] = { 0x89, 'T', 'S', 'Z' };
+
+// LZ4 block format limits
+static const size_t MIN_MATCH = 4;
+static const size_t LAST_LITERALS = 5;   // the block ends with this many literals
+static const size_t MATCH_LIMIT = 12;    // no match starts this close to the end
+static const size_t MAX_OFFSET = 65535;
+
+// hash table entries, 2^HASH_BITS
+#define HASH_BITS 14
+
+// function prototypes
+static size_t lz4Bound(const size_t len);
+static size_t lz4Compress(const unsigned char* src, const size_t len,
+                          unsigned char* dst);
+static bool lz4Decompress(const unsigned char* src, const size_t len,
+                          unsigned char* dst, const size_t rawLen);
+static unsigned char* putLength(unsigned char* op, size_t len);
+static uint32_t read32(const unsigned char* p);
+
+// codec from its name
+bool codec_parse(const char* name, codec_t* codec, int* level)
+{
+  if (name == NULL || codec == NULL || level == NULL) {
+    return false;
+  }
+  if (strcmp(name, "none") == 0) {
+    *codec = CODEC_NONE;
+    *level = 0;
+  } else if (strcmp(name, "lz4") == 0) {
+    *codec = CODEC_LZ4;
+    *level = 0;
+  } else if (strcmp(name, "zlib") == 0) {
+    *codec = CODEC_ZLIB;
+    *level = 6;
+  } else if (strncmp(name, "zlib:", 5) == 0 && name[5] >= '1' && name[5] <= '9'
+             && name[6] == '\0') {
+    *codec = CODEC_ZLIB;
+    *level = name[5] - '0';
+  } else {
+    return false;
+  }
+  return true;
+}
+
+// name of a codec
+const char* codec_name(const codec_t codec)
+{
+  switch (codec) {
+  case CODEC_LZ4:
+    return "lz4";
+  case CODEC_ZLIB:
+    return "zlib";
+  default:
+    return "none";
+  }
+}
+
+// frame and compress, or NULL if not worth it
+char* codec_compress(const codec_t codec, const int level,
+                     const char* data, const size_t len, size_t* outLen)
+{
+  if (data == NULL || outLen == NULL || len > UINT32_MAX
+      || (codec != CODEC_LZ4 && codec != CODEC_ZLIB)) {
+    return NULL;
+  }
+
+  size_t bound = (codec == CODEC_LZ4) ? lz4Bound(len) : compressBound(len);
+  unsigned char* out = malloc(CODEC_HEADER + bound);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  size_t packed;
+  if (codec == CODEC_LZ4) {
+    packed = lz4Compress((const unsigned char*)data, len, out + CODEC_HEADER);
+  } else {
+    uLongf destLen = bound;
+    if (compress2(out + CODEC_HEADER, &destLen, (const Bytef*)data, len,
+                  level) != Z_OK) {
+      free(out);
+      return NULL;
+    }
+    packed = destLen;
+  }
+
+  // only keep it if it saves something
+  if (CODEC_HEADER + packed >= len) {
+    free(out);
+    return NULL;
+  }
+
+  memcpy(out, MAGIC, sizeof(MAGIC));
+  out[4] = (unsigned char)codec;
+  for (int i = 0; i < 4; i++) {
+    out[5 + i] = (len >> (8 * i)) & 0xff;
+  }
+  *outLen = CODEC_HEADER + packed;
+  return (char*)out;
+}
+
+// framed?
+bool codec_isCompressed(const char* data, const size_t len)
+{
+  return data != NULL && len >= CODEC_HEADER
+         && memcmp(data, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+// unframe and decompress
+char* codec_decompress(const char* data, const size_t len, size_t* outLen)
+{
+  if (!codec_isCompressed(data, len) || outLen == NULL) {
+    return NULL;
+  }
+
+  const unsigned char* in = (const unsigned char*)data;
+  codec_t codec = in[4];
+  size_t rawLen = (size_t)in[5] | (size_t)in[6] << 8 | (size_t)in[7] << 16
+                  | (size_t)in[8] << 24;
+  unsigned char* out = malloc(rawLen + 1);
+  if (out == NULL) {
+    return NULL;
+  }
+
+  bool ok = false;
+  if (codec == CODEC_LZ4) {
+    ok = lz4Decompress(in + CODEC_HEADER, len - CODEC_HEADER, out, rawLen);
+  } else if (codec == CODEC_ZLIB) {
+    uLongf destLen = rawLen;
+    ok = uncompress(out, &destLen, in + CODEC_HEADER, len - CODEC_HEADER) == Z_OK
+         && destLen == rawLen;
+  }
+  if (!ok) {
+    free(out);
+    return NULL;
+  }
+  out[rawLen] = '\0';
+  *outLen = rawLen;
+  return (char*)out;
+}
+
+/**************** LZ4 ****************/
+
+// most bytes an LZ4 block of len bytes can take
+static size_t lz4Bound(const size_t len)
+{
+  return len + len / 255 + 16;
+}
+
+// compress src into dst (at least lz4Bound bytes); we return the block length
+static size_t lz4Compress(const unsigned char* src, const size_t len,
+                          unsigned char* dst)
+{
+  // last position + 1 at which each hashed 4-byte string was seen, 0 = never
+  uint32_t* table = calloc(1 << HASH_BITS, sizeof(uint32_t));
+  unsigned char* op = dst;
+  size_t anchor = 0; // first literal not yet written
+
+  if (table != NULL && len > MATCH_LIMIT) {
+    size_t limit = len - MATCH_LIMIT;
+    size_t i = 0;
+    size_t misses = 0;
+    while (i < limit) {
+      uint32_t seq = read32(src + i);
+      uint32_t h = (seq * 2654435761U) >> (32 - HASH_BITS);
+      size_t ref = table[h];
+      table[h] = i + 1;
+
+      if (ref == 0 || i - (ref - 1) > MAX_OFFSET || read32(src + ref - 1) != seq) {
+        i += 1 + (misses++ >> 5); // skip ahead through incompressible data
+        continue;
+      }
+      ref--;
+      misses = 0;
+
+      // extend the match, stopping short of the final literals
+      size_t matchLen = MIN_MATCH;
+      while (i + matchLen < len - LAST_LITERALS && src[ref + matchLen] == src[i + matchLen]) {
+        matchLen++;
+      }
+
+      // token, literals, offset, match length
+      size_t literals = i - anchor;
+      size_t extra = matchLen - MIN_MATCH;
+      unsigned char* token = op++;
+      *token = (unsigned char)(((literals < 15 ? literals : 15) << 4)
+                               | (extra < 15 ? extra : 15));
+      if (literals >= 15) {
+        op = putLength(op, literals - 15);
+      }
+      memcpy(op, src + anchor, literals);
+      op += literals;
+      size_t offset = i - ref;
+      *op++ = offset & 0xff;
+      *op++ = offset >> 8;
+      if (extra >= 15) {
+        op = putLength(op, extra - 15);
+      }
+
+      i += matchLen;
+      anchor = i;
+    }
+  }
+  free(table);
+
+  // the rest is literals
+  size_t literals = len - anchor;
+  *op++ = (unsigned char)((literals < 15 ? literals : 15) << 4);
+  if (literals >= 15) {
+    op = putLength(op, literals - 15);
+  }
+  memcpy(op, src + anchor, literals);
+  op += literals;
+  return op - dst;
+}
+
+// decompress a block into exactly rawLen bytes at dst; false if malformed
+static bool lz4Decompress(const unsigned char* src, const size_t len,
+                          unsigned char* dst, const size_t rawLen)
+{
+  const unsigned char* ip = src;
+  const unsigned char* end = src + len;
+  unsigned char* op = dst;
+  unsigned char* opEnd = dst + rawLen;
+
+  while (ip < end) {
+    unsigned char token = *ip++;
+
+    // literals
+    size_t literals = token >> 4;
+    if (literals == 15) {
+      unsigned char b;
+      do {
+        if (ip >= end) {
+          return false;
+        }
+        b = *ip++;
+        literals += b;
+      } while (b == 255);
+    }
+    if ((size_t)(end - ip) < literals || (size_t)(opEnd - op) < literals) {
+      return false;
+    }
+    memcpy(op, ip, literals);
+    ip += literals;
+    op += literals;
+    if (ip == end) {
+      break; // the last sequence has no match
+    }
+
+    // match
+    if (end - ip < 2) {
+      return false;
+    }
+    size_t offset = ip[0] | (size_t)ip[1] << 8;
+    ip += 2;
+    if (offset == 0 || offset > (size_t)(op - dst)) {
+      return false;
+    }
+    size_t matchLen = token & 15;
+    if (matchLen == 15) {
+      unsigned char b;
+      do {
+        if (ip >= end) {
+          return false;
+        }
+        b = *ip++;
+        matchLen += b;
+      } while (b == 255);
+    }
+    matchLen += MIN_MATCH;
+    if ((size_t)(opEnd - op) < matchLen) {
+      return false;
+    }
+
+    // byte by byte: the match may overlap what it is copying
+    const unsigned char* match = op - offset;
+    if (offset >= matchLen) {
+      memcpy(op, match, matchLen);
+      op += matchLen;
+    } else {
+      for (size_t k = 0; k < matchLen; k++) {
+        *op++ = *match++;
+      }
+    }
+  }
+  return op == opEnd;
+}
+
+// LZ4 extra length bytes: 255s then the remainder
+static unsigned char* putLength(unsigned char* op, size_t len)
+{
+  while (len >= 255) {
+    *op++ = 255;
+    len -= 255;
+  }
+  *op++ = (unsigned char)len;
+  return op;
+}
+
+// unaligned native-order load
+static uint32_t read32(const unsigned char* p)
+{
+  uint32_t v;
+  memcpy(&v, p, sizeof(v));
+  return v;
+}
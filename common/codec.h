@@ -0,0 +1,71 @@
+/* codec.h - header file for CS50 TSE page compression
+ *
+ * Compresses the text of a saved page. Two codecs are offered:
+ *
+ *   lz4    the LZ4 block format (written here, no library): fast to
+ *          compress and very fast to decompress
+ *   zlib   deflate through zlib at a level from 1 (fast) to 9 (small)
+ *
+ * A compressed page is framed so it can be told apart from a plain one:
+ *
+ *   "\x89TSZ"  codec (1 byte)  original length (4 bytes, little-endian)  data
+ *
+ * No page text starts with byte 0x89, so readers can take either kind.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __CODEC_H
+#define __CODEC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// the codecs; values are stored in the frame
+typedef enum codec {
+  CODEC_NONE = 0,
+  CODEC_LZ4 = 1,
+  CODEC_ZLIB = 2
+} codec_t;
+
+// bytes of frame before the compressed data
+#define CODEC_HEADER 9
+
+/*
+ * Reads a codec name: "none", "lz4", "zlib" (level 6) or "zlib:LEVEL".
+ *
+ * We return true and set *codec and *level, or false if name is not valid.
+ */
+bool codec_parse(const char* name, codec_t* codec, int* level);
+
+/*
+ * We return the name of codec ("none", "lz4" or "zlib").
+ */
+const char* codec_name(const codec_t codec);
+
+/*
+ * Compresses len bytes of data with codec at level (ignored by lz4).
+ *
+ * We return a new framed buffer and set *outLen to its length; or NULL if
+ *   the data would not get smaller (or on error), in which case it is
+ *   best stored as it is. The caller must free the result.
+ */
+char* codec_compress(const codec_t codec, const int level,
+                     const char* data, const size_t len, size_t* outLen);
+
+/*
+ * We return true if the len bytes at data begin with a compression frame.
+ */
+bool codec_isCompressed(const char* data, const size_t len);
+
+/*
+ * Decompresses a framed buffer.
+ *
+ * We return a new buffer with the original bytes and a '\0' after them,
+ *   setting *outLen to their number; or NULL if data is not a valid frame.
+ *   The caller must free the result.
+ */
+char* codec_decompress(const char* data, const size_t len, size_t* outLen);
+
+#endif // __CODEC_H
@@ -0,0 +1,447 @@
+/* concindex.c - CS50 TSE concurrent index builder
+ *
+ * A word's stripe is picked by bits 32..37 of its fasthash; the strarenas
+ *   take their table slots from the low bits, so the stripes do not thin
+ *   out any one table. Each stripe has a mutex, a strarena of its words and
+ *   an array of terms by handle, each a growing array of (docID, count)
+ *   postings as in spillindex. Stripes are 64-byte aligned, so two locks
+ *   never share a cache line.
+ *
+ * A concbuffer is a strarena of one page's words with a count and stripe
+ *   for each. A flush groups the handles by stripe (a counting sort), then
+ *   visits each stripe that has any under its lock, once.
+ *
+ * Postings arrive in whatever order the threads flush, so a term notes
+ *   when a docID comes in lower than its last one; concindex_save sorts
+ *   only those terms.
+ *
+ * Full and extensive documentation is in concindex.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdatomic.h>
+#include <pthread.h>
+#include "concindex.h"
+#include "strarena.h"
+#include "fasthash.h"
+
+// stdio buffer for the index file
+static const size_t BUFFER_BYTES = 1 << 20;
+
+// one docID's count
+typedef struct posting {
+  int32_t docID;
+  int32_t count;
+} posting_t;
+
+// one word's postings
+typedef struct term {
+  posting_t* postings;
+  int n;
+  int cap;
+  bool sorted;          // postings in docID order with no docID twice
+} term_t;
+
+// one stripe of the lexicon, alone on its cache lines
+typedef struct stripe {
+  _Alignas(64) pthread_mutex_t lock;
+  strarena_t* words;
+  term_t* terms;        // by the word's handle
+  int termCap;
+  long postings;
+  long locks;           // times locked by a flush
+  long contended;       // ... and found already held
+} stripe_t;
+
+// defines a concurrent index
+typedef struct concindex {
+  stripe_t* stripes;
+  atomic_long pages;
+} concindex_t;
+
+// defines a page's word counts
+typedef struct concbuffer {
+  strarena_t* words;
+  int* counts;          // by handle
+  unsigned char* stripe;  // by handle
+  int cap;
+  int* order;           // handles grouped by stripe, while flushing
+  int orderCap;
+} concbuffer_t;
+
+// a word and its term, for sorting
+typedef struct entry {
+  const char* word;
+  term_t* term;
+} entry_t;
+
+// function prototypes
+static int stripeOf(const char* word, const size_t len);
+static bool appendWords(stripe_t* stripe, concbuffer_t* buf, const int* handles,
+                        const int n, const int docID);
+static bool addPosting(term_t* term, const int docID, const int count);
+static void prepareTerm(term_t* term);
+static int compareEntries(const void* a, const void* b);
+static int comparePostings(const void* a, const void* b);
+static void writeLine(FILE* out, const char* word, const term_t* term);
+
+// an empty index
+concindex_t* concindex_new(const int expected)
+{
+  concindex_t* idx = malloc(sizeof(concindex_t));
+  stripe_t* stripes = aligned_alloc(64, CONC_STRIPES * sizeof(stripe_t));
+  if (idx == NULL || stripes == NULL) {
+    free(idx);
+    free(stripes);
+    return NULL;
+  }
+  memset(stripes, 0, CONC_STRIPES * sizeof(stripe_t));
+  idx->stripes = stripes;
+  atomic_init(&idx->pages, 0);
+
+  for (int s = 0; s < CONC_STRIPES; s++) {
+    stripes[s].words = strarena_new(expected / CONC_STRIPES);
+    if (stripes[s].words == NULL) {
+      for (int t = 0; t < s; t++) {
+        strarena_delete(stripes[t].words);
+        pthread_mutex_destroy(&stripes[t].lock);
+      }
+      free(stripes);
+      free(idx);
+      return NULL;
+    }
+    pthread_mutex_init(&stripes[s].lock, NULL);
+  }
+  return idx;
+}
+
+// an empty buffer
+concbuffer_t* concbuffer_new(void)
+{
+  concbuffer_t* buf = calloc(1, sizeof(concbuffer_t));
+  if (buf == NULL) {
+    return NULL;
+  }
+  buf->words = strarena_new(0);
+  if (buf->words == NULL) {
+    free(buf);
+    return NULL;
+  }
+  return buf;
+}
+
+// count a word of the page
+bool concbuffer_add(concbuffer_t* buf, const char* word)
+{
+  if (buf == NULL || word == NULL) {
+    return false;
+  }
+  size_t len = strlen(word);
+  int before = strarena_count(buf->words);
+  int w = strarena_intern(buf->words, word, len);
+  if (w < 0) {
+    return false;
+  }
+  if (w < before) {
+    buf->counts[w]++;
+    return true;
+  }
+
+  // a new word of this page
+  if (w >= buf->cap) {
+    int cap = (buf->cap == 0) ? 1024 : buf->cap * 2;
+    int* counts = realloc(buf->counts, cap * sizeof(int));
+    if (counts == NULL) {
+      return false;
+    }
+    buf->counts = counts;
+    unsigned char* stripe = realloc(buf->stripe, cap);
+    if (stripe == NULL) {
+      return false;
+    }
+    buf->stripe = stripe;
+    buf->cap = cap;
+  }
+  buf->counts[w] = 1;
+  buf->stripe[w] = stripeOf(word, len);
+  return true;
+}
+
+// add the buffer's page to the index, a stripe at a time
+bool concindex_flush(concindex_t* idx, concbuffer_t* buf, const int docID)
+{
+  if (idx == NULL || buf == NULL || docID <= 0) {
+    return false;
+  }
+  int n = strarena_count(buf->words);
+  if (n > buf->orderCap) {
+    int* order = realloc(buf->order, buf->cap * sizeof(int));
+    if (order == NULL) {
+      return false;
+    }
+    buf->order = order;
+    buf->orderCap = buf->cap;
+  }
+
+  // handles by stripe: start[s] is where stripe s's handles begin
+  int start[CONC_STRIPES + 1] = { 0 };
+  for (int w = 0; w < n; w++) {
+    start[buf->stripe[w] + 1]++;
+  }
+  for (int s = 0; s < CONC_STRIPES; s++) {
+    start[s + 1] += start[s];
+  }
+  int next[CONC_STRIPES];
+  memcpy(next, start, sizeof(next));
+  for (int w = 0; w < n; w++) {
+    buf->order[next[buf->stripe[w]]++] = w;
+  }
+
+  bool ok = true;
+  for (int s = 0; s < CONC_STRIPES && ok; s++) {
+    if (start[s] == start[s + 1]) {
+      continue;
+    }
+    stripe_t* stripe = &idx->stripes[s];
+    bool held = (pthread_mutex_trylock(&stripe->lock) != 0);
+    if (held) {
+      pthread_mutex_lock(&stripe->lock);
+    }
+    stripe->locks++;
+    stripe->contended += held;
+    ok = appendWords(stripe, buf, buf->order + start[s],
+                     start[s + 1] - start[s], docID);
+    pthread_mutex_unlock(&stripe->lock);
+  }
+
+  strarena_clear(buf->words);
+  atomic_fetch_add(&idx->pages, 1);
+  return ok;
+}
+
+// write the index file
+bool concindex_save(concindex_t* idx, const char* indexFilename)
+{
+  if (idx == NULL || indexFilename == NULL) {
+    return false;
+  }
+
+  // every word, in strcmp order
+  int total = 0;
+  for (int s = 0; s < CONC_STRIPES; s++) {
+    total += strarena_count(idx->stripes[s].words);
+  }
+  entry_t* entries = malloc((total + 1) * sizeof(entry_t));
+  if (entries == NULL) {
+    fprintf(stderr, "concindex: out of memory saving '%s'\n", indexFilename);
+    return false;
+  }
+  int e = 0;
+  for (int s = 0; s < CONC_STRIPES; s++) {
+    stripe_t* stripe = &idx->stripes[s];
+    for (int t = 0; t < strarena_count(stripe->words); t++) {
+      entries[e].word = strarena_get(stripe->words, t);
+      entries[e].term = &stripe->terms[t];
+      e++;
+    }
+  }
+  qsort(entries, total, sizeof(entry_t), compareEntries);
+
+  FILE* out = fopen(indexFilename, "w");
+  if (out == NULL) {
+    fprintf(stderr, "concindex: cannot create '%s'\n", indexFilename);
+    free(entries);
+    return false;
+  }
+  setvbuf(out, NULL, _IOFBF, BUFFER_BYTES);
+  for (int i = 0; i < total; i++) {
+    prepareTerm(entries[i].term);
+    writeLine(out, entries[i].word, entries[i].term);
+  }
+  free(entries);
+  bool ok = !ferror(out);
+  ok = (fclose(out) == 0) && ok;
+  if (!ok) {
+    fprintf(stderr, "concindex: cannot write '%s'\n", indexFilename);
+  }
+  return ok;
+}
+
+// one line of what was built
+void concindex_printStats(concindex_t* idx, FILE* fp)
+{
+  if (idx == NULL || fp == NULL) {
+    return;
+  }
+  long words = 0, postings = 0, locks = 0, contended = 0;
+  for (int s = 0; s < CONC_STRIPES; s++) {
+    stripe_t* stripe = &idx->stripes[s];
+    pthread_mutex_lock(&stripe->lock);
+    words += strarena_count(stripe->words);
+    postings += stripe->postings;
+    locks += stripe->locks;
+    contended += stripe->contended;
+    pthread_mutex_unlock(&stripe->lock);
+  }
+  fprintf(fp, "concindex: %ld words, %ld postings, %ld pages, "
+          "%d stripes locked %ld times, %ld (%.2f%%) contended\n",
+          words, postings, atomic_load(&idx->pages), CONC_STRIPES, locks,
+          contended, (locks > 0) ? 100.0 * contended / locks : 0.0);
+}
+
+// free a buffer
+void concbuffer_delete(concbuffer_t* buf)
+{
+  if (buf == NULL) {
+    return;
+  }
+  strarena_delete(buf->words);
+  free(buf->counts);
+  free(buf->stripe);
+  free(buf->order);
+  free(buf);
+}
+
+// free the index
+void concindex_delete(concindex_t* idx)
+{
+  if (idx == NULL) {
+    return;
+  }
+  for (int s = 0; s < CONC_STRIPES; s++) {
+    stripe_t* stripe = &idx->stripes[s];
+    for (int t = 0; t < strarena_count(stripe->words); t++) {
+      free(stripe->terms[t].postings);
+    }
+    free(stripe->terms);
+    strarena_delete(stripe->words);
+    pthread_mutex_destroy(&stripe->lock);
+  }
+  free(idx->stripes);
+  free(idx);
+}
+
+/**************** helpers ****************/
+
+// bits 32..37 of the hash; strarena's slots come from the low bits
+static int stripeOf(const char* word, const size_t len)
+{
+  return (fasthash(word, len) >> 32) & (CONC_STRIPES - 1);
+}
+
+// with the stripe locked, a posting for each of the buffer's handles
+static bool appendWords(stripe_t* stripe, concbuffer_t* buf, const int* handles,
+                        const int n, const int docID)
+{
+  for (int i = 0; i < n; i++) {
+    int w = handles[i];
+    int t = strarena_intern(stripe->words, strarena_get(buf->words, w),
+                            strarena_length(buf->words, w));
+    if (t < 0) {
+      return false;
+    }
+    if (t >= stripe->termCap) {
+      int cap = (stripe->termCap == 0) ? 1024 : stripe->termCap * 2;
+      term_t* terms = realloc(stripe->terms, cap * sizeof(term_t));
+      if (terms == NULL) {
+        return false;
+      }
+      memset(terms + stripe->termCap, 0,
+             (cap - stripe->termCap) * sizeof(term_t));
+      stripe->terms = terms;
+      stripe->termCap = cap;
+    }
+    if (!addPosting(&stripe->terms[t], docID, buf->counts[w])) {
+      return false;
+    }
+    stripe->postings++;
+  }
+  return true;
+}
+
+// append (docID, count) to a term
+static bool addPosting(term_t* term, const int docID, const int count)
+{
+  if (term->n == term->cap) {
+    int cap = (term->cap == 0) ? 2 : term->cap * 2;
+    posting_t* postings = realloc(term->postings, cap * sizeof(posting_t));
+    if (postings == NULL) {
+      return false;
+    }
+    term->postings = postings;
+    term->cap = cap;
+  }
+  if (term->n == 0) {
+    term->sorted = true;
+  } else if (term->postings[term->n - 1].docID >= docID) {
+    term->sorted = false;
+  }
+  term->postings[term->n].docID = docID;
+  term->postings[term->n].count = count;
+  term->n++;
+  return true;
+}
+
+// postings in docID order, each docID once
+static void prepareTerm(term_t* term)
+{
+  if (term->sorted) {
+    return;
+  }
+  qsort(term->postings, term->n, sizeof(posting_t), comparePostings);
+  int out = 0;
+  for (int i = 1; i < term->n; i++) {
+    if (term->postings[i].docID == term->postings[out].docID) {
+      term->postings[out].count += term->postings[i].count;
+    } else {
+      term->postings[++out] = term->postings[i];
+    }
+  }
+  term->n = out + 1;
+  term->sorted = true;
+}
+
+// by word, for qsort
+static int compareEntries(const void* a, const void* b)
+{
+  return strcmp(((const entry_t*)a)->word, ((const entry_t*)b)->word);
+}
+
+// by docID, for qsort
+static int comparePostings(const void* a, const void* b)
+{
+  int32_t x = ((const posting_t*)a)->docID;
+  int32_t y = ((const posting_t*)b)->docID;
+  return (x > y) - (x < y);
+}
+
+// "word docID count [docID count]...\n", the numbers without printf
+static void writeLine(FILE* out, const char* word, const term_t* term)
+{
+  fputs(word, out);
+  char buf[24];
+  for (int p = 0; p < term->n; p++) {
+    int i = sizeof(buf);
+    uint32_t v = term->postings[p].count;
+    do {
+      buf[--i] = '0' + v % 10;
+      v /= 10;
+    } while (v > 0);
+    buf[--i] = ' ';
+    v = term->postings[p].docID;
+    do {
+      buf[--i] = '0' + v % 10;
+      v /= 10;
+    } while (v > 0);
+    buf[--i] = ' ';
+    fwrite(buf + i, 1, sizeof(buf) - i, out);
+  }
+  fputc('\n', out);
+}
@@ -0,0 +1,95 @@
+/* concindex.h - header file for CS50 TSE concurrent index builder
+ *
+ * Lets several threads index pages into one index at the same time, with
+ *   no merge at the end. The lexicon is split into CONC_STRIPES stripes by
+ *   the word's hash, each with its own lock, words and postings, so two
+ *   threads wait for each other only when they touch the same stripe at
+ *   the same moment.
+ *
+ * Each thread counts a page's words in its own concbuffer first, without
+ *   any lock. concindex_flush then appends the page to the index: each
+ *   stripe the page has words in is locked once, and every word gets one
+ *   (docID, count) posting. A page is counted by one thread only, so that
+ *   posting is final; concindex_save just sorts, and writes the file in
+ *   the format of index_save, one word per line with its docIDs in
+ *   increasing order:
+ *
+ *   word docID count [docID count]...
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __CONCINDEX_H
+#define __CONCINDEX_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// stripes (and locks) of the lexicon, a power of 2
+#define CONC_STRIPES 64
+
+// opaque concurrent index
+typedef struct concindex concindex_t;
+
+// opaque per-thread buffer of one page's word counts
+typedef struct concbuffer concbuffer_t;
+
+/*
+ * The user provides the number of distinct words expected (a hint only).
+ *
+ * We return a pointer to a new empty index, or NULL if out of memory. The
+ *   user must call concindex_delete.
+ */
+concindex_t* concindex_new(const int expected);
+
+/*
+ * We return a pointer to a new empty buffer, or NULL if out of memory. A
+ *   buffer belongs to one thread at a time; the user must call
+ *   concbuffer_delete.
+ */
+concbuffer_t* concbuffer_new(void);
+
+/*
+ * Counts one occurrence of word in the buffer's page.
+ *
+ * We return false on bad parameters or if out of memory.
+ */
+bool concbuffer_add(concbuffer_t* buf, const char* word);
+
+/*
+ * Appends the buffer's page to the index as docID (> 0), and empties the
+ *   buffer for the next page. Any number of threads may flush their own
+ *   buffers at once; each docID should be flushed once (counts of a docID
+ *   flushed twice are added when saved).
+ *
+ * We return false on bad parameters or if out of memory.
+ */
+bool concindex_flush(concindex_t* idx, concbuffer_t* buf, const int docID);
+
+/*
+ * Writes the index to indexFilename, words in strcmp order, once every
+ *   flush has returned.
+ *
+ * We return false if the file could not be written.
+ */
+bool concindex_save(concindex_t* idx, const char* indexFilename);
+
+/*
+ * Prints one line to fp: words, postings, pages flushed, and how often a
+ *   flush found a stripe's lock already held.
+ */
+void concindex_printStats(concindex_t* idx, FILE* fp);
+
+/*
+ * Delete the buffer, free allocated memory
+ */
+void concbuffer_delete(concbuffer_t* buf);
+
+/*
+ * Delete the index, free allocated memory
+ */
+void concindex_delete(concindex_t* idx);
+
+#endif // __CONCINDEX_H
@@ -0,0 +1,362 @@
+/* dedup.c - CS50 TSE duplicate page detection
+ *
+ * Every page added becomes an entry holding its two fingerprints. Entries
+ *   are chained from a bucket table keyed by the low 16 bits of the exact
+ *   hash and, when near duplicates are wanted, from four bucket tables keyed
+ *   by the four 16-bit bands of the SimHash. Chains are linked by entry index
+ *   so the entries can sit in one growing array.
+ *
+ * Full and extensive documentation is in dedup.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "dedup.h"
+#include "word.h"
+#include "../libcs50/webpage.h"
+
+// buckets per table, one per 16-bit key
+#define BUCKETS 65536
+#define BANDS 4
+
+// XXH64 primes
+static const uint64_t P1 = 0x9E3779B185EBCA87ULL;
+static const uint64_t P2 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t P3 = 0x165667B19E3779F9ULL;
+static const uint64_t P4 = 0x85EBCA77C2B2AE63ULL;
+static const uint64_t P5 = 0x27D4EB2F165667C5ULL;
+
+// one saved page
+typedef struct entry {
+  uint64_t exact;
+  uint64_t simhash;
+  int docID;
+  int nextExact;            // next entry in the same exact bucket, -1 at end
+  int nextBand[BANDS];      // ... in the same band buckets
+} entry_t;
+
+// defines a dedup table
+typedef struct dedup {
+  int maxDistance;
+  entry_t* entries;
+  int count;
+  int capacity;
+  int* exactHeads;          // BUCKETS chain heads, -1 if empty
+  int* bandHeads;           // BANDS * BUCKETS, NULL for exact only
+  size_t checked;
+  size_t exactDups;
+  size_t nearDups;
+  size_t bytesSaved;
+} dedup_t;
+
+// function prototypes
+static int findDuplicate(dedup_t* dedup, const uint64_t exact,
+                         const uint64_t simhash, bool* near);
+static bool addEntry(dedup_t* dedup, const uint64_t exact,
+                     const uint64_t simhash, const int docID);
+static int distance(uint64_t a, uint64_t b);
+static uint64_t rotl(const uint64_t x, const int r);
+static uint64_t read64(const unsigned char* p);
+static uint32_t read32(const unsigned char* p);
+static uint64_t xxRound(uint64_t acc, const uint64_t input);
+static uint64_t xxMerge(uint64_t acc, const uint64_t val);
+static uint64_t mix(uint64_t h);
+
+// create an empty table
+dedup_t* dedup_new(const int maxDistance)
+{
+  if (maxDistance < 0 || maxDistance > DEDUP_MAX_DISTANCE) {
+    return NULL;
+  }
+
+  dedup_t* dedup = calloc(1, sizeof(dedup_t));
+  if (dedup == NULL) {
+    return NULL;
+  }
+  dedup->maxDistance = maxDistance;
+  dedup->exactHeads = malloc(BUCKETS * sizeof(int));
+  if (maxDistance > 0) {
+    dedup->bandHeads = malloc(BANDS * BUCKETS * sizeof(int));
+  }
+  if (dedup->exactHeads == NULL || (maxDistance > 0 && dedup->bandHeads == NULL)) {
+    dedup_delete(dedup);
+    return NULL;
+  }
+  memset(dedup->exactHeads, -1, BUCKETS * sizeof(int));
+  if (dedup->bandHeads != NULL) {
+    memset(dedup->bandHeads, -1, BANDS * BUCKETS * sizeof(int));
+  }
+  return dedup;
+}
+
+// return the docID this page duplicates, or remember it and return 0
+int dedup_add(dedup_t* dedup, webpage_t* page, const int docID)
+{
+  if (dedup == NULL || page == NULL || docID <= 0) {
+    return 0;
+  }
+  const char* html = webpage_getHTML(page);
+  if (html == NULL) {
+    return 0;
+  }
+
+  size_t len = strlen(html);
+  uint64_t exact = dedup_hash(html, len);
+  uint64_t simhash = (dedup->maxDistance > 0) ? dedup_simhash(page) : 0;
+  dedup->checked++;
+
+  bool near = false;
+  int original = findDuplicate(dedup, exact, simhash, &near);
+  if (original > 0) {
+    if (near) {
+      dedup->nearDups++;
+    } else {
+      dedup->exactDups++;
+    }
+    dedup->bytesSaved += len;
+    return original;
+  }
+
+  if (!addEntry(dedup, exact, simhash, docID)) {
+    fprintf(stderr, "dedup: out of memory\n");
+  }
+  return 0;
+}
+
+// one line of statistics
+void dedup_printStats(dedup_t* dedup, FILE* fp)
+{
+  if (dedup == NULL || fp == NULL) {
+    return;
+  }
+  fprintf(fp, "dedup: %zu pages checked, %zu exact and %zu near duplicates "
+          "(distance <= %d), %zu bytes not saved\n",
+          dedup->checked, dedup->exactDups, dedup->nearDups,
+          dedup->maxDistance, dedup->bytesSaved);
+}
+
+// free everything
+void dedup_delete(dedup_t* dedup)
+{
+  if (dedup == NULL) {
+    return;
+  }
+  free(dedup->entries);
+  free(dedup->exactHeads);
+  free(dedup->bandHeads);
+  free(dedup);
+}
+
+// XXH64 with seed 0
+uint64_t dedup_hash(const void* data, const size_t len)
+{
+  const unsigned char* p = data;
+  const unsigned char* end = p + len;
+  uint64_t h;
+
+  if (len >= 32) {
+    uint64_t v1 = P1 + P2;
+    uint64_t v2 = P2;
+    uint64_t v3 = 0;
+    uint64_t v4 = -P1;
+    do {
+      v1 = xxRound(v1, read64(p));
+      v2 = xxRound(v2, read64(p + 8));
+      v3 = xxRound(v3, read64(p + 16));
+      v4 = xxRound(v4, read64(p + 24));
+      p += 32;
+    } while (p + 32 <= end);
+    h = rotl(v1, 1) + rotl(v2, 7) + rotl(v3, 12) + rotl(v4, 18);
+    h = xxMerge(h, v1);
+    h = xxMerge(h, v2);
+    h = xxMerge(h, v3);
+    h = xxMerge(h, v4);
+  } else {
+    h = P5;
+  }
+  h += len;
+
+  // the last 0..31 bytes
+  for (; p + 8 <= end; p += 8) {
+    h ^= xxRound(0, read64(p));
+    h = rotl(h, 27) * P1 + P4;
+  }
+  if (p + 4 <= end) {
+    h ^= (uint64_t)read32(p) * P1;
+    h = rotl(h, 23) * P2 + P3;
+    p += 4;
+  }
+  for (; p < end; p++) {
+    h ^= (*p) * P5;
+    h = rotl(h, 11) * P1;
+  }
+
+  h ^= h >> 33;
+  h *= P2;
+  h ^= h >> 29;
+  h *= P3;
+  h ^= h >> 32;
+  return h;
+}
+
+// SimHash over word shingles (each word with the two before it)
+uint64_t dedup_simhash(webpage_t* page)
+{
+  if (page == NULL) {
+    return 0;
+  }
+
+  int weights[64] = { 0 };
+  uint64_t window[3] = { 0, 0, 0 };
+  int pos = 0;
+  char* word;
+  while ((word = webpage_getNextWord(page, &pos)) != NULL) {
+    if (normalizeWord(word)) {
+      window[0] = window[1];
+      window[1] = window[2];
+      window[2] = dedup_hash(word, strlen(word));
+
+      // the first two shingles are short; a page of one word still counts
+      uint64_t feature = mix(window[2] ^ rotl(window[1], 21)
+                             ^ rotl(window[0], 42));
+      for (int b = 0; b < 64; b++) {
+        weights[b] += ((feature >> b) & 1) ? 1 : -1;
+      }
+    }
+    free(word);
+  }
+
+  uint64_t simhash = 0;
+  for (int b = 0; b < 64; b++) {
+    if (weights[b] > 0) {
+      simhash |= 1ULL << b;
+    }
+  }
+  return simhash;
+}
+
+/**************** helpers ****************/
+
+// docID of a matching entry, or 0; near says whether it matched by SimHash
+static int findDuplicate(dedup_t* dedup, const uint64_t exact,
+                         const uint64_t simhash, bool* near)
+{
+  for (int i = dedup->exactHeads[exact & 0xffff]; i >= 0;
+       i = dedup->entries[i].nextExact) {
+    if (dedup->entries[i].exact == exact) {
+      *near = false;
+      return dedup->entries[i].docID;
+    }
+  }
+
+  if (dedup->bandHeads == NULL || simhash == 0) {
+    return 0;
+  }
+  for (int band = 0; band < BANDS; band++) {
+    int key = (simhash >> (16 * band)) & 0xffff;
+    for (int i = dedup->bandHeads[band * BUCKETS + key]; i >= 0;
+         i = dedup->entries[i].nextBand[band]) {
+      if (distance(dedup->entries[i].simhash, simhash) <= dedup->maxDistance) {
+        *near = true;
+        return dedup->entries[i].docID;
+      }
+    }
+  }
+  return 0;
+}
+
+// append an entry and link it into its buckets
+static bool addEntry(dedup_t* dedup, const uint64_t exact,
+                     const uint64_t simhash, const int docID)
+{
+  if (dedup->count == dedup->capacity) {
+    int capacity = (dedup->capacity == 0) ? 1024 : dedup->capacity * 2;
+    entry_t* entries = realloc(dedup->entries, capacity * sizeof(entry_t));
+    if (entries == NULL) {
+      return false;
+    }
+    dedup->entries = entries;
+    dedup->capacity = capacity;
+  }
+
+  int i = dedup->count++;
+  entry_t* e = &dedup->entries[i];
+  e->exact = exact;
+  e->simhash = simhash;
+  e->docID = docID;
+  e->nextExact = dedup->exactHeads[exact & 0xffff];
+  dedup->exactHeads[exact & 0xffff] = i;
+
+  // a page without words is only matched exactly
+  for (int band = 0; band < BANDS; band++) {
+    e->nextBand[band] = -1;
+    if (dedup->bandHeads != NULL && simhash != 0) {
+      int key = (simhash >> (16 * band)) & 0xffff;
+      e->nextBand[band] = dedup->bandHeads[band * BUCKETS + key];
+      dedup->bandHeads[band * BUCKETS + key] = i;
+    }
+  }
+  return true;
+}
+
+// number of differing bits
+static int distance(uint64_t a, uint64_t b)
+{
+  uint64_t x = a ^ b;
+  int bits = 0;
+  while (x != 0) {
+    x &= x - 1;
+    bits++;
+  }
+  return bits;
+}
+
+static uint64_t rotl(const uint64_t x, const int r)
+{
+  return (x << r) | (x >> (64 - r));
+}
+
+// unaligned little-endian loads
+static uint64_t read64(const unsigned char* p)
+{
+  uint64_t v = 0;
+  for (int i = 7; i >= 0; i--) {
+    v = (v << 8) | p[i];
+  }
+  return v;
+}
+
+static uint32_t read32(const unsigned char* p)
+{
+  return (uint32_t)p[0] | (uint32_t)p[1] << 8 | (uint32_t)p[2] << 16
+         | (uint32_t)p[3] << 24;
+}
+
+static uint64_t xxRound(uint64_t acc, const uint64_t input)
+{
+  acc += input * P2;
+  acc = rotl(acc, 31);
+  return acc * P1;
+}
+
+static uint64_t xxMerge(uint64_t acc, const uint64_t val)
+{
+  acc ^= xxRound(0, val);
+  return acc * P1 + P4;
+}
+
+// murmur3 finalizer, spreads shingle hashes over all 64 bits
+static uint64_t mix(uint64_t h)
+{
+  h ^= h >> 33;
+  h *= 0xff51afd7ed558ccdULL;
+  h ^= h >> 33;
+  h *= 0xc4ceb9fe1a85ec53ULL;
+  h ^= h >> 33;
+  return h;
+}
@@ -0,0 +1,74 @@
+/* dedup.h - header file for CS50 TSE duplicate page detection
+ *
+ * The crawler only knows two URLs are the same page if they normalize to the
+ *   same string; mirrors and copies under other URLs would be saved and
+ *   indexed again. A dedup table remembers a content fingerprint of every page
+ *   saved so far and reports when a newly fetched page duplicates one of them:
+ *
+ *   exact   a 64-bit xxHash of the HTML; equal hashes mean equal pages (up to
+ *           a 2^-64 chance of collision)
+ *   near    a 64-bit SimHash of the page's words, taken three at a time; pages
+ *           that differ in a few words have SimHashes a few bits apart
+ *
+ * Near duplicates are found within a Hamming distance of at most 3: the
+ *   SimHash is cut into four 16-bit bands, and two hashes at distance <= 3
+ *   must agree exactly on at least one band, so only pages sharing a band
+ *   with the new page are compared.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __DEDUP_H
+#define __DEDUP_H
+
+#include <stdio.h>
+#include <stdint.h>
+#include <stddef.h>
+#include "../libcs50/webpage.h"
+
+// largest SimHash distance the band tables can find
+#define DEDUP_MAX_DISTANCE 3
+
+// opaque dedup table
+typedef struct dedup dedup_t;
+
+/*
+ * The user provides the largest SimHash distance at which two pages count as
+ *   the same: 0 for exact duplicates only, up to DEDUP_MAX_DISTANCE.
+ *
+ * We return a pointer to a new empty table, or NULL on bad distance or error.
+ */
+dedup_t* dedup_new(const int maxDistance);
+
+/*
+ * Checks a fetched page against every page added so far.
+ *
+ * We return the docID of the page it duplicates, and the page is not added;
+ *   or 0 if it is new, in which case it is remembered under docID.
+ */
+int dedup_add(dedup_t* dedup, webpage_t* page, const int docID);
+
+/*
+ * We print one line of statistics to fp: pages checked, exact and near
+ *   duplicates found, and the bytes of HTML they would have taken.
+ */
+void dedup_printStats(dedup_t* dedup, FILE* fp);
+
+/*
+ * Delete the table, free allocated memory
+ */
+void dedup_delete(dedup_t* dedup);
+
+/*
+ * We return the 64-bit xxHash (XXH64, seed 0) of len bytes at data.
+ */
+uint64_t dedup_hash(const void* data, const size_t len);
+
+/*
+ * We return the 64-bit SimHash of the page's words (normalized as the
+ *   indexer does), or 0 for a page without words.
+ */
+uint64_t dedup_simhash(webpage_t* page);
+
+#endif // __DEDUP_H
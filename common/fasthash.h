@@ -0,0 +1,29 @@
+/* fasthash.h - header file for CS50 TSE string hash
+ *
+ * A 64-bit hash of the wyhash family: eight bytes at a time, each pair of
+ *   words mixed by one 64 x 64 -> 128-bit multiply, and a key of 16 bytes
+ *   or less (nearly every word) in just two multiplies, with no loop. The
+ *   length is given, so the key need not be NUL-terminated or strlen'd.
+ *
+ * Every bit of the result is well mixed, so a table of 2^k slots takes the
+ *   low k bits (hash & (slots - 1)) rather than a modulo.
+ *
+ * The result depends on the machine's byte order; it is for tables in
+ *   memory, not for files.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __FASTHASH_H
+#define __FASTHASH_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+/*
+ * We return the 64-bit hash of len bytes at data.
+ */
+uint64_t fasthash(const void* data, const size_t len);
+
+#endif // __FASTHASH_H
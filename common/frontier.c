@@ -0,0 +1,276 @@
+/* frontier.c - CS50 TSE crawl frontier
+ *
+ * Each depth has a queue made of a linked list of chunks; URLs are appended
+ *   as NUL-terminated strings to the tail chunk and read from the head chunk.
+ *   A chunk is freed as soon as every URL in it has been read.
+ *
+ * When the frontier is over its memory budget, a queue's new URLs go to its
+ *   spill file (one URL per line) instead. While a queue has spilled URLs all
+ *   further pushes go to the file too, which keeps the queue in FIFO order;
+ *   once the chunks run dry, URLs are read back from the file.
+ *
+ * Full and extensive documentation is in frontier.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "frontier.h"
+
+// bytes per chunk of URLs (bigger for a longer URL)
+static const size_t CHUNK_SIZE = 64 * 1024;
+
+// a block of URLs stored back to back
+typedef struct chunk {
+  struct chunk* next;
+  size_t size;      // bytes available in data
+  size_t used;      // bytes written
+  size_t read;      // bytes already popped
+  char data[];
+} chunk_t;
+
+// the URLs of one depth
+typedef struct queue {
+  chunk_t* head;        // pop from here
+  chunk_t* tail;        // push to here
+  size_t count;         // URLs in chunks
+  FILE* spill;          // overflow file, NULL until needed
+  long spillRead;       // offset of next URL to read back
+  long spillWrite;      // offset at which to append
+  size_t spillCount;    // URLs in the file
+} queue_t;
+
+// defines a frontier
+typedef struct frontier {
+  queue_t* queues;      // one per depth, 0..maxDepth
+  int maxDepth;
+  size_t memBudget;     // bytes of URLs allowed in memory (0 = unlimited)
+  size_t memBytes;      // bytes of URLs now in memory
+  size_t spilled;       // total URLs ever written to disk
+} frontier_t;
+
+// function prototypes
+static bool queue_append(frontier_t* frontier, queue_t* q, const char* url,
+                         const size_t len);
+static bool queue_spill(queue_t* q, const char* url);
+static void queue_refill(frontier_t* frontier, queue_t* q);
+
+// create an empty frontier
+frontier_t* frontier_new(const int maxDepth, const size_t memBudget)
+{
+  if (maxDepth < 0) {
+    return NULL;
+  }
+
+  frontier_t* frontier = malloc(sizeof(frontier_t));
+  if (frontier == NULL) {
+    return NULL;
+  }
+  frontier->queues = calloc(maxDepth + 1, sizeof(queue_t));
+  if (frontier->queues == NULL) {
+    free(frontier);
+    return NULL;
+  }
+  frontier->maxDepth = maxDepth;
+  frontier->memBudget = memBudget;
+  frontier->memBytes = 0;
+  frontier->spilled = 0;
+  return frontier;
+}
+
+// add a url at the back of its depth's queue
+bool frontier_push(frontier_t* frontier, const char* url, const int depth)
+{
+  if (frontier == NULL || url == NULL || depth < 0 || depth > frontier->maxDepth
+      || strchr(url, '\n') != NULL) {
+    return false; // bad parameters
+  }
+
+  queue_t* q = &frontier->queues[depth];
+  size_t len = strlen(url) + 1;
+
+  // once spilling, stay on disk until the file drains so order is kept
+  bool overBudget = frontier->memBudget > 0
+                    && frontier->memBytes + len > frontier->memBudget;
+  if (q->spillCount > 0 || (overBudget && q->count > 0)) {
+    if (!queue_spill(q, url)) {
+      return false;
+    }
+    frontier->spilled++;
+    return true;
+  }
+  return queue_append(frontier, q, url, len);
+}
+
+// take the oldest url of the shallowest depth
+char* frontier_pop(frontier_t* frontier, int* depth)
+{
+  if (frontier == NULL || depth == NULL) {
+    return NULL;
+  }
+
+  for (int d = 0; d <= frontier->maxDepth; d++) {
+    queue_t* q = &frontier->queues[d];
+    if (q->count == 0) {
+      queue_refill(frontier, q);
+    }
+    if (q->count == 0) {
+      continue; // this depth is done
+    }
+
+    // the head chunk always holds the oldest unread url
+    chunk_t* chunk = q->head;
+    const char* src = chunk->data + chunk->read;
+    size_t len = strlen(src) + 1;
+    char* url = malloc(len);
+    if (url == NULL) {
+      return NULL;
+    }
+    memcpy(url, src, len);
+
+    chunk->read += len;
+    q->count--;
+    frontier->memBytes -= len;
+    if (chunk->read == chunk->used) {
+      // chunk is spent; keep the tail chunk for reuse
+      if (chunk == q->tail) {
+        chunk->read = chunk->used = 0;
+      } else {
+        q->head = chunk->next;
+        free(chunk);
+      }
+    }
+
+    *depth = d;
+    return url;
+  }
+  return NULL; // empty
+}
+
+// number of urls waiting
+size_t frontier_size(frontier_t* frontier)
+{
+  if (frontier == NULL) {
+    return 0;
+  }
+  size_t size = 0;
+  for (int d = 0; d <= frontier->maxDepth; d++) {
+    size += frontier->queues[d].count + frontier->queues[d].spillCount;
+  }
+  return size;
+}
+
+// number of urls ever spilled
+size_t frontier_spilled(frontier_t* frontier)
+{
+  return (frontier == NULL) ? 0 : frontier->spilled;
+}
+
+// free everything
+void frontier_delete(frontier_t* frontier)
+{
+  if (frontier == NULL) {
+    return;
+  }
+  for (int d = 0; d <= frontier->maxDepth; d++) {
+    queue_t* q = &frontier->queues[d];
+    chunk_t* chunk = q->head;
+    while (chunk != NULL) {
+      chunk_t* next = chunk->next;
+      free(chunk);
+      chunk = next;
+    }
+    if (q->spill != NULL) {
+      fclose(q->spill); // tmpfile is removed on close
+    }
+  }
+  free(frontier->queues);
+  free(frontier);
+}
+
+/**************** queues ****************/
+
+// copy a url (len includes the '\0') into the tail chunk
+static bool queue_append(frontier_t* frontier, queue_t* q, const char* url,
+                         const size_t len)
+{
+  if (q->tail == NULL || q->tail->used + len > q->tail->size) {
+    size_t size = (len > CHUNK_SIZE) ? len : CHUNK_SIZE;
+    chunk_t* chunk = malloc(sizeof(chunk_t) + size);
+    if (chunk == NULL) {
+      return false;
+    }
+    chunk->next = NULL;
+    chunk->size = size;
+    chunk->used = 0;
+    chunk->read = 0;
+    if (q->tail == NULL) {
+      q->head = chunk;
+    } else {
+      q->tail->next = chunk;
+    }
+    q->tail = chunk;
+  }
+
+  memcpy(q->tail->data + q->tail->used, url, len);
+  q->tail->used += len;
+  q->count++;
+  frontier->memBytes += len;
+  return true;
+}
+
+// append a url to the queue's spill file, creating it if need be
+static bool queue_spill(queue_t* q, const char* url)
+{
+  if (q->spill == NULL) {
+    q->spill = tmpfile();
+    if (q->spill == NULL) {
+      fprintf(stderr, "frontier: cannot create spill file\n");
+      return false;
+    }
+    q->spillRead = q->spillWrite = 0;
+  }
+
+  if (fseek(q->spill, q->spillWrite, SEEK_SET) != 0
+      || fputs(url, q->spill) == EOF || fputc('\n', q->spill) == EOF) {
+    fprintf(stderr, "frontier: cannot write spill file\n");
+    return false;
+  }
+  q->spillWrite = ftell(q->spill);
+  q->spillCount++;
+  return true;
+}
+
+// move spilled urls back into memory, up to half the budget
+static void queue_refill(frontier_t* frontier, queue_t* q)
+{
+  if (q->spillCount == 0 || fseek(q->spill, q->spillRead, SEEK_SET) != 0) {
+    return;
+  }
+
+  char* line = NULL;
+  size_t lineSize = 0;
+  ssize_t len;
+  while (q->spillCount > 0 && (len = getline(&line, &lineSize, q->spill)) > 0) {
+    line[len - 1] = '\0'; // newline becomes the terminator
+    if (!queue_append(frontier, q, line, len)) {
+      break; // leave the rest on disk
+    }
+    q->spillRead += len;
+    q->spillCount--;
+    if (q->count > 0 && frontier->memBytes >= frontier->memBudget / 2) {
+      break;
+    }
+  }
+  free(line);
+
+  // file drained: start over at its beginning
+  if (q->spillCount == 0) {
+    q->spillRead = q->spillWrite = 0;
+  }
+}
@@ -0,0 +1,65 @@
+/* frontier.h - header file for CS50 TSE crawl frontier
+ *
+ * The frontier holds the URLs the crawler has yet to visit. It is a set of
+ *   first-in first-out queues, one per depth; frontier_pop always takes the
+ *   oldest URL of the shallowest depth, so the crawl is truly breadth-first.
+ *
+ * URLs are packed back to back into large chunks, so there is no allocation
+ *   per entry. Once the URLs held in memory pass a byte budget, new URLs are
+ *   spilled to a temporary file and read back when their turn comes.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __FRONTIER_H
+#define __FRONTIER_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// opaque frontier
+typedef struct frontier frontier_t;
+
+/*
+ * The user provides the deepest depth that will be pushed (>= 0) and the
+ *   number of bytes of URLs to keep in memory before spilling to disk
+ *   (0 means never spill).
+ *
+ * We return a pointer to a new empty frontier, or NULL on error.
+ */
+frontier_t* frontier_new(const int maxDepth, const size_t memBudget);
+
+/*
+ * Adds a copy of url, found at the given depth, to the back of its queue.
+ *   The caller keeps ownership of url.
+ *
+ * We return false on bad parameters (NULL, depth out of range, url holding
+ *   a newline) or on memory/disk error.
+ */
+bool frontier_push(frontier_t* frontier, const char* url, const int depth);
+
+/*
+ * Removes the oldest URL of the shallowest non-empty depth.
+ *
+ * We return the URL in newly malloc'd memory (the caller must free it) and
+ *   store its depth in *depth, or return NULL if the frontier is empty.
+ */
+char* frontier_pop(frontier_t* frontier, int* depth);
+
+/*
+ * We return the number of URLs waiting, in memory and on disk.
+ */
+size_t frontier_size(frontier_t* frontier);
+
+/*
+ * We return the number of URLs that have been spilled to disk so far.
+ */
+size_t frontier_spilled(frontier_t* frontier);
+
+/*
+ * Delete the frontier, its spill files, and all memory
+ */
+void frontier_delete(frontier_t* frontier);
+
+#endif // __FRONTIER_H
@@ -1,33 +1,132 @@
 /* index.c - CS50 TSE index module
  *
- * The index is a hashtable that maps words to counters.
+ * The index maps words to counters.
  *   the counters maps docID to count of word occurrence.
  *
+ * The words are interned in a strarena, which packs them into large blocks
+ *   and numbers them; a word's counters are found at its number in an
+ *   array. There is no malloc per word apart from its counters.
+ *
+ * index_save sorts the words, and each word's docIDs, so the same index
+ *   always makes the same file. The words are gathered and sorted first;
+ *   each word's line is then formatted (without printf) straight into a
+ *   1 MB buffer, which is written out whenever it fills.
+ *
+ * index_load maps the whole file and scans it by hand: no fscanf, no limit
+ *   on the length of a word, and a table sized from the number of lines
+ *   rather than a fixed 500 slots. Words are interned straight from the
+ *   mapped text, without a copy.
+ *
+ * index_open leaves the words in the file: the index is then a front for
+ *   a lazyindex, which reads each word when it is first looked up, into a
+ *   postings list. index_findPostings copies that list; index_find has to
+ *   make it counters, and keeps them until the next call.
+ *
+ * index_prefix needs the words in order, which the strarena does not keep:
+ *   they are sorted into an array on the first call, and again only once
+ *   words have been added since.
+ *
  * Full and extensive documentation is in index.h
  *
  * Author: Jacob Bacus
  * Feburary 2025
  */
 
+#define _GNU_SOURCE
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
-#include "../libcs50/hashtable.h"
+#include <stdint.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "../libcs50/counters.h"
+#include "posindex.h"
+#include "lazyindex.h"
+#include "postings.h"
+#include "strarena.h"
 #include "index.h"
 
 // defines an index
 typedef struct index {
-  hashtable_t* table; // word to counters
+  strarena_t* words;      // the words, numbered
+  counters_t** ctrs;      // each word's counters, by number
+  int ctrsCap;
+  int slots;              // expected words
+  posindex_t* positions;  // word to positions, NULL unless enabled
+  lazyindex_t* lazy;      // the file's words, if opened by index_open
+  counters_t* found;      // index_find's last answer from lazy
+  const char** sorted;    // the words in strcmp order, for index_prefix
+  int nsorted;            // words when they were sorted
 } index_t;
 
 
+// index_save's output buffer, written out only when full
+static const size_t WRITE_BUFFER = 1 << 20;
+
+// most characters of an int in decimal, with its sign
+#define MAX_INT_DIGITS 11
+
+// one docID and its count
+typedef struct posting {
+  int docID;
+  int count;
+} posting_t;
+
+// one word of the index, for sorting
+typedef struct wordEntry {
+  uint64_t prefix;      // first 8 bytes, big-endian, so most compares stay here
+  const char* word;
+  counters_t* ctrs;
+} wordEntry_t;
+
+// every word of the index, gathered in one pass and put in order afterwards
+typedef struct wordList {
+  wordEntry_t* words;
+  int count;
+  int cap;
+  bool failed;          // out of memory
+} wordList_t;
+
+// index_save's output: each line is formatted straight into buf, which is
+//   written out whenever the next piece might not fit
+typedef struct lineWriter {
+  FILE* fp;
+  char* buf;            // WRITE_BUFFER bytes
+  size_t len;
+  posting_t* pairs;     // the current word's pairs
+  int npairs;
+  int pairCap;
+  bool failed;          // out of memory, or a write failed
+} lineWriter_t;
+
 // function prototypes
-static void index_delete_item(void* item);
-static void index_save_helper(void* fp, const char* key, void* item);
-static void counters_save_helper(void* fp, const int key, const int count);
-static void index_load_insert(index_t* idx, const char* word, FILE* fp);
+static counters_t* wordCounters(index_t* idx, const char* word,
+                                const size_t len, bool* fresh);
+static void index_save_helper(void* arg, const char* word, counters_t* ctrs);
+static void counters_save_helper(void* arg, const int key, const int count);
+static void writeLine(lineWriter_t* out, const char* word, counters_t* ctrs);
+static bool writeBytes(lineWriter_t* out, const char* data, const size_t len);
+static bool flushWriter(lineWriter_t* out);
+static char* formatInt(char* p, const int value);
+static bool sortWords(wordEntry_t* words, const int count);
+static int compareWords(const void* a, const void* b);
+static int comparePostings(const void* a, const void* b);
+static bool sortForPrefix(index_t* idx);
+static int compareStrings(const void* a, const void* b);
+static int findPrefix(const char** sorted, const int count, const char* prefix,
+                      const size_t len, const bool past);
+static bool index_load_text(index_t* idx, const char* text, const size_t len);
+static bool index_load_insert(index_t* idx, const char* word,
+                              const size_t wordLen,
+                              const int docID, const int count,
+                              counters_t** ctrs, bool* fresh);
+static int loadSlots(const char* text, const size_t len);
+static void loadPositions(index_t* idx, const char* filename);
+static void makePosFilename(char* buf, const size_t size, const char* filename);
 
 // create a new index
 index_t* index_new(const int slots)
@@ -39,107 +138,523 @@ index_t* index_new(const int slots)
     return NULL;
   }
 
-  // creatae the hashtable for index
-  idx->table = hashtable_new(slots);
-  if (idx->table == NULL) {
+  // creatae the words for index
+  idx->words = strarena_new(slots);
+  if (idx->words == NULL) {
     free(idx);
     return NULL;
   }
+  idx->ctrs = NULL;
+  idx->ctrsCap = 0;
+  idx->slots = slots;
+  idx->positions = NULL;
+  idx->lazy = NULL;
+  idx->found = NULL;
+  idx->sorted = NULL;
+  idx->nsorted = 0;
   return idx;
 }
 
 // place a word into the index, incrementing the respective counter
 bool index_insert(index_t* idx, const char* word, const int docID)
 {
-  // bad parameters
-  if (idx == NULL || word == NULL || docID <= 0) {
+  // bad parameters, or a read-only lazy index
+  if (idx == NULL || word == NULL || docID <= 0 || idx->lazy != NULL) {
     return false;
   }
 
-  // check if word is in hashtable already
-  counters_t* ctrs = hashtable_find(idx->table, word);
+  // find the word's counters, made if the word is new
+  bool fresh;
+  counters_t* ctrs = wordCounters(idx, word, strlen(word), &fresh);
   if (ctrs == NULL) {
-    // word not found so make a counters
-    counters_t* newCtrs = counters_new();
-    if (newCtrs == NULL) {
-      return false; // failed to create
-    }
-    
-    // insert into hashtable
-    if (!hashtable_insert(idx->table, word, newCtrs)) {
-      counters_delete(newCtrs);
-      return false;
+    return false; // failed to create
+  }
+
+  //increment docID value
+  counters_add(ctrs, docID);
+  return true;
+}
+
+// set a word's counter at docID, as index_insert but to a known count
+bool index_set(index_t* idx, const char* word, const int docID,
+               const int count)
+{
+  if (idx == NULL || word == NULL || docID <= 0 || count <= 0
+      || idx->lazy != NULL) {
+    return false;
+  }
+  bool fresh;
+  counters_t* ctrs = wordCounters(idx, word, strlen(word), &fresh);
+  return ctrs != NULL && counters_set(ctrs, docID, count);
+}
+
+/*
+ * Helper function called by index_insert and index_load_insert
+ *   Returns the counters of the word of len bytes, interning the word and
+ *   making it empty counters if it is new (*fresh says whether it was).
+ *   Returns NULL if out of memory
+ */
+static counters_t* wordCounters(index_t* idx, const char* word,
+                                const size_t len, bool* fresh)
+{
+  int w = strarena_intern(idx->words, word, len);
+  if (w < 0) {
+    return NULL;
+  }
+  if (w >= idx->ctrsCap) {
+    int cap = (idx->ctrsCap == 0) ? 1024 : idx->ctrsCap * 2;
+    counters_t** grown = realloc(idx->ctrs, cap * sizeof(counters_t*));
+    if (grown == NULL) {
+      return NULL;
     }
+    memset(grown + idx->ctrsCap, 0, (cap - idx->ctrsCap) * sizeof(counters_t*));
+    idx->ctrs = grown;
+    idx->ctrsCap = cap;
+  }
+  *fresh = (idx->ctrs[w] == NULL);
+  if (*fresh) {
+    idx->ctrs[w] = counters_new();
+  }
+  return idx->ctrs[w];
+}
 
-    //increment docID value
-    counters_add(newCtrs, docID);
-  } else {
-    // word was found
-    counters_add(ctrs, docID);
+// turns on the positional layer
+bool index_enablePositions(index_t* idx)
+{
+  if (idx == NULL) {
+    return false;
+  }
+  if (idx->positions == NULL) {
+    idx->positions = posindex_new(idx->slots);
+  }
+  return idx->positions != NULL;
+}
+
+// place a word into the index, along with its position if tracked
+bool index_insertAt(index_t* idx, const char* word, const int docID,
+                    const int position)
+{
+  if (!index_insert(idx, word, docID)) {
+    return false;
+  }
+  if (idx->positions != NULL) {
+    return posindex_insert(idx->positions, word, docID, position);
   }
   return true;
 }
 
+// is there a positional layer?
+bool index_hasPositions(index_t* idx)
+{
+  return idx != NULL && idx->positions != NULL;
+}
+
+// find docs containing a phrase
+counters_t* index_findPhrase(index_t* idx, char** words, const int nwords)
+{
+  if (idx == NULL || idx->positions == NULL) {
+    return NULL;
+  }
+  return posindex_phrase(idx->positions, words, nwords);
+}
+
 // checks if a word is in the index
 counters_t* index_find(index_t* idx, const char* word)
 {
   if (idx == NULL || word == NULL) {
     return NULL; // bad parameters
   }
-  return hashtable_find(idx->table, word);
+  if (idx->lazy != NULL) {
+    postings_t* list = lazyindex_find(idx->lazy, word);
+    counters_delete(idx->found);
+    idx->found = (list == NULL) ? NULL : postings_toCounters(list);
+    return idx->found;
+  }
+  int w = strarena_find(idx->words, word, strlen(word));
+  return (w < 0) ? NULL : idx->ctrs[w];
+}
+
+// a word's docIDs and counts as a new postings list
+postings_t* index_findPostings(index_t* idx, const char* word)
+{
+  if (idx == NULL || word == NULL) {
+    return NULL; // bad parameters
+  }
+  if (idx->lazy != NULL) {
+    return postings_without(lazyindex_find(idx->lazy, word), NULL, 0);
+  }
+  int w = strarena_find(idx->words, word, strlen(word));
+  return postings_fromCounters((w < 0) ? NULL : idx->ctrs[w]);
+}
+
+// calls itemfunc on every word
+void index_iterate(index_t* idx, void* arg,
+                   void (*itemfunc)(void* arg, const char* word,
+                                    counters_t* ctrs))
+{
+  if (idx == NULL || itemfunc == NULL) {
+    return;
+  }
+  if (idx->lazy != NULL) {
+    lazyindex_iterate(idx->lazy, arg, itemfunc);
+    return;
+  }
+  int nwords = strarena_count(idx->words);
+  for (int w = 0; w < nwords; w++) {
+    if (idx->ctrs[w] != NULL) {
+      itemfunc(arg, strarena_get(idx->words, w), idx->ctrs[w]);
+    }
+  }
+}
+
+// the first max words starting with prefix, in order
+int index_prefix(index_t* idx, const char* prefix, const int max, void* arg,
+                 void (*itemfunc)(void* arg, const char* word))
+{
+  if (idx == NULL || prefix == NULL || itemfunc == NULL) {
+    return 0;
+  }
+  if (idx->lazy != NULL) {
+    return lazyindex_prefix(idx->lazy, prefix, max, arg, itemfunc);
+  }
+  if (!sortForPrefix(idx)) {
+    return 0; // out of memory
+  }
+  size_t len = strlen(prefix);
+  int first = findPrefix(idx->sorted, idx->nsorted, prefix, len, false);
+  int end = findPrefix(idx->sorted, idx->nsorted, prefix, len, true);
+  for (int w = first; w < end && w - first < max; w++) {
+    itemfunc(arg, idx->sorted[w]);
+  }
+  return end - first;
+}
+
+/*
+ * Helper function called by index_prefix
+ *   sorts the words into idx->sorted unless that is up to date (words are
+ *   never removed, so it is if their number has not changed).
+ *   Returns false if out of memory
+ */
+static bool sortForPrefix(index_t* idx)
+{
+  int nwords = strarena_count(idx->words);
+  if (idx->sorted != NULL && idx->nsorted == nwords) {
+    return true;
+  }
+  const char** sorted = realloc(idx->sorted, (nwords + 1) * sizeof(char*));
+  if (sorted == NULL) {
+    return false;
+  }
+  for (int w = 0; w < nwords; w++) {
+    sorted[w] = strarena_get(idx->words, w);
+  }
+  qsort(sorted, nwords, sizeof(char*), compareStrings);
+  idx->sorted = sorted;
+  idx->nsorted = nwords;
+  return true;
+}
+
+// qsort comparison of two strings, in strcmp order
+static int compareStrings(const void* a, const void* b)
+{
+  return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+/*
+ * Binary search of the sorted words for the first that starts with the
+ *   prefix of len chars (or would, if none does), or with past, the first
+ *   after every word that starts with it
+ */
+static int findPrefix(const char** sorted, const int count, const char* prefix,
+                      const size_t len, const bool past)
+{
+  int lo = 0;
+  int hi = count;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    int c = strncmp(sorted[mid], prefix, len);
+    if (c < 0 || (past && c == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
 }
 
 // saves index to a file
-void index_save(index_t* idx, const char* filename)
+bool index_save(index_t* idx, const char* filename)
 {
   if (idx == NULL || filename == NULL) {
-    return; // bad arguments
+    return false; // bad arguments
+  }
+  if (idx->lazy != NULL) {
+    fprintf(stderr, "index_save: a lazily opened index cannot be saved\n");
+    return false;
   }
 
   FILE* fp = fopen(filename, "w");
   if (fp == NULL) {
     fprintf(stderr, "index_save: cannot open file '%s'\n", filename);
-    return;
+    return false;
   }
 
-  // iterate through hashtable for printing
-  hashtable_iterate(idx->table, fp, index_save_helper);
-  fclose(fp);
+  // every word, in order
+  wordList_t list = { 0 };
+  index_iterate(idx, &list, index_save_helper);
+  bool failed = list.failed || !sortWords(list.words, list.count);
+
+  // each word's line formatted straight into a big buffer, written when full
+  lineWriter_t out = { fp, NULL, 0, NULL, 0, 0, failed };
+  if (!failed) {
+    out.buf = malloc(WRITE_BUFFER);
+    out.failed = (out.buf == NULL);
+  }
+  for (int w = 0; w < list.count && !out.failed; w++) {
+    writeLine(&out, list.words[w].word, list.words[w].ctrs);
+  }
+  failed = !flushWriter(&out);
+  free(out.buf);
+  free(out.pairs);
+  free(list.words);
+  failed = (fclose(fp) != 0) || failed;
+  if (failed) {
+    fprintf(stderr, "index_save: cannot write file '%s'\n", filename);
+  }
+
+  // positions go in a file of their own; drop any stale one otherwise
+  char posFilename[1024];
+  makePosFilename(posFilename, sizeof(posFilename), filename);
+  if (idx->positions != NULL) {
+    failed = !posindex_save(idx->positions, posFilename) || failed;
+  } else {
+    remove(posFilename);
+  }
+  return !failed;
 }
 
 /*
- * Called by hashtable_iterate in the index_save function
- *   prints the word and iterates through counters.
+ * Called by index_iterate in the index_save function
+ *   adds the word and its counters to the list to be sorted
  */
-static void index_save_helper(void* arg, const char* key, void* item)
+static void index_save_helper(void* arg, const char* word, counters_t* ctrs)
 {
-  FILE* fp = arg;
-  counters_t* ctrs = item;
-  if (fp == NULL || key == NULL || ctrs == NULL) {
-    return; // bad args
+  wordList_t* list = arg;
+  if (word == NULL || ctrs == NULL || list->failed) {
+    return; // bad args, or out of memory already
+  }
+  if (list->count == list->cap) {
+    int cap = (list->cap == 0) ? 1024 : list->cap * 2;
+    wordEntry_t* words = realloc(list->words, cap * sizeof(wordEntry_t));
+    if (words == NULL) {
+      list->failed = true;
+      return;
+    }
+    list->words = words;
+    list->cap = cap;
   }
 
-  // print word
-  fprintf(fp, "%s", key);
-
-  // call docID-pair printer
-  counters_iterate(ctrs, fp, counters_save_helper);
-
-  // end line
-  fprintf(fp, "\n");
+  wordEntry_t* entry = &list->words[list->count++];
+  entry->prefix = 0;
+  for (int i = 0; i < 8 && word[i] != '\0'; i++) {
+    entry->prefix |= (uint64_t)(unsigned char)word[i] << (56 - 8 * i);
+  }
+  entry->word = word;
+  entry->ctrs = ctrs;
 }
 
 /*
- * Called by index_save_helper to go through counters in index
- *   prints docID-count pairs to show how many times words show up in files
+ * Called by writeLine through counters_iterate
+ *   gathers the word's docID-count pairs
  */
 static void counters_save_helper(void* arg, const int key, const int count)
 {
-  FILE* fp = arg;
-  if (fp == NULL) {
+  lineWriter_t* out = arg;
+  if (out->failed) {
     return;
   }
-  fprintf(fp, " %d %d", key, count);
+  if (out->npairs == out->pairCap) {
+    int cap = (out->pairCap == 0) ? 64 : out->pairCap * 2;
+    posting_t* pairs = realloc(out->pairs, cap * sizeof(posting_t));
+    if (pairs == NULL) {
+      out->failed = true;
+      return;
+    }
+    out->pairs = pairs;
+    out->pairCap = cap;
+  }
+  out->pairs[out->npairs].docID = key;
+  out->pairs[out->npairs].count = count;
+  out->npairs++;
+}
+
+// formats "word docID count [docID count]...\n", docIDs in order, into the
+//   writer's buffer; out->failed says if it could not
+static void writeLine(lineWriter_t* out, const char* word, counters_t* ctrs)
+{
+  out->npairs = 0;
+  counters_iterate(ctrs, out, counters_save_helper);
+
+  // counters give docIDs in the order they were added, usually increasing
+  for (int i = 1; i < out->npairs; i++) {
+    if (out->pairs[i - 1].docID > out->pairs[i].docID) {
+      qsort(out->pairs, out->npairs, sizeof(posting_t), comparePostings);
+      break;
+    }
+  }
+
+  if (!writeBytes(out, word, strlen(word))) {
+    return;
+  }
+
+  // the buffer is written out whenever it may not hold another pair and
+  //   the newline, so a line of any length fits
+  const size_t most = 2 * (MAX_INT_DIGITS + 1) + 1;
+  char* p = out->buf + out->len;
+  char* limit = out->buf + WRITE_BUFFER - most;
+  for (int i = 0; ; i++) {
+    if (p > limit) {
+      out->len = p - out->buf;
+      if (!flushWriter(out)) {
+        return;
+      }
+      p = out->buf;
+    }
+    if (i == out->npairs) {
+      break;
+    }
+    *p++ = ' ';
+    p = formatInt(p, out->pairs[i].docID);
+    *p++ = ' ';
+    p = formatInt(p, out->pairs[i].count);
+  }
+  *p++ = '\n';
+  out->len = p - out->buf;
+}
+
+// copies len bytes into the writer's buffer, or writes them straight out
+//   if they are more than it holds; false if a write failed
+static bool writeBytes(lineWriter_t* out, const char* data, const size_t len)
+{
+  if (out->len + len > WRITE_BUFFER && !flushWriter(out)) {
+    return false;
+  }
+  if (len > WRITE_BUFFER) {
+    out->failed = fwrite(data, 1, len, out->fp) != len;
+  } else {
+    memcpy(out->buf + out->len, data, len);
+    out->len += len;
+  }
+  return !out->failed;
+}
+
+// writes out and empties the writer's buffer; false if any write failed
+static bool flushWriter(lineWriter_t* out)
+{
+  if (!out->failed && out->len > 0) {
+    out->failed = fwrite(out->buf, 1, out->len, out->fp) != out->len;
+  }
+  out->len = 0;
+  return !out->failed;
+}
+
+// writes value in decimal at p, returning the end; no printf to parse
+static char* formatInt(char* p, const int value)
+{
+  char digits[MAX_INT_DIGITS];
+  int n = 0;
+  unsigned int v = (value < 0) ? -(unsigned int)value : (unsigned int)value;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  if (value < 0) {
+    *p++ = '-';
+  }
+  while (n > 0) {
+    *p++ = digits[--n];
+  }
+  return p;
+}
+
+/*
+ * Sorts words in strcmp order: a radix sort on the prefixes, a byte at a
+ *   time from the last, then qsort for any run of words sharing all 8
+ *   bytes. Few words do, so this costs a handful of sequential passes
+ *   rather than qsort's many string compares all over memory.
+ *
+ * Returns false if out of memory
+ */
+static bool sortWords(wordEntry_t* words, const int count)
+{
+  if (count < 256) {
+    if (count > 1) {
+      qsort(words, count, sizeof(wordEntry_t), compareWords);
+    }
+    return true;
+  }
+
+  wordEntry_t* spare = malloc(count * sizeof(wordEntry_t));
+  if (spare == NULL) {
+    return false;
+  }
+  wordEntry_t* from = words;
+  wordEntry_t* to = spare;
+  for (int shift = 0; shift < 64; shift += 8) {
+    int buckets[257] = { 0 };
+    for (int i = 0; i < count; i++) {
+      buckets[((from[i].prefix >> shift) & 0xff) + 1]++;
+    }
+    if (buckets[((from[0].prefix >> shift) & 0xff) + 1] == count) {
+      continue; // every word has the same byte here
+    }
+    for (int b = 1; b < 257; b++) {
+      buckets[b] += buckets[b - 1];
+    }
+    for (int i = 0; i < count; i++) {
+      to[buckets[(from[i].prefix >> shift) & 0xff]++] = from[i];
+    }
+    wordEntry_t* swap = from;
+    from = to;
+    to = swap;
+  }
+  if (from != words) {
+    memcpy(words, from, count * sizeof(wordEntry_t));
+  }
+  free(spare);
+
+  // words sharing a prefix
+  for (int start = 0; start < count; ) {
+    int end = start + 1;
+    while (end < count && words[end].prefix == words[start].prefix) {
+      end++;
+    }
+    if (end - start > 1) {
+      qsort(words + start, end - start, sizeof(wordEntry_t), compareWords);
+    }
+    start = end;
+  }
+  return true;
+}
+
+// words by strcmp, for qsort; the prefixes order words as strcmp does
+//   unless they are equal
+static int compareWords(const void* a, const void* b)
+{
+  const wordEntry_t* x = a;
+  const wordEntry_t* y = b;
+  if (x->prefix != y->prefix) {
+    return (x->prefix > y->prefix) ? 1 : -1;
+  }
+  return strcmp(x->word, y->word);
+}
+
+// pairs by docID, for qsort
+static int comparePostings(const void* a, const void* b)
+{
+  int x = ((const posting_t*)a)->docID;
+  int y = ((const posting_t*)b)->docID;
+  return (x > y) - (x < y);
 }
 
 // Generates an index from a properly formatted file
@@ -148,55 +663,199 @@ index_t* index_load(const char* filename)
   if (filename == NULL) {
     return NULL;
   }
-  FILE* fp = fopen(filename, "r");
-  if (fp == NULL) {
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
     return NULL;
   }
-
-  // Do not know number of words in file, but can assume 500 is sufficient as it is
-  //   default set in indexer
-  index_t* idx = index_new(500);
-  if (idx == NULL) {
-    fclose(fp);
-    return NULL; // failed to intialize
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
   }
 
-  // read one word, followed by pairs of docID and count
+  // the whole file at once; an empty one cannot be mapped, but is empty
+  size_t len = st.st_size;
+  char* text = NULL;
+  if (len > 0) {
+    text = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (text == MAP_FAILED) {
+      fprintf(stderr, "index_load: cannot map '%s'\n", filename);
+      close(fd);
+      return NULL;
+    }
+    madvise(text, len, MADV_SEQUENTIAL);
+  }
+  close(fd);
 
-  
-  char word[200]; // max word size of 200 chars
-  while (fscanf(fp, "%s", word) == 1) {
-    index_load_insert(idx, word, fp);
+  // about one word per line
+  index_t* idx = index_new(loadSlots(text, len));
+  bool ok = (idx != NULL) && index_load_text(idx, text, len);
+  if (len > 0) {
+    munmap(text, len);
+  }
+  if (!ok) {
+    index_delete(idx);
+    return NULL; // failed to intialize
   }
+  loadPositions(idx, filename);
+  return idx;
+}
 
-  fclose(fp);
+// Opens an index file, reading each word only when it is looked up
+index_t* index_open(const char* filename, const size_t cacheBytes)
+{
+  if (filename == NULL) {
+    return NULL;
+  }
+  index_t* idx = index_new(1); // never inserted into
+  if (idx == NULL) {
+    return NULL;
+  }
+  idx->lazy = lazyindex_open(filename, cacheBytes);
+  if (idx->lazy == NULL) {
+    index_delete(idx);
+    return NULL;
+  }
+  loadPositions(idx, filename);
   return idx;
 }
 
 /*
- * Helper function called by index_load 
- *   Reads the the pairs of docID and count
+ * Helper function called by index_load and index_open
+ *   picks up the positional layer if one was saved beside filename
  */
-static void index_load_insert(index_t* idx, const char* word, FILE* fp)
+static void loadPositions(index_t* idx, const char* filename)
 {
+  char posFilename[1024];
+  makePosFilename(posFilename, sizeof(posFilename), filename);
+  FILE* posFp = fopen(posFilename, "r");
+  if (posFp != NULL) {
+    fclose(posFp);
+    idx->positions = posindex_load(posFilename);
+    if (idx->positions == NULL) {
+      fprintf(stderr, "index_load: ignoring unreadable '%s'\n", posFilename);
+    }
+  }
+}
+
+/*
+ * Helper function called by index_load
+ *   Scans the text: a word, then pairs of docID and count for as long as
+ *   the next token is a number. Lines do not matter, as with fscanf.
+ *   Returns false if out of memory
+ */
+static bool index_load_text(index_t* idx, const char* text, const size_t len)
+{
+  const char* p = text;
+  const char* end = text + len;
+
   while (true) {
-    int docID, count;
-    int nread = fscanf(fp, "%d %d", &docID, &count);
-    if (nread != 2) {
-      break; // line is out of words
+    while (p < end && isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (p == end) {
+      break;
     }
 
-    counters_t* ctrs = hashtable_find(idx->table, word);
-    if (ctrs == NULL) {
-      // new counters for this word
-      ctrs = counters_new();
-      hashtable_insert(idx->table, word, ctrs);
+    // the word runs to the next space
+    const char* word = p;
+    while (p < end && !isspace((unsigned char)*p)) {
+      p++;
     }
+    size_t wordLen = p - word;
 
-    for (int i = 0; i < count; i++) {
-      counters_add(ctrs, docID);
+    // its pairs
+    counters_t* ctrs = NULL;
+    bool fresh = false;
+    while (true) {
+      int docID, count;
+      const char* next = index_scanInt(p, end, &docID);
+      if (next == NULL) {
+        break; // not a number: the next word
+      }
+      next = index_scanInt(next, end, &count);
+      if (next == NULL) {
+        break; // a docID with no count: read it as the next word
+      }
+      p = next;
+      if (!index_load_insert(idx, word, wordLen, docID, count, &ctrs, &fresh)) {
+        return false;
+      }
+    }
+  }
+  return true;
+}
+
+/*
+ * Helper function called by index_load_text
+ *   Adds count to word's docID. ctrs caches the word's counters across its
+ *   pairs; while the counters are fresh (new on this word's line) its
+ *   docIDs are all new, so there is no count to add to.
+ *   Returns false if out of memory
+ */
+static bool index_load_insert(index_t* idx, const char* word,
+                              const size_t wordLen,
+                              const int docID, const int count,
+                              counters_t** ctrs, bool* fresh)
+{
+  if (docID <= 0 || count <= 0) {
+    return true; // skipped
+  }
+  if (*ctrs == NULL) {
+    *ctrs = wordCounters(idx, word, wordLen, fresh);
+    if (*ctrs == NULL) {
+      return false;
     }
   }
+  int old = *fresh ? 0 : counters_get(*ctrs, docID);
+  return counters_set(*ctrs, docID, old + count);
+}
+
+// one docID or count of an index line (lazyindex reads lines with it too)
+const char* index_scanInt(const char* p, const char* end, int* value)
+{
+  while (p < end && isspace((unsigned char)*p)) {
+    p++;
+  }
+  bool negative = (p < end && *p == '-');
+  if (negative) {
+    p++;
+  }
+  if (p == end || !isdigit((unsigned char)*p)) {
+    return NULL;
+  }
+  long v = 0;
+  while (p < end && isdigit((unsigned char)*p)) {
+    v = v * 10 + (*p++ - '0');
+    if (v > INT_MAX) {
+      return NULL;
+    }
+  }
+  if (p < end && !isspace((unsigned char)*p)) {
+    return NULL; // "12abc" is not a number
+  }
+  *value = negative ? -(int)v : (int)v;
+  return p;
+}
+
+/*
+ * Slots for the words of an index file: one per line, at least 500 (the
+ *   indexer's own smallest) and at most 2^20
+ */
+static int loadSlots(const char* text, const size_t len)
+{
+  size_t lines = 0;
+  for (const char* p = text; p != NULL && p < text + len; p++) {
+    p = memchr(p, '\n', text + len - p);
+    if (p == NULL) {
+      break;
+    }
+    lines++;
+  }
+  if (lines < 500) {
+    return 500;
+  }
+  return (lines > (1 << 20)) ? (1 << 20) : (int)lines;
 }
 
 // deletes the index
@@ -205,18 +864,21 @@ void index_delete(index_t* idx)
   if (idx == NULL) {
     return;
   }
-  hashtable_delete(idx->table, index_delete_item);
+  int nwords = strarena_count(idx->words);
+  for (int w = 0; w < nwords; w++) {
+    counters_delete(idx->ctrs[w]);
+  }
+  free(idx->ctrs);
+  free(idx->sorted);
+  strarena_delete(idx->words);
+  posindex_delete(idx->positions);
+  lazyindex_delete(idx->lazy);
+  counters_delete(idx->found);
   free(idx);
 }
 
-/*
- * Helper function called by index_delete that removes the counters in index
- */
-static void index_delete_item(void* item)
+// the positional layer of "filename" lives in "filename.pos"
+static void makePosFilename(char* buf, const size_t size, const char* filename)
 {
-  if (item == NULL) {
-    return;
-  }
-  // item is a counters
-  counters_delete(item);
+  snprintf(buf, size, "%s.pos", filename);
 }
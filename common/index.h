@@ -6,6 +6,7 @@
 #include <stdbool.h>
 #include "../libcs50/hashtable.h"
 #include "../libcs50/counters.h"
+#include "postings.h"
 
 // makes struct for index
 typedef struct index index_t;
@@ -28,6 +29,52 @@ index_t* index_new(const int slots);
  */
 bool index_insert(index_t* idx, const char* word, const int docID);
 
+/*
+ * The user gives a pointer to an index, a word, a docID and a count
+ *
+ * The word's counter at docID is set to count, the word added if it is new,
+ *   as when the count is already known (merging indexes, say)
+ *
+ * We return true on successful execution and false otherwise
+ */
+bool index_set(index_t* idx, const char* word, const int docID,
+               const int count);
+
+/*
+ * The user gives a pointer to an index
+ *
+ * Turns on the optional positional layer (see posindex.h): from now on
+ *   index_insertAt records where each word occurs, index_save writes the
+ *   positions to "filename.pos" and index_findPhrase can be used.
+ *
+ * We return true on success (or if positions were already on), false otherwise
+ */
+bool index_enablePositions(index_t* idx);
+
+/*
+ * Like index_insert, but also records that the word is the position'th word
+ *   of docID when the positional layer is on (ignored otherwise).
+ *
+ * We return true on successful execution and false otherwise
+ */
+bool index_insertAt(index_t* idx, const char* word, const int docID,
+                    const int position);
+
+/*
+ * We return true if the index has a positional layer
+ */
+bool index_hasPositions(index_t* idx);
+
+/*
+ * The user gives a pointer to an index with positions, and an array of
+ *   nwords normalized words
+ *
+ * We return a new counters mapping docID to the number of times the words
+ *   occur as a phrase in that doc, or NULL if the index has no positions
+ *   (or on error). The caller must counters_delete() the result.
+ */
+counters_t* index_findPhrase(index_t* idx, char** words, const int nwords);
+
 /*
  * The user gives a pointer to an index, and a word
  *
@@ -35,25 +82,90 @@ bool index_insert(index_t* idx, const char* word, const int docID);
  */
 counters_t* index_find(index_t* idx, const char* word);
 
+/*
+ * The user gives a pointer to an index, and a word
+ *
+ * We return a new postings list of the word's docIDs and counts (empty if
+ *   it is not in the index), or NULL on bad parameters or out of memory.
+ *   The caller must postings_delete() the result. From an index_open index
+ *   this is a copy of the decoded list, with no counters made on the way.
+ */
+postings_t* index_findPostings(index_t* idx, const char* word);
+
+/*
+ * The user gives a pointer to an index, a prefix, a max, an arg, and an
+ *   itemfunc
+ *
+ * itemfunc is called with arg on each of the first max words (in strcmp
+ *   order) that start with prefix; the word does not outlive the call.
+ *
+ * We return how many words start with prefix, which may be more than max
+ */
+int index_prefix(index_t* idx, const char* prefix, const int max, void* arg,
+                 void (*itemfunc)(void* arg, const char* word));
+
+/*
+ * The user gives a pointer to an index, an arg, and an itemfunc
+ *
+ * itemfunc is called with arg on every word and its counters, in no
+ *   particular order. The counters belong to the index.
+ */
+void index_iterate(index_t* idx, void* arg,
+                   void (*itemfunc)(void* arg, const char* word,
+                                    counters_t* ctrs));
+
 /*
  * The user provides an index and a filename
  *   The entire index is saved to a file one line per word
  *     word docID count [docID count ...]
+ *   with the words in strcmp order and each word's docIDs increasing, so
+ *   the same index always gives the same file
  *
- * Nothing is done is file cannot be written
+ * If the index has positions they are saved alongside, in "filename.pos"
+ *
+ * We return false, having said why, if the file cannot be written
  */
-void index_save(index_t* idx, const char* filename);
+bool index_save(index_t* idx, const char* filename);
 
 /*
  * The user provides a filename which is assumed to be generated by the
  *   index_save function (not extensively errorchecked.
  *
+ * If "filename.pos" exists, the positional layer is loaded from it as well
+ *
  * Returns NULL on any file reading or memory error
  *
  * Otherwise returns a pointer to the created index
  */
 index_t* index_load(const char* filename);
 
+/*
+ * The user provides a filename generated by index_save, and how many bytes
+ *   of words' counters to keep in memory.
+ *
+ * Like index_load, but only the file's lexicon is read (see lazyindex.h):
+ *   a word's counters are read from the file when index_find first asks
+ *   for them, and cached, least recently used going first once the cache
+ *   is over cacheBytes. The counters index_find returns then stay valid
+ *   only until the next index_find.
+ *
+ * The index is read-only: index_insert fails and index_save does nothing.
+ *
+ * Returns NULL on any file reading or memory error, or a pointer to the index
+ */
+index_t* index_open(const char* filename, const size_t cacheBytes);
+
+/*
+ * The user provides a pointer into an index file's text and the end of it
+ *   (which need not be NUL-terminated)
+ *
+ * We skip spaces, then read a decimal int into value. We return the end of
+ *   the number, or NULL if there is not one, it is followed by something
+ *   other than a space, or it is too big for an int. index_load and
+ *   lazyindex read every docID and count with it.
+ */
+const char* index_scanInt(const char* p, const char* end, int* value);
+
 /*
  * Delete the index, free allocated memory
  */
@@ -0,0 +1,318 @@
+/* intersect.c - CS50 TSE sorted-array intersection
+ *
+ * The vector kernels work a block of a against a block of b: every value of
+ *   a's block is compared with every value of b's, by comparing a's block
+ *   with b's rotated a lane at a time (_mm_alignr_epi8 of b with itself),
+ *   which gives a mask of a's values found in b's block. The mask picks one
+ *   of 256 byte shuffles that packs those values to the front, and all 8
+ *   lanes are stored, the count moving on by the matches only. Then the
+ *   block whose last value is smaller is replaced by the next one (both, if
+ *   the last values are equal), as none of its values can be in any later
+ *   block of the other array. What is left when either array has no whole
+ *   block more is merged.
+ *
+ * Full and extensive documentation is in intersect.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "intersect.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define INTERSECT_X86
+#endif
+
+// a kernel that intersects two arrays
+typedef int (*kernel_t)(const uint16_t* a, const int na, const uint16_t* b,
+                        const int nb, uint16_t* out);
+
+// function prototypes
+#ifdef INTERSECT_X86
+static int intersectSsse3(const uint16_t* a, const int na, const uint16_t* b,
+                          const int nb, uint16_t* out);
+static int intersectAvx2(const uint16_t* a, const int na, const uint16_t* b,
+                         const int nb, uint16_t* out);
+#endif
+
+// the vector kernel in use, and its name
+static kernel_t vectorKernel = intersect_merge;
+static const char* kernelName = "scalar";
+
+#ifdef INTERSECT_X86
+// for each mask of 8 lanes, the byte shuffle packing those lanes first
+static uint8_t packShuffles[256][16];
+#endif
+
+// make the shuffles, and pick the best kernel the CPU has, before main runs
+__attribute__((constructor))
+static void pickKernel(void)
+{
+#ifdef INTERSECT_X86
+  for (int mask = 0; mask < 256; mask++) {
+    int n = 0;
+    for (int lane = 0; lane < 8; lane++) {
+      if (mask & (1 << lane)) {
+        packShuffles[mask][n++] = 2 * lane;
+        packShuffles[mask][n++] = 2 * lane + 1;
+      }
+    }
+    while (n < 16) {
+      packShuffles[mask][n++] = 0x80; // zero
+    }
+  }
+#endif
+  if (!intersect_useKernel("avx2")) {
+    intersect_useKernel("ssse3");
+  }
+}
+
+// gallop into the longer array when it is far longer, else the vector kernel
+int intersect(const uint16_t* a, const int na, const uint16_t* b,
+              const int nb, uint16_t* out)
+{
+  if (na <= 0 || nb <= 0) {
+    return 0;
+  }
+  if (na / INTERSECT_SKEW >= nb || nb / INTERSECT_SKEW >= na) {
+    return intersect_gallop(a, na, b, nb, out);
+  }
+  return vectorKernel(a, na, b, nb, out);
+}
+
+// step through whichever array is behind
+int intersect_merge(const uint16_t* a, const int na, const uint16_t* b,
+                    const int nb, uint16_t* out)
+{
+  int i = 0;
+  int j = 0;
+  int n = 0;
+  while (i < na && j < nb) {
+    if (a[i] < b[j]) {
+      i++;
+    } else if (a[i] > b[j]) {
+      j++;
+    } else {
+      out[n++] = a[i];
+      i++;
+      j++;
+    }
+  }
+  return n;
+}
+
+// seek each value of the shorter array in the longer, from the last found
+int intersect_gallop(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, uint16_t* out)
+{
+  if (na > nb) {
+    return intersect_gallop(b, nb, a, na, out);
+  }
+  int n = 0;
+  int lo = 0;
+  for (int i = 0; i < na && lo < nb; i++) {
+    uint16_t value = a[i];
+    if (b[lo] < value) {
+      // b[lo] < value: find hi with b[hi] >= value, or the end
+      int step = 1;
+      int hi = lo + step;
+      while (hi < nb && b[hi] < value) {
+        lo = hi;
+        step *= 2;
+        hi = lo + step;
+      }
+      if (hi > nb) {
+        hi = nb;
+      }
+      lo++;
+      while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (b[mid] < value) {
+          lo = mid + 1;
+        } else {
+          hi = mid;
+        }
+      }
+    }
+    if (lo < nb && b[lo] == value) {
+      out[n++] = value;
+      lo++;
+    }
+  }
+  return n;
+}
+
+// the kernel chosen
+int intersect_vector(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, uint16_t* out)
+{
+  if (na <= 0 || nb <= 0) {
+    return 0;
+  }
+  return vectorKernel(a, na, b, nb, out);
+}
+
+// switch kernels, if the CPU can run them
+bool intersect_useKernel(const char* name)
+{
+  if (name == NULL) {
+    return false;
+  }
+  if (strcmp(name, "scalar") == 0) {
+    vectorKernel = intersect_merge;
+    kernelName = "scalar";
+    return true;
+  }
+#ifdef INTERSECT_X86
+  __builtin_cpu_init();
+  if (strcmp(name, "ssse3") == 0 && __builtin_cpu_supports("ssse3")
+      && __builtin_cpu_supports("popcnt")) {
+    vectorKernel = intersectSsse3;
+    kernelName = "ssse3";
+    return true;
+  }
+  if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")
+      && __builtin_cpu_supports("popcnt")) {
+    vectorKernel = intersectAvx2;
+    kernelName = "avx2";
+    return true;
+  }
+#endif
+  return false;
+}
+
+// the kernel's name
+const char* intersect_kernel(void)
+{
+  return kernelName;
+}
+
+#ifdef INTERSECT_X86
+// lanes of va equal to any lane of vb, rotated r lanes
+#define MATCH_ROTATED(eq, va, vb, r) \
+  eq = _mm_or_si128(eq, _mm_cmpeq_epi16(va, _mm_alignr_epi8(vb, vb, 2 * (r))))
+#define MATCH_ROTATED256(eq, va, vb, r) \
+  eq = _mm256_or_si256(eq, _mm256_cmpeq_epi16(va, \
+                                              _mm256_alignr_epi8(vb, vb, 2 * (r))))
+
+// blocks of 8 against 8
+__attribute__((target("ssse3,popcnt")))
+static int intersectSsse3(const uint16_t* a, const int na, const uint16_t* b,
+                          const int nb, uint16_t* out)
+{
+  const int stopA = na & ~7;
+  const int stopB = nb & ~7;
+  int i = 0;
+  int j = 0;
+  int n = 0;
+  if (stopA > 0 && stopB > 0) {
+    __m128i va = _mm_loadu_si128((const __m128i*)a);
+    __m128i vb = _mm_loadu_si128((const __m128i*)b);
+    while (true) {
+      __m128i eq = _mm_cmpeq_epi16(va, vb);
+      MATCH_ROTATED(eq, va, vb, 1);
+      MATCH_ROTATED(eq, va, vb, 2);
+      MATCH_ROTATED(eq, va, vb, 3);
+      MATCH_ROTATED(eq, va, vb, 4);
+      MATCH_ROTATED(eq, va, vb, 5);
+      MATCH_ROTATED(eq, va, vb, 6);
+      MATCH_ROTATED(eq, va, vb, 7);
+      int mask = _mm_movemask_epi8(_mm_packs_epi16(eq, _mm_setzero_si128()));
+      __m128i packed = _mm_shuffle_epi8(va,
+                         _mm_loadu_si128((const __m128i*)packShuffles[mask]));
+      _mm_storeu_si128((__m128i*)(out + n), packed);
+      n += _mm_popcnt_u32(mask);
+
+      uint16_t lastA = a[i + 7];
+      uint16_t lastB = b[j + 7];
+      if (lastA <= lastB) {
+        i += 8;
+        if (i == stopA) {
+          break;
+        }
+        va = _mm_loadu_si128((const __m128i*)(a + i));
+      }
+      if (lastB <= lastA) {
+        j += 8;
+        if (j == stopB) {
+          break;
+        }
+        vb = _mm_loadu_si128((const __m128i*)(b + j));
+      }
+    }
+  }
+  return n + intersect_merge(a + i, na - i, b + j, nb - j, out + n);
+}
+
+/*
+ * Blocks of 16 against 16: b's block is taken as its two halves, each
+ *   copied to both 128-bit lanes, as _mm256_alignr_epi8 rotates within a
+ *   lane; a's block is compared with both, rotated 0 to 7 lanes
+ */
+__attribute__((target("avx2,popcnt")))
+static int intersectAvx2(const uint16_t* a, const int na, const uint16_t* b,
+                         const int nb, uint16_t* out)
+{
+  const int stopA = na & ~15;
+  const int stopB = nb & ~15;
+  int i = 0;
+  int j = 0;
+  int n = 0;
+  if (stopA > 0 && stopB > 0) {
+    __m256i va = _mm256_loadu_si256((const __m256i*)a);
+    __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)b));
+    __m256i high = _mm256_broadcastsi128_si256(
+                     _mm_loadu_si128((const __m128i*)(b + 8)));
+    while (true) {
+      __m256i eq = _mm256_or_si256(_mm256_cmpeq_epi16(va, low),
+                                   _mm256_cmpeq_epi16(va, high));
+      for (int half = 0; half < 2; half++) {
+        __m256i vb = (half == 0) ? low : high;
+        MATCH_ROTATED256(eq, va, vb, 1);
+        MATCH_ROTATED256(eq, va, vb, 2);
+        MATCH_ROTATED256(eq, va, vb, 3);
+        MATCH_ROTATED256(eq, va, vb, 4);
+        MATCH_ROTATED256(eq, va, vb, 5);
+        MATCH_ROTATED256(eq, va, vb, 6);
+        MATCH_ROTATED256(eq, va, vb, 7);
+      }
+      __m128i eqLow = _mm256_castsi256_si128(eq);
+      __m128i eqHigh = _mm256_extracti128_si256(eq, 1);
+      int mask = _mm_movemask_epi8(_mm_packs_epi16(eqLow, eqHigh));
+      __m128i packed = _mm_shuffle_epi8(_mm256_castsi256_si128(va),
+                         _mm_loadu_si128((const __m128i*)packShuffles[mask & 0xff]));
+      _mm_storeu_si128((__m128i*)(out + n), packed);
+      n += _mm_popcnt_u32(mask & 0xff);
+      packed = _mm_shuffle_epi8(_mm256_extracti128_si256(va, 1),
+                 _mm_loadu_si128((const __m128i*)packShuffles[mask >> 8]));
+      _mm_storeu_si128((__m128i*)(out + n), packed);
+      n += _mm_popcnt_u32(mask >> 8);
+
+      uint16_t lastA = a[i + 15];
+      uint16_t lastB = b[j + 15];
+      if (lastA <= lastB) {
+        i += 16;
+        if (i == stopA) {
+          break;
+        }
+        va = _mm256_loadu_si256((const __m256i*)(a + i));
+      }
+      if (lastB <= lastA) {
+        j += 16;
+        if (j == stopB) {
+          break;
+        }
+        low = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(b + j)));
+        high = _mm256_broadcastsi128_si256(
+                 _mm_loadu_si128((const __m128i*)(b + j + 8)));
+      }
+    }
+  }
+  return n + intersect_merge(a + i, na - i, b + j, nb - j, out + n);
+}
+#endif
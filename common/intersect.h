@@ -0,0 +1,68 @@
+/* intersect.h - header file for CS50 TSE sorted-array intersection
+ *
+ * Intersections of two increasing arrays of 16-bit values, as roaring's
+ *   array containers hold the low halves of docIDs (see roaring.h); an
+ *   'and' of two rare words comes down to these.
+ *
+ *   merge    one step through either array per comparison
+ *   gallop   each value of the shorter array sought in the longer by
+ *            steps of 1, 2, 4... then a binary search; best when one array
+ *            is many times longer than the other
+ *   ssse3    blocks of 8 values of each compared all against all, with the
+ *            block of b rotated by byte shuffles, and the matches packed
+ *            together with one more shuffle
+ *   avx2     the same with blocks of 16
+ *
+ * intersect picks gallop when one array is INTERSECT_SKEW times longer or
+ *   more, else the vector kernel the CPU has.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __INTERSECT_H
+#define __INTERSECT_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// values the vector kernels may write past the result, so out must have room
+#define INTERSECT_SLACK 16
+
+// how many times longer one array must be for intersect to gallop
+#define INTERSECT_SKEW 64
+
+/*
+ * The user gives two arrays of increasing values, a of na and b of nb,
+ *   and out with room for the smaller of na and nb plus INTERSECT_SLACK.
+ *
+ * We write the values in both to out, in increasing order, and return how
+ *   many there are. The kernel is chosen by the arrays' lengths, as above.
+ */
+int intersect(const uint16_t* a, const int na, const uint16_t* b,
+              const int nb, uint16_t* out);
+
+/*
+ * The same with one method: the plain merge, galloping, and the vector
+ *   kernel in use (see intersect_useKernel; "scalar" is the merge)
+ */
+int intersect_merge(const uint16_t* a, const int na, const uint16_t* b,
+                    const int nb, uint16_t* out);
+int intersect_gallop(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, uint16_t* out);
+int intersect_vector(const uint16_t* a, const int na, const uint16_t* b,
+                     const int nb, uint16_t* out);
+
+/*
+ * Chooses the vector kernel: "scalar", "ssse3" or "avx2". The best the CPU
+ *   has is chosen to begin with; this is for comparing them. We return
+ *   false if the CPU lacks the one named.
+ */
+bool intersect_useKernel(const char* name);
+
+/*
+ * We return the name of the vector kernel in use
+ */
+const char* intersect_kernel(void);
+
+#endif // __INTERSECT_H
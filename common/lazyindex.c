@@ -0,0 +1,617 @@
+/* lazyindex.c - CS50 TSE lazily loaded index
+ *
+ * If the file has an up-to-date lexicon beside it (lexicon.h), that is
+ *   mapped and words are found in its trie, so opening reads nothing of the
+ *   index file. Otherwise the lexicon is an array of (word, line) in strcmp
+ *   order, pointing into the mapped file, so a lookup is a binary search
+ *   and opening costs one pass for the line ends. Either way a word is a
+ *   number, its place in strcmp order. A word's line is read into two
+ *   arrays, then made a postings list (postings.h): one sort if the line
+ *   was out of order, none otherwise. Decoded words sit in a cache of
+ *   entries linked from most to least recently used; each word knows its
+ *   cache entry, if any. A word on several lines (never written by
+ *   index_save, and refused by lexicon_build) has its counts added up, as
+ *   index_load does.
+ *
+ * The cache's size is an estimate: PAIR_BYTES for each docID in a word's
+ *   postings, plus WORD_BYTES for the word.
+ *
+ * Full and extensive documentation is in lazyindex.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lazyindex.h"
+#include "lexicon.h"
+#include "index.h"
+#include "postings.h"
+#include "../libcs50/counters.h"
+
+// bytes of a postings pair (a docID and a count)
+static const size_t PAIR_BYTES = 2 * sizeof(int);
+// estimated bytes of a cached word's list and cache entry
+static const size_t WORD_BYTES = 64;
+
+// one line of the index file
+typedef struct term {
+  const char* word;     // in the mapped file, not NUL-terminated
+  int len;
+} term_t;
+
+// one cached word
+typedef struct cacheEntry {
+  postings_t* list;
+  size_t bytes;
+  int term;
+  int prev;             // more recently used, or -1
+  int next;             // less recently used, or -1
+} cacheEntry_t;
+
+// defines a lazy index
+typedef struct lazyindex {
+  char* text;           // the mapped file
+  size_t len;
+  lexicon_t* lex;       // the file's lexicon, or NULL to use terms
+  term_t* terms;        // sorted by word
+  int nterms;
+  int nwords;           // distinct words
+  int* slots;           // each term's cache entry + 1, or 0
+  cacheEntry_t* cache;
+  int ncache;           // entries ever used
+  int cacheCap;
+  int freeSlot;         // a dropped entry to reuse, chained through next
+  int head;             // most recently used
+  int tail;             // least recently used
+  size_t cached;        // estimated bytes in the cache
+  size_t budget;
+  long hits;
+  long misses;
+  long dropped;
+} lazyindex_t;
+
+// function prototypes
+static bool readLexicon(lazyindex_t* lazy);
+static int compareTerms(const void* a, const void* b);
+static int compareWord(const term_t* term, const char* word, const int len);
+static int findTerm(lazyindex_t* lazy, const char* word, const int len);
+static int findPrefix(lazyindex_t* lazy, const char* prefix, const int len,
+                      const bool past);
+static const char* termWord(lazyindex_t* lazy, const int t, int* len);
+static postings_t* decodeTerm(lazyindex_t* lazy, const int t);
+static bool cacheInsert(lazyindex_t* lazy, const int t, postings_t* list);
+static void cacheUnlink(lazyindex_t* lazy, const int slot);
+static void cachePushFront(lazyindex_t* lazy, const int slot);
+static void cacheDrop(lazyindex_t* lazy, const int slot);
+
+// map the file and read its lexicon
+lazyindex_t* lazyindex_open(const char* filename, const size_t cacheBytes)
+{
+  if (filename == NULL) {
+    return NULL;
+  }
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+  lazyindex_t* lazy = calloc(1, sizeof(lazyindex_t));
+  if (lazy == NULL) {
+    close(fd);
+    return NULL;
+  }
+  lazy->len = st.st_size;
+  lazy->budget = cacheBytes;
+  lazy->freeSlot = lazy->head = lazy->tail = -1;
+
+  // an empty file cannot be mapped, but is an empty index
+  if (lazy->len > 0) {
+    lazy->text = mmap(NULL, lazy->len, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (lazy->text == MAP_FAILED) {
+      fprintf(stderr, "lazyindex: cannot map '%s'\n", filename);
+      close(fd);
+      free(lazy);
+      return NULL;
+    }
+  }
+  close(fd);
+
+  lazy->lex = lexicon_open(filename);
+  if (lazy->lex != NULL) {
+    lazy->nterms = lazy->nwords = lexicon_words(lazy->lex);
+  } else if (!readLexicon(lazy)) {
+    lazyindex_delete(lazy);
+    return NULL;
+  }
+  lazy->slots = calloc(lazy->nterms + 1, sizeof(int));
+  if (lazy->slots == NULL) {
+    lazyindex_delete(lazy);
+    return NULL;
+  }
+  return lazy;
+}
+
+/*
+ * Records where every line starts and how long its word is, then sorts
+ *   the lines by word if the file did not have them in order.
+ *   Returns false if out of memory
+ */
+static bool readLexicon(lazyindex_t* lazy)
+{
+  const char* p = lazy->text;
+  const char* end = lazy->text + lazy->len;
+  int cap = 0;
+  bool sorted = true;
+
+  if (lazy->len > 0) {
+    madvise(lazy->text, lazy->len, MADV_SEQUENTIAL);
+  }
+  while (p < end) {
+    // a line is a word, then its pairs after a space
+    const char* lineEnd = memchr(p, '\n', end - p);
+    if (lineEnd == NULL) {
+      lineEnd = end;
+    }
+    while (p < lineEnd && isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (p == lineEnd) {
+      p = (lineEnd == end) ? end : lineEnd + 1; // blank line
+      continue;
+    }
+    const char* word = p;
+    p = memchr(word, ' ', lineEnd - word);
+    if (p == NULL) {
+      p = lineEnd;
+    }
+    if (p - word > INT_MAX || lazy->nterms == INT_MAX / 2) {
+      return false; // no sensible index file
+    }
+    if (lazy->nterms == cap) {
+      cap = (cap == 0) ? 1024 : cap * 2;
+      term_t* grown = realloc(lazy->terms, cap * sizeof(term_t));
+      if (grown == NULL) {
+        return false;
+      }
+      lazy->terms = grown;
+    }
+    term_t* term = &lazy->terms[lazy->nterms++];
+    term->word = word;
+    term->len = p - word;
+    if (sorted && lazy->nterms > 1 && compareTerms(term - 1, term) > 0) {
+      sorted = false;
+    }
+    p = (lineEnd == end) ? end : lineEnd + 1;
+  }
+  if (lazy->len > 0) {
+    madvise(lazy->text, lazy->len, MADV_RANDOM);
+  }
+
+  if (!sorted) {
+    qsort(lazy->terms, lazy->nterms, sizeof(term_t), compareTerms);
+  }
+  for (int t = 0; t < lazy->nterms; t++) {
+    if (t == 0 || compareTerms(&lazy->terms[t - 1], &lazy->terms[t]) != 0) {
+      lazy->nwords++;
+    }
+  }
+  return true;
+}
+
+// qsort comparison of two lines by word, in strcmp order
+static int compareTerms(const void* a, const void* b)
+{
+  const term_t* y = b;
+  return compareWord(a, y->word, y->len);
+}
+
+// strcmp of a line's word with a word of len chars
+static int compareWord(const term_t* term, const char* word, const int len)
+{
+  int common = (term->len < len) ? term->len : len;
+  int c = memcmp(term->word, word, common);
+  if (c != 0) {
+    return c;
+  }
+  return (term->len > len) - (term->len < len);
+}
+
+// the first line for word, or -1 if none
+static int findTerm(lazyindex_t* lazy, const char* word, const int len)
+{
+  if (lazy->lex != NULL) {
+    int t = lexicon_find(lazy->lex, word, len);
+    int termLen;
+    const char* found = (t < 0) ? NULL : termWord(lazy, t, &termLen);
+    if (found == NULL || termLen != len || memcmp(found, word, len) != 0) {
+      return -1; // not there, or the lexicon does not fit the file
+    }
+    return t;
+  }
+  int lo = 0;
+  int hi = lazy->nterms;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (compareWord(&lazy->terms[mid], word, len) < 0) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo < lazy->nterms && compareWord(&lazy->terms[lo], word, len) == 0) {
+    return lo;
+  }
+  return -1;
+}
+
+// the word of term t, and its length, in the mapped file; NULL if none
+static const char* termWord(lazyindex_t* lazy, const int t, int* len)
+{
+  if (lazy->lex == NULL) {
+    *len = lazy->terms[t].len;
+    return lazy->terms[t].word;
+  }
+  size_t offset = lexicon_offset(lazy->lex, t);
+  if (offset >= lazy->len) {
+    return NULL;
+  }
+  const char* word = lazy->text + offset;
+  const char* p = word;
+  const char* end = lazy->text + lazy->len;
+  while (p < end && *p != ' ' && *p != '\n') {
+    p++;
+  }
+  *len = p - word;
+  return word;
+}
+
+// look a word up, reading it from the file if it is not cached
+postings_t* lazyindex_find(lazyindex_t* lazy, const char* word)
+{
+  if (lazy == NULL || word == NULL) {
+    return NULL;
+  }
+  size_t len = strlen(word);
+  int t = (len > INT_MAX) ? -1 : findTerm(lazy, word, len);
+  if (t < 0) {
+    return NULL;
+  }
+
+  int slot = lazy->slots[t] - 1;
+  if (slot >= 0) {
+    lazy->hits++;
+    cacheUnlink(lazy, slot);
+    cachePushFront(lazy, slot);
+    return lazy->cache[slot].list;
+  }
+
+  lazy->misses++;
+  postings_t* list = decodeTerm(lazy, t);
+  if (list == NULL || !cacheInsert(lazy, t, list)) {
+    postings_delete(list);
+    return NULL;
+  }
+  return list;
+}
+
+/*
+ * Reads the pairs of every line for the word at line t into a new postings
+ *   list. Returns NULL if out of memory
+ */
+static postings_t* decodeTerm(lazyindex_t* lazy, const int t)
+{
+  const char* fileEnd = lazy->text + lazy->len;
+  int* docIDs = NULL;
+  int* counts = NULL;
+  int n = 0;
+  int cap = 0;
+  bool failed = false;
+  for (int u = t; u < lazy->nterms
+       && (u == t || (lazy->lex == NULL
+                      && compareTerms(&lazy->terms[t], &lazy->terms[u]) == 0)); u++) {
+    int len;
+    const char* p = termWord(lazy, u, &len);
+    if (p == NULL) {
+      break;
+    }
+    p += len;
+    const char* end = memchr(p, '\n', fileEnd - p);
+    if (end == NULL) {
+      end = fileEnd;
+    }
+    while (!failed) {
+      int docID, count;
+      const char* next = index_scanInt(p, end, &docID);
+      if (next == NULL || (next = index_scanInt(next, end, &count)) == NULL) {
+        break;
+      }
+      p = next;
+      if (docID <= 0 || count <= 0) {
+        continue;
+      }
+      if (n == cap) {
+        // a line holds at most one pair for every 4 of its bytes
+        int want = (cap == 0) ? (int)((end - p) / 4 + 16) : cap * 2;
+        int* grownIDs = realloc(docIDs, want * sizeof(int));
+        if (grownIDs != NULL) {
+          docIDs = grownIDs;
+        }
+        int* grownCounts = realloc(counts, want * sizeof(int));
+        if (grownCounts != NULL) {
+          counts = grownCounts;
+        }
+        if (grownIDs == NULL || grownCounts == NULL || want <= cap) {
+          failed = true;
+          break;
+        }
+        cap = want;
+      }
+      docIDs[n] = docID;
+      counts[n] = count;
+      n++;
+    }
+  }
+  // sorts only if the lines were out of order, and adds up repeated docIDs
+  postings_t* list = failed ? NULL : postings_fromPairs(docIDs, counts, n);
+  free(docIDs);
+  free(counts);
+  return list;
+}
+
+/*
+ * Caches the postings of line t as most recently used, then drops least
+ *   recently used words until the cache is within budget; the new word
+ *   stays even if it alone is over. Returns false if out of memory
+ */
+static bool cacheInsert(lazyindex_t* lazy, const int t, postings_t* list)
+{
+  int slot = lazy->freeSlot;
+  if (slot >= 0) {
+    lazy->freeSlot = lazy->cache[slot].next;
+  } else {
+    if (lazy->ncache == lazy->cacheCap) {
+      int cap = (lazy->cacheCap == 0) ? 64 : lazy->cacheCap * 2;
+      cacheEntry_t* grown = realloc(lazy->cache, cap * sizeof(cacheEntry_t));
+      if (grown == NULL) {
+        return false;
+      }
+      lazy->cache = grown;
+      lazy->cacheCap = cap;
+    }
+    slot = lazy->ncache++;
+  }
+
+  cacheEntry_t* entry = &lazy->cache[slot];
+  entry->list = list;
+  entry->bytes = WORD_BYTES + postings_count(list) * PAIR_BYTES;
+  entry->term = t;
+  lazy->slots[t] = slot + 1;
+  lazy->cached += entry->bytes;
+  cachePushFront(lazy, slot);
+
+  while (lazy->cached > lazy->budget && lazy->tail != slot) {
+    cacheDrop(lazy, lazy->tail);
+  }
+  return true;
+}
+
+// takes an entry out of the recently used list
+static void cacheUnlink(lazyindex_t* lazy, const int slot)
+{
+  cacheEntry_t* entry = &lazy->cache[slot];
+  if (entry->prev >= 0) {
+    lazy->cache[entry->prev].next = entry->next;
+  } else {
+    lazy->head = entry->next;
+  }
+  if (entry->next >= 0) {
+    lazy->cache[entry->next].prev = entry->prev;
+  } else {
+    lazy->tail = entry->prev;
+  }
+}
+
+// makes an entry the most recently used
+static void cachePushFront(lazyindex_t* lazy, const int slot)
+{
+  cacheEntry_t* entry = &lazy->cache[slot];
+  entry->prev = -1;
+  entry->next = lazy->head;
+  if (lazy->head >= 0) {
+    lazy->cache[lazy->head].prev = slot;
+  } else {
+    lazy->tail = slot;
+  }
+  lazy->head = slot;
+}
+
+// forgets a cached word, keeping its entry for reuse
+static void cacheDrop(lazyindex_t* lazy, const int slot)
+{
+  cacheEntry_t* entry = &lazy->cache[slot];
+  cacheUnlink(lazy, slot);
+  postings_delete(entry->list);
+  entry->list = NULL;
+  lazy->slots[entry->term] = 0;
+  lazy->cached -= entry->bytes;
+  lazy->dropped++;
+  entry->next = lazy->freeSlot;
+  lazy->freeSlot = slot;
+}
+
+// every word in order, decoded for the call only
+void lazyindex_iterate(lazyindex_t* lazy, void* arg,
+                       void (*itemfunc)(void* arg, const char* word,
+                                        counters_t* ctrs))
+{
+  if (lazy == NULL || itemfunc == NULL) {
+    return;
+  }
+  char* word = NULL;
+  size_t wordCap = 0;
+  for (int t = 0; t < lazy->nterms; t++) {
+    if (lazy->lex == NULL && t > 0
+        && compareTerms(&lazy->terms[t - 1], &lazy->terms[t]) == 0) {
+      continue; // read with the word's first line
+    }
+    int len;
+    const char* termText = termWord(lazy, t, &len);
+    if (termText == NULL) {
+      break;
+    }
+    if ((size_t)len + 1 > wordCap) {
+      wordCap = 2 * ((size_t)len + 1);
+      char* grown = realloc(word, wordCap);
+      if (grown == NULL) {
+        break;
+      }
+      word = grown;
+    }
+    memcpy(word, termText, len);
+    word[len] = '\0';
+
+    bool cached = (lazy->slots[t] > 0);
+    postings_t* list = cached ? lazy->cache[lazy->slots[t] - 1].list
+                              : decodeTerm(lazy, t);
+    counters_t* ctrs = (list == NULL) ? NULL : postings_toCounters(list);
+    if (!cached) {
+      postings_delete(list);
+    }
+    if (ctrs == NULL) {
+      break;
+    }
+    itemfunc(arg, word, ctrs);
+    counters_delete(ctrs);
+  }
+  free(word);
+}
+
+// the first max words starting with prefix, from the lexicon alone
+int lazyindex_prefix(lazyindex_t* lazy, const char* prefix, const int max,
+                     void* arg, void (*itemfunc)(void* arg, const char* word))
+{
+  if (lazy == NULL || prefix == NULL || itemfunc == NULL) {
+    return 0;
+  }
+  size_t len = strlen(prefix);
+  if (len > INT_MAX) {
+    return 0;
+  }
+  int first;
+  int end;
+  if (lazy->lex != NULL) {
+    end = lexicon_prefix(lazy->lex, prefix, &first) + first;
+  } else {
+    first = findPrefix(lazy, prefix, len, false);
+    end = findPrefix(lazy, prefix, len, true);
+  }
+
+  char* word = NULL;
+  size_t wordCap = 0;
+  int total = 0;
+  for (int t = first; t < end; t++) {
+    if (lazy->lex == NULL && t > first
+        && compareTerms(&lazy->terms[t - 1], &lazy->terms[t]) == 0) {
+      continue; // a word on several lines counts once
+    }
+    if (++total > max) {
+      if (lazy->lex != NULL) {
+        total = end - first; // no repeated words in a lexicon
+        break;
+      }
+      continue;
+    }
+    int termLen;
+    const char* termText = termWord(lazy, t, &termLen);
+    if (termText == NULL) {
+      break;
+    }
+    if ((size_t)termLen + 1 > wordCap) {
+      wordCap = 2 * ((size_t)termLen + 1);
+      char* grown = realloc(word, wordCap);
+      if (grown == NULL) {
+        break;
+      }
+      word = grown;
+    }
+    memcpy(word, termText, termLen);
+    word[termLen] = '\0';
+    itemfunc(arg, word);
+  }
+  free(word);
+  return total;
+}
+
+/*
+ * Binary search of the lines for the first whose word starts with the
+ *   prefix of len chars (or would, if none does), or with past, the first
+ *   after every such line
+ */
+static int findPrefix(lazyindex_t* lazy, const char* prefix, const int len,
+                      const bool past)
+{
+  int lo = 0;
+  int hi = lazy->nterms;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    const term_t* term = &lazy->terms[mid];
+    int common = (term->len < len) ? term->len : len;
+    int c = memcmp(term->word, prefix, common);
+    if (c == 0 && term->len < len) {
+      c = -1; // a proper prefix of the prefix comes before it
+    }
+    if (c < 0 || (past && c == 0)) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo;
+}
+
+// one line about the lexicon and the cache
+void lazyindex_printStats(lazyindex_t* lazy, FILE* fp)
+{
+  if (lazy == NULL || fp == NULL) {
+    return;
+  }
+  fprintf(fp, "lazyindex: %d words (%s), %ld hits, %ld misses, %ld dropped, "
+          "cache %.1f of %.1f MB\n",
+          lazy->nwords, (lazy->lex != NULL) ? "lexicon file" : "scanned",
+          lazy->hits, lazy->misses, lazy->dropped,
+          lazy->cached / 1e6, lazy->budget / 1e6);
+}
+
+// unmap the file and free it all
+void lazyindex_delete(lazyindex_t* lazy)
+{
+  if (lazy == NULL) {
+    return;
+  }
+  for (int slot = lazy->head; slot >= 0; slot = lazy->cache[slot].next) {
+    postings_delete(lazy->cache[slot].list);
+  }
+  if (lazy->len > 0) {
+    munmap(lazy->text, lazy->len);
+  }
+  lexicon_close(lazy->lex);
+  free(lazy->terms);
+  free(lazy->slots);
+  free(lazy->cache);
+  free(lazy);
+}
@@ -0,0 +1,79 @@
+/* lazyindex.h - header file for CS50 TSE lazily loaded index
+ *
+ * Opens an index file without reading its postings. Opening maps the file
+ *   and its lexicon file (see lexicon.h) if the indexer left an up-to-date
+ *   one beside it; otherwise it builds only a lexicon: where each word's
+ *   line starts, in strcmp order (index_save already writes them so; an
+ *   older unsorted file is sorted once, in memory). A word's docIDs and counts are read from its
+ *   line the first time it is looked up and kept in a cache; once the
+ *   cache is over its budget the least recently used words are dropped.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __LAZYINDEX_H
+#define __LAZYINDEX_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "postings.h"
+#include "../libcs50/counters.h"
+
+// opaque lazily loaded index
+typedef struct lazyindex lazyindex_t;
+
+/*
+ * The user provides the name of an index file (as written by index_save)
+ *   and how many bytes of decoded postings to keep cached.
+ *
+ * We return a pointer to the lazy index, or NULL if the file cannot be read
+ *   or out of memory. The user must call lazyindex_delete.
+ */
+lazyindex_t* lazyindex_open(const char* filename, const size_t cacheBytes);
+
+/*
+ * The user gives a lazy index and a word
+ *
+ * We return the word's postings, or NULL if it is not in the index (or out
+ *   of memory). The list belongs to the cache: it stays valid until the
+ *   next lazyindex_find that has to read a word from the file.
+ */
+postings_t* lazyindex_find(lazyindex_t* lazy, const char* word);
+
+/*
+ * The user gives a lazy index, an arg, and an itemfunc
+ *
+ * itemfunc is called with arg on every word and its counters, in strcmp
+ *   order. Neither the word nor the counters outlive the call. The cache
+ *   is not filled.
+ */
+void lazyindex_iterate(lazyindex_t* lazy, void* arg,
+                       void (*itemfunc)(void* arg, const char* word,
+                                        counters_t* ctrs));
+
+/*
+ * The user gives a lazy index, a prefix, a max, an arg, and an itemfunc
+ *
+ * itemfunc is called with arg on each of the first max words (in strcmp
+ *   order) that start with prefix; the word does not outlive the call.
+ *   Nothing is decoded and the cache is not touched.
+ *
+ * We return how many words start with prefix, which may be more than max
+ */
+int lazyindex_prefix(lazyindex_t* lazy, const char* prefix, const int max,
+                     void* arg, void (*itemfunc)(void* arg, const char* word));
+
+/*
+ * Prints one line about the lexicon and the cache to fp:
+ *   words, lookups that hit and missed the cache, words dropped, and the
+ *   cache's size against its budget
+ */
+void lazyindex_printStats(lazyindex_t* lazy, FILE* fp);
+
+/*
+ * Delete the lazy index: unmap the file, free allocated memory
+ */
+void lazyindex_delete(lazyindex_t* lazy);
+
+#endif // __LAZYINDEX_H
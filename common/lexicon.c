@@ -0,0 +1,713 @@
+/* lexicon.c - CS50 TSE persisted lexicon
+ *
+ * The file is a header, the line offset of each word, the trie's nodes,
+ *   the first byte of each node's edge, and the rest of the edges' bytes:
+ *
+ *   header_t | uint64_t[words] | node_t[nodes + 1] | bytes[nodes] | labels
+ *
+ *   in the byte order of the machine that wrote it (the header says which).
+ *   Node 0 is the root. The nodes are numbered breadth first, so a node's
+ *   children follow one another, sorted by their first byte, and come
+ *   after it; their first bytes sit side by side, so finding a child looks
+ *   at a cache line or two. Edges and child lists are laid out in node
+ *   order too, so where the next node's start tells where a node's end:
+ *   no lengths are stored, and a last, empty node closes both lists.
+ *   A node is a word's end if it is a leaf, or if the first word below it
+ *   is its own (which sorts before all the others).
+ *
+ * Opening checks every node and offset once, so a damaged file is refused
+ *   rather than followed out of bounds.
+ *
+ * Full and extensive documentation is in lexicon.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <ctype.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "lexicon.h"
+
+// the first bytes of every lexicon file
+static const char MAGIC[8] = "TSELEX1\n";
+// written as a uint32_t; read back differently on a machine of other order
+static const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// the start of the file
+typedef struct header {
+  char magic[8];
+  uint32_t byteOrder;
+  uint32_t words;
+  uint32_t nodes;
+  uint32_t labelBytes;
+  uint64_t indexSize;   // the index file it was built for
+  int64_t indexSec;     // ... and its modification time
+  int64_t indexNsec;
+} header_t;
+
+// one node of the trie, and the edge into it
+typedef struct node {
+  uint32_t label;       // where the edge's bytes after the first start
+  uint32_t child;       // where its children start (end, at the next node's)
+  uint32_t first;       // number of the first word below it
+} node_t;
+
+// defines a lexicon
+typedef struct lexicon {
+  char* map;            // the whole file
+  size_t len;
+  const uint64_t* offsets;
+  const node_t* nodes;
+  const unsigned char* bytes;
+  const unsigned char* labels;
+  int words;
+} lexicon_t;
+
+// the index file's words while a lexicon is built
+typedef struct wordList {
+  const unsigned char** word;  // in the mapped index file
+  uint32_t* len;
+  uint64_t* offset;
+  int count;
+  int cap;
+} wordList_t;
+
+// the trie while it is built
+typedef struct trie {
+  node_t* nodes;
+  unsigned char* bytes;
+  uint32_t* lo;         // each node's words, lo up to hi
+  uint32_t* hi;
+  uint32_t* depth;      // ... which share their first depth bytes
+  int count;
+  int cap;
+  unsigned char* labels;
+  size_t labelBytes;
+  size_t labelCap;
+} trie_t;
+
+// function prototypes
+static void lexName(const char* indexFilename, const char* suffix,
+                    char* name, const size_t size);
+static bool readWords(const char* text, const size_t len, wordList_t* list);
+static bool buildTrie(const wordList_t* list, trie_t* trie);
+static int addNode(trie_t* trie, const unsigned char* edge, const size_t edgeLen,
+                   const uint32_t lo, const uint32_t hi, const uint32_t depth);
+static bool writeLexicon(const char* filename, const struct stat* index,
+                         const wordList_t* list, const trie_t* trie);
+static bool writeArray(FILE* fp, const void* items, const size_t size,
+                       const size_t count);
+static bool checkNodes(const lexicon_t* lex, const header_t* head,
+                       const uint64_t indexSize);
+static bool isWord(const lexicon_t* lex, const uint32_t n, const uint32_t end);
+static uint32_t childEnd(const lexicon_t* lex, const uint32_t parent,
+                         const uint32_t k, const uint32_t end);
+static int findChild(const lexicon_t* lex, const uint32_t n,
+                     const unsigned char c, const bool atLeast);
+static int compareEdge(const lexicon_t* lex, const uint32_t k,
+                       const unsigned char* str, const size_t len,
+                       size_t* edgeLen);
+static uint32_t rank(lexicon_t* lex, const unsigned char* word, const size_t len);
+
+// indexFilename with .lex and suffix after it
+static void lexName(const char* indexFilename, const char* suffix,
+                    char* name, const size_t size)
+{
+  snprintf(name, size, "%s.lex%s", indexFilename, suffix);
+}
+
+// build the lexicon of an index file
+bool lexicon_build(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return false;
+  }
+  char name[1024], tmpName[1024];
+  lexName(indexFilename, "", name, sizeof(name));
+  lexName(indexFilename, ".tmp", tmpName, sizeof(tmpName));
+
+  int fd = open(indexFilename, O_RDONLY);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    unlink(name);
+    return false;
+  }
+  char* text = NULL;
+  if (st.st_size > 0) {
+    text = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (text == MAP_FAILED) {
+      close(fd);
+      unlink(name);
+      return false;
+    }
+    madvise(text, st.st_size, MADV_SEQUENTIAL);
+  }
+  close(fd);
+
+  wordList_t list = { NULL, NULL, NULL, 0, 0 };
+  trie_t trie = { NULL, NULL, NULL, NULL, NULL, 0, 0, NULL, 0, 0 };
+  bool ok = readWords(text, st.st_size, &list)
+            && buildTrie(&list, &trie)
+            && writeLexicon(tmpName, &st, &list, &trie)
+            && rename(tmpName, name) == 0;
+  if (!ok) {
+    unlink(tmpName);
+    unlink(name);
+  }
+
+  if (text != NULL) {
+    munmap(text, st.st_size);
+  }
+  free(list.word);
+  free(list.len);
+  free(list.offset);
+  free(trie.nodes);
+  free(trie.bytes);
+  free(trie.lo);
+  free(trie.hi);
+  free(trie.depth);
+  free(trie.labels);
+  return ok;
+}
+
+/*
+ * Lists the word starting each line of text and where it starts.
+ *   Returns false if the words are not in strcmp order, each once, or out
+ *   of memory
+ */
+static bool readWords(const char* text, const size_t len, wordList_t* list)
+{
+  const char* p = text;
+  const char* end = text + len;
+  while (p < end) {
+    const char* lineEnd = memchr(p, '\n', end - p);
+    if (lineEnd == NULL) {
+      lineEnd = end;
+    }
+    while (p < lineEnd && isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (p == lineEnd) {
+      p = (lineEnd == end) ? end : lineEnd + 1; // blank line
+      continue;
+    }
+    const char* word = p;
+    const char* wordEnd = memchr(word, ' ', lineEnd - word);
+    if (wordEnd == NULL) {
+      wordEnd = lineEnd;
+    }
+    size_t wordLen = wordEnd - word;
+    if (wordLen > UINT32_MAX || list->count == INT_MAX / 2) {
+      return false;
+    }
+
+    if (list->count > 0) {
+      // strictly after the word before it
+      int last = list->count - 1;
+      size_t common = (list->len[last] < wordLen) ? list->len[last] : wordLen;
+      int c = memcmp(list->word[last], word, common);
+      if (c > 0 || (c == 0 && list->len[last] >= wordLen)) {
+        return false;
+      }
+    }
+    if (list->count == list->cap) {
+      int cap = (list->cap == 0) ? 1024 : list->cap * 2;
+      const unsigned char** words = realloc(list->word, cap * sizeof(*words));
+      if (words != NULL) {
+        list->word = words;
+      }
+      uint32_t* lens = realloc(list->len, cap * sizeof(*lens));
+      if (lens != NULL) {
+        list->len = lens;
+      }
+      uint64_t* offsets = realloc(list->offset, cap * sizeof(*offsets));
+      if (offsets != NULL) {
+        list->offset = offsets;
+      }
+      if (words == NULL || lens == NULL || offsets == NULL) {
+        return false;
+      }
+      list->cap = cap;
+    }
+    list->word[list->count] = (const unsigned char*)word;
+    list->len[list->count] = wordLen;
+    list->offset[list->count] = word - text;
+    list->count++;
+    p = (lineEnd == end) ? end : lineEnd + 1;
+  }
+  return true;
+}
+
+/*
+ * Builds the radix trie of the sorted words breadth first: each node, in
+ *   turn, splits its words by their next byte, and each group becomes a
+ *   child whose edge runs as far as the group's words agree (the first and
+ *   last of them, since they are sorted). Returns false if out of memory
+ */
+static bool buildTrie(const wordList_t* list, trie_t* trie)
+{
+  if (addNode(trie, NULL, 0, 0, list->count, 0) < 0) {
+    return false;
+  }
+  for (int n = 0; n < trie->count; n++) {
+    uint32_t lo = trie->lo[n];
+    uint32_t hi = trie->hi[n];
+    uint32_t depth = trie->depth[n];
+    if (lo < hi && list->len[lo] == depth) {
+      lo++; // the node's own word
+    }
+    trie->nodes[n].child = trie->count;
+    while (lo < hi) {
+      unsigned char c = list->word[lo][depth];
+      uint32_t group = lo + 1;
+      while (group < hi && list->word[group][depth] == c) {
+        group++;
+      }
+      const unsigned char* a = list->word[lo];
+      const unsigned char* b = list->word[group - 1];
+      uint32_t shortest = (list->len[lo] < list->len[group - 1])
+                          ? list->len[lo] : list->len[group - 1];
+      uint32_t common = depth + 1;
+      while (common < shortest && a[common] == b[common]) {
+        common++;
+      }
+      if (addNode(trie, a + depth, common - depth, lo, group, common) < 0) {
+        return false;
+      }
+      lo = group;
+    }
+  }
+  // the closing node
+  if (addNode(trie, NULL, 0, list->count, list->count, 0) < 0) {
+    return false;
+  }
+  trie->count--;
+  trie->nodes[trie->count].child = trie->count;
+  return true;
+}
+
+// a node for words lo up to hi, after the edge; its number, or -1
+static int addNode(trie_t* trie, const unsigned char* edge, const size_t edgeLen,
+                   const uint32_t lo, const uint32_t hi, const uint32_t depth)
+{
+  size_t labelLen = (edgeLen > 0) ? edgeLen - 1 : 0;
+  if (trie->count == trie->cap) {
+    if (trie->cap >= INT_MAX / 2) {
+      return -1;
+    }
+    int cap = (trie->cap == 0) ? 1024 : trie->cap * 2;
+    node_t* nodes = realloc(trie->nodes, cap * sizeof(node_t));
+    if (nodes != NULL) {
+      trie->nodes = nodes;
+    }
+    unsigned char* bytes = realloc(trie->bytes, cap);
+    if (bytes != NULL) {
+      trie->bytes = bytes;
+    }
+    uint32_t* los = realloc(trie->lo, cap * sizeof(uint32_t));
+    if (los != NULL) {
+      trie->lo = los;
+    }
+    uint32_t* his = realloc(trie->hi, cap * sizeof(uint32_t));
+    if (his != NULL) {
+      trie->hi = his;
+    }
+    uint32_t* depths = realloc(trie->depth, cap * sizeof(uint32_t));
+    if (depths != NULL) {
+      trie->depth = depths;
+    }
+    if (nodes == NULL || bytes == NULL || los == NULL || his == NULL
+        || depths == NULL) {
+      return -1;
+    }
+    trie->cap = cap;
+  }
+  if (trie->labelBytes + labelLen > trie->labelCap) {
+    size_t cap = (trie->labelCap == 0) ? 65536 : trie->labelCap * 2;
+    while (cap < trie->labelBytes + labelLen) {
+      cap *= 2;
+    }
+    if (trie->labelBytes + labelLen > UINT32_MAX) {
+      return -1;
+    }
+    unsigned char* labels = realloc(trie->labels, cap);
+    if (labels == NULL) {
+      return -1;
+    }
+    trie->labels = labels;
+    trie->labelCap = cap;
+  }
+
+  int n = trie->count++;
+  trie->nodes[n] = (node_t){ trie->labelBytes, 0, lo };
+  trie->bytes[n] = (edgeLen > 0) ? edge[0] : 0;
+  if (labelLen > 0) {
+    memcpy(trie->labels + trie->labelBytes, edge + 1, labelLen);
+  }
+  trie->labelBytes += labelLen;
+  trie->lo[n] = lo;
+  trie->hi[n] = hi;
+  trie->depth[n] = depth;
+  return n;
+}
+
+// write the header, nodes, offsets and labels; false on any error
+static bool writeLexicon(const char* filename, const struct stat* index,
+                         const wordList_t* list, const trie_t* trie)
+{
+  FILE* fp = fopen(filename, "w");
+  if (fp == NULL) {
+    return false;
+  }
+  header_t head;
+  memset(&head, 0, sizeof(head));
+  memcpy(head.magic, MAGIC, sizeof(head.magic));
+  head.byteOrder = BYTE_ORDER_MARK;
+  head.words = list->count;
+  head.nodes = trie->count;
+  head.labelBytes = trie->labelBytes;
+  head.indexSize = index->st_size;
+  head.indexSec = index->st_mtim.tv_sec;
+  head.indexNsec = index->st_mtim.tv_nsec;
+
+  size_t nodes = trie->count;
+  bool ok = writeArray(fp, &head, sizeof(head), 1)
+            && writeArray(fp, list->offset, sizeof(uint64_t), list->count)
+            && writeArray(fp, trie->nodes, sizeof(node_t), nodes + 1)
+            && writeArray(fp, trie->bytes, 1, nodes)
+            && writeArray(fp, trie->labels, 1, trie->labelBytes);
+  return (fclose(fp) == 0) && ok;
+}
+
+// fwrite count items, of which there may be none (and no array)
+static bool writeArray(FILE* fp, const void* items, const size_t size,
+                       const size_t count)
+{
+  return count == 0 || fwrite(items, size, count, fp) == count;
+}
+
+// map the lexicon of an index file, if it is there and up to date
+lexicon_t* lexicon_open(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return NULL;
+  }
+  struct stat index, st;
+  if (stat(indexFilename, &index) != 0) {
+    return NULL;
+  }
+  char name[1024];
+  lexName(indexFilename, "", name, sizeof(name));
+  int fd = open(name, O_RDONLY);
+  if (fd < 0) {
+    return NULL;
+  }
+  if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(header_t)) {
+    close(fd);
+    return NULL;
+  }
+  char* map = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return NULL;
+  }
+
+  header_t head;
+  memcpy(&head, map, sizeof(head));
+  size_t expected = sizeof(header_t) + (size_t)head.words * sizeof(uint64_t)
+                    + ((size_t)head.nodes + 1) * sizeof(node_t)
+                    + head.nodes + head.labelBytes;
+  lexicon_t* lex = NULL;
+  if (memcmp(head.magic, MAGIC, sizeof(head.magic)) == 0
+      && head.byteOrder == BYTE_ORDER_MARK
+      && head.nodes > 0 && head.words <= INT_MAX
+      && expected == (size_t)st.st_size
+      && head.indexSize == (uint64_t)index.st_size
+      && head.indexSec == index.st_mtim.tv_sec
+      && head.indexNsec == index.st_mtim.tv_nsec) {
+    lex = malloc(sizeof(lexicon_t));
+  }
+  if (lex == NULL) {
+    munmap(map, st.st_size);
+    return NULL;
+  }
+  lex->map = map;
+  lex->len = st.st_size;
+  lex->offsets = (const uint64_t*)(map + sizeof(header_t));
+  lex->nodes = (const node_t*)(lex->offsets + head.words);
+  lex->bytes = (const unsigned char*)(lex->nodes + head.nodes + 1);
+  lex->labels = lex->bytes + head.nodes;
+  lex->words = head.words;
+  if (!checkNodes(lex, &head, index.st_size)) {
+    lexicon_close(lex);
+    return NULL;
+  }
+  return lex;
+}
+
+/*
+ * Checks that the edges and child lists run in order to the closing node,
+ *   and end where the labels and nodes do; every node's children come after
+ *   it (so no walk can loop), and every offset lies in the index file
+ */
+static bool checkNodes(const lexicon_t* lex, const header_t* head,
+                       const uint64_t indexSize)
+{
+  const node_t* last = &lex->nodes[head->nodes];
+  if (lex->nodes[0].label != 0 || last->label != head->labelBytes
+      || last->child != head->nodes) {
+    return false;
+  }
+  for (uint32_t n = 0; n < head->nodes; n++) {
+    const node_t* node = &lex->nodes[n];
+    if (node->label > node[1].label || node->child > node[1].child
+        || node->child <= n || node->first > head->words) {
+      return false;
+    }
+  }
+  for (uint32_t w = 0; w < head->words; w++) {
+    if (lex->offsets[w] >= indexSize) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// how many words
+int lexicon_words(lexicon_t* lex)
+{
+  return (lex == NULL) ? 0 : lex->words;
+}
+
+// does a word end at node n, whose words end before word number end?
+static bool isWord(const lexicon_t* lex, const uint32_t n, const uint32_t end)
+{
+  const node_t* node = &lex->nodes[n];
+  return node->first < end
+         && (node[1].child == node->child
+             || lex->nodes[node->child].first > node->first);
+}
+
+// where the words below the parent's child k end; end is the parent's
+static uint32_t childEnd(const lexicon_t* lex, const uint32_t parent,
+                         const uint32_t k, const uint32_t end)
+{
+  return (k + 1 < lex->nodes[parent + 1].child) ? lex->nodes[k + 1].first : end;
+}
+
+/*
+ * The child of node n whose edge starts with c, or -1; with atLeast, the
+ *   first child whose edge starts with c or a later byte instead
+ */
+static int findChild(const lexicon_t* lex, const uint32_t n,
+                     const unsigned char c, const bool atLeast)
+{
+  uint32_t lo = lex->nodes[n].child;
+  uint32_t end = lex->nodes[n + 1].child;
+  if (!atLeast) {
+    // a node has few children, and memchr looks at many bytes at a time
+    const unsigned char* at = memchr(lex->bytes + lo, c, end - lo);
+    return (at == NULL) ? -1 : (int)(at - lex->bytes);
+  }
+  uint32_t hi = end;
+  while (lo < hi) {
+    uint32_t mid = lo + (hi - lo) / 2;
+    if (lex->bytes[mid] < c) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return (lo == end) ? -1 : (int)lo;
+}
+
+/*
+ * memcmp of node k's edge with str, over the shorter of the two; sets
+ *   *edgeLen to the edge's length
+ */
+static int compareEdge(const lexicon_t* lex, const uint32_t k,
+                       const unsigned char* str, const size_t len,
+                       size_t* edgeLen)
+{
+  const node_t* node = &lex->nodes[k];
+  *edgeLen = 1 + node[1].label - node->label;
+  if (len == 0) {
+    return 1;
+  }
+  if (lex->bytes[k] != str[0]) {
+    return (lex->bytes[k] < str[0]) ? -1 : 1;
+  }
+  size_t common = (*edgeLen < len) ? *edgeLen : len;
+  return memcmp(lex->labels + node->label, str + 1, common - 1);
+}
+
+// the number of a word, or -1
+int lexicon_find(lexicon_t* lex, const char* word, const size_t len)
+{
+  if (lex == NULL || word == NULL) {
+    return -1;
+  }
+  const unsigned char* w = (const unsigned char*)word;
+  uint32_t n = 0;
+  size_t pos = 0;
+  while (pos < len) {
+    int k = findChild(lex, n, w[pos], false);
+    size_t edgeLen;
+    if (k < 0 || compareEdge(lex, k, w + pos, len - pos, &edgeLen) != 0
+        || edgeLen > len - pos) {
+      return -1;
+    }
+    pos += edgeLen;
+    n = k;
+  }
+  // below the root there is always a word, so its end need not be known
+  return isWord(lex, n, lex->words) ? (int)lex->nodes[n].first : -1;
+}
+
+// the words starting with a prefix
+int lexicon_prefix(lexicon_t* lex, const char* prefix, int* first)
+{
+  *first = 0;
+  if (lex == NULL || prefix == NULL) {
+    return 0;
+  }
+  const unsigned char* p = (const unsigned char*)prefix;
+  size_t len = strlen(prefix);
+  uint32_t n = 0;
+  uint32_t end = lex->words;
+  size_t pos = 0;
+  while (pos < len) {
+    int k = findChild(lex, n, p[pos], false);
+    size_t edgeLen;
+    if (k < 0 || compareEdge(lex, k, p + pos, len - pos, &edgeLen) != 0) {
+      return 0;
+    }
+    pos += edgeLen; // the prefix may end inside the edge
+    end = childEnd(lex, n, k, end);
+    n = k;
+  }
+  *first = lex->nodes[n].first;
+  return end - lex->nodes[n].first;
+}
+
+// how many words sort before word
+static uint32_t rank(lexicon_t* lex, const unsigned char* word, const size_t len)
+{
+  uint32_t n = 0;
+  uint32_t end = lex->words;
+  size_t pos = 0;
+  while (pos < len) {
+    // the node's own word is a proper prefix of word, so before it
+    int k = findChild(lex, n, word[pos], true);
+    if (k < 0) {
+      return end;
+    }
+    uint32_t kEnd = childEnd(lex, n, k, end);
+    size_t edgeLen;
+    int c = compareEdge(lex, k, word + pos, len - pos, &edgeLen);
+    if (c < 0) {
+      return kEnd;
+    }
+    if (c > 0 || edgeLen > len - pos) {
+      return lex->nodes[k].first; // all after word, or word a prefix of them
+    }
+    pos += edgeLen;
+    end = kEnd;
+    n = k;
+  }
+  return lex->nodes[n].first;
+}
+
+// the words from..to
+int lexicon_range(lexicon_t* lex, const char* from, const char* to, int* first)
+{
+  *first = 0;
+  if (lex == NULL || from == NULL || to == NULL) {
+    return 0;
+  }
+  uint32_t lo = rank(lex, (const unsigned char*)from, strlen(from));
+  uint32_t hi = rank(lex, (const unsigned char*)to, strlen(to));
+  if (lexicon_find(lex, to, strlen(to)) >= 0) {
+    hi++;
+  }
+  *first = lo;
+  return (hi > lo) ? hi - lo : 0;
+}
+
+// spell out word number n
+int lexicon_word(lexicon_t* lex, const int n, char* buf, const size_t size)
+{
+  if (lex == NULL || n < 0 || n >= lex->words) {
+    return -1;
+  }
+  uint32_t node = 0;
+  uint32_t end = lex->words;
+  size_t len = 0;
+  while (!(isWord(lex, node, end) && lex->nodes[node].first == (uint32_t)n)) {
+    // the last child whose words start at or before n
+    uint32_t lo = lex->nodes[node].child;
+    uint32_t hi = lex->nodes[node + 1].child;
+    if (lo == hi || lex->nodes[lo].first > (uint32_t)n) {
+      return -1; // only in a damaged trie
+    }
+    while (hi - lo > 1) {
+      uint32_t mid = lo + (hi - lo) / 2;
+      if (lex->nodes[mid].first <= (uint32_t)n) {
+        lo = mid;
+      } else {
+        hi = mid;
+      }
+    }
+    const node_t* child = &lex->nodes[lo];
+    size_t edgeLen = 1 + child[1].label - child->label;
+    for (size_t b = 0; b < edgeLen; b++, len++) {
+      if (len + 1 < size) {
+        buf[len] = (b == 0) ? lex->bytes[lo] : lex->labels[child->label + b - 1];
+      }
+    }
+    end = childEnd(lex, node, lo, end);
+    node = lo;
+  }
+  if (size > 0) {
+    buf[(len < size) ? len : size - 1] = '\0';
+  }
+  return (len > INT_MAX) ? INT_MAX : (int)len;
+}
+
+// where word number n's line starts
+size_t lexicon_offset(lexicon_t* lex, const int n)
+{
+  if (lex == NULL || n < 0 || n >= lex->words) {
+    return 0;
+  }
+  return lex->offsets[n];
+}
+
+// size of the file
+size_t lexicon_bytes(lexicon_t* lex)
+{
+  return (lex == NULL) ? 0 : lex->len;
+}
+
+// unmap and free
+void lexicon_close(lexicon_t* lex)
+{
+  if (lex == NULL) {
+    return;
+  }
+  munmap(lex->map, lex->len);
+  free(lex);
+}
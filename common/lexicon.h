@@ -0,0 +1,101 @@
+/* lexicon.h - header file for CS50 TSE persisted lexicon
+ *
+ * A lexicon maps the words of a sorted index file (as index_save writes
+ *   it) to where their lines start in that file. It is saved beside the
+ *   index as "indexFilename.lex" and memory-mapped as it is, so opening
+ *   one reads nothing but its header.
+ *
+ * The words are numbered 0, 1, 2... in strcmp order and kept in a sorted
+ *   trie whose single-child chains are merged into one edge (a radix
+ *   trie). Every node knows the number of the first word below it, so a
+ *   prefix is a run of consecutive numbers, and so is a range of words.
+ *
+ * A lexicon belongs to one version of its index file: it records the
+ *   file's size and modification time, and is not opened for any other.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __LEXICON_H
+#define __LEXICON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// opaque lexicon
+typedef struct lexicon lexicon_t;
+
+/*
+ * The user provides the name of an index file written by index_save (or
+ *   any file of lines "word ..." with the words in strcmp order, each once).
+ *
+ * We write its lexicon to "indexFilename.lex" and return true, or return
+ *   false (removing any old lexicon) if the file cannot be read, its words
+ *   are not sorted, or the lexicon cannot be written.
+ */
+bool lexicon_build(const char* indexFilename);
+
+/*
+ * The user provides the name of an index file.
+ *
+ * We map "indexFilename.lex" and return the lexicon, or NULL if there is
+ *   none, or it is damaged, or it was built for another version of the
+ *   index file. The user must call lexicon_close.
+ */
+lexicon_t* lexicon_open(const char* indexFilename);
+
+/*
+ * We return how many words the lexicon holds
+ */
+int lexicon_words(lexicon_t* lex);
+
+/*
+ * The user gives a lexicon and a word of len bytes (need not be
+ *   NUL-terminated).
+ *
+ * We return the word's number, or -1 if it is not in the lexicon.
+ */
+int lexicon_find(lexicon_t* lex, const char* word, const size_t len);
+
+/*
+ * The user gives a lexicon and a prefix (NUL-terminated; "" matches all).
+ *
+ * We return how many words start with the prefix, and set *first to the
+ *   number of the first of them; they are numbered *first, *first + 1...
+ */
+int lexicon_prefix(lexicon_t* lex, const char* prefix, int* first);
+
+/*
+ * The user gives a lexicon and two words, from and to (NUL-terminated).
+ *
+ * We return how many words w have from <= w <= to in strcmp order, and set
+ *   *first to the number of the first of them, as lexicon_prefix does.
+ */
+int lexicon_range(lexicon_t* lex, const char* from, const char* to, int* first);
+
+/*
+ * The user gives a lexicon, a word number, and a buffer of size bytes.
+ *
+ * We copy the word into buf, truncated to size - 1 bytes and NUL-terminated
+ *   as snprintf does, and return its full length (or -1 for a bad number).
+ */
+int lexicon_word(lexicon_t* lex, const int n, char* buf, const size_t size);
+
+/*
+ * We return where the line of word number n starts in the index file
+ *   (0 for a bad number).
+ */
+size_t lexicon_offset(lexicon_t* lex, const int n);
+
+/*
+ * We return the size of the lexicon file in bytes
+ */
+size_t lexicon_bytes(lexicon_t* lex);
+
+/*
+ * Unmap the lexicon and free it
+ */
+void lexicon_close(lexicon_t* lex);
+
+#endif // __LEXICON_H
@@ -11,12 +11,63 @@
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <dirent.h>
+#include <limits.h>
 #include "pagedir.h"
+#include "pagestore.h"
+#include "codec.h"
 #include "../libcs50/webpage.h"
 
+// first line of a manifest; one without it was not started by this version
+static const char MANIFEST_HEADER[] = "# tse manifest: docID bytes\n";
+
+// the packed store of storeDir, kept open between calls; NULL if storeDir
+//   holds one file per page
+static pagestore_t* store = NULL;
+static char storeDir[1024];
+static bool storeChecked = false;
+
+// how pages are compressed as they are saved, and what it saved
+static codec_t saveCodec = CODEC_NONE;
+static int saveLevel = 0;
+static size_t pagesSaved = 0;
+static size_t bytesIn = 0;      // page text given to pagedir_save
+static size_t bytesOut = 0;     // ... and written
+
+// carries pagedir_scan's callback through pagestore_scan
+typedef struct scanArg {
+  void* arg;
+  void (*itemfunc)(void* arg, webpage_t* page, const int docID);
+  int count;
+} scanArg_t;
+
 // function prototypes
 static bool isWritableDirectory (const char* pageDirectory);
 static char* makeFilePath(const char* dir, const int docID);
+static pagestore_t* getStore(const char* pageDirectory);
+static char* formatPage(const webpage_t* page, size_t* len);
+static bool parseHeader(const char* data, const size_t len, size_t* urlLen,
+                        int* depth, size_t* htmlStart);
+static webpage_t* parsePage(char* data, const size_t len);
+static webpage_t* loadFile(const char* filename);
+static char* readHeader(const int fd, const size_t size, size_t* urlLen,
+                        int* depth, size_t* htmlStart, bool* compressed);
+static webpage_t* loadRecord(char* data, const size_t len);
+static bool readAt(const int fd, char* buf, size_t len, off_t offset);
+static void scanPacked(void* arg, const int docID, char* data, const size_t len);
+static void addToManifest(const char* pageDirectory, const int docID,
+                          const size_t size);
+static pageInfo_t* listStore(pagestore_t* packed, int* count);
+static bool listManifest(const char* pageDirectory, pageInfo_t** pages,
+                         int* count);
+static pageInfo_t* listFiles(const char* pageDirectory, int* count);
+static bool addPage(pageInfo_t** pages, int* count, int* capacity,
+                    const int docID, const size_t size);
+static int comparePages(const void* a, const void* b);
 
 // creates the pageDirectory
 
@@ -46,6 +97,35 @@ bool pagedir_init(const char* pageDirectory)
   return true;
 }
 
+// packed or one file per page, for pages saved from now on
+bool pagedir_setLayout(const char* pageDirectory, const bool packed)
+{
+  if (pageDirectory == NULL) {
+    return false;
+  }
+  pagedir_close();
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.manifest", pageDirectory);
+  if (!packed) {
+    pagestore_remove(pageDirectory);
+    FILE* fp = fopen(filename, "w");
+    if (fp == NULL) {
+      fprintf(stderr, "cannot create '%s'\n", filename);
+      return false;
+    }
+    fputs(MANIFEST_HEADER, fp);
+    fclose(fp);
+    return true;
+  }
+
+  remove(filename); // the store's index lists its pages
+
+  store = pagestore_open(pageDirectory, true);
+  snprintf(storeDir, sizeof(storeDir), "%s", pageDirectory);
+  storeChecked = true;
+  return store != NULL;
+}
+
 // save webpage to directory
 void pagedir_save(const webpage_t* page, const char* pageDirectory, const int docID)
 {
@@ -54,19 +134,44 @@ void pagedir_save(const webpage_t* page, const char* pageDirectory, const int do
     return;
   }
 
-  // grab page data
-  const char* url = webpage_getURL(page);
-  const int depth = webpage_getDepth(page);
-  const char* html = webpage_getHTML(page);
+  // failed to grab page data
+  if (webpage_getURL(page) == NULL || webpage_getHTML(page) == NULL) {
+    return;
+  }
 
-  // failed to grab
-  if (url == NULL || html == NULL) {
+  // the text of the page file, compressed if asked and worth it
+  size_t len;
+  char* data = formatPage(page, &len);
+  if (data == NULL) {
+    return;
+  }
+  pagesSaved++;
+  bytesIn += len;
+  if (saveCodec != CODEC_NONE) {
+    size_t packedLen;
+    char* packedData = codec_compress(saveCodec, saveLevel, data, len, &packedLen);
+    if (packedData != NULL) {
+      free(data);
+      data = packedData;
+      len = packedLen;
+    }
+  }
+  bytesOut += len;
+
+  // packed: appended to the store
+  pagestore_t* packed = getStore(pageDirectory);
+  if (packed != NULL) {
+    if (!pagestore_append(packed, docID, data, len)) {
+      fprintf(stderr, "cannot save page %d to the page store\n", docID);
+    }
+    free(data);
     return;
   }
 
   char * filename = makeFilePath(pageDirectory, docID);
   // failed to make a filename
   if (filename == NULL) {
+    free(data);
     return;
   }
 
@@ -74,16 +179,75 @@ void pagedir_save(const webpage_t* page, const char* pageDirectory, const int do
   if (fp == NULL) {
     fprintf(stderr, "cannot create file to write page to\n");
     free(filename);
+    free(data);
     return;
   }
 
-  // print data to file
-  fprintf(fp, "%s\n", url);
-  fprintf(fp, "%d\n", depth);
-  fprintf(fp, "%s\n", html);
+  // write data to file, and list it once it is there
+  bool written = fwrite(data, 1, len, fp) == len;
+  if (fclose(fp) == 0 && written) {
+    addToManifest(pageDirectory, docID, len);
+  } else {
+    fprintf(stderr, "cannot write page %d\n", docID);
+  }
+  free(filename);
+  free(data);
+}
+
+// compression for pages saved from now on
+bool pagedir_setCompression(const char* codecName)
+{
+  codec_t codec;
+  int level;
+  if (!codec_parse(codecName, &codec, &level)) {
+    return false;
+  }
+  saveCodec = codec;
+  saveLevel = level;
+  return true;
+}
 
+// what pagedir_save wrote
+void pagedir_printStats(FILE* fp)
+{
+  if (fp == NULL) {
+    return;
+  }
+  fprintf(fp, "pagedir: %zu pages saved, %zu bytes stored for %zu bytes of "
+          "text (%s, ratio %.2f)\n",
+          pagesSaved, bytesOut, bytesIn, codec_name(saveCodec),
+          bytesOut > 0 ? (double)bytesIn / bytesOut : 0.0);
+}
+
+// note that url is a duplicate of docID
+bool pagedir_saveAlias(const char* pageDirectory, const char* url, const int docID)
+{
+  if (pageDirectory == NULL || url == NULL || docID <= 0) {
+    return false;
+  }
+
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.aliases", pageDirectory);
+
+  FILE* fp = fopen(filename, "a");
+  if (fp == NULL) {
+    fprintf(stderr, "cannot open '%s'\n", filename);
+    return false;
+  }
+  fprintf(fp, "%d %s\n", docID, url);
   fclose(fp);
-  free(filename);
+  return true;
+}
+
+// forget the aliases of an earlier crawl
+void pagedir_clearAliases(const char* pageDirectory)
+{
+  if (pageDirectory == NULL) {
+    return;
+  }
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.aliases", pageDirectory);
+  remove(filename);
 }
 
 // checks that the directory given has a .crawler file
@@ -115,73 +279,126 @@ webpage_t* pagedir_load(const char* pageDirectory, const int docID)
     return NULL;
   }
 
-  // make filepath
+  // packed: one read from the store
+  pagestore_t* packed = getStore(pageDirectory);
+  if (packed != NULL) {
+    size_t len;
+    char* data = pagestore_read(packed, docID, &len);
+    if (data == NULL) {
+      return NULL;
+    }
+    return loadRecord(data, len);
+  }
+
+  // one file: the header, then the html straight into its own buffer
   char filename[1024];
   snprintf(filename, sizeof(filename), "%s/%d", pageDirectory, docID);
+  return loadFile(filename);
+}
 
-  FILE* fp = fopen(filename, "r");
-  if (fp == NULL) {
-    return NULL; // can't open!
+// just the first line of a page
+char* pagedir_loadURL(const char* pageDirectory, const int docID)
+{
+  if (pageDirectory == NULL || docID <= 0) {
+    return NULL;
   }
 
-  // read the URL
+  // a plain page file: only its header is read
   char* url = NULL;
-  size_t len = 0;
-  
-  // if it fails
-  if (getline(&url, &len, fp) == -1) {
-    free(url);
-    fclose(fp);
-    return NULL;
-  }
-  
-  // remove newline
-  char* newline = strchr(url, '\n');
-  if (newline) {
-    *newline = '\0';
+  bool compressed = false;
+  if (getStore(pageDirectory) == NULL) {
+    char filename[1024];
+    snprintf(filename, sizeof(filename), "%s/%d", pageDirectory, docID);
+    int fd = open(filename, O_RDONLY);
+    struct stat st;
+    if (fd < 0) {
+      return NULL;
+    }
+    if (fstat(fd, &st) == 0) {
+      size_t urlLen, htmlStart;
+      int depth;
+      char* head = readHeader(fd, st.st_size, &urlLen, &depth, &htmlStart,
+                              &compressed);
+      if (head != NULL && !compressed) {
+        url = strndup(head, urlLen);
+      }
+      free(head);
+    }
+    close(fd);
+    if (!compressed) {
+      return url;
+    }
   }
 
-  // read depth
-  int depth = 0;
-
-  // if it fails
-  if (fscanf(fp, "%d\n", &depth) != 1) {
-    free(url);
-    fclose(fp);
-    return NULL;
+  // packed or compressed: the whole page
+  webpage_t* page = pagedir_load(pageDirectory, docID);
+  if (page != NULL) {
+    url = strdup(webpage_getURL(page));
+    webpage_delete(page);
   }
+  return url;
+}
 
-  // read remaining html line by line
-  char* html = NULL;
-  size_t html_len = 0;
-  char buffer[1024];
-  while (fgets(buffer, sizeof(buffer), fp) != NULL) {
-    size_t chunkLen = strlen(buffer);
+// every page, in turn
+int pagedir_scan(const char* pageDirectory, void* arg,
+                 void (*itemfunc)(void* arg, webpage_t* page, const int docID))
+{
+  if (pageDirectory == NULL || itemfunc == NULL) {
+    return 0;
+  }
 
-    // reallocate memory as you go to accomodate new data (+ 1 is for NULL byte)
-    char* newHtml = realloc(html, html_len + chunkLen + 1);
+  scanArg_t scan = { arg, itemfunc, 0 };
+  pagestore_t* packed = getStore(pageDirectory);
+  if (packed != NULL) {
+    pagestore_scan(packed, &scan, scanPacked);
+    return scan.count;
+  }
 
-    if (newHtml == NULL) {
-      // out of memory probably
-      free(html);
-      free(url);
-      fclose(fp);
-      return NULL;
+  // one file per page, as listed
+  int count;
+  pageInfo_t* pages = pagedir_list(pageDirectory, &count);
+  for (int i = 0; i < count; i++) {
+    webpage_t* page = pagedir_load(pageDirectory, pages[i].docID);
+    if (page == NULL) {
+      fprintf(stderr, "cannot load page %d\n", pages[i].docID);
+      continue;
     }
-    html = newHtml;
-    memcpy(html + html_len, buffer, chunkLen + 1); // copy data and '\0'
-    html_len += chunkLen;
+    scan.count++;
+    (*itemfunc)(arg, page, pages[i].docID);
+    webpage_delete(page);
   }
-  fclose(fp);
+  free(pages);
+  return scan.count;
+}
 
-  // createa a webpage
-  webpage_t* page = webpage_new(url, depth, html);
-  if (page == NULL) {
-    // webpage failed :(
-    free(url);
-    free(html);
+// the pages there are, without reading them
+pageInfo_t* pagedir_list(const char* pageDirectory, int* count)
+{
+  if (count == NULL) {
+    return NULL;
   }
-  return page;
+  *count = 0;
+  if (pageDirectory == NULL) {
+    return NULL;
+  }
+
+  pagestore_t* packed = getStore(pageDirectory);
+  if (packed != NULL) {
+    return listStore(packed, count);
+  }
+  pageInfo_t* pages = NULL;
+  if (listManifest(pageDirectory, &pages, count)) {
+    return pages;
+  }
+  return listFiles(pageDirectory, count);
+}
+
+// close the packed store
+void pagedir_close(void)
+{
+  pagestore_close(store);
+  store = NULL;
+  storeChecked = false;
 }
 
 // attempts to write into directory by making a test file
@@ -213,3 +430,421 @@ static char* makeFilePath(const char* dir, const int docID) {
   }
   return path;
 }
+
+// the open store for pageDirectory, opening it if there is one
+static pagestore_t* getStore(const char* pageDirectory)
+{
+  if (storeChecked && strcmp(storeDir, pageDirectory) == 0) {
+    return store;
+  }
+  // a directory of page files leaves another's open store alone, so copying
+  //   pages between the two does not reopen the store for every page
+  bool packed = pagestore_exists(pageDirectory);
+  if (!packed && store != NULL) {
+    return NULL;
+  }
+  pagedir_close();
+  snprintf(storeDir, sizeof(storeDir), "%s", pageDirectory);
+  storeChecked = true;
+  if (packed) {
+    store = pagestore_open(pageDirectory, false);
+  }
+  return store;
+}
+
+// the text of a page file, in a new buffer of *len bytes (plus '\0')
+static char* formatPage(const webpage_t* page, size_t* len)
+{
+  const char* url = webpage_getURL(page);
+  const int depth = webpage_getDepth(page);
+  const char* html = webpage_getHTML(page);
+
+  int size = snprintf(NULL, 0, "%s\n%d\n%s\n", url, depth, html);
+  char* data = malloc(size + 1);
+  if (data != NULL) {
+    snprintf(data, size + 1, "%s\n%d\n%s\n", url, depth, html);
+    *len = size;
+  }
+  return data;
+}
+
+// find the end of the url line and the depth line; false if malformed
+static bool parseHeader(const char* data, const size_t len, size_t* urlLen,
+                        int* depth, size_t* htmlStart)
+{
+  const char* newline = memchr(data, '\n', len);
+  if (newline == NULL) {
+    return false;
+  }
+  const char* p = newline + 1;
+  const char* end = data + len;
+  bool negative = (p < end && *p == '-');
+  if (negative) {
+    p++;
+  }
+  if (p == end || *p < '0' || *p > '9') {
+    return false;
+  }
+  int value = 0;
+  while (p < end && *p >= '0' && *p <= '9') {
+    value = value * 10 + (*p++ - '0');
+  }
+  if (p == end || *p != '\n') {
+    return false;
+  }
+
+  *urlLen = newline - data;
+  *depth = negative ? -value : value;
+  *htmlStart = p + 1 - data;
+  return true;
+}
+
+// a webpage from the text of a page file in data, which it takes over
+static webpage_t* parsePage(char* data, const size_t len)
+{
+  size_t urlLen, htmlStart;
+  int depth;
+  if (!parseHeader(data, len, &urlLen, &depth, &htmlStart)) {
+    free(data);
+    return NULL;
+  }
+  size_t htmlLen = len - htmlStart;
+  if (htmlLen > 0 && data[htmlStart + htmlLen - 1] == '\n') {
+    htmlLen--; // added by pagedir_save
+  }
+
+  // the html slides to the front of data, which becomes the page's html
+  char* url = strndup(data, urlLen);
+  memmove(data, data + htmlStart, htmlLen);
+  data[htmlLen] = '\0';
+  webpage_t* page = (url == NULL) ? NULL : webpage_new(url, depth, data);
+  if (page == NULL) {
+    free(url);
+    free(data);
+  }
+  return page;
+}
+
+// a webpage from a page file: one read for the header, one for the html
+static webpage_t* loadFile(const char* filename)
+{
+  int fd = open(filename, O_RDONLY);
+  if (fd < 0) {
+    return NULL; // can't open!
+  }
+  struct stat st;
+  if (fstat(fd, &st) != 0) {
+    close(fd);
+    return NULL;
+  }
+  size_t size = st.st_size;
+
+  size_t urlLen, htmlStart;
+  int depth;
+  bool compressed;
+  char* head = readHeader(fd, size, &urlLen, &depth, &htmlStart, &compressed);
+  if (head == NULL) {
+    close(fd);
+    return NULL;
+  }
+
+  // compressed: read it all and decompress
+  if (compressed) {
+    free(head);
+    char* data = malloc(size);
+    if (data == NULL || !readAt(fd, data, size, 0)) {
+      free(data);
+      close(fd);
+      return NULL;
+    }
+    close(fd);
+    return loadRecord(data, size);
+  }
+
+  char* url = strndup(head, urlLen);
+  free(head);
+  size_t htmlLen = size - htmlStart;
+  char* html = malloc(htmlLen + 1);
+  if (url == NULL || html == NULL || !readAt(fd, html, htmlLen, htmlStart)) {
+    free(url);
+    free(html);
+    close(fd);
+    return NULL;
+  }
+  close(fd);
+
+  // drop the newline pagedir_save put after the html, so it reads back as fetched
+  if (htmlLen > 0 && html[htmlLen - 1] == '\n') {
+    htmlLen--;
+  }
+  html[htmlLen] = '\0';
+
+  // createa a webpage
+  webpage_t* page = webpage_new(url, depth, html);
+  if (page == NULL) {
+    // webpage failed :(
+    free(url);
+    free(html);
+  }
+  return page;
+}
+
+// read the start of a page file until its header is in; the header is
+//   almost always in the first KB, and more is read for a long url
+static char* readHeader(const int fd, const size_t size, size_t* urlLen,
+                        int* depth, size_t* htmlStart, bool* compressed)
+{
+  char* head = NULL;
+  size_t headSize = 1024;
+  *compressed = false;
+  while (true) {
+    size_t want = (headSize < size) ? headSize : size;
+    char* bigger = realloc(head, want + 1);
+    if (bigger == NULL || !readAt(fd, bigger, want, 0)) {
+      free(bigger != NULL ? bigger : head);
+      return NULL;
+    }
+    head = bigger;
+    if (codec_isCompressed(head, want)) {
+      *compressed = true;
+      return head;
+    }
+    if (parseHeader(head, want, urlLen, depth, htmlStart)) {
+      return head;
+    }
+    if (want == size) {
+      free(head); // malformed
+      return NULL;
+    }
+    headSize *= 4;
+  }
+}
+
+// a webpage from a whole record (compressed or not), which it takes over
+static webpage_t* loadRecord(char* data, const size_t len)
+{
+  if (!codec_isCompressed(data, len)) {
+    return parsePage(data, len);
+  }
+  size_t rawLen;
+  char* raw = codec_decompress(data, len, &rawLen);
+  free(data);
+  return (raw == NULL) ? NULL : parsePage(raw, rawLen);
+}
+
+// pread until len bytes are in
+static bool readAt(const int fd, char* buf, size_t len, off_t offset)
+{
+  while (len > 0) {
+    ssize_t n = pread(fd, buf, len, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    buf += n;
+    len -= n;
+    offset += n;
+  }
+  return true;
+}
+
+// pagestore_scan's callback: parse the page and pass it on
+static void scanPacked(void* arg, const int docID, char* data, const size_t len)
+{
+  scanArg_t* scan = arg;
+
+  // a compressed page decompresses into a buffer of its own
+  if (codec_isCompressed(data, len)) {
+    size_t rawLen;
+    char* raw = codec_decompress(data, len, &rawLen);
+    webpage_t* page = (raw == NULL) ? NULL : parsePage(raw, rawLen);
+    if (page != NULL) {
+      scan->count++;
+      (*scan->itemfunc)(scan->arg, page, docID);
+      webpage_delete(page);
+    }
+    return;
+  }
+
+  // data belongs to the segment buffer, so the page gets copies
+  size_t urlLen, htmlStart;
+  int depth;
+  if (!parseHeader(data, len, &urlLen, &depth, &htmlStart)) {
+    return;
+  }
+  size_t htmlLen = len - htmlStart;
+  if (htmlLen > 0 && data[htmlStart + htmlLen - 1] == '\n') {
+    htmlLen--;
+  }
+  char* url = strndup(data, urlLen);
+  char* html = strndup(data + htmlStart, htmlLen);
+  webpage_t* page = (url == NULL || html == NULL) ? NULL
+                    : webpage_new(url, depth, html);
+  if (page == NULL) {
+    free(url);
+    free(html);
+  } else {
+    scan->count++;
+    (*scan->itemfunc)(scan->arg, page, docID);
+    webpage_delete(page);
+  }
+}
+
+// append "docID size" to the manifest, if there is one
+static void addToManifest(const char* pageDirectory, const int docID,
+                          const size_t size)
+{
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.manifest", pageDirectory);
+  int fd = open(filename, O_WRONLY | O_APPEND);
+  if (fd < 0) {
+    return; // a crawl from before manifests
+  }
+  char line[64];
+  int len = snprintf(line, sizeof(line), "%d %zu\n", docID, size);
+  if (write(fd, line, len) != len) {
+    fprintf(stderr, "cannot add page %d to '%s'\n", docID, filename);
+  }
+  close(fd);
+}
+
+// every docID in the store's index
+static pageInfo_t* listStore(pagestore_t* packed, int* count)
+{
+  pageInfo_t* pages = NULL;
+  int capacity = 0;
+  for (int docID = 1; docID <= pagestore_maxDocID(packed); docID++) {
+    size_t size = pagestore_length(packed, docID);
+    if (size > 0 && !addPage(&pages, count, &capacity, docID, size)) {
+      break;
+    }
+  }
+  return pages;
+}
+
+// the manifest's pages; false if there is no manifest to go by
+static bool listManifest(const char* pageDirectory, pageInfo_t** pages,
+                         int* count)
+{
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.manifest", pageDirectory);
+  FILE* fp = fopen(filename, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  char line[128];
+  if (fgets(line, sizeof(line), fp) == NULL || strcmp(line, MANIFEST_HEADER) != 0) {
+    fclose(fp);
+    return false;
+  }
+
+  int capacity = 0;
+  while (fgets(line, sizeof(line), fp) != NULL) {
+    char* end;
+    long docID = strtol(line, &end, 10);
+    unsigned long long size = strtoull(end, &end, 10);
+    if (docID <= 0 || docID > INT_MAX || *end != '\n') {
+      continue; // torn by a crash
+    }
+    if (!addPage(pages, count, &capacity, docID, size)) {
+      break;
+    }
+  }
+  fclose(fp);
+  if (*count == 0) {
+    return true;
+  }
+
+  // a page saved again (on a resumed crawl) is listed again: going back
+  //   from the end, keep only the last line for each docID
+  int maxDocID = 0;
+  for (int i = 0; i < *count; i++) {
+    if ((*pages)[i].docID > maxDocID) {
+      maxDocID = (*pages)[i].docID;
+    }
+  }
+  bool* seen = calloc(maxDocID + 1, sizeof(bool));
+  if (seen == NULL) {
+    free(*pages);
+    *pages = NULL;
+    *count = 0;
+    return true;
+  }
+  int kept = *count;
+  for (int i = *count - 1; i >= 0; i--) {
+    int docID = (*pages)[i].docID;
+    if (!seen[docID]) {
+      seen[docID] = true;
+      (*pages)[--kept] = (*pages)[i];
+    }
+  }
+  free(seen);
+  memmove(*pages, *pages + kept, (*count - kept) * sizeof(pageInfo_t));
+  *count -= kept;
+  if (*count > 1) {
+    qsort(*pages, *count, sizeof(pageInfo_t), comparePages);
+  }
+  return true;
+}
+
+// page files named by their docID, for a crawl from before manifests
+static pageInfo_t* listFiles(const char* pageDirectory, int* count)
+{
+  DIR* dir = opendir(pageDirectory);
+  if (dir == NULL) {
+    return NULL;
+  }
+  pageInfo_t* pages = NULL;
+  int capacity = 0;
+  struct dirent* entry;
+  while ((entry = readdir(dir)) != NULL) {
+    // only names that are a docID: digits, no leading zero
+    const char* name = entry->d_name;
+    if (name[0] < '1' || name[0] > '9' || strspn(name, "0123456789") != strlen(name)) {
+      continue;
+    }
+    long docID = strtol(name, NULL, 10);
+    struct stat st;
+    if (docID > INT_MAX || fstatat(dirfd(dir), name, &st, 0) != 0
+        || !S_ISREG(st.st_mode)) {
+      continue;
+    }
+    if (!addPage(&pages, count, &capacity, docID, st.st_size)) {
+      break;
+    }
+  }
+  closedir(dir);
+  if (*count > 1) {
+    qsort(pages, *count, sizeof(pageInfo_t), comparePages);
+  }
+  return pages;
+}
+
+// append to a growing list of pages
+static bool addPage(pageInfo_t** pages, int* count, int* capacity,
+                    const int docID, const size_t size)
+{
+  if (*count == *capacity) {
+    int newCapacity = (*capacity == 0) ? 1024 : *capacity * 2;
+    pageInfo_t* grown = realloc(*pages, newCapacity * sizeof(pageInfo_t));
+    if (grown == NULL) {
+      return false;
+    }
+    *pages = grown;
+    *capacity = newCapacity;
+  }
+  (*pages)[*count].docID = docID;
+  (*pages)[*count].size = size;
+  (*count)++;
+  return true;
+}
+
+// by docID, for qsort
+static int comparePages(const void* a, const void* b)
+{
+  int x = ((const pageInfo_t*)a)->docID;
+  int y = ((const pageInfo_t*)b)->docID;
+  return (x > y) - (x < y);
+}
@@ -3,6 +3,12 @@
  * Gives two functions, one for creating a file for crawler use
  *   and another for saving a webpage to a directory
  *
+ * A page directory holds its pages in one of two layouts: one file per
+ *   docID (the default), or packed into a few large segment files (see
+ *   pagestore.h). The crawler picks the layout with pagedir_setLayout; all
+ *   other functions work the same on either. The packed store, once used,
+ *   stays open until pagedir_close.
+ *
  *
  * Author: Jacob Bacus
  * Date: Feburary 2025
@@ -11,6 +17,7 @@
 #ifndef __PAGEDIR_H
 #define __PAGEDIR_H
 
+#include <stdio.h>
 #include <stdbool.h>
 #include "../libcs50/webpage.h"
 
@@ -26,10 +33,41 @@ bool pagedir_init(const char* pageDirectory);
 
 
 /*
- * Saves a webpage to pageDirectory/docID. The file will contain:
+ * Chooses how pages are saved in pageDirectory from now on: packed into
+ *   segment files if packed is true, one file per page otherwise. Any pages
+ *   already packed there are deleted. Page files are listed in a new
+ *   manifest, pageDirectory/.manifest (see pagedir_list).
+ *
+ * Returns:
+ *   true on a successful run
+ *   false otherwise
+ */
+bool pagedir_setLayout(const char* pageDirectory, const bool packed);
+
+/*
+ * Chooses how pages are compressed by pagedir_save from now on: "none" (the
+ *   default), "lz4", "zlib" or "zlib:LEVEL" (see codec.h). Pages are loaded
+ *   the same whether or not, or however, they were compressed.
+ *
+ * Returns:
+ *   true on a successful run
+ *   false if codecName is not a codec
+ */
+bool pagedir_setCompression(const char* codecName);
+
+/*
+ * Prints one line to fp: pages saved so far, the bytes of text given and
+ *   the bytes written, and the compression ratio.
+ */
+void pagedir_printStats(FILE* fp);
+
+/*
+ * Saves a webpage to pageDirectory/docID (or to the packed store). The file will contain:
  *   The webpage URL
  *   The webpage depth
  *   subsequent lines: the webpage's HTML content
+ * all compressed into one frame if pagedir_setCompression asked for it.
+ * A page file is then added to the manifest, if pagedir_setLayout started one.
  *
  * Caller provides:
  *  valid page
@@ -40,6 +78,21 @@ bool pagedir_init(const char* pageDirectory);
  */
 void pagedir_save(const webpage_t* page, const char* pageDirectory, const int docID);
 
+/*
+ * Records that url was fetched but duplicates the page saved as docID, by
+ *   appending a line "docID url" to pageDirectory/.aliases.
+ *
+ * Returns:
+ *   true on a successful run
+ *   false otherwise
+ */
+bool pagedir_saveAlias(const char* pageDirectory, const char* url, const int docID);
+
+/*
+ * Removes pageDirectory/.aliases, if any, before a new crawl.
+ */
+void pagedir_clearAliases(const char* pageDirectory);
+
 /*
  * Returns true if a directory is created by a crawler
  * Works by checking for a ".crawler" file
@@ -53,6 +106,8 @@ bool pagedir_validate(const char* pageDirectory);
  * Loads the file specified by "pageDirectory/docID"
  *   (loads as a webpage)
  * 
+ * A compressed page is decompressed first.
+ *
  * The user provides a valid pageDirectory and docID for within crawler
  *
  * We return a pointer to newly allocated webpage_t or NULL on failure
@@ -62,4 +117,46 @@ bool pagedir_validate(const char* pageDirectory);
  */
 webpage_t* pagedir_load(const char* pageDirectory, const int docID);
 
+/*
+ * Loads only the URL of page docID.
+ *
+ * We return a newly allocated string, which the user must free,
+ *   or NULL on failure
+ */
+char* pagedir_loadURL(const char* pageDirectory, const int docID);
+
+// a page found by pagedir_list
+typedef struct pageInfo {
+  int docID;
+  size_t size;      // bytes stored (compressed, if it was)
+} pageInfo_t;
+
+/*
+ * Lists the pages in pageDirectory, without reading them: from the packed
+ *   store's index; else from the manifest, a line "docID bytes" per page
+ *   file saved (the last line for a docID wins); else, for a directory
+ *   crawled before manifests, from its file names.
+ *
+ * We return a new array of *count pages sorted by docID, which the user
+ *   must free, or NULL (and *count 0) if there are none.
+ */
+pageInfo_t* pagedir_list(const char* pageDirectory, int* count);
+
+/*
+ * Loads every page in pageDirectory in turn, calling itemfunc(arg, page,
+ *   docID) for each; the page is deleted after the call. Page files are
+ *   read in the order pagedir_list gives them, and one that cannot be
+ *   loaded is reported and skipped; a packed store is read one whole
+ *   segment at a time.
+ *
+ * We return the number of pages loaded.
+ */
+int pagedir_scan(const char* pageDirectory, void* arg,
+                 void (*itemfunc)(void* arg, webpage_t* page, const int docID));
+
+/*
+ * Closes the packed store, if one is open, and frees its memory
+ */
+void pagedir_close(void);
+
 #endif
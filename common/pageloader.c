@@ -0,0 +1,339 @@
+/* pageloader.c - CS50 TSE prefetching page loader
+ *
+ * Every page gets a sequence number, 0, 1, 2, ... (for page files, its place
+ *   in the list) and lives in slot (seq % queueDepth) of the ring until it
+ *   is taken. A reader may only fill a slot once the page queueDepth before
+ *   it has been taken, so the ring never holds more than queueDepth pages
+ *   and pages come out in sequence order however the readers race. One
+ *   mutex guards the ring and the timers; readers wait on 'roomy', callers
+ *   on 'filled'.
+ *
+ * Full and extensive documentation is in pageloader.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <limits.h>
+#include <time.h>
+#include <pthread.h>
+#include "pageloader.h"
+#include "pagedir.h"
+#include "pagestore.h"
+#include "../libcs50/webpage.h"
+
+// most reader threads
+static const int MAX_READERS = 64;
+
+// one place in the ring
+typedef struct slot {
+  webpage_t* page;
+  int docID;
+  bool ready;       // filled and not yet taken
+} slot_t;
+
+// defines a page loader
+typedef struct pageloader {
+  char* dir;
+  bool packed;
+  const pageInfo_t* list;  // page files to load, in order
+  int depth;            // slots in the ring
+  slot_t* slots;
+  pthread_mutex_t lock;
+  pthread_cond_t roomy;   // a slot was emptied, or stop
+  pthread_cond_t filled;  // a slot was filled, or the end found
+  long claimed;         // next sequence number for a reader
+  long head;            // next sequence number for the caller
+  long end;             // first sequence number with no page, LONG_MAX until known
+  bool stop;
+  pthread_t* threads;
+  int nthreads;
+
+  // stage timing, in seconds
+  long pages;
+  double loadTime;      // readers loading, summed over readers
+  double roomWait;      // readers waiting for an empty slot
+  double pageWait;      // caller waiting for a page
+  double useTime;       // caller working on pages
+  double started;
+  double lastTaken;     // when the caller last got a page, 0 if not holding one
+  double finished;      // when the caller saw the end, 0 until then
+  double readerMark;    // packed: when the reader last stopped waiting
+} pageloader_t;
+
+// function prototypes
+static void* readFiles(void* arg);
+static void* readPacked(void* arg);
+static void pushPacked(void* arg, webpage_t* page, const int docID);
+static bool waitForRoom(pageloader_t* loader, const long seq);
+static void fill(pageloader_t* loader, const long seq, webpage_t* page,
+                 const int docID);
+static double nowSeconds(void);
+
+// start the readers
+pageloader_t* pageloader_new(const char* pageDirectory,
+                             const pageInfo_t* pages, const int count,
+                             const int readers, const int queueDepth)
+{
+  if (pageDirectory == NULL || (pages == NULL && count > 0) || count < 0
+      || readers < 1 || queueDepth < 1) {
+    return NULL;
+  }
+
+  pageloader_t* loader = calloc(1, sizeof(pageloader_t));
+  if (loader == NULL) {
+    return NULL;
+  }
+  loader->dir = malloc(strlen(pageDirectory) + 1);
+  loader->slots = calloc(queueDepth, sizeof(slot_t));
+  loader->packed = pagestore_exists(pageDirectory);
+  int nthreads = loader->packed ? 1 : (readers < MAX_READERS ? readers : MAX_READERS);
+  loader->threads = calloc(nthreads, sizeof(pthread_t));
+  if (loader->dir == NULL || loader->slots == NULL || loader->threads == NULL) {
+    free(loader->dir);
+    free(loader->slots);
+    free(loader->threads);
+    free(loader);
+    return NULL;
+  }
+  strcpy(loader->dir, pageDirectory);
+  loader->depth = queueDepth;
+  loader->list = pages;
+  loader->end = loader->packed ? LONG_MAX : count;
+  pthread_mutex_init(&loader->lock, NULL);
+  pthread_cond_init(&loader->roomy, NULL);
+  pthread_cond_init(&loader->filled, NULL);
+  loader->started = nowSeconds();
+
+  // the first page file is loaded here, which also leaves pagedir settled on
+  //   this directory before the readers call it at the same time
+  if (!loader->packed && count > 0) {
+    webpage_t* page = pagedir_load(pageDirectory, pages[0].docID);
+    loader->loadTime = nowSeconds() - loader->started;
+    if (page == NULL) {
+      fprintf(stderr, "pageloader: cannot load page %d\n", pages[0].docID);
+    }
+    loader->claimed = 1;
+    fill(loader, 0, page, pages[0].docID);
+  }
+
+  for (int t = 0; t < nthreads; t++) {
+    if (pthread_create(&loader->threads[t], NULL,
+                       loader->packed ? readPacked : readFiles, loader) != 0) {
+      fprintf(stderr, "pageloader: cannot start reader %d\n", t + 1);
+      pageloader_delete(loader);
+      return NULL;
+    }
+    loader->nthreads++;
+  }
+  return loader;
+}
+
+// the next page, in order
+webpage_t* pageloader_next(pageloader_t* loader, int* docID)
+{
+  if (loader == NULL || docID == NULL) {
+    return NULL;
+  }
+
+  pthread_mutex_lock(&loader->lock);
+  double start = nowSeconds();
+  if (loader->lastTaken > 0) {
+    loader->useTime += start - loader->lastTaken;
+    loader->lastTaken = 0;
+  }
+
+  // the next page that loaded; another caller may take it while this one
+  //   waits, so the head's slot is found afresh after every wait
+  webpage_t* page = NULL;
+  while (page == NULL && loader->head < loader->end) {
+    slot_t* slot = &loader->slots[loader->head % loader->depth];
+    if (!slot->ready) {
+      pthread_cond_wait(&loader->filled, &loader->lock);
+      continue;
+    }
+    page = slot->page;
+    *docID = slot->docID;
+    slot->page = NULL;
+    slot->ready = false;
+    loader->head++;
+    pthread_cond_broadcast(&loader->roomy);
+    if (loader->head == loader->end) {
+      pthread_cond_broadcast(&loader->filled); // wake other callers to end
+    }
+  }
+  double now = nowSeconds();
+  loader->pageWait += now - start;
+
+  if (page != NULL) {
+    loader->pages++;
+    loader->lastTaken = now;
+  } else if (loader->finished == 0) {
+    loader->finished = now;
+  }
+  pthread_mutex_unlock(&loader->lock);
+  return page;
+}
+
+// one line of stage timing
+void pageloader_printStats(pageloader_t* loader, FILE* fp)
+{
+  if (loader == NULL || fp == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&loader->lock);
+  double elapsed = ((loader->finished > 0) ? loader->finished : nowSeconds())
+                   - loader->started;
+  double overlap = loader->loadTime + loader->useTime - elapsed;
+  fprintf(fp, "pageloader: %ld pages, %d reader%s, queue %d: "
+          "loading %.3f s (%.3f s waiting for room), "
+          "using %.3f s (%.3f s waiting for pages), "
+          "%.3f s elapsed, %.3f s overlapped\n",
+          loader->pages, loader->nthreads, (loader->nthreads == 1) ? "" : "s",
+          loader->depth, loader->loadTime, loader->roomWait,
+          loader->useTime, loader->pageWait,
+          elapsed, (overlap > 0) ? overlap : 0);
+  pthread_mutex_unlock(&loader->lock);
+}
+
+// stop and free
+void pageloader_delete(pageloader_t* loader)
+{
+  if (loader == NULL) {
+    return;
+  }
+  pthread_mutex_lock(&loader->lock);
+  loader->stop = true;
+  pthread_cond_broadcast(&loader->roomy);
+  pthread_mutex_unlock(&loader->lock);
+  for (int t = 0; t < loader->nthreads; t++) {
+    pthread_join(loader->threads[t], NULL);
+  }
+
+  for (int s = 0; s < loader->depth; s++) {
+    webpage_delete(loader->slots[s].page);
+  }
+  pthread_mutex_destroy(&loader->lock);
+  pthread_cond_destroy(&loader->roomy);
+  pthread_cond_destroy(&loader->filled);
+  free(loader->threads);
+  free(loader->slots);
+  free(loader->dir);
+  free(loader);
+}
+
+/**************** readers ****************/
+
+// one file per page: claim the next listed page, load it, put it in its slot
+static void* readFiles(void* arg)
+{
+  pageloader_t* loader = arg;
+
+  pthread_mutex_lock(&loader->lock);
+  while (!loader->stop && loader->claimed < loader->end) {
+    long seq = loader->claimed++;
+    if (!waitForRoom(loader, seq)) {
+      break;
+    }
+    int docID = loader->list[seq].docID;
+    pthread_mutex_unlock(&loader->lock);
+
+    double start = nowSeconds();
+    webpage_t* page = pagedir_load(loader->dir, docID);
+    double took = nowSeconds() - start;
+    if (page == NULL) {
+      fprintf(stderr, "pageloader: cannot load page %d\n", docID);
+    }
+
+    pthread_mutex_lock(&loader->lock);
+    loader->loadTime += took;
+    fill(loader, seq, page, docID);
+  }
+  pthread_mutex_unlock(&loader->lock);
+  return NULL;
+}
+
+// a packed store: pagedir_scan reads it, pushPacked queues each page
+static void* readPacked(void* arg)
+{
+  pageloader_t* loader = arg;
+
+  pthread_mutex_lock(&loader->lock);
+  loader->readerMark = nowSeconds();
+  pthread_mutex_unlock(&loader->lock);
+
+  pagedir_scan(loader->dir, loader, pushPacked);
+
+  pthread_mutex_lock(&loader->lock);
+  loader->loadTime += nowSeconds() - loader->readerMark;
+  loader->end = loader->claimed;
+  pthread_cond_broadcast(&loader->filled);
+  pthread_mutex_unlock(&loader->lock);
+  return NULL;
+}
+
+// pagedir_scan's callback; the page is deleted after it, so queue a copy
+static void pushPacked(void* arg, webpage_t* page, const int docID)
+{
+  pageloader_t* loader = arg;
+
+  char* url = strdup(webpage_getURL(page));
+  char* html = strdup(webpage_getHTML(page));
+  webpage_t* copy = (url == NULL || html == NULL) ? NULL
+                    : webpage_new(url, webpage_getDepth(page), html);
+  if (copy == NULL) {
+    free(url);
+    free(html);
+    return;
+  }
+
+  // loading is everything since the last page was queued
+  pthread_mutex_lock(&loader->lock);
+  loader->loadTime += nowSeconds() - loader->readerMark;
+  long seq = loader->claimed++;
+  bool room = waitForRoom(loader, seq);
+  loader->readerMark = nowSeconds();
+  if (room) {
+    fill(loader, seq, copy, docID);
+  } else {
+    webpage_delete(copy);
+  }
+  pthread_mutex_unlock(&loader->lock);
+}
+
+/**************** helpers ****************/
+
+// with the lock held, wait until seq's slot is free; false if stopped
+static bool waitForRoom(pageloader_t* loader, const long seq)
+{
+  double start = nowSeconds();
+  while (!loader->stop && seq >= loader->head + loader->depth) {
+    pthread_cond_wait(&loader->roomy, &loader->lock);
+  }
+  loader->roomWait += nowSeconds() - start;
+  return !loader->stop;
+}
+
+// with the lock held, put page (NULL if it did not load) in seq's slot
+static void fill(pageloader_t* loader, const long seq, webpage_t* page,
+                 const int docID)
+{
+  slot_t* slot = &loader->slots[seq % loader->depth];
+  slot->page = page;
+  slot->docID = docID;
+  slot->ready = true;
+  pthread_cond_broadcast(&loader->filled);
+}
+
+// monotonic clock in seconds
+static double nowSeconds(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec / 1e9;
+}
@@ -0,0 +1,70 @@
+/* pageloader.h - header file for CS50 TSE prefetching page loader
+ *
+ * Loads a crawl's pages ahead of whoever is using them. Reader threads load
+ *   pages into a ring of queueDepth slots while the caller takes them out
+ *   with pageloader_next, so reading the next pages from disk overlaps with
+ *   the work done on this one.
+ *
+ * One file per page: the readers take the listed pages in turn and load
+ *   them in parallel; the ring hands them back in the order of the list,
+ *   skipping any that cannot be loaded, just as pagedir_scan does.
+ * A packed store: a single reader runs pagedir_scan, reading whole segments,
+ *   and the pages come back in the order pagedir_scan gives them.
+ *
+ * The loader times its stages: time spent loading and waiting for room in
+ *   the ring (readers), and time spent waiting for pages and working on them
+ *   (the caller, between calls to pageloader_next).
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __PAGELOADER_H
+#define __PAGELOADER_H
+
+#include <stdio.h>
+#include "pagedir.h"
+#include "../libcs50/webpage.h"
+
+// opaque page loader
+typedef struct pageloader pageloader_t;
+
+/*
+ * Starts loading the pages of pageDirectory with readers threads (at least 1;
+ *   only 1 is used for a packed store) into a ring of queueDepth pages.
+ *   pages lists the count pages to load (see pagedir_list) and must last
+ *   until pageloader_delete; a packed store is read by pagedir_scan instead.
+ *
+ * We return a pointer to the loader, or NULL on bad parameters or if the
+ *   threads cannot be started. The user must call pageloader_delete.
+ */
+pageloader_t* pageloader_new(const char* pageDirectory,
+                             const pageInfo_t* pages, const int count,
+                             const int readers, const int queueDepth);
+
+/*
+ * Takes the next page, waiting for it to be loaded if need be, and sets
+ *   *docID to its docID.
+ *
+ * Several threads may take pages at once; each page goes to one of them,
+ *   and the time using pages is then measured from whichever took a page
+ *   last.
+ *
+ * We return the page, which the user must free with webpage_delete,
+ *   or NULL when there are no more pages.
+ */
+webpage_t* pageloader_next(pageloader_t* loader, int* docID);
+
+/*
+ * Prints the stage timing to fp: pages loaded, time spent loading and
+ *   waiting for room, time spent using pages and waiting for them, the
+ *   elapsed time, and how much of the loading and using overlapped.
+ */
+void pageloader_printStats(pageloader_t* loader, FILE* fp);
+
+/*
+ * Stops the readers and frees the loader, with any pages not yet taken
+ */
+void pageloader_delete(pageloader_t* loader);
+
+#endif // __PAGELOADER_H
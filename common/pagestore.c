@@ -0,0 +1,428 @@
+/* pagestore.c - CS50 TSE packed page store
+ *
+ * The index is kept in memory as an array of locations indexed by docID.
+ *   Each append writes the page to its segment and then its record to the
+ *   index, both with plain write(2) on O_APPEND descriptors; a page whose
+ *   record never made it to the index is just unreferenced bytes.
+ *
+ * Full and extensive documentation is in pagestore.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include "pagestore.h"
+
+// a segment is closed once it reaches this size
+static const uint64_t SEGMENT_BYTES = 64 * 1024 * 1024;
+
+// one record of the index file
+typedef struct record {
+  int32_t docID;
+  uint32_t segment;
+  uint64_t offset;
+  uint64_t length;
+} record_t;
+
+// where a page is; segment 0 means no page
+typedef struct location {
+  uint32_t segment;
+  uint64_t offset;
+  uint64_t length;
+} location_t;
+
+// defines a page store
+typedef struct pagestore {
+  char* dir;
+  location_t* pages;    // by docID; pages[0] unused
+  int capacity;         // entries in pages
+  int maxDocID;
+  int indexFd;
+  uint32_t segment;     // segment being appended to, 0 before the first
+  int writeFd;          // ... its descriptor, -1 until needed
+  uint64_t writeSize;   // ... its size
+  uint32_t readSegment; // segment open for reading, 0 if none
+  int readFd;
+} pagestore_t;
+
+// function prototypes
+static void segmentName(const pagestore_t* store, const uint32_t segment,
+                        char* name, const size_t size);
+static bool setLocation(pagestore_t* store, const record_t* rec);
+static bool loadIndex(pagestore_t* store);
+static bool openSegment(pagestore_t* store, const uint32_t segment);
+static bool writeAll(const int fd, const void* data, size_t len);
+static bool readAll(const int fd, void* data, size_t len, off_t offset);
+
+// is there a store here?
+bool pagestore_exists(const char* pageDirectory)
+{
+  if (pageDirectory == NULL) {
+    return false;
+  }
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.pagestore", pageDirectory);
+  return access(filename, F_OK) == 0;
+}
+
+// delete the store's files
+void pagestore_remove(const char* pageDirectory)
+{
+  if (!pagestore_exists(pageDirectory)) {
+    return;
+  }
+  pagestore_t* store = pagestore_open(pageDirectory, true); // drops segments
+  pagestore_close(store);
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.pagestore", pageDirectory);
+  unlink(filename);
+}
+
+// open (or create) the store in pageDirectory
+pagestore_t* pagestore_open(const char* pageDirectory, const bool create)
+{
+  if (pageDirectory == NULL) {
+    return NULL;
+  }
+
+  pagestore_t* store = calloc(1, sizeof(pagestore_t));
+  if (store == NULL) {
+    return NULL;
+  }
+  store->dir = malloc(strlen(pageDirectory) + 1);
+  if (store->dir == NULL) {
+    free(store);
+    return NULL;
+  }
+  strcpy(store->dir, pageDirectory);
+  store->writeFd = -1;
+  store->readFd = -1;
+
+  char filename[1024];
+  snprintf(filename, sizeof(filename), "%s/.pagestore", pageDirectory);
+  if (create) {
+    // old segments would otherwise be appended to
+    for (uint32_t s = 1; ; s++) {
+      segmentName(store, s, filename, sizeof(filename));
+      if (unlink(filename) != 0) {
+        break;
+      }
+    }
+    snprintf(filename, sizeof(filename), "%s/.pagestore", pageDirectory);
+    store->indexFd = open(filename, O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+  } else {
+    store->indexFd = open(filename, O_RDWR | O_APPEND);
+  }
+  if (store->indexFd < 0) {
+    fprintf(stderr, "pagestore: cannot open '%s'\n", filename);
+    pagestore_close(store);
+    return NULL;
+  }
+
+  if (!create && !loadIndex(store)) {
+    fprintf(stderr, "pagestore: cannot read '%s'\n", filename);
+    pagestore_close(store);
+    return NULL;
+  }
+  return store;
+}
+
+// add a page at the end of the current segment
+bool pagestore_append(pagestore_t* store, const int docID,
+                      const char* data, const size_t len)
+{
+  if (store == NULL || docID <= 0 || data == NULL) {
+    return false;
+  }
+
+  // carry on with the last segment, and start a new one when it is full
+  if (store->writeFd < 0
+      && !openSegment(store, (store->segment == 0) ? 1 : store->segment)) {
+    return false;
+  }
+  if (store->writeSize > 0 && store->writeSize + len > SEGMENT_BYTES
+      && !openSegment(store, store->segment + 1)) {
+    return false;
+  }
+
+  record_t rec = { docID, store->segment, store->writeSize, len };
+  if (!writeAll(store->writeFd, data, len)) {
+    fprintf(stderr, "pagestore: cannot write segment %u\n", store->segment);
+    return false;
+  }
+  store->writeSize += len;
+  if (!writeAll(store->indexFd, &rec, sizeof(rec))) {
+    fprintf(stderr, "pagestore: cannot write index\n");
+    return false;
+  }
+  return setLocation(store, &rec);
+}
+
+// read one page into a new buffer
+char* pagestore_read(pagestore_t* store, const int docID, size_t* len)
+{
+  if (store == NULL || docID <= 0 || docID > store->maxDocID || len == NULL) {
+    return NULL;
+  }
+  location_t* loc = &store->pages[docID];
+  if (loc->segment == 0) {
+    return NULL; // never stored
+  }
+
+  // keep the last segment read open; lookups cluster
+  if (store->readSegment != loc->segment) {
+    if (store->readFd >= 0) {
+      close(store->readFd);
+    }
+    char filename[1024];
+    segmentName(store, loc->segment, filename, sizeof(filename));
+    store->readFd = open(filename, O_RDONLY);
+    store->readSegment = (store->readFd >= 0) ? loc->segment : 0;
+    if (store->readFd < 0) {
+      return NULL;
+    }
+  }
+
+  char* data = malloc(loc->length + 1);
+  if (data == NULL) {
+    return NULL;
+  }
+  if (!readAll(store->readFd, data, loc->length, loc->offset)) {
+    free(data);
+    return NULL;
+  }
+  data[loc->length] = '\0';
+  *len = loc->length;
+  return data;
+}
+
+// highest docID stored
+int pagestore_maxDocID(pagestore_t* store)
+{
+  return (store == NULL) ? 0 : store->maxDocID;
+}
+
+// bytes stored for docID
+size_t pagestore_length(pagestore_t* store, const int docID)
+{
+  if (store == NULL || docID <= 0 || docID > store->maxDocID
+      || store->pages[docID].segment == 0) {
+    return 0;
+  }
+  return store->pages[docID].length;
+}
+
+// hand every page to itemfunc, reading each segment whole
+bool pagestore_scan(pagestore_t* store, void* arg,
+                    void (*itemfunc)(void* arg, const int docID,
+                                     char* data, const size_t len))
+{
+  if (store == NULL || itemfunc == NULL) {
+    return false;
+  }
+
+  int next = -1; // the following segment, opened early for its readahead hint
+  for (uint32_t s = 1; s <= store->segment; s++) {
+    char filename[1024];
+    segmentName(store, s, filename, sizeof(filename));
+    int fd = (next >= 0) ? next : open(filename, O_RDONLY);
+    next = -1;
+    struct stat st;
+    if (fd < 0 || fstat(fd, &st) != 0) {
+      if (fd >= 0) {
+        close(fd);
+      }
+      fprintf(stderr, "pagestore: cannot read '%s'\n", filename);
+      return false;
+    }
+
+    // one big read per segment; the extra byte terminates each page in turn
+    char* buf = malloc(st.st_size + 1);
+    if (buf == NULL || !readAll(fd, buf, st.st_size, 0)) {
+      fprintf(stderr, "pagestore: cannot read '%s'\n", filename);
+      free(buf);
+      close(fd);
+      return false;
+    }
+    close(fd);
+
+    // the kernel can read the next segment while this one's pages are used
+    if (s < store->segment) {
+      segmentName(store, s + 1, filename, sizeof(filename));
+      next = open(filename, O_RDONLY);
+      if (next >= 0) {
+        posix_fadvise(next, 0, 0, POSIX_FADV_WILLNEED);
+      }
+    }
+
+    for (int docID = 1; docID <= store->maxDocID; docID++) {
+      location_t* loc = &store->pages[docID];
+      if (loc->segment != s || loc->offset + loc->length > (uint64_t)st.st_size) {
+        continue;
+      }
+      char* data = buf + loc->offset;
+      char saved = data[loc->length];
+      data[loc->length] = '\0';
+      (*itemfunc)(arg, docID, data, loc->length);
+      data[loc->length] = saved;
+    }
+    free(buf);
+  }
+  return true;
+}
+
+// close files and free everything
+void pagestore_close(pagestore_t* store)
+{
+  if (store == NULL) {
+    return;
+  }
+  if (store->indexFd >= 0) {
+    close(store->indexFd);
+  }
+  if (store->writeFd >= 0) {
+    close(store->writeFd);
+  }
+  if (store->readFd >= 0) {
+    close(store->readFd);
+  }
+  free(store->pages);
+  free(store->dir);
+  free(store);
+}
+
+/**************** helpers ****************/
+
+// pageDirectory/segment-NNNN
+static void segmentName(const pagestore_t* store, const uint32_t segment,
+                        char* name, const size_t size)
+{
+  snprintf(name, size, "%s/segment-%04u", store->dir, segment);
+}
+
+// remember where rec's page is, growing the table as needed
+static bool setLocation(pagestore_t* store, const record_t* rec)
+{
+  if (rec->docID >= store->capacity) {
+    int capacity = (store->capacity == 0) ? 1024 : store->capacity;
+    while (capacity <= rec->docID) {
+      capacity *= 2;
+    }
+    location_t* pages = realloc(store->pages, capacity * sizeof(location_t));
+    if (pages == NULL) {
+      return false;
+    }
+    memset(pages + store->capacity, 0,
+           (capacity - store->capacity) * sizeof(location_t));
+    store->pages = pages;
+    store->capacity = capacity;
+  }
+
+  store->pages[rec->docID].segment = rec->segment;
+  store->pages[rec->docID].offset = rec->offset;
+  store->pages[rec->docID].length = rec->length;
+  if (rec->docID > store->maxDocID) {
+    store->maxDocID = rec->docID;
+  }
+  if (rec->segment > store->segment) {
+    store->segment = rec->segment;
+  }
+  return true;
+}
+
+// read every index record; a torn last record is cut off
+static bool loadIndex(pagestore_t* store)
+{
+  struct stat st;
+  if (fstat(store->indexFd, &st) != 0) {
+    return false;
+  }
+  size_t count = st.st_size / sizeof(record_t);
+  record_t* recs = malloc(count * sizeof(record_t) + 1);
+  if (recs == NULL || !readAll(store->indexFd, recs, count * sizeof(record_t), 0)) {
+    free(recs);
+    return false;
+  }
+
+  bool ok = true;
+  for (size_t i = 0; i < count && ok; i++) {
+    ok = recs[i].docID > 0 && recs[i].segment > 0 && setLocation(store, &recs[i]);
+  }
+  free(recs);
+
+  if ((off_t)(count * sizeof(record_t)) != st.st_size
+      && ftruncate(store->indexFd, count * sizeof(record_t)) != 0) {
+    return false;
+  }
+  return ok;
+}
+
+// make segment the one appended to
+static bool openSegment(pagestore_t* store, const uint32_t segment)
+{
+  char filename[1024];
+  segmentName(store, segment, filename, sizeof(filename));
+  int fd = open(filename, O_WRONLY | O_CREAT | O_APPEND, 0644);
+  struct stat st;
+  if (fd < 0 || fstat(fd, &st) != 0) {
+    if (fd >= 0) {
+      close(fd);
+    }
+    fprintf(stderr, "pagestore: cannot open '%s'\n", filename);
+    return false;
+  }
+  if (store->writeFd >= 0) {
+    close(store->writeFd);
+  }
+  store->writeFd = fd;
+  store->segment = segment;
+  store->writeSize = st.st_size;
+  return true;
+}
+
+// write(2) until done
+static bool writeAll(const int fd, const void* data, size_t len)
+{
+  const char* p = data;
+  while (len > 0) {
+    ssize_t n = write(fd, p, len);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+  }
+  return true;
+}
+
+// pread(2) until done
+static bool readAll(const int fd, void* data, size_t len, off_t offset)
+{
+  char* p = data;
+  while (len > 0) {
+    ssize_t n = pread(fd, p, len, offset);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    p += n;
+    len -= n;
+    offset += n;
+  }
+  return true;
+}
@@ -0,0 +1,96 @@
+/* pagestore.h - header file for CS50 TSE packed page store
+ *
+ * A page store keeps a crawl's pages in a few large segment files instead of
+ *   one file per docID. Pages are appended to the current segment,
+ *   pageDirectory/segment-NNNN, which is closed at SEGMENT_BYTES and a new
+ *   one started. An index file, pageDirectory/.pagestore, holds one
+ *   fixed-size record per append:
+ *
+ *   docID, segment, offset, length     (4 + 4 + 8 + 8 bytes, host order)
+ *
+ * The index is append-only too; if a docID is stored twice (as on a resumed
+ *   crawl) the later record wins. The whole index is read into memory when
+ *   the store is opened, so finding a page costs one pread.
+ *
+ * The store does not know what a page looks like: each page is an opaque
+ *   run of bytes (pagedir.c writes the same text as a page file).
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __PAGESTORE_H
+#define __PAGESTORE_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+// opaque page store
+typedef struct pagestore pagestore_t;
+
+/*
+ * We return true if pageDirectory holds a page store.
+ */
+bool pagestore_exists(const char* pageDirectory);
+
+/*
+ * Deletes the store in pageDirectory (its index and segments), if any.
+ */
+void pagestore_remove(const char* pageDirectory);
+
+/*
+ * Opens the store in pageDirectory. With create true any old store there is
+ *   emptied (or a new one made); otherwise the store must exist, and new
+ *   pages are appended after the old ones.
+ *
+ * We return a pointer to the store, or NULL if it cannot be opened.
+ */
+pagestore_t* pagestore_open(const char* pageDirectory, const bool create);
+
+/*
+ * Appends len bytes of data as page docID (> 0). The bytes are handed to the
+ *   kernel before we return, so they survive the process being killed.
+ *
+ * We return false on bad parameters or if the store could not be written.
+ */
+bool pagestore_append(pagestore_t* store, const int docID,
+                      const char* data, const size_t len);
+
+/*
+ * Reads page docID.
+ *
+ * We return a malloc'd copy of its bytes with a '\0' after them, setting
+ *   *len to their number, or NULL if there is no such page.
+ *   The caller must free the result.
+ */
+char* pagestore_read(pagestore_t* store, const int docID, size_t* len);
+
+/*
+ * We return the highest docID in the store, 0 if it is empty.
+ */
+int pagestore_maxDocID(pagestore_t* store);
+
+/*
+ * We return the number of bytes stored for page docID, 0 if there is no
+ *   such page. No file is read.
+ */
+size_t pagestore_length(pagestore_t* store, const int docID);
+
+/*
+ * Reads the store one whole segment at a time, calling
+ *   itemfunc(arg, docID, data, len) for every page in it; data ends in '\0'
+ *   and is only valid during the call. Pages come in docID order within a
+ *   segment, and segments in the order they were written.
+ *
+ * We return false if a segment could not be read.
+ */
+bool pagestore_scan(pagestore_t* store, void* arg,
+                    void (*itemfunc)(void* arg, const int docID,
+                                     char* data, const size_t len));
+
+/*
+ * Close the store, free allocated memory
+ */
+void pagestore_close(pagestore_t* store);
+
+#endif // __PAGESTORE_H
@@ -0,0 +1,558 @@
+/* posindex.c - CS50 TSE positional index
+ *
+ * A strarena numbers the words, and an array indexed by that number holds
+ *   each word's postings: an array of documents, and a single byte buffer
+ *   holding the delta-encoded positions of every document back to back.
+ *
+ * Full and extensive documentation is in posindex.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "../libcs50/counters.h"
+#include "posindex.h"
+#include "strarena.h"
+
+// file header for a saved positional index
+static const char POS_MAGIC[] = "TSEPOS1\n";
+
+// one document within a word's postings
+typedef struct docpos {
+  int docID;
+  int npos;        // number of positions of the word in this doc
+  size_t start;    // offset of the first encoded position in bytes
+  size_t len;      // number of encoded bytes
+} docpos_t;
+
+// all occurrences of one word
+typedef struct postings {
+  docpos_t* docs;
+  int ndocs;
+  int maxdocs;
+  unsigned char* bytes; // varint position deltas of all docs
+  size_t nbytes;
+  size_t maxbytes;
+  int lastPos;          // last position inserted into docs[ndocs-1]
+  bool sorted;          // docs are in increasing docID order
+} postings_t;
+
+// defines a positional index
+typedef struct posindex {
+  strarena_t* words;      // word to handle
+  postings_t** postings;  // by handle
+  int cap;
+} posindex_t;
+
+// function prototypes
+static postings_t* wordPostings(posindex_t* pidx, const char* word,
+                                const size_t len, bool* fresh);
+static postings_t* postings_new(void);
+static void postings_delete(postings_t* p);
+static bool postings_addDoc(postings_t* p, const int docID);
+static bool postings_addBytes(postings_t* p, const unsigned char* src, size_t len);
+static void postings_sort(postings_t* p);
+static int compareDocpos(const void* a, const void* b);
+static int* decodePositions(const postings_t* p, const docpos_t* doc);
+static bool containsPosition(const int* pos, const int npos, const int target);
+static int encodeVarint(uint64_t value, unsigned char* out);
+static bool writeVarint(FILE* fp, uint64_t value);
+static bool readVarint(FILE* fp, uint64_t* value);
+static void saveWord(FILE* fp, const char* word, const size_t len,
+                     postings_t* p);
+
+// create a new positional index
+posindex_t* posindex_new(const int slots)
+{
+  posindex_t* pidx = malloc(sizeof(posindex_t));
+  if (pidx == NULL) {
+    return NULL;
+  }
+
+  pidx->words = strarena_new(slots);
+  if (pidx->words == NULL) {
+    free(pidx);
+    return NULL;
+  }
+  pidx->postings = NULL;
+  pidx->cap = 0;
+  return pidx;
+}
+
+// record one occurrence of word at position in docID
+bool posindex_insert(posindex_t* pidx, const char* word, const int docID,
+                     const int position)
+{
+  if (pidx == NULL || word == NULL || docID <= 0 || position < 0) {
+    return false; // bad parameters
+  }
+
+  bool fresh;
+  postings_t* p = wordPostings(pidx, word, strlen(word), &fresh);
+  if (p == NULL) {
+    return false;
+  }
+
+  // first occurrence in this doc starts a new entry
+  if (p->ndocs == 0 || p->docs[p->ndocs - 1].docID != docID) {
+    if (!postings_addDoc(p, docID)) {
+      return false;
+    }
+  } else if (position <= p->lastPos) {
+    return false; // positions must increase within a doc
+  }
+
+  // store the distance from the previous position
+  docpos_t* doc = &p->docs[p->ndocs - 1];
+  unsigned char buf[10];
+  int len = encodeVarint(position - (doc->npos == 0 ? 0 : p->lastPos), buf);
+  if (!postings_addBytes(p, buf, len)) {
+    return false;
+  }
+  doc->len += len;
+  doc->npos++;
+  p->lastPos = position;
+  return true;
+}
+
+// find documents where the words occur next to each other, in order
+counters_t* posindex_phrase(posindex_t* pidx, char** words, const int nwords)
+{
+  if (pidx == NULL || words == NULL || nwords <= 0) {
+    return NULL; // bad parameters
+  }
+
+  counters_t* result = counters_new();
+  if (result == NULL) {
+    return NULL;
+  }
+
+  // every word must be in the index for the phrase to occur anywhere
+  postings_t** lists = calloc(nwords, sizeof(postings_t*));
+  int* cursor = calloc(nwords, sizeof(int));
+  int** positions = calloc(nwords, sizeof(int*));
+  if (lists == NULL || cursor == NULL || positions == NULL) {
+    free(lists);
+    free(cursor);
+    free(positions);
+    counters_delete(result);
+    return NULL;
+  }
+  for (int i = 0; i < nwords; i++) {
+    int w = strarena_find(pidx->words, words[i], strlen(words[i]));
+    lists[i] = (w < 0) ? NULL : pidx->postings[w];
+    if (lists[i] == NULL) {
+      free(lists);
+      free(cursor);
+      free(positions);
+      return result; // empty
+    }
+    postings_sort(lists[i]);
+  }
+
+  // walk the docs of the first word, advancing the others to the same docID
+  for (int d = 0; d < lists[0]->ndocs; d++) {
+    int docID = lists[0]->docs[d].docID;
+    bool inAll = true;
+    for (int i = 1; i < nwords && inAll; i++) {
+      postings_t* p = lists[i];
+      while (cursor[i] < p->ndocs && p->docs[cursor[i]].docID < docID) {
+        cursor[i]++;
+      }
+      if (cursor[i] >= p->ndocs) {
+        d = lists[0]->ndocs; // some word has run out of docs
+        inAll = false;
+      } else if (p->docs[cursor[i]].docID != docID) {
+        inAll = false;
+      }
+    }
+    if (!inAll) {
+      continue;
+    }
+
+    // positional intersection: word i must sit at (start + i)
+    bool ok = true;
+    for (int i = 0; i < nwords; i++) {
+      const docpos_t* doc = (i == 0) ? &lists[0]->docs[d]
+                                     : &lists[i]->docs[cursor[i]];
+      positions[i] = decodePositions(lists[i], doc);
+      if (positions[i] == NULL) {
+        ok = false;
+      }
+    }
+
+    int matches = 0;
+    const docpos_t* first = &lists[0]->docs[d];
+    for (int k = 0; ok && k < first->npos; k++) {
+      int start = positions[0][k];
+      bool found = true;
+      for (int i = 1; i < nwords && found; i++) {
+        const docpos_t* doc = &lists[i]->docs[cursor[i]];
+        found = containsPosition(positions[i], doc->npos, start + i);
+      }
+      if (found) {
+        matches++;
+      }
+    }
+    if (matches > 0) {
+      counters_set(result, docID, matches);
+    }
+
+    for (int i = 0; i < nwords; i++) {
+      free(positions[i]);
+      positions[i] = NULL;
+    }
+    if (!ok) {
+      counters_delete(result);
+      result = NULL;
+      break;
+    }
+  }
+
+  free(lists);
+  free(cursor);
+  free(positions);
+  return result;
+}
+
+// saves the positional index to a file
+bool posindex_save(posindex_t* pidx, const char* filename)
+{
+  if (pidx == NULL || filename == NULL) {
+    return false; // bad arguments
+  }
+
+  FILE* fp = fopen(filename, "wb");
+  if (fp == NULL) {
+    fprintf(stderr, "posindex_save: cannot open file '%s'\n", filename);
+    return false;
+  }
+
+  fputs(POS_MAGIC, fp);
+  for (int w = 0; w < strarena_count(pidx->words); w++) {
+    saveWord(fp, strarena_get(pidx->words, w), strarena_length(pidx->words, w),
+             pidx->postings[w]);
+  }
+
+  bool ok = !ferror(fp);
+  if (fclose(fp) != 0) {
+    ok = false;
+  }
+  return ok;
+}
+
+/*
+ * Called by posindex_save
+ *   writes one word and its postings, docs sorted by docID
+ */
+static void saveWord(FILE* fp, const char* word, const size_t len,
+                     postings_t* p)
+{
+  if (word == NULL || p == NULL) {
+    return; // bad args
+  }
+
+  postings_sort(p);
+
+  writeVarint(fp, len);
+  fwrite(word, 1, len, fp);
+  writeVarint(fp, p->ndocs);
+
+  int prevDocID = 0;
+  for (int d = 0; d < p->ndocs; d++) {
+    docpos_t* doc = &p->docs[d];
+    writeVarint(fp, doc->docID - prevDocID);
+    writeVarint(fp, doc->npos);
+    writeVarint(fp, doc->len);
+    fwrite(p->bytes + doc->start, 1, doc->len, fp);
+    prevDocID = doc->docID;
+  }
+}
+
+// load a positional index written by posindex_save
+posindex_t* posindex_load(const char* filename)
+{
+  if (filename == NULL) {
+    return NULL;
+  }
+  FILE* fp = fopen(filename, "rb");
+  if (fp == NULL) {
+    return NULL;
+  }
+
+  // check the header
+  char magic[sizeof(POS_MAGIC)] = { 0 };
+  if (fread(magic, 1, strlen(POS_MAGIC), fp) != strlen(POS_MAGIC)
+      || strcmp(magic, POS_MAGIC) != 0) {
+    fclose(fp);
+    return NULL;
+  }
+
+  posindex_t* pidx = posindex_new(500);
+  if (pidx == NULL) {
+    fclose(fp);
+    return NULL;
+  }
+
+  bool ok = true;
+  uint64_t wordLen;
+  unsigned char chunk[4096];
+  while (ok && readVarint(fp, &wordLen)) {
+    char* word = malloc(wordLen + 1);
+    uint64_t ndocs = 0;
+    bool fresh = false;
+    postings_t* p = NULL;
+    if (word == NULL || fread(word, 1, wordLen, fp) != wordLen
+        || !readVarint(fp, &ndocs)
+        || (p = wordPostings(pidx, word, wordLen, &fresh)) == NULL
+        || !fresh) {
+      free(word);
+      ok = false; // also a word saved twice
+      break;
+    }
+    free(word);
+
+    // each doc: docID delta, npos, nbytes, then the encoded positions
+    int docID = 0;
+    for (uint64_t d = 0; ok && d < ndocs; d++) {
+      uint64_t delta, npos, len;
+      if (!readVarint(fp, &delta) || !readVarint(fp, &npos)
+          || !readVarint(fp, &len) || !postings_addDoc(p, docID + delta)) {
+        ok = false;
+        break;
+      }
+      docID += delta;
+      p->docs[p->ndocs - 1].npos = npos;
+      p->docs[p->ndocs - 1].len = len;
+      while (len > 0) {
+        size_t n = len < sizeof(chunk) ? len : sizeof(chunk);
+        if (fread(chunk, 1, n, fp) != n || !postings_addBytes(p, chunk, n)) {
+          ok = false;
+          break;
+        }
+        len -= n;
+      }
+    }
+  }
+
+  fclose(fp);
+  if (!ok) {
+    posindex_delete(pidx);
+    return NULL;
+  }
+  return pidx;
+}
+
+// deletes the positional index
+void posindex_delete(posindex_t* pidx)
+{
+  if (pidx == NULL) {
+    return;
+  }
+  for (int w = 0; w < strarena_count(pidx->words); w++) {
+    postings_delete(pidx->postings[w]);
+  }
+  free(pidx->postings);
+  strarena_delete(pidx->words);
+  free(pidx);
+}
+
+/**************** postings ****************/
+
+/*
+ * Returns the postings of the word of len bytes, interning the word and
+ *   making it empty postings if it is new (*fresh says whether it was).
+ *   Returns NULL if out of memory
+ */
+static postings_t* wordPostings(posindex_t* pidx, const char* word,
+                                const size_t len, bool* fresh)
+{
+  int w = strarena_intern(pidx->words, word, len);
+  if (w < 0) {
+    return NULL;
+  }
+  if (w >= pidx->cap) {
+    int cap = (pidx->cap == 0) ? 1024 : pidx->cap * 2;
+    postings_t** grown = realloc(pidx->postings, cap * sizeof(postings_t*));
+    if (grown == NULL) {
+      return NULL;
+    }
+    memset(grown + pidx->cap, 0, (cap - pidx->cap) * sizeof(postings_t*));
+    pidx->postings = grown;
+    pidx->cap = cap;
+  }
+  *fresh = (pidx->postings[w] == NULL);
+  if (*fresh) {
+    pidx->postings[w] = postings_new();
+  }
+  return pidx->postings[w];
+}
+
+// create empty postings for a word
+static postings_t* postings_new(void)
+{
+  postings_t* p = calloc(1, sizeof(postings_t));
+  if (p != NULL) {
+    p->sorted = true;
+  }
+  return p;
+}
+
+// free postings
+static void postings_delete(postings_t* p)
+{
+  if (p == NULL) {
+    return;
+  }
+  free(p->docs);
+  free(p->bytes);
+  free(p);
+}
+
+// start a new (empty) doc entry at the end of the postings
+static bool postings_addDoc(postings_t* p, const int docID)
+{
+  if (p->ndocs == p->maxdocs) {
+    int newMax = p->maxdocs == 0 ? 4 : p->maxdocs * 2;
+    docpos_t* newDocs = realloc(p->docs, newMax * sizeof(docpos_t));
+    if (newDocs == NULL) {
+      return false;
+    }
+    p->docs = newDocs;
+    p->maxdocs = newMax;
+  }
+  if (p->ndocs > 0 && p->docs[p->ndocs - 1].docID > docID) {
+    p->sorted = false;
+  }
+
+  docpos_t* doc = &p->docs[p->ndocs++];
+  doc->docID = docID;
+  doc->npos = 0;
+  doc->start = p->nbytes;
+  doc->len = 0;
+  p->lastPos = 0;
+  return true;
+}
+
+// append encoded bytes, doubling the buffer as needed
+static bool postings_addBytes(postings_t* p, const unsigned char* src, size_t len)
+{
+  if (p->nbytes + len > p->maxbytes) {
+    size_t newMax = p->maxbytes == 0 ? 16 : p->maxbytes * 2;
+    while (newMax < p->nbytes + len) {
+      newMax *= 2;
+    }
+    unsigned char* newBytes = realloc(p->bytes, newMax);
+    if (newBytes == NULL) {
+      return false;
+    }
+    p->bytes = newBytes;
+    p->maxbytes = newMax;
+  }
+  memcpy(p->bytes + p->nbytes, src, len);
+  p->nbytes += len;
+  return true;
+}
+
+// put docs in docID order; the encoded bytes stay where they are
+static void postings_sort(postings_t* p)
+{
+  if (!p->sorted) {
+    qsort(p->docs, p->ndocs, sizeof(docpos_t), compareDocpos);
+    p->sorted = true;
+  }
+}
+
+// orders doc entries by increasing docID
+static int compareDocpos(const void* a, const void* b)
+{
+  const docpos_t* da = a;
+  const docpos_t* db = b;
+  return (da->docID > db->docID) - (da->docID < db->docID);
+}
+
+// expands the delta-encoded positions of one doc into a new array
+static int* decodePositions(const postings_t* p, const docpos_t* doc)
+{
+  int* pos = malloc((doc->npos > 0 ? doc->npos : 1) * sizeof(int));
+  if (pos == NULL) {
+    return NULL;
+  }
+
+  const unsigned char* in = p->bytes + doc->start;
+  int current = 0;
+  for (int i = 0; i < doc->npos; i++) {
+    uint64_t value = 0;
+    int shift = 0;
+    unsigned char byte;
+    do {
+      byte = *in++;
+      value |= (uint64_t)(byte & 0x7f) << shift;
+      shift += 7;
+    } while (byte & 0x80);
+    current += (int)value;
+    pos[i] = current;
+  }
+  return pos;
+}
+
+// binary search of a sorted position array
+static bool containsPosition(const int* pos, const int npos, const int target)
+{
+  int lo = 0;
+  int hi = npos - 1;
+  while (lo <= hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (pos[mid] == target) {
+      return true;
+    } else if (pos[mid] < target) {
+      lo = mid + 1;
+    } else {
+      hi = mid - 1;
+    }
+  }
+  return false;
+}
+
+/**************** varints ****************/
+
+// 7 bits per byte, high bit set on all but the last byte; returns bytes used
+static int encodeVarint(uint64_t value, unsigned char* out)
+{
+  int len = 0;
+  while (value >= 0x80) {
+    out[len++] = (unsigned char)(value | 0x80);
+    value >>= 7;
+  }
+  out[len++] = (unsigned char)value;
+  return len;
+}
+
+// write one varint to a file
+static bool writeVarint(FILE* fp, uint64_t value)
+{
+  unsigned char buf[10];
+  int len = encodeVarint(value, buf);
+  return fwrite(buf, 1, len, fp) == (size_t)len;
+}
+
+// read one varint from a file; false at EOF or on a truncated number
+static bool readVarint(FILE* fp, uint64_t* value)
+{
+  *value = 0;
+  for (int shift = 0; shift < 64; shift += 7) {
+    int c = getc(fp);
+    if (c == EOF) {
+      return false;
+    }
+    *value |= (uint64_t)(c & 0x7f) << shift;
+    if ((c & 0x80) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
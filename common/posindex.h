@@ -0,0 +1,76 @@
+/* posindex.h - header file for CS50 TSE positional index
+ *
+ * A positional index maps a word to the list of documents it appears in,
+ *   and for each document, the positions (word offsets) of every occurrence.
+ *   Position lists are kept delta-encoded as variable-length integers, so a
+ *   typical position costs one byte.
+ *
+ * It is the optional layer beneath index.h that makes phrase queries possible
+ *   without re-reading the pages from pageDirectory.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __POSINDEX_H
+#define __POSINDEX_H
+
+#include <stdbool.h>
+#include "../libcs50/counters.h"
+
+// opaque positional index
+typedef struct posindex posindex_t;
+
+/*
+ * The user provides the number of distinct words expected (a hint only).
+ * We return a pointer to a new, empty positional index, or NULL on error.
+ */
+posindex_t* posindex_new(const int slots);
+
+/*
+ * The user gives a positional index, a word, a docID and the position of the
+ *   word within that document (0 is the first word of the page).
+ *
+ * All positions of a word within one document must be inserted together and
+ *   in increasing order; documents themselves may arrive in any order.
+ *
+ * We return true on success, false on bad parameters or memory error.
+ */
+bool posindex_insert(posindex_t* pidx, const char* word, const int docID,
+                     const int position);
+
+/*
+ * The user gives a positional index and an array of nwords normalized words.
+ *
+ * We return a new counters mapping each docID to the number of times the words
+ *   occur there consecutively (as a phrase). Documents without the phrase are
+ *   left out, so the counters may be empty. NULL is returned on bad parameters
+ *   or memory error.
+ *
+ * The caller is responsible for counters_delete() on the result.
+ */
+counters_t* posindex_phrase(posindex_t* pidx, char** words, const int nwords);
+
+/*
+ * Saves the positional index to filename in a compact binary format:
+ *   "TSEPOS1\n", then for every word
+ *     len word ndocs [docID-delta npos nbytes position-deltas...]
+ *   with every number written as a variable-length integer.
+ *
+ * We return false if the file could not be written.
+ */
+bool posindex_save(posindex_t* pidx, const char* filename);
+
+/*
+ * Loads a positional index written by posindex_save.
+ *
+ * We return NULL if the file cannot be read or is malformed.
+ */
+posindex_t* posindex_load(const char* filename);
+
+/*
+ * Delete the positional index, free allocated memory
+ */
+void posindex_delete(posindex_t* pidx);
+
+#endif // __POSINDEX_H
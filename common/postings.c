@@ -0,0 +1,371 @@
+/* postings.c - CS50 TSE postings lists
+ *
+ * A list is two parallel arrays, docIDs and counts. A union keeps a
+ *   min-heap of cursors, one per list, by the docID each is at: the top
+ *   cursor's pair is added to the result (to the last pair, if it has the
+ *   same docID), and the cursor goes back on the heap at its next pair.
+ *
+ * Full and extensive documentation is in postings.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdbool.h>
+#include <limits.h>
+#include "postings.h"
+#include "../libcs50/counters.h"
+
+// defines a postings list
+typedef struct postings {
+  int* docIDs;          // increasing
+  int* counts;
+  int n;
+} postings_t;
+
+// one list being merged, and how far along it is
+typedef struct cursor {
+  const postings_t* list;
+  int at;
+} cursor_t;
+
+// function prototypes
+static postings_t* newPostings(const int cap);
+static void countPair(void* arg, const int docID, const int count);
+static void addPair(void* arg, const int docID, const int count);
+static bool isSorted(const postings_t* list);
+static void sortPairs(postings_t* list);
+static int comparePairs(const void* a, const void* b);
+static void heapPush(cursor_t** heap, int* n, cursor_t* cursor);
+static cursor_t* heapPop(cursor_t** heap, int* n);
+
+// a counters' pairs, in docID order
+postings_t* postings_fromCounters(counters_t* ctrs)
+{
+  int n = 0;
+  counters_iterate(ctrs, &n, countPair);
+  postings_t* list = newPostings(n);
+  if (list == NULL) {
+    return NULL;
+  }
+  counters_iterate(ctrs, list, addPair);
+  if (!isSorted(list)) {
+    sortPairs(list);
+  }
+  return list;
+}
+
+// the pairs in docID order, duplicates added up, counts of 0 or less dropped
+postings_t* postings_fromPairs(const int* docIDs, const int* counts,
+                               const int n)
+{
+  if (n < 0 || (n > 0 && (docIDs == NULL || counts == NULL))) {
+    return NULL;
+  }
+  postings_t* list = newPostings(n);
+  if (list == NULL) {
+    return NULL;
+  }
+  for (int i = 0; i < n; i++) {
+    list->docIDs[i] = docIDs[i];
+    list->counts[i] = counts[i];
+  }
+  list->n = n;
+  if (!isSorted(list)) {
+    sortPairs(list);
+  }
+  // squeeze out duplicates and empty counts in place
+  int kept = 0;
+  for (int i = 0; i < list->n; i++) {
+    if (kept > 0 && list->docIDs[kept - 1] == list->docIDs[i]) {
+      list->counts[kept - 1] += list->counts[i];
+    } else {
+      if (kept > 0 && list->counts[kept - 1] <= 0) {
+        kept--;
+      }
+      list->docIDs[kept] = list->docIDs[i];
+      list->counts[kept] = list->counts[i];
+      kept++;
+    }
+  }
+  if (kept > 0 && list->counts[kept - 1] <= 0) {
+    kept--;
+  }
+  list->n = kept;
+  return list;
+}
+
+// docIDs in the list
+int postings_count(postings_t* list)
+{
+  return (list == NULL) ? 0 : list->n;
+}
+
+// the docIDs
+const int* postings_docIDs(postings_t* list)
+{
+  return (list == NULL) ? NULL : list->docIDs;
+}
+
+// the counts
+const int* postings_counts(postings_t* list)
+{
+  return (list == NULL) ? NULL : list->counts;
+}
+
+// gallop ahead to docID, then binary search the last step
+int postings_seek(postings_t* list, const int docID, int* at)
+{
+  if (list == NULL || at == NULL || *at >= list->n) {
+    return 0;
+  }
+  int lo = *at;
+  if (list->docIDs[lo] < docID) {
+    // docIDs[lo] < docID: find hi with docIDs[hi] >= docID, or the end
+    int step = 1;
+    int hi = lo + step;
+    while (hi < list->n && list->docIDs[hi] < docID) {
+      lo = hi;
+      step *= 2;
+      hi = lo + step;
+    }
+    if (hi > list->n) {
+      hi = list->n;
+    }
+    lo++;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (list->docIDs[mid] < docID) {
+        lo = mid + 1;
+      } else {
+        hi = mid;
+      }
+    }
+  }
+  *at = lo;
+  return (lo < list->n && list->docIDs[lo] == docID) ? list->counts[lo] : 0;
+}
+
+// every docID of the k lists, counts added, in one pass over them all
+postings_t* postings_union(postings_t** lists, const int k)
+{
+  if (lists == NULL || k < 0) {
+    return NULL;
+  }
+  long total = 0;
+  for (int i = 0; i < k; i++) {
+    total += postings_count(lists[i]);
+  }
+  if (total > INT_MAX) {
+    return NULL;
+  }
+  postings_t* result = newPostings(total);
+  cursor_t* cursors = malloc((k + 1) * sizeof(cursor_t));
+  cursor_t** heap = malloc((k + 1) * sizeof(cursor_t*));
+  if (result == NULL || cursors == NULL || heap == NULL) {
+    postings_delete(result);
+    free(cursors);
+    free(heap);
+    return NULL;
+  }
+
+  int n = 0;
+  for (int i = 0; i < k; i++) {
+    if (postings_count(lists[i]) > 0) {
+      cursors[i].list = lists[i];
+      cursors[i].at = 0;
+      heapPush(heap, &n, &cursors[i]);
+    }
+  }
+  while (n > 0) {
+    cursor_t* top = heapPop(heap, &n);
+    int docID = top->list->docIDs[top->at];
+    int count = top->list->counts[top->at];
+    if (result->n > 0 && result->docIDs[result->n - 1] == docID) {
+      result->counts[result->n - 1] += count;
+    } else {
+      result->docIDs[result->n] = docID;
+      result->counts[result->n] = count;
+      result->n++;
+    }
+    if (++top->at < top->list->n) {
+      heapPush(heap, &n, top);
+    }
+  }
+  free(cursors);
+  free(heap);
+  return result;
+}
+
+// the list's pairs whose docID is not among the sorted docIDs
+postings_t* postings_without(postings_t* list, const int* docIDs,
+                             const int n)
+{
+  if (n < 0 || (n > 0 && docIDs == NULL)) {
+    return NULL;
+  }
+  postings_t* result = newPostings(postings_count(list));
+  if (result == NULL || list == NULL) {
+    return result;
+  }
+  int j = 0;
+  for (int i = 0; i < list->n; i++) {
+    while (j < n && docIDs[j] < list->docIDs[i]) {
+      j++;
+    }
+    if (j < n && docIDs[j] == list->docIDs[i]) {
+      continue;
+    }
+    result->docIDs[result->n] = list->docIDs[i];
+    result->counts[result->n] = list->counts[i];
+    result->n++;
+  }
+  return result;
+}
+
+// the list as counters
+counters_t* postings_toCounters(postings_t* list)
+{
+  counters_t* ctrs = counters_new();
+  if (ctrs == NULL || list == NULL) {
+    return ctrs;
+  }
+  for (int i = 0; i < list->n; i++) {
+    counters_set(ctrs, list->docIDs[i], list->counts[i]);
+  }
+  return ctrs;
+}
+
+// frees the list
+void postings_delete(postings_t* list)
+{
+  if (list == NULL) {
+    return;
+  }
+  free(list->docIDs);
+  free(list->counts);
+  free(list);
+}
+
+// an empty list with room for cap pairs; NULL if out of memory
+static postings_t* newPostings(const int cap)
+{
+  postings_t* list = malloc(sizeof(postings_t));
+  if (list == NULL) {
+    return NULL;
+  }
+  list->docIDs = malloc((cap + 1) * sizeof(int));
+  list->counts = malloc((cap + 1) * sizeof(int));
+  list->n = 0;
+  if (list->docIDs == NULL || list->counts == NULL) {
+    postings_delete(list);
+    return NULL;
+  }
+  return list;
+}
+
+// counters_iterate helper: count the pairs to keep
+static void countPair(void* arg, const int docID, const int count)
+{
+  if (count > 0) {
+    (*(int*)arg)++;
+  }
+}
+
+// counters_iterate helper: keep a pair
+static void addPair(void* arg, const int docID, const int count)
+{
+  postings_t* list = arg;
+  if (count > 0) {
+    list->docIDs[list->n] = docID;
+    list->counts[list->n] = count;
+    list->n++;
+  }
+}
+
+// are the docIDs increasing?
+static bool isSorted(const postings_t* list)
+{
+  for (int i = 1; i < list->n; i++) {
+    if (list->docIDs[i - 1] >= list->docIDs[i]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+/*
+ * Puts the pairs in docID order: they are sorted as (docID, count) pairs
+ *   and copied back, as the two arrays cannot be sorted together in place
+ */
+static void sortPairs(postings_t* list)
+{
+  int (*pairs)[2] = malloc((list->n + 1) * sizeof(*pairs));
+  if (pairs == NULL) {
+    return; // leaves the list as it is
+  }
+  for (int i = 0; i < list->n; i++) {
+    pairs[i][0] = list->docIDs[i];
+    pairs[i][1] = list->counts[i];
+  }
+  qsort(pairs, list->n, sizeof(*pairs), comparePairs);
+  for (int i = 0; i < list->n; i++) {
+    list->docIDs[i] = pairs[i][0];
+    list->counts[i] = pairs[i][1];
+  }
+  free(pairs);
+}
+
+// qsort comparison of two (docID, count) pairs by docID
+static int comparePairs(const void* a, const void* b)
+{
+  int x = ((const int*)a)[0];
+  int y = ((const int*)b)[0];
+  return (x > y) - (x < y);
+}
+
+// add cursor to the min-heap of lists by current docID
+static void heapPush(cursor_t** heap, int* n, cursor_t* cursor)
+{
+  int docID = cursor->list->docIDs[cursor->at];
+  int i = (*n)++;
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (heap[parent]->list->docIDs[heap[parent]->at] <= docID) {
+      break;
+    }
+    heap[i] = heap[parent];
+    i = parent;
+  }
+  heap[i] = cursor;
+}
+
+// take the list with the smallest current docID off the heap
+static cursor_t* heapPop(cursor_t** heap, int* n)
+{
+  cursor_t* top = heap[0];
+  cursor_t* last = heap[--(*n)];
+  int docID = last->list->docIDs[last->at];
+  int i = 0;
+  while (true) {
+    int child = 2 * i + 1;
+    if (child >= *n) {
+      break;
+    }
+    if (child + 1 < *n && heap[child + 1]->list->docIDs[heap[child + 1]->at]
+                          < heap[child]->list->docIDs[heap[child]->at]) {
+      child++;
+    }
+    if (docID <= heap[child]->list->docIDs[heap[child]->at]) {
+      break;
+    }
+    heap[i] = heap[child];
+    i = child;
+  }
+  if (*n > 0) {
+    heap[i] = last;
+  }
+  return top;
+}
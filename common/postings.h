@@ -0,0 +1,98 @@
+/* postings.h - header file for CS50 TSE postings lists
+ *
+ * A postings list is one word's (docID, count) pairs in increasing docID
+ *   order, held in an array. counters keep their pairs in a linked list in
+ *   no useful order, so merging many of them means a scan of one for every
+ *   docID of another; sorted lists are merged in one pass instead.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __POSTINGS_H
+#define __POSTINGS_H
+
+#include "../libcs50/counters.h"
+
+// opaque postings list
+typedef struct postings postings_t;
+
+/*
+ * The user gives a counters (NULL is taken as empty).
+ *
+ * We return a new postings list of its pairs with a count above 0, or NULL
+ *   if out of memory. The user must call postings_delete.
+ */
+postings_t* postings_fromCounters(counters_t* ctrs);
+
+/*
+ * The user gives n docIDs and their counts, in any order.
+ *
+ * We return a new postings list of the pairs with a count above 0, the
+ *   counts of a docID given more than once added up, or NULL if out of
+ *   memory. The user must call postings_delete.
+ */
+postings_t* postings_fromPairs(const int* docIDs, const int* counts,
+                               const int n);
+
+/*
+ * We return how many docIDs the list holds
+ */
+int postings_count(postings_t* list);
+
+/*
+ * We return the list's docIDs, in increasing order (postings_count of them)
+ */
+const int* postings_docIDs(postings_t* list);
+
+/*
+ * We return the list's counts, one for each of its docIDs
+ */
+const int* postings_counts(postings_t* list);
+
+/*
+ * The user gives a list, a docID, and a cursor *at into the list, which
+ *   starts at 0; the docIDs given with one cursor must never decrease.
+ *
+ * We move *at to the first pair whose docID is docID or more, and return
+ *   that docID's count, or 0 if the list does not hold it. The cursor
+ *   gallops: it steps 1, 2, 4... pairs ahead, then searches the last step,
+ *   so a seek costs the log of the distance moved.
+ */
+int postings_seek(postings_t* list, const int docID, int* at);
+
+/*
+ * The user gives an array of k postings lists (NULL entries are skipped).
+ *
+ * We merge them into one new list holding every docID in any of them, with
+ *   its counts added up, and return it, or NULL if out of memory. The user
+ *   must call postings_delete.
+ *
+ * The lists are merged k ways at once: a heap of the lists by their next
+ *   docID gives each docID in order, in O(log k) steps.
+ */
+postings_t* postings_union(postings_t** lists, const int k);
+
+/*
+ * The user gives a list (NULL is taken as empty) and n docIDs in
+ *   increasing order.
+ *
+ * We return a new list of the list's pairs whose docID is not one of them,
+ *   or NULL if out of memory; with n 0 it is a copy. The user must call
+ *   postings_delete. Both are walked once, side by side.
+ */
+postings_t* postings_without(postings_t* list, const int* docIDs,
+                             const int n);
+
+/*
+ * We return a new counters of the list's pairs, or NULL if out of memory.
+ *   The user must counters_delete the result.
+ */
+counters_t* postings_toCounters(postings_t* list);
+
+/*
+ * Free the postings list
+ */
+void postings_delete(postings_t* list);
+
+#endif // __POSTINGS_H
@@ -0,0 +1,946 @@
+/* roaring.c - CS50 TSE compressed docID sets
+ *
+ * A set is an array of containers in increasing order of key (the docIDs'
+ *   high 16 bits); a container holds the low 16 bits of its docIDs, as an
+ *   array, a bitmap or runs, and its count. No container is ever empty.
+ *
+ * A container is made in whichever kind is smallest for its docIDs, and a
+ *   container that comes out of an 'and' or 'or' is tidied the same way:
+ *   a bitmap of ARRAY_MAX docIDs or fewer becomes an array, and so on.
+ *
+ * Two bitmaps are combined by a kernel chosen when the program starts:
+ *   AVX2 (256 bits at a time) if the CPU has it, else SSE2 (128 bits),
+ *   else plain 64-bit words. Each kernel counts the bits it sets as it goes.
+ *
+ * Full and extensive documentation is in roaring.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include "roaring.h"
+#include "intersect.h"
+#if defined(__x86_64__)
+#include <immintrin.h>
+#define ROARING_X86
+#endif
+
+// most docIDs an array container holds; past it a bitmap is smaller
+#define ARRAY_MAX 4096
+// 64-bit words in a bitmap container
+#define BITMAP_WORDS 1024
+
+// kinds of container
+typedef enum { ARRAY, BITMAP, RUN } kind_t;
+
+// consecutive values first..last
+typedef struct run {
+  uint16_t first;
+  uint16_t last;
+} run_t;
+
+// the docIDs with one high 16 bits
+typedef struct container {
+  uint16_t key;
+  kind_t kind;
+  int count;            // docIDs held
+  int size;             // values (array) or runs (run) held
+  union {
+    uint16_t* values;   // increasing
+    uint64_t* words;    // BITMAP_WORDS of them
+    run_t* runs;        // increasing, apart
+  };
+} container_t;
+
+// defines a set
+typedef struct roaring {
+  container_t* containers;
+  int n;
+  int cap;
+} roaring_t;
+
+// a kernel that combines two bitmaps into out, and counts the bits set
+typedef int (*kernel_t)(const uint64_t* a, const uint64_t* b, uint64_t* out);
+
+// function prototypes
+static roaring_t* newSet(const int cap);
+static bool addContainer(roaring_t* set, container_t* c);
+static bool makeContainer(container_t* c, const uint16_t key,
+                          const int* docIDs, const int n);
+static bool newArray(container_t* c, const int cap);
+static bool newBitmap(container_t* c);
+static bool newRuns(container_t* c, const int cap);
+static void freeContainer(container_t* c);
+static bool copyContainer(container_t* to, const container_t* from);
+static bool tidy(container_t* c);
+static bool toBitmap(container_t* c);
+static bool toArray(container_t* c);
+static void fillBitmap(const container_t* c, uint64_t* words);
+static void setRange(uint64_t* words, const int first, const int last);
+static int countBits(const uint64_t* words);
+static bool containerContains(const container_t* c, const uint16_t value);
+static bool andContainers(container_t* out, const container_t* x,
+                          const container_t* y);
+static bool orContainers(container_t* out, const container_t* x,
+                         const container_t* y);
+static bool andArrays(container_t* out, const container_t* x,
+                      const container_t* y);
+static bool andArrayBitmap(container_t* out, const container_t* x,
+                           const container_t* y);
+static bool andArrayRuns(container_t* out, const container_t* x,
+                         const container_t* y);
+static bool andRuns(container_t* out, const container_t* x,
+                    const container_t* y);
+static bool orArrays(container_t* out, const container_t* x,
+                     const container_t* y);
+static bool orRuns(container_t* out, const container_t* x, const container_t* y);
+static bool combineBitmaps(container_t* out, const container_t* x,
+                           const container_t* y, const kernel_t kernel);
+static int andScalar(const uint64_t* a, const uint64_t* b, uint64_t* out);
+static int orScalar(const uint64_t* a, const uint64_t* b, uint64_t* out);
+#ifdef ROARING_X86
+static int andSse2(const uint64_t* a, const uint64_t* b, uint64_t* out);
+static int orSse2(const uint64_t* a, const uint64_t* b, uint64_t* out);
+static int andAvx2(const uint64_t* a, const uint64_t* b, uint64_t* out);
+static int orAvx2(const uint64_t* a, const uint64_t* b, uint64_t* out);
+#endif
+
+// the kernels in use, and their name
+static kernel_t andKernel = andScalar;
+static kernel_t orKernel = orScalar;
+static const char* kernelName = "scalar";
+
+// pick the best kernels the CPU has, before main runs
+__attribute__((constructor))
+static void pickKernels(void)
+{
+  if (!roaring_useKernel("avx2")) {
+    roaring_useKernel("sse2");
+  }
+}
+
+/**************** sets ****************/
+
+// one container per high 16 bits of the docIDs
+roaring_t* roaring_fromSorted(const int* docIDs, const int n)
+{
+  if (n < 0 || (docIDs == NULL && n > 0)) {
+    return NULL;
+  }
+  for (int i = 0; i < n; i++) {
+    if (docIDs[i] < 0 || (i > 0 && docIDs[i - 1] >= docIDs[i])) {
+      return NULL; // not a set in order
+    }
+  }
+  roaring_t* set = newSet(1);
+  if (set == NULL) {
+    return NULL;
+  }
+  for (int i = 0; i < n; ) {
+    uint16_t key = (uint32_t)docIDs[i] >> 16;
+    int j = i + 1;
+    while (j < n && ((uint32_t)docIDs[j] >> 16) == key) {
+      j++;
+    }
+    container_t c;
+    if (!makeContainer(&c, key, docIDs + i, j - i) || !addContainer(set, &c)) {
+      roaring_delete(set);
+      return NULL;
+    }
+    i = j;
+  }
+  return set;
+}
+
+// containers with the same key, intersected
+roaring_t* roaring_and(roaring_t* a, roaring_t* b)
+{
+  if (a == NULL || b == NULL) {
+    return NULL;
+  }
+  roaring_t* set = newSet((a->n < b->n) ? a->n : b->n);
+  if (set == NULL) {
+    return NULL;
+  }
+  int i = 0;
+  int j = 0;
+  while (i < a->n && j < b->n) {
+    container_t* x = &a->containers[i];
+    container_t* y = &b->containers[j];
+    if (x->key < y->key) {
+      i++;
+    } else if (x->key > y->key) {
+      j++;
+    } else {
+      container_t c;
+      if (!andContainers(&c, x, y)) {
+        freeContainer(&c);
+        roaring_delete(set);
+        return NULL;
+      }
+      if (c.count == 0) {
+        freeContainer(&c);
+      } else if (!addContainer(set, &c)) {
+        roaring_delete(set);
+        return NULL;
+      }
+      i++;
+      j++;
+    }
+  }
+  return set;
+}
+
+// containers with the same key united, and the rest copied
+roaring_t* roaring_or(roaring_t* a, roaring_t* b)
+{
+  if (a == NULL || b == NULL) {
+    return NULL;
+  }
+  roaring_t* set = newSet(a->n + b->n);
+  if (set == NULL) {
+    return NULL;
+  }
+  int i = 0;
+  int j = 0;
+  while (i < a->n || j < b->n) {
+    container_t* x = (i < a->n) ? &a->containers[i] : NULL;
+    container_t* y = (j < b->n) ? &b->containers[j] : NULL;
+    container_t c;
+    bool ok;
+    if (y == NULL || (x != NULL && x->key < y->key)) {
+      ok = copyContainer(&c, x);
+      i++;
+    } else if (x == NULL || y->key < x->key) {
+      ok = copyContainer(&c, y);
+      j++;
+    } else {
+      ok = orContainers(&c, x, y);
+      i++;
+      j++;
+    }
+    if (!ok) {
+      freeContainer(&c);
+    }
+    if (!ok || !addContainer(set, &c)) {
+      roaring_delete(set);
+      return NULL;
+    }
+  }
+  return set;
+}
+
+// docIDs in the set
+int roaring_count(roaring_t* set)
+{
+  if (set == NULL) {
+    return 0;
+  }
+  int count = 0;
+  for (int i = 0; i < set->n; i++) {
+    count += set->containers[i].count;
+  }
+  return count;
+}
+
+// binary search for the container, then look in it
+bool roaring_contains(roaring_t* set, const int docID)
+{
+  if (set == NULL || docID < 0) {
+    return false;
+  }
+  uint16_t key = (uint32_t)docID >> 16;
+  int lo = 0;
+  int hi = set->n;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    if (set->containers[mid].key < key) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  return lo < set->n && set->containers[lo].key == key
+         && containerContains(&set->containers[lo], docID & 0xffff);
+}
+
+// every docID, in order
+int roaring_toArray(roaring_t* set, int* docIDs)
+{
+  if (set == NULL || docIDs == NULL) {
+    return 0;
+  }
+  int n = 0;
+  for (int i = 0; i < set->n; i++) {
+    const container_t* c = &set->containers[i];
+    int high = (int)c->key << 16;
+    if (c->kind == ARRAY) {
+      for (int v = 0; v < c->size; v++) {
+        docIDs[n++] = high | c->values[v];
+      }
+    } else if (c->kind == BITMAP) {
+      for (int w = 0; w < BITMAP_WORDS; w++) {
+        uint64_t bits = c->words[w];
+        while (bits != 0) {
+          docIDs[n++] = high | (w * 64 + __builtin_ctzll(bits));
+          bits &= bits - 1;
+        }
+      }
+    } else {
+      for (int r = 0; r < c->size; r++) {
+        for (int v = c->runs[r].first; v <= c->runs[r].last; v++) {
+          docIDs[n++] = high | v;
+        }
+      }
+    }
+  }
+  return n;
+}
+
+// the set, its container array, and every container's values
+size_t roaring_bytes(roaring_t* set)
+{
+  if (set == NULL) {
+    return 0;
+  }
+  size_t bytes = sizeof(roaring_t) + set->cap * sizeof(container_t);
+  for (int i = 0; i < set->n; i++) {
+    const container_t* c = &set->containers[i];
+    if (c->kind == ARRAY) {
+      bytes += c->size * sizeof(uint16_t);
+    } else if (c->kind == BITMAP) {
+      bytes += BITMAP_WORDS * sizeof(uint64_t);
+    } else {
+      bytes += c->size * sizeof(run_t);
+    }
+  }
+  return bytes;
+}
+
+// one line about the set
+void roaring_print(roaring_t* set, FILE* fp)
+{
+  if (set == NULL || fp == NULL) {
+    return;
+  }
+  int kinds[3] = { 0, 0, 0 };
+  for (int i = 0; i < set->n; i++) {
+    kinds[set->containers[i].kind]++;
+  }
+  fprintf(fp, "roaring: %d docIDs in %d containers (%d array, %d bitmap, "
+          "%d run), %zu bytes\n", roaring_count(set), set->n,
+          kinds[ARRAY], kinds[BITMAP], kinds[RUN], roaring_bytes(set));
+}
+
+// switch kernels, if the CPU can run them
+bool roaring_useKernel(const char* name)
+{
+  if (name == NULL) {
+    return false;
+  }
+  if (strcmp(name, "scalar") == 0) {
+    andKernel = andScalar;
+    orKernel = orScalar;
+    kernelName = "scalar";
+    return true;
+  }
+#ifdef ROARING_X86
+  __builtin_cpu_init();
+  if (strcmp(name, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+    andKernel = andSse2;
+    orKernel = orSse2;
+    kernelName = "sse2";
+    return true;
+  }
+  if (strcmp(name, "avx2") == 0 && __builtin_cpu_supports("avx2")
+      && __builtin_cpu_supports("popcnt")) {
+    andKernel = andAvx2;
+    orKernel = orAvx2;
+    kernelName = "avx2";
+    return true;
+  }
+#endif
+  return false;
+}
+
+// the kernels' name
+const char* roaring_kernel(void)
+{
+  return kernelName;
+}
+
+// frees every container, then the set
+void roaring_delete(roaring_t* set)
+{
+  if (set == NULL) {
+    return;
+  }
+  for (int i = 0; i < set->n; i++) {
+    freeContainer(&set->containers[i]);
+  }
+  free(set->containers);
+  free(set);
+}
+
+// an empty set with room for cap containers; NULL if out of memory
+static roaring_t* newSet(const int cap)
+{
+  roaring_t* set = malloc(sizeof(roaring_t));
+  if (set == NULL) {
+    return NULL;
+  }
+  set->cap = (cap > 0) ? cap : 1;
+  set->n = 0;
+  set->containers = malloc(set->cap * sizeof(container_t));
+  if (set->containers == NULL) {
+    free(set);
+    return NULL;
+  }
+  return set;
+}
+
+// appends a container, which the set then owns (it is freed on failure)
+static bool addContainer(roaring_t* set, container_t* c)
+{
+  if (set->n == set->cap) {
+    int cap = set->cap * 2;
+    container_t* grown = realloc(set->containers, cap * sizeof(container_t));
+    if (grown == NULL) {
+      freeContainer(c);
+      return false;
+    }
+    set->containers = grown;
+    set->cap = cap;
+  }
+  set->containers[set->n++] = *c;
+  return true;
+}
+
+/**************** containers ****************/
+
+/*
+ * Makes the container of n increasing docIDs with the given key, as
+ *   whichever kind takes fewest bytes: 2 a docID, 8 KB, or 4 a run.
+ *   Returns false if out of memory
+ */
+static bool makeContainer(container_t* c, const uint16_t key,
+                          const int* docIDs, const int n)
+{
+  int nruns = 1;
+  for (int i = 1; i < n; i++) {
+    if (docIDs[i] != docIDs[i - 1] + 1) {
+      nruns++;
+    }
+  }
+  size_t arrayBytes = n * sizeof(uint16_t);
+  size_t bitmapBytes = BITMAP_WORDS * sizeof(uint64_t);
+  size_t runBytes = nruns * sizeof(run_t);
+
+  bool ok;
+  if (runBytes < arrayBytes && runBytes < bitmapBytes) {
+    ok = newRuns(c, nruns);
+    for (int i = 0; ok && i < n; i++) {
+      uint16_t v = docIDs[i] & 0xffff;
+      if (c->size > 0 && c->runs[c->size - 1].last + 1 == v) {
+        c->runs[c->size - 1].last = v;
+      } else {
+        c->runs[c->size].first = c->runs[c->size].last = v;
+        c->size++;
+      }
+    }
+  } else if (n <= ARRAY_MAX) {
+    ok = newArray(c, n);
+    for (int i = 0; ok && i < n; i++) {
+      c->values[c->size++] = docIDs[i] & 0xffff;
+    }
+  } else {
+    ok = newBitmap(c);
+    for (int i = 0; ok && i < n; i++) {
+      uint16_t v = docIDs[i] & 0xffff;
+      c->words[v >> 6] |= (uint64_t)1 << (v & 63);
+    }
+  }
+  c->key = key;
+  c->count = ok ? n : 0;
+  return ok;
+}
+
+// an empty array container with room for cap values
+static bool newArray(container_t* c, const int cap)
+{
+  c->kind = ARRAY;
+  c->count = c->size = 0;
+  c->values = malloc((cap > 0 ? cap : 1) * sizeof(uint16_t));
+  return c->values != NULL;
+}
+
+// an empty bitmap container
+static bool newBitmap(container_t* c)
+{
+  c->kind = BITMAP;
+  c->count = c->size = 0;
+  c->words = calloc(BITMAP_WORDS, sizeof(uint64_t));
+  return c->words != NULL;
+}
+
+// an empty run container with room for cap runs
+static bool newRuns(container_t* c, const int cap)
+{
+  c->kind = RUN;
+  c->count = c->size = 0;
+  c->runs = malloc((cap > 0 ? cap : 1) * sizeof(run_t));
+  return c->runs != NULL;
+}
+
+// frees a container's values (all kinds share the pointer)
+static void freeContainer(container_t* c)
+{
+  free(c->values);
+  c->values = NULL;
+}
+
+// a copy of a container
+static bool copyContainer(container_t* to, const container_t* from)
+{
+  *to = *from;
+  size_t bytes;
+  if (from->kind == ARRAY) {
+    bytes = from->size * sizeof(uint16_t);
+  } else if (from->kind == BITMAP) {
+    bytes = BITMAP_WORDS * sizeof(uint64_t);
+  } else {
+    bytes = from->size * sizeof(run_t);
+  }
+  to->values = malloc(bytes > 0 ? bytes : 1);
+  if (to->values == NULL) {
+    return false;
+  }
+  memcpy(to->values, from->values, bytes);
+  return true;
+}
+
+/*
+ * Turns a container made by 'and' or 'or' into the smallest kind for its
+ *   count: a bitmap of ARRAY_MAX or fewer becomes an array, an array of
+ *   more becomes a bitmap, and runs become either once they take more
+ *   room. Returns false if out of memory
+ */
+static bool tidy(container_t* c)
+{
+  if (c->kind == BITMAP && c->count <= ARRAY_MAX) {
+    return toArray(c);
+  }
+  if (c->kind == ARRAY && c->count > ARRAY_MAX) {
+    return toBitmap(c);
+  }
+  if (c->kind == RUN) {
+    size_t runBytes = c->size * sizeof(run_t);
+    if (c->count <= ARRAY_MAX && runBytes >= c->count * sizeof(uint16_t)) {
+      return toArray(c);
+    }
+    if (c->count > ARRAY_MAX && runBytes >= BITMAP_WORDS * sizeof(uint64_t)) {
+      return toBitmap(c);
+    }
+  }
+  return true;
+}
+
+// turns any container into a bitmap
+static bool toBitmap(container_t* c)
+{
+  container_t b;
+  if (!newBitmap(&b)) {
+    return false;
+  }
+  fillBitmap(c, b.words);
+  b.key = c->key;
+  b.count = c->count;
+  freeContainer(c);
+  *c = b;
+  return true;
+}
+
+// turns a bitmap or run container into an array
+static bool toArray(container_t* c)
+{
+  container_t a;
+  if (!newArray(&a, c->count)) {
+    return false;
+  }
+  if (c->kind == BITMAP) {
+    for (int w = 0; w < BITMAP_WORDS; w++) {
+      uint64_t bits = c->words[w];
+      while (bits != 0) {
+        a.values[a.size++] = w * 64 + __builtin_ctzll(bits);
+        bits &= bits - 1;
+      }
+    }
+  } else {
+    for (int r = 0; r < c->size; r++) {
+      for (int v = c->runs[r].first; v <= c->runs[r].last; v++) {
+        a.values[a.size++] = v;
+      }
+    }
+  }
+  a.key = c->key;
+  a.count = a.size;
+  freeContainer(c);
+  *c = a;
+  return true;
+}
+
+// sets the bits of a container's values in words (which start cleared)
+static void fillBitmap(const container_t* c, uint64_t* words)
+{
+  if (c->kind == ARRAY) {
+    for (int i = 0; i < c->size; i++) {
+      words[c->values[i] >> 6] |= (uint64_t)1 << (c->values[i] & 63);
+    }
+  } else if (c->kind == BITMAP) {
+    memcpy(words, c->words, BITMAP_WORDS * sizeof(uint64_t));
+  } else {
+    for (int r = 0; r < c->size; r++) {
+      setRange(words, c->runs[r].first, c->runs[r].last);
+    }
+  }
+}
+
+// sets bits first..last, a word at a time
+static void setRange(uint64_t* words, const int first, const int last)
+{
+  int firstWord = first >> 6;
+  int lastWord = last >> 6;
+  uint64_t firstMask = ~(uint64_t)0 << (first & 63);
+  uint64_t lastMask = ~(uint64_t)0 >> (63 - (last & 63));
+  if (firstWord == lastWord) {
+    words[firstWord] |= firstMask & lastMask;
+    return;
+  }
+  words[firstWord] |= firstMask;
+  for (int w = firstWord + 1; w < lastWord; w++) {
+    words[w] = ~(uint64_t)0;
+  }
+  words[lastWord] |= lastMask;
+}
+
+// bits set in a bitmap
+static int countBits(const uint64_t* words)
+{
+  int count = 0;
+  for (int w = 0; w < BITMAP_WORDS; w++) {
+    count += __builtin_popcountll(words[w]);
+  }
+  return count;
+}
+
+// is value in the container?
+static bool containerContains(const container_t* c, const uint16_t value)
+{
+  if (c->kind == BITMAP) {
+    return (c->words[value >> 6] >> (value & 63)) & 1;
+  }
+  int lo = 0;
+  int hi = c->size;
+  while (lo < hi) {
+    int mid = lo + (hi - lo) / 2;
+    uint16_t last = (c->kind == ARRAY) ? c->values[mid] : c->runs[mid].last;
+    if (last < value) {
+      lo = mid + 1;
+    } else {
+      hi = mid;
+    }
+  }
+  if (lo == c->size) {
+    return false;
+  }
+  return (c->kind == ARRAY) ? c->values[lo] == value
+                            : c->runs[lo].first <= value;
+}
+
+/**************** and, or ****************/
+
+// the intersection of two containers with the same key, by their kinds
+static bool andContainers(container_t* out, const container_t* x,
+                          const container_t* y)
+{
+  if (x->kind > y->kind) {
+    const container_t* swap = x;
+    x = y;
+    y = swap;
+  }
+  bool ok;
+  if (x->kind == ARRAY && y->kind == ARRAY) {
+    ok = andArrays(out, x, y);
+  } else if (x->kind == ARRAY && y->kind == BITMAP) {
+    ok = andArrayBitmap(out, x, y);
+  } else if (x->kind == ARRAY) {
+    ok = andArrayRuns(out, x, y);
+  } else if (x->kind == RUN) {
+    ok = andRuns(out, x, y);
+  } else {
+    ok = combineBitmaps(out, x, y, andKernel);
+  }
+  out->key = x->key;
+  return ok && tidy(out);
+}
+
+// the union of two containers with the same key, by their kinds
+static bool orContainers(container_t* out, const container_t* x,
+                         const container_t* y)
+{
+  bool ok;
+  if (x->kind == ARRAY && y->kind == ARRAY) {
+    ok = orArrays(out, x, y);
+  } else if (x->kind == RUN && y->kind == RUN) {
+    ok = orRuns(out, x, y);
+  } else {
+    ok = combineBitmaps(out, x, y, orKernel);
+  }
+  out->key = x->key;
+  return ok && tidy(out);
+}
+
+// the values in both arrays, by intersect's choice of kernel
+static bool andArrays(container_t* out, const container_t* x,
+                      const container_t* y)
+{
+  int cap = (x->size < y->size) ? x->size : y->size;
+  if (!newArray(out, cap + INTERSECT_SLACK)) {
+    return false;
+  }
+  out->size = intersect(x->values, x->size, y->values, y->size, out->values);
+  out->count = out->size;
+  return true;
+}
+
+// keeps the array's values whose bits are set
+static bool andArrayBitmap(container_t* out, const container_t* x,
+                           const container_t* y)
+{
+  if (!newArray(out, x->size)) {
+    return false;
+  }
+  for (int i = 0; i < x->size; i++) {
+    uint16_t v = x->values[i];
+    if ((y->words[v >> 6] >> (v & 63)) & 1) {
+      out->values[out->size++] = v;
+    }
+  }
+  out->count = out->size;
+  return true;
+}
+
+// keeps the array's values inside a run, walking both in order
+static bool andArrayRuns(container_t* out, const container_t* x,
+                         const container_t* y)
+{
+  if (!newArray(out, x->size)) {
+    return false;
+  }
+  int r = 0;
+  for (int i = 0; i < x->size && r < y->size; i++) {
+    uint16_t v = x->values[i];
+    while (r < y->size && y->runs[r].last < v) {
+      r++;
+    }
+    if (r < y->size && y->runs[r].first <= v) {
+      out->values[out->size++] = v;
+    }
+  }
+  out->count = out->size;
+  return true;
+}
+
+// the overlaps of two lists of runs
+static bool andRuns(container_t* out, const container_t* x,
+                    const container_t* y)
+{
+  if (!newRuns(out, x->size + y->size)) {
+    return false;
+  }
+  int i = 0;
+  int j = 0;
+  while (i < x->size && j < y->size) {
+    int first = (x->runs[i].first > y->runs[j].first) ? x->runs[i].first
+                                                      : y->runs[j].first;
+    int last = (x->runs[i].last < y->runs[j].last) ? x->runs[i].last
+                                                   : y->runs[j].last;
+    if (first <= last) {
+      out->runs[out->size].first = first;
+      out->runs[out->size].last = last;
+      out->size++;
+      out->count += last - first + 1;
+    }
+    if (x->runs[i].last < y->runs[j].last) {
+      i++;
+    } else {
+      j++;
+    }
+  }
+  return true;
+}
+
+// merges two sorted arrays, keeping every value once
+static bool orArrays(container_t* out, const container_t* x,
+                     const container_t* y)
+{
+  if (!newArray(out, x->size + y->size)) {
+    return false;
+  }
+  int i = 0;
+  int j = 0;
+  while (i < x->size || j < y->size) {
+    if (j == y->size || (i < x->size && x->values[i] < y->values[j])) {
+      out->values[out->size++] = x->values[i++];
+    } else if (i == x->size || y->values[j] < x->values[i]) {
+      out->values[out->size++] = y->values[j++];
+    } else {
+      out->values[out->size++] = x->values[i];
+      i++;
+      j++;
+    }
+  }
+  out->count = out->size;
+  return true;
+}
+
+// merges two lists of runs, joining runs that overlap or touch
+static bool orRuns(container_t* out, const container_t* x, const container_t* y)
+{
+  if (!newRuns(out, x->size + y->size)) {
+    return false;
+  }
+  int i = 0;
+  int j = 0;
+  while (i < x->size || j < y->size) {
+    run_t next;
+    if (j == y->size || (i < x->size && x->runs[i].first < y->runs[j].first)) {
+      next = x->runs[i++];
+    } else {
+      next = y->runs[j++];
+    }
+    run_t* last = (out->size > 0) ? &out->runs[out->size - 1] : NULL;
+    if (last != NULL && next.first <= last->last + 1) {
+      if (next.last > last->last) {
+        out->count += next.last - last->last;
+        last->last = next.last;
+      }
+    } else {
+      out->runs[out->size++] = next;
+      out->count += next.last - next.first + 1;
+    }
+  }
+  return true;
+}
+
+/*
+ * Combines two containers with a bitmap kernel, making a bitmap of any
+ *   that is not one first
+ */
+static bool combineBitmaps(container_t* out, const container_t* x,
+                           const container_t* y, const kernel_t kernel)
+{
+  uint64_t* scratch[2] = { NULL, NULL };
+  const uint64_t* words[2];
+  const container_t* in[2] = { x, y };
+  bool ok = newBitmap(out);
+  for (int k = 0; k < 2 && ok; k++) {
+    if (in[k]->kind == BITMAP) {
+      words[k] = in[k]->words;
+    } else {
+      scratch[k] = calloc(BITMAP_WORDS, sizeof(uint64_t));
+      ok = (scratch[k] != NULL);
+      if (ok) {
+        fillBitmap(in[k], scratch[k]);
+        words[k] = scratch[k];
+      }
+    }
+  }
+  if (ok) {
+    out->count = kernel(words[0], words[1], out->words);
+  }
+  free(scratch[0]);
+  free(scratch[1]);
+  return ok;
+}
+
+/**************** kernels ****************/
+
+// out = a & b, 64 bits at a time
+static int andScalar(const uint64_t* a, const uint64_t* b, uint64_t* out)
+{
+  for (int w = 0; w < BITMAP_WORDS; w++) {
+    out[w] = a[w] & b[w];
+  }
+  return countBits(out);
+}
+
+// out = a | b, 64 bits at a time
+static int orScalar(const uint64_t* a, const uint64_t* b, uint64_t* out)
+{
+  for (int w = 0; w < BITMAP_WORDS; w++) {
+    out[w] = a[w] | b[w];
+  }
+  return countBits(out);
+}
+
+#ifdef ROARING_X86
+// out = a & b, 128 bits at a time
+__attribute__((target("sse2")))
+static int andSse2(const uint64_t* a, const uint64_t* b, uint64_t* out)
+{
+  for (int w = 0; w < BITMAP_WORDS; w += 2) {
+    __m128i v = _mm_and_si128(_mm_loadu_si128((const __m128i*)(a + w)),
+                              _mm_loadu_si128((const __m128i*)(b + w)));
+    _mm_storeu_si128((__m128i*)(out + w), v);
+  }
+  return countBits(out);
+}
+
+// out = a | b, 128 bits at a time
+__attribute__((target("sse2")))
+static int orSse2(const uint64_t* a, const uint64_t* b, uint64_t* out)
+{
+  for (int w = 0; w < BITMAP_WORDS; w += 2) {
+    __m128i v = _mm_or_si128(_mm_loadu_si128((const __m128i*)(a + w)),
+                             _mm_loadu_si128((const __m128i*)(b + w)));
+    _mm_storeu_si128((__m128i*)(out + w), v);
+  }
+  return countBits(out);
+}
+
+// out = a & b, 256 bits at a time, counted with popcnt as they are stored
+__attribute__((target("avx2,popcnt")))
+static int andAvx2(const uint64_t* a, const uint64_t* b, uint64_t* out)
+{
+  int count = 0;
+  for (int w = 0; w < BITMAP_WORDS; w += 4) {
+    __m256i v = _mm256_and_si256(_mm256_loadu_si256((const __m256i*)(a + w)),
+                                 _mm256_loadu_si256((const __m256i*)(b + w)));
+    _mm256_storeu_si256((__m256i*)(out + w), v);
+    count += _mm_popcnt_u64(out[w]) + _mm_popcnt_u64(out[w + 1])
+             + _mm_popcnt_u64(out[w + 2]) + _mm_popcnt_u64(out[w + 3]);
+  }
+  return count;
+}
+
+// out = a | b, 256 bits at a time, counted with popcnt as they are stored
+__attribute__((target("avx2,popcnt")))
+static int orAvx2(const uint64_t* a, const uint64_t* b, uint64_t* out)
+{
+  int count = 0;
+  for (int w = 0; w < BITMAP_WORDS; w += 4) {
+    __m256i v = _mm256_or_si256(_mm256_loadu_si256((const __m256i*)(a + w)),
+                                _mm256_loadu_si256((const __m256i*)(b + w)));
+    _mm256_storeu_si256((__m256i*)(out + w), v);
+    count += _mm_popcnt_u64(out[w]) + _mm_popcnt_u64(out[w + 1])
+             + _mm_popcnt_u64(out[w + 2]) + _mm_popcnt_u64(out[w + 3]);
+  }
+  return count;
+}
+#endif
@@ -0,0 +1,96 @@
+/* roaring.h - header file for CS50 TSE compressed docID sets
+ *
+ * A roaring bitmap is a set of docIDs split by their high 16 bits into
+ *   containers of up to 65536 values each, and each container is stored
+ *   the way that takes least room for how dense it is:
+ *
+ *   array    the low 16 bits in order, 2 bytes a docID (at most 4096)
+ *   bitmap   one bit for each of the 65536 values, 8 KB
+ *   run      (first, last) pairs for runs of consecutive docIDs, 4 bytes a run
+ *
+ * So a rare word's docIDs are a short array and a word in nearly every doc
+ *   is a bitmap, or a single run. Intersections and unions work container
+ *   by container, picking a method for each pair of kinds; two bitmaps are
+ *   combined with SIMD instructions, 128 or 256 bits at a time.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __ROARING_H
+#define __ROARING_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// opaque docID set
+typedef struct roaring roaring_t;
+
+/*
+ * The user gives n docIDs (each at least 0), in increasing order.
+ *
+ * We return a new set of them, or NULL if they are not in order or out of
+ *   memory. The user must call roaring_delete.
+ */
+roaring_t* roaring_fromSorted(const int* docIDs, const int n);
+
+/*
+ * We return a new set of the docIDs in both a and b, or NULL if out of
+ *   memory. The user must call roaring_delete.
+ */
+roaring_t* roaring_and(roaring_t* a, roaring_t* b);
+
+/*
+ * We return a new set of the docIDs in a or b, or NULL if out of memory.
+ *   The user must call roaring_delete.
+ */
+roaring_t* roaring_or(roaring_t* a, roaring_t* b);
+
+/*
+ * We return how many docIDs the set holds
+ */
+int roaring_count(roaring_t* set);
+
+/*
+ * We return true if docID is in the set
+ */
+bool roaring_contains(roaring_t* set, const int docID);
+
+/*
+ * The user gives a set and an array with room for roaring_count docIDs.
+ *
+ * We fill the array with the set's docIDs in increasing order and return
+ *   how many there are.
+ */
+int roaring_toArray(roaring_t* set, int* docIDs);
+
+/*
+ * We return the bytes the set takes, containers included
+ */
+size_t roaring_bytes(roaring_t* set);
+
+/*
+ * Prints one line about the set to fp: docIDs, containers of each kind,
+ *   and bytes
+ */
+void roaring_print(roaring_t* set, FILE* fp);
+
+/*
+ * Chooses the kernels that combine two bitmaps: "scalar", "sse2" or
+ *   "avx2". The best the CPU has is chosen to begin with; this is for
+ *   comparing them. We return false if the CPU lacks the one named.
+ */
+bool roaring_useKernel(const char* name);
+
+/*
+ * We return the name of the kernels in use
+ */
+const char* roaring_kernel(void);
+
+/*
+ * Free the set and its containers
+ */
+void roaring_delete(roaring_t* set);
+
+#endif // __ROARING_H
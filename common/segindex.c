@@ -0,0 +1,515 @@
+/* segindex.c - CS50 TSE segmented index
+ *
+ * Segment 0 is the base, segment i the i'th delta. Each segment keeps the
+ *   docIDs masked out of it: every docID on the .del list of a newer delta,
+ *   sorted. A word's postings are the union of every segment's postings
+ *   for it, each less its masked docIDs (one pass down both sorted lists);
+ *   as a docID is unmasked in one segment only, no counts are ever added
+ *   together.
+ *
+ * A prefix takes the first max matching words of every segment, interned
+ *   in a strarena so a word in several segments is kept once, then sorted.
+ *
+ * Full and extensive documentation is in segindex.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "segindex.h"
+#include "index.h"
+#include "postings.h"
+#include "../libcs50/counters.h"
+#include "strarena.h"
+
+// one index file and what newer segments mask out of it
+typedef struct segment {
+  index_t* index;
+  int* masked;          // sorted docIDs
+  int nmasked;
+} segment_t;
+
+// defines a segmented index
+typedef struct segindex {
+  segment_t* segs;
+  int nsegs;
+} segindex_t;
+
+// a base being compacted
+typedef struct compaction {
+  segindex_t* seg;
+  index_t* merged;       // every live word's merged counts
+  bool failed;           // out of memory
+} compaction_t;
+
+// a prefix's words being gathered from every segment
+typedef struct expansion {
+  strarena_t* words;
+  int gathered;          // words given by the segments, repeats included
+} expansion_t;
+
+// function prototypes
+static segindex_t* loadSegments(const char* indexFilename, const bool lazy,
+                                const size_t cacheBytes);
+static bool readDeletes(const char* filename, int** docIDs, int* count);
+static postings_t* mergeSegments(segindex_t* seg, postings_t** lists);
+static void gatherWord(void* arg, const char* word);
+static void compactWord(void* arg, const char* word, counters_t* ctrs);
+static int compareInts(const void* a, const void* b);
+static int compareStrings(const void* a, const void* b);
+static bool fileExists(const char* filename);
+static void deltaName(char* buf, const size_t size, const char* indexFilename,
+                      const int delta, const char* suffix);
+
+// load the base and every delta
+segindex_t* segindex_load(const char* indexFilename)
+{
+  return loadSegments(indexFilename, false, 0);
+}
+
+// open the base and every delta lazily
+segindex_t* segindex_open(const char* indexFilename, const size_t cacheBytes)
+{
+  return loadSegments(indexFilename, true, cacheBytes);
+}
+
+/*
+ * Helper function called by segindex_load and segindex_open
+ *   reads every segment with index_load, or with index_open if lazy,
+ *   sharing the cache budget out evenly
+ */
+static segindex_t* loadSegments(const char* indexFilename, const bool lazy,
+                                const size_t cacheBytes)
+{
+  if (indexFilename == NULL) {
+    return NULL;
+  }
+  segindex_t* seg = calloc(1, sizeof(segindex_t));
+  if (seg == NULL) {
+    return NULL;
+  }
+
+  // how many deltas
+  char name[1024];
+  int ndeltas = 0;
+  deltaName(name, sizeof(name), indexFilename, ndeltas + 1, "");
+  while (fileExists(name)) {
+    ndeltas++;
+    deltaName(name, sizeof(name), indexFilename, ndeltas + 1, "");
+  }
+
+  seg->segs = calloc(ndeltas + 1, sizeof(segment_t));
+  if (seg->segs == NULL) {
+    free(seg);
+    return NULL;
+  }
+  seg->nsegs = ndeltas + 1;
+
+  // newest first, gathering the .del lists into each older segment's mask
+  int* masked = NULL;
+  int nmasked = 0;
+  for (int s = ndeltas; s >= 0; s--) {
+    segment_t* segment = &seg->segs[s];
+    if (s == 0) {
+      snprintf(name, sizeof(name), "%s", indexFilename);
+    } else {
+      deltaName(name, sizeof(name), indexFilename, s, "");
+    }
+    segment->index = lazy ? index_open(name, cacheBytes / seg->nsegs)
+                          : index_load(name);
+    segment->masked = malloc((nmasked + 1) * sizeof(int));
+    if (segment->index == NULL || segment->masked == NULL) {
+      fprintf(stderr, "segindex: cannot load '%s'\n", name);
+      free(masked);
+      segindex_delete(seg);
+      return NULL;
+    }
+    if (nmasked > 0) {
+      memcpy(segment->masked, masked, nmasked * sizeof(int));
+    }
+    segment->nmasked = nmasked;
+
+    // this delta's deletes mask everything older
+    if (s > 0) {
+      int* deletes = NULL;
+      int ndeletes = 0;
+      deltaName(name, sizeof(name), indexFilename, s, ".del");
+      int* grown = readDeletes(name, &deletes, &ndeletes)
+                   ? realloc(masked, (nmasked + ndeletes + 1) * sizeof(int))
+                   : NULL;
+      if (grown == NULL) {
+        fprintf(stderr, "segindex: cannot load '%s'\n", name);
+        free(deletes);
+        free(masked);
+        segindex_delete(seg);
+        return NULL;
+      }
+      masked = grown;
+      if (ndeletes > 0) {
+        memcpy(masked + nmasked, deletes, ndeletes * sizeof(int));
+      }
+      nmasked += ndeletes;
+      free(deletes);
+      if (nmasked > 1) {
+        qsort(masked, nmasked, sizeof(int), compareInts);
+      }
+    }
+  }
+  free(masked);
+  return seg;
+}
+
+// base plus deltas
+int segindex_segments(segindex_t* seg)
+{
+  return (seg == NULL) ? 0 : seg->nsegs;
+}
+
+// can phrases be found in every segment?
+bool segindex_hasPositions(segindex_t* seg)
+{
+  if (seg == NULL) {
+    return false;
+  }
+  for (int s = 0; s < seg->nsegs; s++) {
+    if (!index_hasPositions(seg->segs[s].index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// a word's postings across segments
+postings_t* segindex_find(segindex_t* seg, const char* word)
+{
+  if (seg == NULL || word == NULL) {
+    return NULL;
+  }
+  postings_t** lists = calloc(seg->nsegs, sizeof(postings_t*));
+  if (lists == NULL) {
+    return NULL;
+  }
+  for (int s = 0; s < seg->nsegs; s++) {
+    lists[s] = index_findPostings(seg->segs[s].index, word);
+  }
+  postings_t* merged = mergeSegments(seg, lists);
+  free(lists);
+  return merged;
+}
+
+// the first max words starting with prefix in any segment
+int segindex_prefix(segindex_t* seg, const char* prefix, const int max,
+                    void* arg, void (*itemfunc)(void* arg, const char* word))
+{
+  if (seg == NULL || prefix == NULL || itemfunc == NULL) {
+    return 0;
+  }
+  if (seg->nsegs == 1) {
+    return index_prefix(seg->segs[0].index, prefix, max, arg, itemfunc);
+  }
+
+  expansion_t expansion = { strarena_new(max > 0 ? max : 1), 0 };
+  if (expansion.words == NULL) {
+    return 0;
+  }
+  int total = 0;
+  for (int s = 0; s < seg->nsegs; s++) {
+    total += index_prefix(seg->segs[s].index, prefix, max, &expansion,
+                          gatherWord);
+  }
+  int nwords = strarena_count(expansion.words);
+  total -= expansion.gathered - nwords;  // repeats among those gathered
+
+  // the first max of them, in order
+  const char** sorted = malloc((nwords + 1) * sizeof(char*));
+  if (sorted != NULL) {
+    for (int w = 0; w < nwords; w++) {
+      sorted[w] = strarena_get(expansion.words, w);
+    }
+    qsort(sorted, nwords, sizeof(char*), compareStrings);
+    for (int w = 0; w < nwords && w < max; w++) {
+      itemfunc(arg, sorted[w]);
+    }
+    free(sorted);
+  }
+  strarena_delete(expansion.words);
+  return total;
+}
+
+// a phrase's postings across segments
+postings_t* segindex_findPhrase(segindex_t* seg, char** words, const int nwords)
+{
+  if (!segindex_hasPositions(seg)) {
+    return NULL;
+  }
+  postings_t** lists = calloc(seg->nsegs, sizeof(postings_t*));
+  if (lists == NULL) {
+    return NULL;
+  }
+  for (int s = 0; s < seg->nsegs; s++) {
+    counters_t* found = index_findPhrase(seg->segs[s].index, words, nwords);
+    lists[s] = (found == NULL) ? NULL : postings_fromCounters(found);
+    counters_delete(found);
+  }
+  postings_t* merged = mergeSegments(seg, lists);
+  free(lists);
+  return merged;
+}
+
+// deletes the segmented index
+void segindex_delete(segindex_t* seg)
+{
+  if (seg == NULL) {
+    return;
+  }
+  for (int s = 0; s < seg->nsegs; s++) {
+    index_delete(seg->segs[s].index);
+    free(seg->segs[s].masked);
+  }
+  free(seg->segs);
+  free(seg);
+}
+
+// write the next delta: its .del list, then its index under a temporary
+//   name, renamed into place last so a half-written delta is never loaded
+int segindex_addDelta(const char* indexFilename, index_t* delta,
+                      const int* docIDs, const int count)
+{
+  if (indexFilename == NULL || delta == NULL || (docIDs == NULL && count > 0)) {
+    return 0;
+  }
+
+  char name[1024];
+  int n = 1;
+  deltaName(name, sizeof(name), indexFilename, n, "");
+  while (fileExists(name)) {
+    deltaName(name, sizeof(name), indexFilename, ++n, "");
+  }
+
+  char delName[1024];
+  deltaName(delName, sizeof(delName), indexFilename, n, ".del");
+  FILE* fp = fopen(delName, "w");
+  if (fp == NULL) {
+    fprintf(stderr, "segindex: cannot create '%s'\n", delName);
+    return 0;
+  }
+  for (int i = 0; i < count; i++) {
+    fprintf(fp, "%d\n", docIDs[i]);
+  }
+  if (fclose(fp) != 0) {
+    fprintf(stderr, "segindex: cannot write '%s'\n", delName);
+    return 0;
+  }
+
+  // index_save puts positions in tmpName.pos
+  char tmpName[1024], tmpPos[1024], posName[1024];
+  deltaName(tmpName, sizeof(tmpName), indexFilename, n, ".tmp");
+  deltaName(tmpPos, sizeof(tmpPos), indexFilename, n, ".tmp.pos");
+  deltaName(posName, sizeof(posName), indexFilename, n, ".pos");
+  remove(tmpName);
+  if (!index_save(delta, tmpName)
+      || (index_hasPositions(delta) && rename(tmpPos, posName) != 0)
+      || rename(tmpName, name) != 0) {
+    fprintf(stderr, "segindex: cannot write '%s'\n", name);
+    remove(tmpName);
+    remove(tmpPos);
+    return 0;
+  }
+  return n;
+}
+
+// merge every segment into a new base
+bool segindex_compact(const char* indexFilename)
+{
+  segindex_t* seg = segindex_load(indexFilename);
+  if (seg == NULL) {
+    return false;
+  }
+  if (seg->nsegs == 1) {
+    segindex_delete(seg);
+    return true;
+  }
+  if (index_hasPositions(seg->segs[0].index)) {
+    fprintf(stderr, "segindex: cannot compact '%s', which has positions; "
+            "rebuild it instead\n", indexFilename);
+    segindex_delete(seg);
+    return false;
+  }
+
+  // every word of every segment merged into one index, then saved as a
+  //   build would save it, sorted, to a temporary file
+  char tmpName[1024];
+  snprintf(tmpName, sizeof(tmpName), "%s.compact", indexFilename);
+  compaction_t compaction = { seg, index_new(10000), false };
+  if (compaction.merged == NULL) {
+    fprintf(stderr, "segindex: out of memory compacting '%s'\n",
+            indexFilename);
+    segindex_delete(seg);
+    return false;
+  }
+  for (int s = 0; s < seg->nsegs; s++) {
+    index_iterate(seg->segs[s].index, &compaction, compactWord);
+  }
+  bool ok = !compaction.failed && index_save(compaction.merged, tmpName);
+  index_delete(compaction.merged);
+  segindex_delete(seg);
+
+  if (!ok || rename(tmpName, indexFilename) != 0) {
+    fprintf(stderr, "segindex: cannot write '%s'\n", indexFilename);
+    remove(tmpName);
+    return false;
+  }
+  segindex_removeDeltas(indexFilename);
+  return true;
+}
+
+// remove every delta's files
+void segindex_removeDeltas(const char* indexFilename)
+{
+  if (indexFilename == NULL) {
+    return;
+  }
+  char name[1024], delName[1024], posName[1024];
+  for (int n = 1; ; n++) {
+    deltaName(name, sizeof(name), indexFilename, n, "");
+    deltaName(delName, sizeof(delName), indexFilename, n, ".del");
+    deltaName(posName, sizeof(posName), indexFilename, n, ".pos");
+    if (!fileExists(name) && !fileExists(delName)) {
+      break;
+    }
+    remove(name);
+    remove(delName);
+    remove(posName);
+  }
+}
+
+/**************** helpers ****************/
+
+// read a .del list of docIDs into a new array
+static bool readDeletes(const char* filename, int** docIDs, int* count)
+{
+  FILE* fp = fopen(filename, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  int cap = 16;
+  *count = 0;
+  *docIDs = malloc(cap * sizeof(int));
+  int docID;
+  while (*docIDs != NULL && fscanf(fp, "%d", &docID) == 1) {
+    if (*count == cap) {
+      cap *= 2;
+      int* grown = realloc(*docIDs, cap * sizeof(int));
+      if (grown == NULL) {
+        free(*docIDs);
+        *docIDs = NULL;
+        break;
+      }
+      *docIDs = grown;
+    }
+    (*docIDs)[(*count)++] = docID;
+  }
+  fclose(fp);
+  return *docIDs != NULL;
+}
+
+/*
+ * Takes one list per segment (NULL where a segment failed), drops each
+ *   segment's masked docIDs from its list and unions what is left.
+ *   Deletes the lists; returns the new list, or NULL if any was NULL or
+ *   out of memory
+ */
+static postings_t* mergeSegments(segindex_t* seg, postings_t** lists)
+{
+  bool failed = false;
+  for (int s = 0; s < seg->nsegs; s++) {
+    if (lists[s] == NULL) {
+      failed = true;
+    } else if (seg->segs[s].nmasked > 0) {
+      postings_t* kept = postings_without(lists[s], seg->segs[s].masked,
+                                          seg->segs[s].nmasked);
+      postings_delete(lists[s]);
+      lists[s] = kept;
+      failed = failed || (kept == NULL);
+    }
+  }
+  postings_t* merged = NULL;
+  if (!failed && seg->nsegs == 1) {
+    merged = lists[0];    // nothing to merge with
+    lists[0] = NULL;
+  } else if (!failed) {
+    merged = postings_union(lists, seg->nsegs);
+  }
+  for (int s = 0; s < seg->nsegs; s++) {
+    postings_delete(lists[s]);
+  }
+  return merged;
+}
+
+// index_prefix helper: keep a segment's word, once
+static void gatherWord(void* arg, const char* word)
+{
+  expansion_t* expansion = arg;
+  if (strarena_intern(expansion->words, word, strlen(word)) >= 0) {
+    expansion->gathered++;
+  }
+}
+
+// index_iterate helper: merge a word's counts, the first time it is seen
+static void compactWord(void* arg, const char* word, counters_t* ctrs)
+{
+  compaction_t* compaction = arg;
+  if (compaction->failed || index_find(compaction->merged, word) != NULL) {
+    return; // merged already (or out of memory)
+  }
+  postings_t* merged = segindex_find(compaction->seg, word);
+  if (merged == NULL) {
+    compaction->failed = true;
+    return;
+  }
+  // a word masked out everywhere gets no counts, and so no line
+  const int* docIDs = postings_docIDs(merged);
+  const int* counts = postings_counts(merged);
+  for (int i = 0; i < postings_count(merged) && !compaction->failed; i++) {
+    if (!index_set(compaction->merged, word, docIDs[i], counts[i])) {
+      compaction->failed = true;
+    }
+  }
+  postings_delete(merged);
+}
+
+// for qsort of docIDs
+static int compareInts(const void* a, const void* b)
+{
+  int x = *(const int*)a;
+  int y = *(const int*)b;
+  return (x > y) - (x < y);
+}
+
+// qsort comparison of two strings, in strcmp order
+static int compareStrings(const void* a, const void* b)
+{
+  return strcmp(*(const char* const*)a, *(const char* const*)b);
+}
+
+// does filename exist?
+static bool fileExists(const char* filename)
+{
+  FILE* fp = fopen(filename, "r");
+  if (fp == NULL) {
+    return false;
+  }
+  fclose(fp);
+  return true;
+}
+
+// indexFilename.delta-NNNN followed by suffix
+static void deltaName(char* buf, const size_t size, const char* indexFilename,
+                      const int delta, const char* suffix)
+{
+  snprintf(buf, size, "%s.delta-%04d%s", indexFilename, delta, suffix);
+}
@@ -0,0 +1,122 @@
+/* segindex.h - header file for CS50 TSE segmented index
+ *
+ * An index file can be brought up to date without rebuilding it: indexer
+ *   --update indexes only the pages that changed into a delta segment,
+ *   which sits beside the base index file as
+ *
+ *   indexFilename.delta-NNNN      an index file of the changed pages
+ *   indexFilename.delta-NNNN.del  the docIDs it replaces, one per line
+ *
+ *   (plus indexFilename.delta-NNNN.pos if the base has positions). A docID
+ *   in a delta's .del list is masked out of every older segment, so a
+ *   changed page is found only in its newest segment and a removed page
+ *   nowhere. Deltas are numbered from 1, and a delta counts only once its
+ *   index file exists, which is written last.
+ *
+ * segindex_compact merges the base and its deltas into a new base.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __SEGINDEX_H
+#define __SEGINDEX_H
+
+#include <stdbool.h>
+#include "index.h"
+#include "postings.h"
+#include "../libcs50/counters.h"
+
+// opaque segmented index
+typedef struct segindex segindex_t;
+
+/*
+ * The user provides the name of a base index file.
+ *
+ * We load it with every delta segment beside it and return a pointer to the
+ *   segmented index, or NULL if the base (or a delta) cannot be loaded.
+ *   The user must call segindex_delete.
+ */
+segindex_t* segindex_load(const char* indexFilename);
+
+/*
+ * Like segindex_load, but every segment is opened with index_open, sharing
+ *   cacheBytes out between them: only the lexicons are read now, and each
+ *   word when it is first looked up.
+ */
+segindex_t* segindex_open(const char* indexFilename, const size_t cacheBytes);
+
+/*
+ * We return how many segments there are: the base and its deltas
+ */
+int segindex_segments(segindex_t* seg);
+
+/*
+ * We return true if every segment has positions, so phrases can be found
+ */
+bool segindex_hasPositions(segindex_t* seg);
+
+/*
+ * The user gives a segmented index and a word
+ *
+ * We return a new postings list of the word's count in every docID it is
+ *   in, taken from the newest segment holding that docID (empty if none),
+ *   or NULL if out of memory. The user must postings_delete the result.
+ */
+postings_t* segindex_find(segindex_t* seg, const char* word);
+
+/*
+ * Like index_prefix, over every segment: itemfunc is called on each of the
+ *   first max words that start with prefix in any segment, once per word.
+ *
+ * We return how many distinct words start with prefix. A word in several
+ *   segments is counted once as long as it is among the first max of each;
+ *   past that the count may take it more than once, so it is an upper bound
+ *   when some segment has more than max.
+ */
+int segindex_prefix(segindex_t* seg, const char* prefix, const int max,
+                    void* arg, void (*itemfunc)(void* arg, const char* word));
+
+/*
+ * Like index_findPhrase, over every segment with the same masking.
+ *
+ * We return a new postings list, or NULL if some segment has no positions
+ *   (or on error). The user must postings_delete the result.
+ */
+postings_t* segindex_findPhrase(segindex_t* seg, char** words, const int nwords);
+
+/*
+ * Delete the segmented index, free allocated memory
+ */
+void segindex_delete(segindex_t* seg);
+
+/*
+ * The user provides the name of a base index file, the index of the
+ *   changed pages, and the count docIDs that were added, changed or
+ *   removed.
+ *
+ * We write the index as the next delta segment, with the docIDs as its
+ *   .del list, and return the delta's number, or 0 if it cannot be written.
+ */
+int segindex_addDelta(const char* indexFilename, index_t* delta,
+                      const int* docIDs, const int count);
+
+/*
+ * The user provides the name of a base index file.
+ *
+ * We write the base and its deltas, merged, over the base, and remove the
+ *   deltas. The merged index is saved by index_save, so the file is the
+ *   one a full build of the same pages writes. A base with positions is
+ *   not compacted (rebuild it instead).
+ *
+ * We return true on success, or if there were no deltas.
+ */
+bool segindex_compact(const char* indexFilename);
+
+/*
+ * The user provides the name of a base index file; we remove every delta
+ *   segment beside it (as after a full rebuild).
+ */
+void segindex_removeDeltas(const char* indexFilename);
+
+#endif // __SEGINDEX_H
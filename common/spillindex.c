@@ -0,0 +1,690 @@
+/* spillindex.c - CS50 TSE external-memory index builder
+ *
+ * In memory, words are interned in a strarena, whose handles number the
+ *   terms, each with a growing array of (docID, count) postings. Memory is counted as it is
+ *   allocated; once it reaches the budget every term is sorted and written
+ *   to a run file, and the memory freed.
+ *
+ * A run file is a sequence of terms in strcmp order, each
+ *
+ *   wordLen (4 bytes)  word  (docID, count) pairs (4 + 4 bytes)  docID 0
+ *
+ *   in host byte order, with the docIDs of a term increasing. The merge
+ *   keeps a heap of runs by their current word; the runs holding the
+ *   smallest word have their postings merged by docID, counts of a docID
+ *   found in two runs (a page spilled part way through) being added.
+ *
+ * Full and extensive documentation is in spillindex.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#define _GNU_SOURCE
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <sys/resource.h>
+#include "spillindex.h"
+#include "strarena.h"
+
+// stdio buffer for each run file read or written
+static const size_t BUFFER_BYTES = 64 * 1024;
+
+// malloc's own bytes per allocation, as counted against the budget
+static const size_t MALLOC_OVERHEAD = 16;
+
+// one docID's count
+typedef struct posting {
+  int32_t docID;
+  int32_t count;
+} posting_t;
+
+// one word in memory
+typedef struct term {
+  const char* word;     // in the strarena
+  posting_t* postings;
+  int n;
+  int cap;
+  bool sorted;          // postings in docID order with no docID twice
+} term_t;
+
+// defines an external-memory index builder
+typedef struct spillindex {
+  char* prefix;
+  size_t budget;
+  size_t used;          // bytes allocated for what is in memory
+  strarena_t* words;    // NULL until the first word since a flush
+  size_t wordBytes;     // ... the memory it held when last counted
+  term_t* terms;        // by the word's handle
+  int nterms;
+  int termCap;
+  int* live;            // run numbers written and not yet merged
+  int nlive;
+  int liveCap;
+  int nextRun;
+
+  // what it did
+  long postings;
+  int runsWritten;
+  uint64_t runBytes;
+  int passes;
+} spillindex_t;
+
+// a run file being merged
+typedef struct runReader {
+  FILE* fp;
+  int run;
+  char* word;           // current word
+  size_t wordCap;
+  posting_t cur;        // current posting of that word
+  bool hasPosting;
+  bool bad;             // short read
+} runReader_t;
+
+// function prototypes
+static int findTerm(spillindex_t* spill, const char* word);
+static bool addPosting(spillindex_t* spill, term_t* term, const int docID);
+static void prepareTerm(term_t* term);
+static int* sortTerms(spillindex_t* spill);
+static int compareTerms(const void* a, const void* b, void* arg);
+static int comparePostings(const void* a, const void* b);
+static bool flush(spillindex_t* spill);
+static void clearMemory(spillindex_t* spill);
+static bool writeMemory(spillindex_t* spill, const char* filename);
+static bool merge(spillindex_t* spill, const int* runs, const int k,
+                  FILE* out, const bool text);
+static bool nextTerm(runReader_t* reader);
+static bool nextPosting(runReader_t* reader);
+static void heapPush(runReader_t** heap, int* n, runReader_t* reader);
+static runReader_t* heapPop(runReader_t** heap, int* n);
+static void writeWord(FILE* out, const bool text, const char* word);
+static void writePosting(FILE* out, const bool text, const posting_t* p);
+static void writeEnd(FILE* out, const bool text);
+static void runName(const spillindex_t* spill, const int run, char* name,
+                    const size_t size);
+
+// an empty builder
+spillindex_t* spillindex_new(const char* runPrefix, const size_t budget)
+{
+  if (runPrefix == NULL || budget == 0) {
+    return NULL;
+  }
+  spillindex_t* spill = calloc(1, sizeof(spillindex_t));
+  if (spill == NULL) {
+    return NULL;
+  }
+  spill->prefix = malloc(strlen(runPrefix) + 1);
+  if (spill->prefix == NULL) {
+    free(spill);
+    return NULL;
+  }
+  strcpy(spill->prefix, runPrefix);
+  spill->budget = budget;
+  return spill;
+}
+
+// one more occurrence of word in docID
+bool spillindex_insert(spillindex_t* spill, const char* word, const int docID)
+{
+  if (spill == NULL || word == NULL || docID <= 0) {
+    return false;
+  }
+
+  int t = findTerm(spill, word);
+  if (t < 0 || !addPosting(spill, &spill->terms[t], docID)) {
+    return false;
+  }
+  return spill->used < spill->budget || flush(spill);
+}
+
+// everything to the index file
+bool spillindex_save(spillindex_t* spill, const char* indexFilename)
+{
+  if (spill == NULL || indexFilename == NULL) {
+    return false;
+  }
+
+  // it all fit: no runs at all
+  if (spill->nlive == 0) {
+    return writeMemory(spill, indexFilename);
+  }
+  if (!flush(spill)) {
+    return false;
+  }
+
+  // too many runs to read at once: merge the oldest into bigger runs
+  while (spill->nlive > SPILL_FANIN) {
+    char name[1024];
+    int run = spill->nextRun++;
+    runName(spill, run, name, sizeof(name));
+    FILE* out = fopen(name, "wb");
+    if (out == NULL) {
+      fprintf(stderr, "spillindex: cannot create '%s'\n", name);
+      return false;
+    }
+    setvbuf(out, NULL, _IOFBF, BUFFER_BYTES);
+    bool ok = merge(spill, spill->live, SPILL_FANIN, out, false);
+    ok = (fclose(out) == 0) && ok;
+    if (!ok) {
+      fprintf(stderr, "spillindex: cannot write '%s'\n", name);
+      remove(name);
+      return false;
+    }
+
+    // the merged runs go, the new one joins the end
+    for (int i = 0; i < SPILL_FANIN; i++) {
+      runName(spill, spill->live[i], name, sizeof(name));
+      remove(name);
+    }
+    memmove(spill->live, spill->live + SPILL_FANIN,
+            (spill->nlive - SPILL_FANIN) * sizeof(int));
+    spill->nlive -= SPILL_FANIN;
+    spill->live[spill->nlive++] = run;
+  }
+
+  FILE* out = fopen(indexFilename, "w");
+  if (out == NULL) {
+    fprintf(stderr, "spillindex: cannot create '%s'\n", indexFilename);
+    return false;
+  }
+  setvbuf(out, NULL, _IOFBF, BUFFER_BYTES);
+  bool ok = merge(spill, spill->live, spill->nlive, out, true);
+  ok = (fclose(out) == 0) && ok;
+  if (!ok) {
+    fprintf(stderr, "spillindex: cannot write '%s'\n", indexFilename);
+  }
+  return ok;
+}
+
+// one line of what happened
+void spillindex_printStats(spillindex_t* spill, FILE* fp)
+{
+  if (spill == NULL || fp == NULL) {
+    return;
+  }
+  struct rusage usage;
+  long peakKB = (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : 0;
+  fprintf(fp, "spillindex: %ld postings, %d runs (%.1f MB), %d merge passes, "
+          "budget %.1f MB, peak resident %.1f MB\n",
+          spill->postings, spill->runsWritten, spill->runBytes / 1e6,
+          spill->passes, spill->budget / 1e6, peakKB / 1e3);
+}
+
+// free it all, and remove leftover runs
+void spillindex_delete(spillindex_t* spill)
+{
+  if (spill == NULL) {
+    return;
+  }
+  for (int i = 0; i < spill->nlive; i++) {
+    char name[1024];
+    runName(spill, spill->live[i], name, sizeof(name));
+    remove(name);
+  }
+  clearMemory(spill);
+  free(spill->live);
+  free(spill->prefix);
+  free(spill);
+}
+
+/**************** in memory ****************/
+
+// index of word's term, added if new; -1 if out of memory
+static int findTerm(spillindex_t* spill, const char* word)
+{
+  if (spill->words == NULL) {
+    spill->words = strarena_new(0);
+    if (spill->words == NULL) {
+      return -1;
+    }
+    spill->wordBytes = 0;
+  }
+
+  // room for a new term first, so a new word's handle is always nterms
+  if (spill->nterms == spill->termCap) {
+    int cap = (spill->termCap == 0) ? 1024 : spill->termCap * 2;
+    term_t* terms = realloc(spill->terms, cap * sizeof(term_t));
+    if (terms == NULL) {
+      return -1;
+    }
+    spill->used += (cap - spill->termCap) * sizeof(term_t);
+    spill->terms = terms;
+    spill->termCap = cap;
+  }
+
+  int t = strarena_intern(spill->words, word, strlen(word));
+  size_t wordBytes = strarena_memory(spill->words);
+  spill->used += wordBytes - spill->wordBytes;
+  spill->wordBytes = wordBytes;
+  if (t < 0 || t < spill->nterms) {
+    return t;
+  }
+
+  // new term
+  term_t* term = &spill->terms[spill->nterms++];
+  term->word = strarena_get(spill->words, t);
+  term->postings = NULL;
+  term->n = 0;
+  term->cap = 0;
+  term->sorted = true;
+  return t;
+}
+
+// count docID in term; pages come mostly in docID order, so this is
+//   usually the last posting again or a new one at the end
+static bool addPosting(spillindex_t* spill, term_t* term, const int docID)
+{
+  spill->postings++;
+  if (term->n > 0 && term->postings[term->n - 1].docID == docID) {
+    term->postings[term->n - 1].count++;
+    return true;
+  }
+  if (term->n == term->cap) {
+    int cap = (term->cap == 0) ? 2 : term->cap * 2;
+    posting_t* postings = realloc(term->postings, cap * sizeof(posting_t));
+    if (postings == NULL) {
+      return false;
+    }
+    spill->used += (cap - term->cap) * sizeof(posting_t)
+                   + ((term->cap == 0) ? MALLOC_OVERHEAD : 0);
+    term->postings = postings;
+    term->cap = cap;
+  }
+  if (term->n > 0 && term->postings[term->n - 1].docID > docID) {
+    term->sorted = false;
+  }
+  term->postings[term->n].docID = docID;
+  term->postings[term->n].count = 1;
+  term->n++;
+  return true;
+}
+
+// postings in docID order, each docID once
+static void prepareTerm(term_t* term)
+{
+  if (term->sorted) {
+    return;
+  }
+  qsort(term->postings, term->n, sizeof(posting_t), comparePostings);
+  int out = 0;
+  for (int i = 1; i < term->n; i++) {
+    if (term->postings[i].docID == term->postings[out].docID) {
+      term->postings[out].count += term->postings[i].count;
+    } else {
+      term->postings[++out] = term->postings[i];
+    }
+  }
+  term->n = out + 1;
+  term->sorted = true;
+}
+
+// term indexes in word order, in a new array
+static int* sortTerms(spillindex_t* spill)
+{
+  int* order = malloc((spill->nterms + 1) * sizeof(int));
+  if (order == NULL) {
+    return NULL;
+  }
+  for (int t = 0; t < spill->nterms; t++) {
+    order[t] = t;
+  }
+  qsort_r(order, spill->nterms, sizeof(int), compareTerms, spill->terms);
+  return order;
+}
+
+// by word, for qsort_r over term indexes
+static int compareTerms(const void* a, const void* b, void* arg)
+{
+  const term_t* terms = arg;
+  return strcmp(terms[*(const int*)a].word, terms[*(const int*)b].word);
+}
+
+// by docID, for qsort
+static int comparePostings(const void* a, const void* b)
+{
+  int32_t x = ((const posting_t*)a)->docID;
+  int32_t y = ((const posting_t*)b)->docID;
+  return (x > y) - (x < y);
+}
+
+// write what is in memory as the next run, and free it
+static bool flush(spillindex_t* spill)
+{
+  if (spill->nterms == 0) {
+    return true;
+  }
+  if (spill->nlive == spill->liveCap) {
+    int cap = (spill->liveCap == 0) ? 16 : spill->liveCap * 2;
+    int* live = realloc(spill->live, cap * sizeof(int));
+    if (live == NULL) {
+      return false;
+    }
+    spill->live = live;
+    spill->liveCap = cap;
+  }
+
+  int* order = sortTerms(spill);
+  char name[1024];
+  int run = spill->nextRun++;
+  runName(spill, run, name, sizeof(name));
+  FILE* out = (order == NULL) ? NULL : fopen(name, "wb");
+  if (out == NULL) {
+    fprintf(stderr, "spillindex: cannot create '%s'\n", name);
+    free(order);
+    return false;
+  }
+  setvbuf(out, NULL, _IOFBF, BUFFER_BYTES);
+
+  for (int i = 0; i < spill->nterms; i++) {
+    term_t* term = &spill->terms[order[i]];
+    prepareTerm(term);
+    writeWord(out, false, term->word);
+    for (int p = 0; p < term->n; p++) {
+      writePosting(out, false, &term->postings[p]);
+    }
+    writeEnd(out, false);
+  }
+  free(order);
+  long size = ftell(out);
+  if (ferror(out) || fclose(out) != 0) {
+    fprintf(stderr, "spillindex: cannot write '%s'\n", name);
+    remove(name);
+    return false;
+  }
+
+  spill->live[spill->nlive++] = run;
+  spill->runsWritten++;
+  spill->runBytes += (size > 0) ? size : 0;
+  clearMemory(spill);
+  return true;
+}
+
+// forget every term, giving back all its memory
+static void clearMemory(spillindex_t* spill)
+{
+  for (int t = 0; t < spill->nterms; t++) {
+    free(spill->terms[t].postings);
+  }
+  free(spill->terms);
+  strarena_delete(spill->words);
+  spill->terms = NULL;
+  spill->words = NULL;
+  spill->nterms = 0;
+  spill->termCap = 0;
+  spill->used = 0;
+}
+
+// the index file straight from memory, when nothing was spilled
+static bool writeMemory(spillindex_t* spill, const char* filename)
+{
+  int* order = sortTerms(spill);
+  FILE* out = (order == NULL) ? NULL : fopen(filename, "w");
+  if (out == NULL) {
+    fprintf(stderr, "spillindex: cannot create '%s'\n", filename);
+    free(order);
+    return false;
+  }
+  setvbuf(out, NULL, _IOFBF, BUFFER_BYTES);
+  for (int i = 0; i < spill->nterms; i++) {
+    term_t* term = &spill->terms[order[i]];
+    prepareTerm(term);
+    writeWord(out, true, term->word);
+    for (int p = 0; p < term->n; p++) {
+      writePosting(out, true, &term->postings[p]);
+    }
+    writeEnd(out, true);
+  }
+  free(order);
+  bool ok = !ferror(out);
+  ok = (fclose(out) == 0) && ok;
+  if (!ok) {
+    fprintf(stderr, "spillindex: cannot write '%s'\n", filename);
+  }
+  return ok;
+}
+
+/**************** merging ****************/
+
+// merge runs[0..k-1] into out, as a run or as the text index
+static bool merge(spillindex_t* spill, const int* runs, const int k,
+                  FILE* out, const bool text)
+{
+  runReader_t* readers = calloc(k, sizeof(runReader_t));
+  runReader_t** heap = calloc(k, sizeof(runReader_t*));
+  runReader_t** group = calloc(k, sizeof(runReader_t*));
+  char* word = NULL;      // the word being merged
+  size_t wordCap = 0;
+  bool ok = (readers != NULL && heap != NULL && group != NULL);
+  int n = 0;
+
+  // open every run at its first word
+  for (int i = 0; i < k && ok; i++) {
+    char name[1024];
+    runName(spill, runs[i], name, sizeof(name));
+    readers[i].run = runs[i];
+    readers[i].fp = fopen(name, "rb");
+    if (readers[i].fp == NULL) {
+      fprintf(stderr, "spillindex: cannot read '%s'\n", name);
+      ok = false;
+      break;
+    }
+    setvbuf(readers[i].fp, NULL, _IOFBF, BUFFER_BYTES);
+    if (nextTerm(&readers[i])) {
+      heapPush(heap, &n, &readers[i]);
+    }
+  }
+
+  while (ok && n > 0) {
+    // every run whose current word is the smallest
+    int g = 0;
+    group[g++] = heapPop(heap, &n);
+    while (n > 0 && strcmp(heap[0]->word, group[0]->word) == 0) {
+      group[g++] = heapPop(heap, &n);
+    }
+    size_t len = strlen(group[0]->word);
+    if (len + 1 > wordCap) {
+      char* grown = realloc(word, len + 1);
+      if (grown == NULL) {
+        ok = false;
+        break;
+      }
+      word = grown;
+      wordCap = len + 1;
+    }
+    memcpy(word, group[0]->word, len + 1);
+    writeWord(out, text, word);
+
+    // their postings by docID, adding up a docID found in more than one
+    posting_t pending = { 0, 0 };
+    while (true) {
+      runReader_t* low = NULL;
+      for (int i = 0; i < g; i++) {
+        if (group[i]->hasPosting
+            && (low == NULL || group[i]->cur.docID < low->cur.docID)) {
+          low = group[i];
+        }
+      }
+      if (low == NULL) {
+        break;
+      }
+      if (low->cur.docID == pending.docID) {
+        pending.count += low->cur.count;
+      } else {
+        if (pending.docID != 0) {
+          writePosting(out, text, &pending);
+        }
+        pending = low->cur;
+      }
+      nextPosting(low);
+    }
+    if (pending.docID != 0) {
+      writePosting(out, text, &pending);
+    }
+    writeEnd(out, text);
+
+    // on to each run's next word
+    for (int i = 0; i < g; i++) {
+      if (nextTerm(group[i])) {
+        heapPush(heap, &n, group[i]);
+      }
+    }
+    ok = !ferror(out);
+  }
+
+  for (int i = 0; readers != NULL && i < k; i++) {
+    ok = ok && !readers[i].bad;
+    if (readers[i].fp != NULL) {
+      fclose(readers[i].fp);
+    }
+    free(readers[i].word);
+  }
+  free(readers);
+  free(heap);
+  free(group);
+  free(word);
+  spill->passes++;
+  return ok;
+}
+
+// read the reader's next word and its first posting; false at the end
+static bool nextTerm(runReader_t* reader)
+{
+  uint32_t len;
+  if (fread(&len, sizeof(len), 1, reader->fp) != 1) {
+    return false; // end of run
+  }
+  if (len + 1 > reader->wordCap) {
+    char* grown = realloc(reader->word, len + 1);
+    if (grown == NULL) {
+      reader->bad = true;
+      return false;
+    }
+    reader->word = grown;
+    reader->wordCap = len + 1;
+  }
+  if (fread(reader->word, 1, len, reader->fp) != len) {
+    reader->bad = true;
+    return false;
+  }
+  reader->word[len] = '\0';
+  return nextPosting(reader) || !reader->bad;
+}
+
+// read the reader's next posting of its word; false after the last
+static bool nextPosting(runReader_t* reader)
+{
+  reader->hasPosting = false;
+  if (fread(&reader->cur.docID, sizeof(int32_t), 1, reader->fp) != 1) {
+    reader->bad = true;
+    return false;
+  }
+  if (reader->cur.docID == 0) {
+    return false; // end of word
+  }
+  if (fread(&reader->cur.count, sizeof(int32_t), 1, reader->fp) != 1) {
+    reader->bad = true;
+    return false;
+  }
+  reader->hasPosting = true;
+  return true;
+}
+
+// add reader to the min-heap of runs by current word
+static void heapPush(runReader_t** heap, int* n, runReader_t* reader)
+{
+  int i = (*n)++;
+  while (i > 0) {
+    int parent = (i - 1) / 2;
+    if (strcmp(heap[parent]->word, reader->word) <= 0) {
+      break;
+    }
+    heap[i] = heap[parent];
+    i = parent;
+  }
+  heap[i] = reader;
+}
+
+// take the run with the smallest current word off the heap
+static runReader_t* heapPop(runReader_t** heap, int* n)
+{
+  runReader_t* top = heap[0];
+  runReader_t* last = heap[--(*n)];
+  int i = 0;
+  while (true) {
+    int child = 2 * i + 1;
+    if (child >= *n) {
+      break;
+    }
+    if (child + 1 < *n && strcmp(heap[child + 1]->word, heap[child]->word) < 0) {
+      child++;
+    }
+    if (strcmp(last->word, heap[child]->word) <= 0) {
+      break;
+    }
+    heap[i] = heap[child];
+    i = child;
+  }
+  if (*n > 0) {
+    heap[i] = last;
+  }
+  return top;
+}
+
+/**************** output ****************/
+
+// start a word's record (run) or line (text)
+static void writeWord(FILE* out, const bool text, const char* word)
+{
+  uint32_t len = strlen(word);
+  if (!text) {
+    fwrite(&len, sizeof(len), 1, out);
+  }
+  fwrite(word, 1, len, out);
+}
+
+// one posting: binary, or " docID count"
+static void writePosting(FILE* out, const bool text, const posting_t* p)
+{
+  if (!text) {
+    fwrite(p, sizeof(posting_t), 1, out);
+    return;
+  }
+
+  // digits from the right, as printf would but without parsing a format
+  char buf[24];
+  int i = sizeof(buf);
+  uint32_t v = p->count;
+  do {
+    buf[--i] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  buf[--i] = ' ';
+  v = p->docID;
+  do {
+    buf[--i] = '0' + v % 10;
+    v /= 10;
+  } while (v > 0);
+  buf[--i] = ' ';
+  fwrite(buf + i, 1, sizeof(buf) - i, out);
+}
+
+// end a word's record (docID 0) or line
+static void writeEnd(FILE* out, const bool text)
+{
+  if (text) {
+    fputc('\n', out);
+  } else {
+    int32_t zero = 0;
+    fwrite(&zero, sizeof(zero), 1, out);
+  }
+}
+
+// runPrefix.run-NNNN
+static void runName(const spillindex_t* spill, const int run, char* name,
+                    const size_t size)
+{
+  snprintf(name, size, "%s.run-%04d", spill->prefix, run);
+}
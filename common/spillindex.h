@@ -0,0 +1,71 @@
+/* spillindex.h - header file for CS50 TSE external-memory index builder
+ *
+ * Builds an index file too big to hold in memory. Word occurrences are
+ *   counted in memory, as (word, docID, count), until they take up the
+ *   memory budget; they are then written, sorted by word and docID, to a
+ *   run file and forgotten. spillindex_save merges the runs into an index
+ *   file in the format of index_save, one word per line with its docIDs in
+ *   increasing order:
+ *
+ *   word docID count [docID count]...
+ *
+ * Run files are named runPrefix.run-NNNN and deleted once merged. At most
+ *   SPILL_FANIN runs are merged at once; more are merged in passes, so
+ *   memory stays within the budget (plus a read buffer per run) however
+ *   large the corpus gets.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __SPILLINDEX_H
+#define __SPILLINDEX_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// most runs merged in one pass
+#define SPILL_FANIN 64
+
+// opaque external-memory index builder
+typedef struct spillindex spillindex_t;
+
+/*
+ * Creates a builder that spills past budget bytes to files named
+ *   runPrefix.run-NNNN.
+ *
+ * We return a pointer to the builder, or NULL on bad parameters or if out
+ *   of memory. The user must call spillindex_delete.
+ */
+spillindex_t* spillindex_new(const char* runPrefix, const size_t budget);
+
+/*
+ * Counts one occurrence of word in docID (> 0), writing a run first if the
+ *   budget is used up.
+ *
+ * We return false on bad parameters or if a run could not be written.
+ */
+bool spillindex_insert(spillindex_t* spill, const char* word, const int docID);
+
+/*
+ * Writes everything counted to indexFilename: straight from memory if
+ *   nothing was spilled, otherwise by merging the runs (and what is still
+ *   in memory, as one last run).
+ *
+ * We return false if a file could not be written or read.
+ */
+bool spillindex_save(spillindex_t* spill, const char* indexFilename);
+
+/*
+ * Prints one line to fp: postings counted, runs written and their size,
+ *   merge passes, the memory budget and the process's peak resident memory.
+ */
+void spillindex_printStats(spillindex_t* spill, FILE* fp);
+
+/*
+ * Frees the builder and deletes any run files left
+ */
+void spillindex_delete(spillindex_t* spill);
+
+#endif // __SPILLINDEX_H
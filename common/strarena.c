@@ -0,0 +1,277 @@
+/* strarena.c - CS50 TSE string interner
+ *
+ * Strings are copied, NUL-terminated, into the newest block until it is
+ *   full; a string too long for a block gets a block of its own size. Each
+ *   handle records its string, length and hash, and an open-addressing
+ *   table (linear probing, at most half full) maps a hash to handle + 1.
+ *   Nothing is ever freed one string at a time.
+ *
+ * Full and extensive documentation is in strarena.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <limits.h>
+#include "strarena.h"
+#include "fasthash.h"
+
+// bytes of strings in a block
+static const size_t BLOCK_BYTES = 1 << 16;
+
+// a block of strings
+typedef struct block {
+  struct block* next;   // older block
+  size_t size;
+  size_t used;
+  char data[];
+} block_t;
+
+// one interned string
+typedef struct handle {
+  const char* str;
+  uint32_t len;
+  uint32_t hash;        // low bits of its hash, compared before the bytes
+} handle_t;
+
+// defines a string arena
+typedef struct strarena {
+  block_t* blocks;      // newest first
+  size_t blockBytes;
+  handle_t* handles;
+  int count;
+  int cap;
+  int* table;           // handle + 1 by hash, 0 if empty
+  int tableSize;        // a power of 2
+} strarena_t;
+
+// function prototypes
+static int lookup(strarena_t* arena, const char* str, const size_t len,
+                  const uint64_t hash, size_t* slot);
+static char* copyString(strarena_t* arena, const char* str, const size_t len);
+static bool growTable(strarena_t* arena);
+
+// make an empty arena
+strarena_t* strarena_new(const int expected)
+{
+  strarena_t* arena = calloc(1, sizeof(strarena_t));
+  if (arena == NULL) {
+    return NULL;
+  }
+  arena->tableSize = 1024;
+  while (expected > 0 && arena->tableSize / 2 < expected
+         && arena->tableSize < (1 << 30)) {
+    arena->tableSize *= 2;
+  }
+  arena->table = calloc(arena->tableSize, sizeof(int));
+  if (arena->table == NULL) {
+    free(arena);
+    return NULL;
+  }
+  return arena;
+}
+
+// the handle of a string, added if new
+int strarena_intern(strarena_t* arena, const char* str, const size_t len)
+{
+  if (arena == NULL || str == NULL || len >= UINT32_MAX) {
+    return -1;
+  }
+  uint64_t hash = fasthash(str, len);
+  size_t slot;
+  int handle = lookup(arena, str, len, hash, &slot);
+  if (handle >= 0) {
+    return handle;
+  }
+
+  // a new string: room for its handle, and its copy
+  if (arena->count == arena->cap) {
+    if (arena->cap > INT_MAX / 2) {
+      return -1;
+    }
+    int cap = (arena->cap == 0) ? 1024 : arena->cap * 2;
+    handle_t* grown = realloc(arena->handles, cap * sizeof(handle_t));
+    if (grown == NULL) {
+      return -1;
+    }
+    arena->handles = grown;
+    arena->cap = cap;
+  }
+  char* copy = copyString(arena, str, len);
+  if (copy == NULL) {
+    return -1;
+  }
+  handle = arena->count++;
+  arena->handles[handle] = (handle_t){ copy, (uint32_t)len, (uint32_t)hash };
+  arena->table[slot] = handle + 1;
+
+  // keep the table at most half full
+  if (arena->count * 2 > arena->tableSize && !growTable(arena)) {
+    arena->count--;
+    arena->table[slot] = 0;
+    return -1; // the copy stays in its block, unused
+  }
+  return handle;
+}
+
+// the handle of a string, if interned
+int strarena_find(strarena_t* arena, const char* str, const size_t len)
+{
+  if (arena == NULL || str == NULL) {
+    return -1;
+  }
+  size_t slot;
+  return lookup(arena, str, len, fasthash(str, len), &slot);
+}
+
+/*
+ * Probes the table for a string with the given hash. Returns its handle,
+ *   or -1 with *slot set to the empty slot where it would go
+ */
+static int lookup(strarena_t* arena, const char* str, const size_t len,
+                  const uint64_t hash, size_t* slot)
+{
+  size_t mask = arena->tableSize - 1;
+  size_t s = hash & mask;
+  while (arena->table[s] != 0) {
+    const handle_t* h = &arena->handles[arena->table[s] - 1];
+    if (h->hash == (uint32_t)hash && h->len == len
+        && memcmp(h->str, str, len) == 0) {
+      return arena->table[s] - 1;
+    }
+    s = (s + 1) & mask;
+  }
+  *slot = s;
+  return -1;
+}
+
+/*
+ * Copies len bytes and a NUL into the newest block, starting a new block
+ *   if it does not fit. Returns the copy, or NULL if out of memory
+ */
+static char* copyString(strarena_t* arena, const char* str, const size_t len)
+{
+  block_t* block = arena->blocks;
+  if (block == NULL || block->size - block->used < len + 1) {
+    size_t size = (len + 1 > BLOCK_BYTES) ? len + 1 : BLOCK_BYTES;
+    block = malloc(sizeof(block_t) + size);
+    if (block == NULL) {
+      return NULL;
+    }
+    block->size = size;
+    block->used = 0;
+    block->next = arena->blocks;
+    arena->blocks = block;
+    arena->blockBytes += sizeof(block_t) + size;
+  }
+  char* copy = block->data + block->used;
+  memcpy(copy, str, len);
+  copy[len] = '\0';
+  block->used += len + 1;
+  return copy;
+}
+
+// double the table and rehash every handle
+static bool growTable(strarena_t* arena)
+{
+  if (arena->tableSize >= (1 << 30)) {
+    return false;
+  }
+  int size = arena->tableSize * 2;
+  int* table = calloc(size, sizeof(int));
+  if (table == NULL) {
+    return false;
+  }
+  size_t mask = size - 1;
+  for (int h = 0; h < arena->count; h++) {
+    // the stored hash has the low 32 bits, all a table this size needs
+    size_t s = arena->handles[h].hash & mask;
+    while (table[s] != 0) {
+      s = (s + 1) & mask;
+    }
+    table[s] = h + 1;
+  }
+  free(arena->table);
+  arena->table = table;
+  arena->tableSize = size;
+  return true;
+}
+
+// a handle's string
+const char* strarena_get(strarena_t* arena, const int handle)
+{
+  if (arena == NULL || handle < 0 || handle >= arena->count) {
+    return NULL;
+  }
+  return arena->handles[handle].str;
+}
+
+// a handle's length
+size_t strarena_length(strarena_t* arena, const int handle)
+{
+  if (arena == NULL || handle < 0 || handle >= arena->count) {
+    return 0;
+  }
+  return arena->handles[handle].len;
+}
+
+// how many strings
+int strarena_count(strarena_t* arena)
+{
+  return (arena == NULL) ? 0 : arena->count;
+}
+
+// bytes held
+size_t strarena_memory(strarena_t* arena)
+{
+  if (arena == NULL) {
+    return 0;
+  }
+  return sizeof(strarena_t) + arena->blockBytes
+         + (size_t)arena->cap * sizeof(handle_t)
+         + (size_t)arena->tableSize * sizeof(int);
+}
+
+// forget every string, keeping the newest block
+void strarena_clear(strarena_t* arena)
+{
+  if (arena == NULL) {
+    return;
+  }
+  block_t* keep = arena->blocks;
+  if (keep != NULL) {
+    block_t* block = keep->next;
+    while (block != NULL) {
+      block_t* next = block->next;
+      free(block);
+      block = next;
+    }
+    keep->next = NULL;
+    keep->used = 0;
+    arena->blockBytes = sizeof(block_t) + keep->size;
+  }
+  arena->count = 0;
+  memset(arena->table, 0, arena->tableSize * sizeof(int));
+}
+
+// free it all
+void strarena_delete(strarena_t* arena)
+{
+  if (arena == NULL) {
+    return;
+  }
+  block_t* block = arena->blocks;
+  while (block != NULL) {
+    block_t* next = block->next;
+    free(block);
+    block = next;
+  }
+  free(arena->handles);
+  free(arena->table);
+  free(arena);
+}
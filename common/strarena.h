@@ -0,0 +1,80 @@
+/* strarena.h - header file for CS50 TSE string interner
+ *
+ * A strarena keeps one copy of each distinct string, packed back to back in
+ *   large blocks rather than in a malloc of its own, and numbers them 0, 1,
+ *   2... in the order they were first interned. The number is a handle
+ *   that a user can index its own arrays with; the string's address never
+ *   changes while the arena lives, so it can be handed out as well.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __STRARENA_H
+#define __STRARENA_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// opaque string arena
+typedef struct strarena strarena_t;
+
+/*
+ * The user provides the number of strings expected (the arena grows past
+ *   it anyway).
+ *
+ * We return a pointer to a new empty arena, or NULL if out of memory. The
+ *   user must call strarena_delete.
+ */
+strarena_t* strarena_new(const int expected);
+
+/*
+ * The user gives an arena and a string of len bytes (need not be
+ *   NUL-terminated).
+ *
+ * We return the string's handle, adding a copy if it is new, or -1 if out
+ *   of memory.
+ */
+int strarena_intern(strarena_t* arena, const char* str, const size_t len);
+
+/*
+ * We return the handle of a string of len bytes, or -1 if it was never
+ *   interned.
+ */
+int strarena_find(strarena_t* arena, const char* str, const size_t len);
+
+/*
+ * We return the NUL-terminated string of a handle, or NULL if there is no
+ *   such handle. It lives as long as the arena (until strarena_clear).
+ */
+const char* strarena_get(strarena_t* arena, const int handle);
+
+/*
+ * We return the length of a handle's string (0 if there is no such handle)
+ */
+size_t strarena_length(strarena_t* arena, const int handle);
+
+/*
+ * We return the number of strings in the arena: handles are 0 up to this
+ */
+int strarena_count(strarena_t* arena);
+
+/*
+ * We return the bytes of memory held by the arena: its blocks, the
+ *   handles' table and the hash table.
+ */
+size_t strarena_memory(strarena_t* arena);
+
+/*
+ * Forgets every string, keeping one block for the strings to come. Every
+ *   handle and string handed out before is invalid afterwards.
+ */
+void strarena_clear(strarena_t* arena);
+
+/*
+ * Delete the arena, free allocated memory
+ */
+void strarena_delete(strarena_t* arena);
+
+#endif // __STRARENA_H
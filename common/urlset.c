@@ -0,0 +1,281 @@
+/* urlset.c - CS50 TSE URL-seen set
+ *
+ * Fingerprints live in a power-of-two array probed linearly from
+ *   (fingerprint & mask); 0 marks an empty slot, so a URL whose fingerprint
+ *   is 0 is stored as 1. The table doubles when it is 70% full.
+ *
+ * The Bloom filter uses k bit positions derived from the same fingerprint
+ *   by double hashing, so a URL is only hashed once.
+ *
+ * Full and extensive documentation is in urlset.h
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include "urlset.h"
+#include "fasthash.h"
+
+// grow when more than LOAD_NUM/LOAD_DEN of the slots are used
+static const size_t LOAD_NUM = 7;
+static const size_t LOAD_DEN = 10;
+
+// bits set per URL in the filter; best at about 10 filter bits per URL
+static const int BLOOM_K = 7;
+
+// defines a URL set
+typedef struct urlset {
+  uint64_t* slots;      // fingerprints, 0 = empty
+  size_t capacity;      // power of two
+  size_t count;
+  uint64_t* bloom;      // filter bits, NULL if none
+  size_t bloomBits;     // power of two
+  size_t bloomSet;      // bits turned on
+  size_t lookups;       // urlset_insert/contains calls
+  size_t bloomMisses;   // ... that the filter answered alone
+} urlset_t;
+
+// function prototypes
+static uint64_t fingerprint(const char* url);
+static size_t roundPow2(size_t n);
+static bool findSlot(const urlset_t* set, const uint64_t fp, size_t* slot);
+static bool grow(urlset_t* set);
+static bool bloomMaybe(urlset_t* set, const uint64_t fp);
+static void bloomAdd(urlset_t* set, const uint64_t fp);
+
+// create an empty set
+urlset_t* urlset_new(const size_t expected, const size_t bloomBits)
+{
+  urlset_t* set = calloc(1, sizeof(urlset_t));
+  if (set == NULL) {
+    return NULL;
+  }
+
+  // room for the expected count below the load limit
+  set->capacity = roundPow2((expected < 8 ? 8 : expected) * LOAD_DEN / LOAD_NUM + 1);
+  set->slots = calloc(set->capacity, sizeof(uint64_t));
+  if (set->slots == NULL) {
+    free(set);
+    return NULL;
+  }
+
+  if (bloomBits > 0) {
+    set->bloomBits = roundPow2(bloomBits < 64 ? 64 : bloomBits);
+    set->bloom = calloc(set->bloomBits / 64, sizeof(uint64_t));
+    if (set->bloom == NULL) {
+      free(set->slots);
+      free(set);
+      return NULL;
+    }
+  }
+  return set;
+}
+
+// add a url; true if it is new
+bool urlset_insert(urlset_t* set, const char* url)
+{
+  if (set == NULL || url == NULL) {
+    return false;
+  }
+
+  uint64_t fp = fingerprint(url);
+  set->lookups++;
+  size_t slot;
+  if (!bloomMaybe(set, fp)) {
+    set->bloomMisses++; // definitely new; probe only for a free slot
+    findSlot(set, fp, &slot);
+  } else if (findSlot(set, fp, &slot)) {
+    return false; // already seen
+  }
+
+  if ((set->count + 1) * LOAD_DEN > set->capacity * LOAD_NUM) {
+    if (!grow(set)) {
+      return false;
+    }
+    findSlot(set, fp, &slot);
+  }
+  set->slots[slot] = fp;
+  set->count++;
+  bloomAdd(set, fp);
+  return true;
+}
+
+// is url in the set?
+bool urlset_contains(urlset_t* set, const char* url)
+{
+  if (set == NULL || url == NULL) {
+    return false;
+  }
+
+  uint64_t fp = fingerprint(url);
+  set->lookups++;
+  if (!bloomMaybe(set, fp)) {
+    set->bloomMisses++;
+    return false;
+  }
+  size_t slot;
+  return findSlot(set, fp, &slot);
+}
+
+// number of urls
+size_t urlset_size(urlset_t* set)
+{
+  return (set == NULL) ? 0 : set->count;
+}
+
+// bytes held
+size_t urlset_memory(urlset_t* set)
+{
+  if (set == NULL) {
+    return 0;
+  }
+  return sizeof(urlset_t) + set->capacity * sizeof(uint64_t) + set->bloomBits / 8;
+}
+
+// chance that some stored fingerprint equals that of a new url: n / 2^64
+double urlset_falsePositiveRate(urlset_t* set)
+{
+  if (set == NULL) {
+    return 0.0;
+  }
+  return (double)set->count / 18446744073709551616.0;
+}
+
+// one line of statistics
+void urlset_printStats(urlset_t* set, FILE* fp)
+{
+  if (set == NULL || fp == NULL) {
+    return;
+  }
+
+  size_t bytes = urlset_memory(set);
+  fprintf(fp, "urlset: %zu URLs, %zu bytes (%.1f bytes/URL), "
+          "false-positive rate %.3g",
+          set->count, bytes,
+          set->count > 0 ? (double)bytes / set->count : 0.0,
+          urlset_falsePositiveRate(set));
+
+  if (set->bloom != NULL) {
+    // the filter says "maybe" for a new url with probability fill^k
+    double fill = (double)set->bloomSet / set->bloomBits;
+    double filterRate = 1.0;
+    for (int i = 0; i < BLOOM_K; i++) {
+      filterRate *= fill;
+    }
+    fprintf(fp, "; bloom %zu bits k=%d, filter false-positive rate %.3g, "
+            "%zu of %zu lookups answered by filter",
+            set->bloomBits, BLOOM_K, filterRate,
+            set->bloomMisses, set->lookups);
+  }
+  fprintf(fp, "\n");
+}
+
+// free everything
+void urlset_delete(urlset_t* set)
+{
+  if (set == NULL) {
+    return;
+  }
+  free(set->slots);
+  free(set->bloom);
+  free(set);
+}
+
+/**************** helpers ****************/
+
+// the URL's hash; 0 marks an empty slot, so it is never a fingerprint
+static uint64_t fingerprint(const char* url)
+{
+  uint64_t h = fasthash(url, strlen(url));
+  return (h == 0) ? 1 : h;
+}
+
+// smallest power of two >= n
+static size_t roundPow2(size_t n)
+{
+  size_t p = 1;
+  while (p < n) {
+    p <<= 1;
+  }
+  return p;
+}
+
+// find fp's slot, or the empty slot where it would go; true if found
+static bool findSlot(const urlset_t* set, const uint64_t fp, size_t* slot)
+{
+  size_t mask = set->capacity - 1;
+  size_t i = fp & mask;
+  while (set->slots[i] != 0) {
+    if (set->slots[i] == fp) {
+      *slot = i;
+      return true;
+    }
+    i = (i + 1) & mask;
+  }
+  *slot = i;
+  return false;
+}
+
+// double the table and re-place every fingerprint
+static bool grow(urlset_t* set)
+{
+  size_t oldCapacity = set->capacity;
+  uint64_t* oldSlots = set->slots;
+
+  set->slots = calloc(oldCapacity * 2, sizeof(uint64_t));
+  if (set->slots == NULL) {
+    set->slots = oldSlots;
+    return false;
+  }
+  set->capacity = oldCapacity * 2;
+  for (size_t i = 0; i < oldCapacity; i++) {
+    if (oldSlots[i] != 0) {
+      size_t slot;
+      findSlot(set, oldSlots[i], &slot);
+      set->slots[slot] = oldSlots[i];
+    }
+  }
+  free(oldSlots);
+  return true;
+}
+
+// false if the filter is sure fp was never added (always true with no filter)
+static bool bloomMaybe(urlset_t* set, const uint64_t fp)
+{
+  if (set->bloom == NULL) {
+    return true;
+  }
+  uint64_t h1 = fp;
+  uint64_t h2 = (fp >> 32) | 1;
+  size_t mask = set->bloomBits - 1;
+  for (int i = 0; i < BLOOM_K; i++) {
+    size_t bit = (h1 + i * h2) & mask;
+    if ((set->bloom[bit / 64] & (1ULL << (bit % 64))) == 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// turn on fp's bits in the filter
+static void bloomAdd(urlset_t* set, const uint64_t fp)
+{
+  if (set->bloom == NULL) {
+    return;
+  }
+  uint64_t h1 = fp;
+  uint64_t h2 = (fp >> 32) | 1;
+  size_t mask = set->bloomBits - 1;
+  for (int i = 0; i < BLOOM_K; i++) {
+    size_t bit = (h1 + i * h2) & mask;
+    uint64_t b = 1ULL << (bit % 64);
+    if ((set->bloom[bit / 64] & b) == 0) {
+      set->bloom[bit / 64] |= b;
+      set->bloomSet++;
+    }
+  }
+}
@@ -0,0 +1,75 @@
+/* urlset.h - header file for CS50 TSE URL-seen set
+ *
+ * A urlset remembers which URLs the crawler has already seen without keeping
+ *   the URLs themselves: each URL is hashed to a 64-bit fingerprint and the
+ *   fingerprints are kept in an open-addressing table (8 bytes per slot).
+ *   Two different URLs share a fingerprint with probability about 2^-64, in
+ *   which case the second would wrongly be reported as seen.
+ *
+ * An optional Bloom filter sits in front of the table; a URL that misses the
+ *   filter is new for sure, and the table is not searched for it. The filter
+ *   works best with about 10 bits per URL.
+ *
+ * Author: Jacob Bacus
+ * October 2026
+ */
+
+#ifndef __URLSET_H
+#define __URLSET_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+// opaque URL set
+typedef struct urlset urlset_t;
+
+/*
+ * The user provides the number of URLs expected (the table grows past it
+ *   anyway), and the size of the Bloom filter in bits, 0 for no filter.
+ *
+ * We return a pointer to a new empty set, or NULL on error.
+ */
+urlset_t* urlset_new(const size_t expected, const size_t bloomBits);
+
+/*
+ * Adds url to the set.
+ *
+ * We return true if url was not in the set before (like hashtable_insert),
+ *   false if it was already seen, on bad parameters, or out of memory.
+ */
+bool urlset_insert(urlset_t* set, const char* url);
+
+/*
+ * We return true if url is in the set.
+ */
+bool urlset_contains(urlset_t* set, const char* url);
+
+/*
+ * We return the number of URLs in the set.
+ */
+size_t urlset_size(urlset_t* set);
+
+/*
+ * We return the bytes of memory held by the set (table and filter).
+ */
+size_t urlset_memory(urlset_t* set);
+
+/*
+ * We return the estimated probability that a URL never inserted is reported
+ *   as seen, given how many fingerprints the table holds.
+ */
+double urlset_falsePositiveRate(urlset_t* set);
+
+/*
+ * We print one line of statistics to fp: URLs held, memory per URL, the
+ *   false-positive rate, and (with a filter) the filter's own hit rate.
+ */
+void urlset_printStats(urlset_t* set, FILE* fp);
+
+/*
+ * Delete the set, free allocated memory
+ */
+void urlset_delete(urlset_t* set);
+
+#endif // __URLSET_H
@@ -1,11 +1,34 @@
 /*
  * crawler.c - Crawler portion of CS50 TSE
  *
- * Usage: ./crawler seedURL pageDirectory maxDepth
+ * Usage: ./crawler [--frontier-mb N] [--bloom-mb N] [--resume] [--checkpoint N]
+ *                  [--dedup off|D] [--packed] [--compress CODEC]
+ *                  seedURL pageDirectory maxDepth
  *
  * The crawler begins at a seedURL and travels links until it reaches a maxDepth
  *   the traversed webpages are saved to pageDirectory
  *
+ * Pages are visited breadth-first: all pages at one depth before any page at
+ *   the next. URLs waiting to be crawled are kept in memory up to N megabytes
+ *   (default 64) and spilled to a temporary file beyond that.
+ *
+ * URLs already seen are remembered by 64-bit fingerprint only; --bloom-mb puts
+ *   a Bloom filter of N megabytes in front of that set. Its statistics are
+ *   printed when the crawl is done.
+ *
+ * Progress is logged to pageDirectory/.checkpoint and committed to disk every
+ *   N pages (default 1); --resume picks an interrupted crawl up from its last
+ *   checkpoint instead of starting over.
+ *
+ * A fetched page whose content duplicates a page already saved is not saved
+ *   again; its URL is recorded in pageDirectory/.aliases under the earlier
+ *   docID. --dedup D also counts pages whose SimHashes are at most D bits
+ *   apart (0..3, default 0 for exact copies only); --dedup off saves every page.
+ *
+ * With --packed pages are appended to a few large segment files instead of
+ *   one file per docID (a resumed crawl keeps the layout it started with).
+ *   --compress saves each page compressed with lz4, zlib or zlib:LEVEL (1-9).
+ *
  *
  * Author: Jacob Bacus
  * Feburary 2025
@@ -17,23 +40,47 @@
 #include <ctype.h>
 #include <stdbool.h>
 #include "../libcs50/webpage.h"
-#include "../libcs50/hashtable.h"
-#include "../libcs50/bag.h"
 #include "../common/pagedir.h"
+#include "../common/frontier.h"
+#include "../common/urlset.h"
+#include "../common/checkpoint.h"
+#include "../common/dedup.h"
+
+// default memory for the frontier before it spills to disk
+static const size_t FRONTIER_MB = 64;
+
+// URLs the seen set is first sized for; it grows as needed
+static const size_t SEEN_EXPECTED = 1024;
 
-// struct that holds wepage and depth which is given to bag
+// options given before the positional arguments
+typedef struct crawlerOptions {
+  size_t frontierBytes;   // frontier memory budget
+  size_t bloomBits;       // Bloom filter in front of pagesSeen, 0 for none
+  bool resume;            // continue from pageDirectory/.checkpoint
+  int checkpointEvery;    // pages between checkpoints
+  int dedupDistance;      // SimHash distance for duplicates, -1 for none
+  bool packed;            // pages go to segment files
+} crawlerOptions_t;
 
-typedef struct crawler_page {
-  webpage_t* page;
-  int docID;
-} crawler_page_t;
+// what checkpoint replay rebuilds
+typedef struct crawlState {
+  frontier_t* pagesToCrawl;
+  urlset_t* pagesSeen;
+} crawlState_t;
 
 // function prototypes
 static void parseArgs (const int argc, char* argv[],
-                       char** seedURL, char** pageDirectory, int* maxDepth);
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth);
-static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen,
-                     int maxDepth);
+                       char** seedURL, char** pageDirectory, int* maxDepth,
+                       crawlerOptions_t* options);
+static size_t parseMegabytes(const char* option, const char* value);
+static void crawl(char* seedURL, char* pageDirectory, const int maxDepth,
+                  const crawlerOptions_t* options);
+static void pageScan(webpage_t* page, frontier_t* pagesToCrawl,
+                     urlset_t* pagesSeen, checkpoint_t* log, int maxDepth);
+static void replayURL(void* arg, const char* url, const int depth,
+                      const bool visited);
+static void reloadFingerprints(dedup_t* dedup, const char* pageDirectory,
+                               const int lastDocID);
 
 
 // runs the crawler
@@ -42,27 +89,80 @@ int main(const int argc, char* argv[])
   char* seedURL = NULL;
   char* pageDirectory = NULL;
   int maxDepth = 0;
+  crawlerOptions_t options = { FRONTIER_MB * 1024 * 1024, 0, false, 1, 0, false };
 
-  parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth);
-  crawl(seedURL, pageDirectory, maxDepth);
+  parseArgs(argc, argv, &seedURL, &pageDirectory, &maxDepth, &options);
+  crawl(seedURL, pageDirectory, maxDepth, &options);
   
-  //  free(seedURL);
+  free(seedURL);
 
   return 0; // everything worked!
 }
 
 // read arguments from main and attempt to parse into usable forms
 static void parseArgs (const int argc, char* argv[],
-                       char** seedURL, char** pageDirectory, int* maxDepth)
+                       char** seedURL, char** pageDirectory, int* maxDepth,
+                       crawlerOptions_t* options)
 {
+  // options come before the positional arguments
+  int arg = 1;
+  while (arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+    if (strcmp(argv[arg], "--frontier-mb") == 0 && arg + 1 < argc) {
+      options->frontierBytes = parseMegabytes(argv[arg], argv[arg + 1]);
+      arg += 2;
+    } else if (strcmp(argv[arg], "--bloom-mb") == 0 && arg + 1 < argc) {
+      options->bloomBits = parseMegabytes(argv[arg], argv[arg + 1]) * 8;
+      arg += 2;
+    } else if (strcmp(argv[arg], "--resume") == 0) {
+      options->resume = true;
+      arg++;
+    } else if (strcmp(argv[arg], "--checkpoint") == 0 && arg + 1 < argc) {
+      char* end;
+      long every = strtol(argv[arg + 1], &end, 10);
+      if (*end != '\0' || every < 1) {
+        fprintf(stderr, "Error: invalid --checkpoint '%s'\n", argv[arg + 1]);
+        exit(1);
+      }
+      options->checkpointEvery = (int)every;
+      arg += 2;
+    } else if (strcmp(argv[arg], "--dedup") == 0 && arg + 1 < argc) {
+      char* end;
+      long distance = strtol(argv[arg + 1], &end, 10);
+      if (strcmp(argv[arg + 1], "off") == 0) {
+        options->dedupDistance = -1;
+      } else if (*end != '\0' || distance < 0 || distance > DEDUP_MAX_DISTANCE) {
+        fprintf(stderr, "Error: invalid --dedup '%s'\n", argv[arg + 1]);
+        exit(1);
+      } else {
+        options->dedupDistance = (int)distance;
+      }
+      arg += 2;
+    } else if (strcmp(argv[arg], "--compress") == 0 && arg + 1 < argc) {
+      if (!pagedir_setCompression(argv[arg + 1])) {
+        fprintf(stderr, "Error: invalid --compress '%s'\n", argv[arg + 1]);
+        exit(1);
+      }
+      arg += 2;
+    } else if (strcmp(argv[arg], "--packed") == 0) {
+      options->packed = true;
+      arg++;
+    } else {
+      fprintf(stderr, "Error: unknown option '%s'\n", argv[arg]);
+      exit(1);
+    }
+  }
+
   // check for correct argument count
-  if (argc != 4) {
-    fprintf(stderr, "Usage: %s seedURL pageDirectory maxDepth\n", argv[0]);
+  if (argc - arg != 3) {
+    fprintf(stderr, "Usage: %s [--frontier-mb N] [--bloom-mb N] [--resume] "
+            "[--checkpoint N] [--dedup off|D] [--packed] [--compress CODEC] "
+            "seedURL pageDirectory maxDepth\n",
+            argv[0]);
     exit(1);
   }
 
   // parse seedURL
-  const char* givenURL = argv[1];
+  const char* givenURL = argv[arg];
 
   // try to normalize URL provided
   char* normalized = normalizeURL(givenURL);
@@ -81,7 +181,7 @@ static void parseArgs (const int argc, char* argv[],
   *seedURL = normalized; // use the normalized url
 
   // parse pageDirectory
-  const char* dir = argv[2];
+  const char* dir = argv[arg + 1];
   if (!pagedir_init(dir)) {
     fprintf(stderr, "Error: cannot intialize director '%s' \n", dir);
     free(normalized); // necessary free since URL was created
@@ -91,90 +191,173 @@ static void parseArgs (const int argc, char* argv[],
 
   // parse maxDepth
   char* end; // points to first non-numeric char
-  long depth = strtol(argv[3], &end, 10);
+  long depth = strtol(argv[arg + 2], &end, 10);
   if (*end != '\0' || depth < 0 || depth > 10) {
-    fprintf(stderr, "Error: invalid maxDepth '%s'\n", argv[3]);
+    fprintf(stderr, "Error: invalid maxDepth '%s'\n", argv[arg + 2]);
     free(normalized);
     exit(5);
   }
   *maxDepth = (int)depth;
 }
 
+// megabytes given to an option, which must be a number >= 0
+static size_t parseMegabytes(const char* option, const char* value)
+{
+  char* end;
+  long mb = strtol(value, &end, 10);
+  if (*end != '\0' || mb < 0) {
+    fprintf(stderr, "Error: invalid %s '%s'\n", option, value);
+    exit(1);
+  }
+  return (size_t)mb * 1024 * 1024;
+}
+
 // loop for crawling webpages
-static void crawl(char* seedURL, char* pageDirectory, const int maxDepth)
+static void crawl(char* seedURL, char* pageDirectory, const int maxDepth,
+                  const crawlerOptions_t* options)
 {
-  // make a hashtable to track seen URLs
-  hashtable_t* pagesSeen = hashtable_new(200);
+  // make a set to track seen URLs
+  urlset_t* pagesSeen = urlset_new(SEEN_EXPECTED, options->bloomBits);
   if (pagesSeen == NULL) {
-    fprintf(stderr, "could not create hashtable.\n");
+    fprintf(stderr, "could not create URL set.\n");
     exit(6);
   }
 
-  //place seedURL into the hashtable
-  bool inserted = hashtable_insert(pagesSeen, seedURL, "");
-  if (!inserted) {
-    fprintf(stderr, "Error: could not insert seedURL.");
-    hashtable_delete(pagesSeen, NULL);
-    exit(7);
-  }
-
-  // create bag of pages that need to be crawled
-  bag_t* pagesToCrawl = bag_new();
+  // create the frontier of pages that need to be crawled
+  frontier_t* pagesToCrawl = frontier_new(maxDepth, options->frontierBytes);
   if (pagesToCrawl == NULL) {
-    fprintf(stderr, "Could not create bag.\n");
-    hashtable_delete(pagesSeen, NULL);
+    fprintf(stderr, "Could not create frontier.\n");
+    urlset_delete(pagesSeen);
     exit(8);
   }
 
-  // make the webpage for teh seed
-  webpage_t* seedPage = webpage_new(seedURL, 0, NULL);
-  if (seedPage == NULL) {
-    fprintf(stderr, "Could not create seed webpage.\n");
-    bag_delete(pagesToCrawl, NULL);
-    hashtable_delete(pagesSeen, NULL);
-    exit(9);
+  // open the checkpoint log
+  checkpoint_t* log = checkpoint_open(pageDirectory, options->resume,
+                                      options->checkpointEvery);
+  if (log == NULL) {
+    fprintf(stderr, "Could not open checkpoint log.\n");
+    frontier_delete(pagesToCrawl);
+    urlset_delete(pagesSeen);
+    exit(10);
   }
 
-  bag_insert(pagesToCrawl, seedPage);
+  // remember page content, unless every page is to be saved
+  dedup_t* dedup = NULL;
+  if (options->dedupDistance >= 0) {
+    dedup = dedup_new(options->dedupDistance);
+    if (dedup == NULL) {
+      fprintf(stderr, "Could not create dedup table.\n");
+      checkpoint_close(log);
+      frontier_delete(pagesToCrawl);
+      urlset_delete(pagesSeen);
+      exit(11);
+    }
+  }
 
   int docID = 1; // start docID at 1
+  int pagesDone = 0;
+
+  // rebuild the seen set and frontier from the log, if resuming
+  crawlState_t state = { pagesToCrawl, pagesSeen };
+  if (options->resume
+      && checkpoint_replay(log, &state, replayURL, &pagesDone, &docID)) {
+    printf("Resuming: %d pages done, %zu queued, next docID %d\n",
+           pagesDone, frontier_size(pagesToCrawl), docID);
+    reloadFingerprints(dedup, pageDirectory, docID - 1);
+  } else {
+    pagedir_clearAliases(pageDirectory);
+    if (!pagedir_setLayout(pageDirectory, options->packed)) {
+      fprintf(stderr, "Could not set up page directory layout.\n");
+      checkpoint_close(log);
+      dedup_delete(dedup);
+      frontier_delete(pagesToCrawl);
+      urlset_delete(pagesSeen);
+      exit(12);
+    }
+
+    //place seedURL into the set
+    bool inserted = urlset_insert(pagesSeen, seedURL);
+    if (!inserted) {
+      fprintf(stderr, "Error: could not insert seedURL.");
+      checkpoint_close(log);
+      dedup_delete(dedup);
+      frontier_delete(pagesToCrawl);
+      urlset_delete(pagesSeen);
+      exit(7);
+    }
+
+    // the seed is the only page at depth 0
+    checkpoint_added(log, seedURL, 0);
+    if (!frontier_push(pagesToCrawl, seedURL, 0)) {
+      fprintf(stderr, "Could not queue seed URL.\n");
+      checkpoint_close(log);
+      dedup_delete(dedup);
+      frontier_delete(pagesToCrawl);
+      urlset_delete(pagesSeen);
+      exit(9);
+    }
+  }
   
   // crawling loop
 
-  webpage_t* page;
-  while ((page = bag_extract(pagesToCrawl)) != NULL) {
-    int depth = webpage_getDepth(page);
+  char* url;
+  int depth;
+  while ((url = frontier_pop(pagesToCrawl, &depth)) != NULL) {
+    webpage_t* page = webpage_new(url, depth, NULL);
+    if (page == NULL) {
+      free(url);
+      checkpoint_pageDone(log, docID);
+      continue;
+    }
     
     // get HTML for page
     if (webpage_fetch(page)) {
       // print fetching message
       printf("%2d   Fetched: %s\n", depth, webpage_getURL(page));
       
-      // save the page
-      pagedir_save(page, pageDirectory, docID);
-      docID++;
+      // save the page, unless it is a copy of one already saved
+      int original = dedup_add(dedup, page, docID);
+      if (original > 0) {
+        printf("%2d Duplicate: %s (of %d)\n", depth, webpage_getURL(page),
+               original);
+        pagedir_saveAlias(pageDirectory, webpage_getURL(page), original);
+      } else {
+        pagedir_save(page, pageDirectory, docID);
+        docID++;
+      }
       
       // get URLs if page isn't at maxdepth
       if (depth < maxDepth) {
         printf("%2d  Scanning: %s\n", depth, webpage_getURL(page));
-        pageScan(page, pagesToCrawl, pagesSeen, maxDepth);
+        pageScan(page, pagesToCrawl, pagesSeen, log, maxDepth);
       }
     }
 
-    // frees portions
+    // frees portions (url included)
     webpage_delete(page);
-    //free(page);
+
+    // this page and the URLs it queued are now safe to skip on resume
+    checkpoint_pageDone(log, docID);
   }
 
+  // report how compact the seen set was, and what the log cost
+  urlset_printStats(pagesSeen, stdout);
+  checkpoint_printStats(log, stdout);
+  dedup_printStats(dedup, stdout);
+  pagedir_printStats(stdout);
+  checkpoint_close(log);
+  dedup_delete(dedup);
+  pagedir_close();
+
   // don't need data structures
-  bag_delete(pagesToCrawl, NULL);
-  hashtable_delete(pagesSeen, NULL);
+  frontier_delete(pagesToCrawl);
+  urlset_delete(pagesSeen);
 }
 
 
 // finds urls to add to pagesToCrawl
-static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSeen,
-                     int maxDepth)
+static void pageScan(webpage_t* page, frontier_t* pagesToCrawl,
+                     urlset_t* pagesSeen, checkpoint_t* log, int maxDepth)
 {
   //check if parameters are valid
   if (page == NULL || pagesToCrawl == NULL || pagesSeen == NULL) {
@@ -202,21 +385,46 @@ static void pageScan(webpage_t* page, bag_t* pagesToCrawl, hashtable_t* pagesSee
       free(normURL);
     }
     else {
-      if (!hashtable_insert(pagesSeen, normURL, "")) {
+      if (!urlset_insert(pagesSeen, normURL)) {
         // duplicate
         printf("%2d   Added: %s\n", depth, normURL);
         free(normURL);
       } else {
-        // new added page
-        webpage_t* newPage = webpage_new(normURL, depth+1, NULL);
-        if (newPage != NULL) {
-          bag_insert(pagesToCrawl, newPage);
-        }
-        else {
-            free(normURL);
+        // new added page, queued behind everything at its depth
+        checkpoint_added(log, normURL, depth+1);
+        if (!frontier_push(pagesToCrawl, normURL, depth+1)) {
+          fprintf(stderr, "could not queue '%s'\n", normURL);
         }
+        free(normURL);
       }
     }
     free(foundURL);
   }
 }
+
+// put one logged URL back into the seen set, and the frontier if not visited
+static void replayURL(void* arg, const char* url, const int depth,
+                      const bool visited)
+{
+  crawlState_t* state = arg;
+  urlset_insert(state->pagesSeen, url);
+  if (!visited && !frontier_push(state->pagesToCrawl, url, depth)) {
+    fprintf(stderr, "could not queue '%s'\n", url);
+  }
+}
+
+// fingerprint the pages saved before a resumed crawl
+static void reloadFingerprints(dedup_t* dedup, const char* pageDirectory,
+                               const int lastDocID)
+{
+  if (dedup == NULL) {
+    return;
+  }
+  for (int id = 1; id <= lastDocID; id++) {
+    webpage_t* page = pagedir_load(pageDirectory, id);
+    if (page != NULL) {
+      dedup_add(dedup, page, id);
+      webpage_delete(page);
+    }
+  }
+}
@@ -50,6 +50,30 @@ echo
 echo "7. maxDepth is 99:"
 $PROGRAM http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 99
 
+echo
+echo "8. Bad --frontier-mb:"
+$PROGRAM --frontier-mb lots http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 1
+
+echo
+echo "9. Bad --bloom-mb:"
+$PROGRAM --bloom-mb -1 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 1
+
+echo
+echo "10. Bad --checkpoint:"
+$PROGRAM --checkpoint 0 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 1
+
+echo
+echo "11. Bad --dedup:"
+$PROGRAM --dedup 4 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 1
+
+echo
+echo "12. Bad --compress:"
+$PROGRAM --compress zlib:0 http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 1
+
+echo
+echo "13. Unknown option:"
+$PROGRAM --fast http://cs50tse.cs.dartmouth.edu/tse/letters/index.html $DATADIR/test-err 1
+
 
 # 2. Valgrind test on a moderate site
 
@@ -107,6 +131,52 @@ do
   $PROGRAM http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir $depth
 done
 
+# same crawl with a 1 MB frontier budget; should fetch the same pages as toscrape-1
+echo
+dir="$DATADIR/toscrape-1-mb"
+mkdir -p "$dir"
+echo "Running: $PROGRAM --frontier-mb 1 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+$PROGRAM --frontier-mb 1 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+
+# with a Bloom filter in front of the seen set; compare its stats line
+echo
+dir="$DATADIR/toscrape-1-bloom"
+mkdir -p "$dir"
+echo "Running: $PROGRAM --bloom-mb 1 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+$PROGRAM --bloom-mb 1 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+
+# interrupt a crawl, then resume it; should end with the same pages as toscrape-1
+echo
+dir="$DATADIR/toscrape-1-resume"
+mkdir -p "$dir"
+echo "Running: timeout 5 $PROGRAM --checkpoint 2 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+timeout 5 $PROGRAM --checkpoint 2 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+echo "Running: $PROGRAM --resume --checkpoint 2 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+$PROGRAM --resume --checkpoint 2 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+
+# with near-duplicate detection; duplicates are listed in .aliases
+echo
+dir="$DATADIR/toscrape-1-dedup"
+mkdir -p "$dir"
+echo "Running: $PROGRAM --dedup 3 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+$PROGRAM --dedup 3 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+cat "$dir/.aliases" 2>/dev/null
+
+# packed into segment files; indexer/testing.sh indexes this directory
+echo
+dir="$DATADIR/toscrape-1-packed"
+mkdir -p "$dir"
+echo "Running: $PROGRAM --packed http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+$PROGRAM --packed http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+ls "$dir"
+
+# compressed pages; indexer/testing.sh indexes this directory too
+echo
+dir="$DATADIR/toscrape-1-lz4"
+mkdir -p "$dir"
+echo "Running: $PROGRAM --compress lz4 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1"
+$PROGRAM --compress lz4 http://cs50tse.cs.dartmouth.edu/tse/toscrape/index.html $dir 1
+
 # wikipedia
 echo
 echo "*wikipedia site*"
@@ -1,10 +1,44 @@
 /*
  * indexer.c - CS50 TSE Indexer
  *
- * usage: ./indexer pageDirectory indexFilename
+ * usage: ./indexer [--positions] [--queue N] [--readers N] [--memory-mb N]
+ *                  [--workers N] pageDirectory indexFilename
+ *        ./indexer --update changesFile pageDirectory indexFilename
+ *        ./indexer --compact indexFilename
  *
  * Reads a file named pageDirectory/1...N where N is the highest number in the
- *   directory. builds inverted index and writes to indexFilename
+ *   directory (or every page of a packed directory, a segment at a time).
+ *   builds inverted index and writes to indexFilename
+ *
+ * With --positions the position of every word is recorded as well, and saved
+ *   to indexFilename.pos for phrase queries.
+ *
+ * Pages are loaded ahead of the indexing by reader threads (see
+ *   pageloader.h): --queue N keeps up to N pages waiting (default 64, 0 to
+ *   load each page only when it is indexed) and --readers N loads that many
+ *   page files at once (default 1). The time spent loading and indexing,
+ *   and how much they overlapped, is printed to stderr at the end.
+ *
+ * With --memory-mb N the index is built in at most about N MB (see
+ *   spillindex.h): once the words counted take that much they are written
+ *   out, sorted, to indexFilename.run-NNNN files, which are merged into
+ *   indexFilename at the end; its statistics are printed to stderr. Not
+ *   with --positions.
+ *
+ * With --workers N, N threads take pages from the loader and index them
+ *   at once into one concurrent index (see concindex.h), which is saved
+ *   with no merge; its lock counts are printed to stderr. Not with
+ *   --positions or --memory-mb, and it needs a queue.
+ *
+ * Beside the index file a lexicon of its words is saved as
+ *   indexFilename.lex (see lexicon.h), which the querier maps to find
+ *   words without reading the index first.
+ *
+ * With --update, only the pages whose docIDs are listed in changesFile
+ *   (added, changed or removed since indexFilename was built) are indexed,
+ *   into a delta segment beside it (see segindex.h); the querier reads the
+ *   base and its deltas together. --compact merges them into a new base.
+ *   A full build removes any deltas of the index it replaces.
  *
  * Author: Jacob Bacus
  * Feburary 2025
@@ -14,50 +48,232 @@
 #include <stdlib.h>
 #include <stdbool.h>
 #include <string.h>
+#include <pthread.h>
 #include "../common/pagedir.h"
 #include "../common/word.h"
 #include "../common/index.h"
+#include "../common/pageloader.h"
+#include "../common/spillindex.h"
+#include "../common/segindex.h"
+#include "../common/concindex.h"
+#include "../common/lexicon.h"
 #include "../libcs50/webpage.h"
 
+// how pages are loaded and the index built
+typedef struct options {
+  bool positions;       // record word positions
+  int queue;            // pages loaded ahead, 0 for none
+  int readers;          // reader threads
+  int workers;          // indexing threads
+  size_t memoryBudget;  // bytes before spilling to runs, 0 for no limit
+  char* changes;        // --update: file of changed docIDs, else NULL
+  bool compact;         // --compact
+} options_t;
+
+// where pages are indexed: the index in memory, the spilling builder, or
+//   the concurrent index through this thread's buffer
+typedef struct builder {
+  index_t* index;
+  spillindex_t* spill;
+  concindex_t* conc;
+  concbuffer_t* buffer;
+} builder_t;
+
+// one indexing thread of --workers
+typedef struct worker {
+  pthread_t thread;
+  pageloader_t* loader;
+  builder_t builder;
+} worker_t;
+
 // function prototypes
 static void parseArgs(int argc, char* argv[],
-                      char** pageDirectory, char** indexFilename);
-static void buildIndex(const char* pageDirectory, index_t* index);
-static void indexPage(webpage_t* page, int docID, index_t* index);
+                      char** pageDirectory, char** indexFilename,
+                      options_t* options);
+static int parseCount(const char* option, const char* value, const int min);
+static int indexSlots(const pageInfo_t* pages, const int count);
+static bool saveLexicon(const char* indexFilename);
+static int updateIndex(const char* pageDirectory, const char* indexFilename,
+                       const char* changesFile);
+static int* readChanges(const char* changesFile, int* count);
+static int compareDocIDs(const void* a, const void* b);
+static void buildIndex(const char* pageDirectory, const pageInfo_t* pages,
+                       const int count, builder_t* builder,
+                       const options_t* options);
+static void buildConcurrent(pageloader_t* loader, concindex_t* conc,
+                            const int workers);
+static void* indexPages(void* arg);
+static void indexPageItem(void* arg, webpage_t* page, const int docID);
+static void indexPage(webpage_t* page, int docID, builder_t* builder);
 
 int main(int argc, char* argv[])
 {
   char* pageDirectory = NULL;
   char* indexFilename = NULL;
-  parseArgs(argc, argv, &pageDirectory, &indexFilename);
-  
+  options_t options = { false, 64, 1, 1, 0, NULL, false };
+  parseArgs(argc, argv, &pageDirectory, &indexFilename, &options);
+
+  // bring an existing index up to date, or fold its deltas back in
+  if (options.changes != NULL) {
+    int status = updateIndex(pageDirectory, indexFilename, options.changes);
+    pagedir_close();
+    return status;
+  }
+  if (options.compact) {
+    // a compacted index is sorted as a build's is, so its lexicon must fit
+    if (!segindex_compact(indexFilename) || !saveLexicon(indexFilename)) {
+      return 6;
+    }
+    return 0;
+  }
+
+  // the pages to index, which tell how big the index will get
+  int count;
+  pageInfo_t* pages = pagedir_list(pageDirectory, &count);
+  int slots = indexSlots(pages, count);
+  fprintf(stderr, "indexer: %d pages listed, %d index slots\n", count, slots);
+
+  // with a budget, spill to runs beside the index file
+  if (options.memoryBudget > 0) {
+    builder_t builder = { NULL, spillindex_new(indexFilename, options.memoryBudget),
+                          NULL, NULL };
+    if (builder.spill == NULL) {
+      fprintf(stderr, "indexer: cannot create index\n");
+      exit(1);
+    }
+    buildIndex(pageDirectory, pages, count, &builder, &options);
+    bool saved = spillindex_save(builder.spill, indexFilename);
+    spillindex_printStats(builder.spill, stderr);
+    spillindex_delete(builder.spill);
+    segindex_removeDeltas(indexFilename);
+    if (saved) {
+      saveLexicon(indexFilename);
+    }
+    free(pages);
+    pagedir_close();
+    return saved ? 0 : 6;
+  }
+
+  // several workers share one concurrent index
+  if (options.workers > 1) {
+    builder_t builder = { NULL, NULL, concindex_new(slots), NULL };
+    if (builder.conc == NULL) {
+      fprintf(stderr, "indexer: cannot create index\n");
+      exit(1);
+    }
+    buildIndex(pageDirectory, pages, count, &builder, &options);
+    bool saved = concindex_save(builder.conc, indexFilename);
+    concindex_printStats(builder.conc, stderr);
+    concindex_delete(builder.conc);
+    segindex_removeDeltas(indexFilename);
+    if (saved) {
+      saveLexicon(indexFilename);
+    }
+    free(pages);
+    pagedir_close();
+    return saved ? 0 : 6;
+  }
+
   // empty index
-  index_t* index = index_new(500); // 500 is slot #
-  if (index == NULL) {
+  builder_t builder = { index_new(slots), NULL, NULL, NULL };
+  if (builder.index == NULL
+      || (options.positions && !index_enablePositions(builder.index))) {
     fprintf(stderr, "indexer: cannot create index\n");
     exit(1);
   }
 
   // outsource functionality to index struct
-  buildIndex(pageDirectory, index);
+  buildIndex(pageDirectory, pages, count, &builder, &options);
 
-  index_save(index, indexFilename);
+  index_save(builder.index, indexFilename);
+  segindex_removeDeltas(indexFilename);
+  saveLexicon(indexFilename);
 
-  index_delete(index);
+  index_delete(builder.index);
+  free(pages);
+  pagedir_close();
   return 0;
 }
 
 // go through and check that arguments are valid
 static void parseArgs(int argc, char* argv[],
-                      char** pageDirectory, char** indexFilename)
+                      char** pageDirectory, char** indexFilename,
+                      options_t* options)
 {
-  if (argc !=3) {
-    fprintf(stderr, "Usage: %s pageDirectory indexFilename\n", argv[0]);
+  // options come before the positional arguments
+  int arg = 1;
+  while (arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+    if (strcmp(argv[arg], "--positions") == 0) {
+      options->positions = true;
+    } else if (strcmp(argv[arg], "--queue") == 0 && arg + 1 < argc) {
+      options->queue = parseCount(argv[arg], argv[arg + 1], 0);
+      arg++;
+    } else if (strcmp(argv[arg], "--readers") == 0 && arg + 1 < argc) {
+      options->readers = parseCount(argv[arg], argv[arg + 1], 1);
+      arg++;
+    } else if (strcmp(argv[arg], "--workers") == 0 && arg + 1 < argc) {
+      options->workers = parseCount(argv[arg], argv[arg + 1], 1);
+      arg++;
+    } else if (strcmp(argv[arg], "--update") == 0 && arg + 1 < argc) {
+      options->changes = argv[arg + 1];
+      arg++;
+    } else if (strcmp(argv[arg], "--compact") == 0) {
+      options->compact = true;
+    } else if (strcmp(argv[arg], "--memory-mb") == 0 && arg + 1 < argc) {
+      options->memoryBudget = (size_t)parseCount(argv[arg], argv[arg + 1], 1)
+                              << 20;
+      arg++;
+    } else {
+      fprintf(stderr, "Unknown option '%s'\n", argv[arg]);
+      exit(2);
+    }
+    arg++;
+  }
+
+  if (argc - arg != (options->compact ? 1 : 2)) {
+    fprintf(stderr, "Usage: %s [--positions] [--queue N] [--readers N] "
+            "[--memory-mb N] [--workers N] pageDirectory indexFilename\n"
+            "       %s --update changesFile pageDirectory indexFilename\n"
+            "       %s --compact indexFilename\n", argv[0], argv[0], argv[0]);
+    exit(2);
+  }
+
+  // an update follows the base index, which a full build would replace
+  if ((options->changes != NULL || options->compact)
+      && (options->positions || options->memoryBudget > 0
+          || options->workers > 1
+          || (options->changes != NULL && options->compact))) {
+    fprintf(stderr, "--update and --compact take no other options\n");
+    exit(2);
+  }
+  if (options->compact) {
+    *indexFilename = argv[arg];
+    FILE* fp = fopen(*indexFilename, "r+");
+    if (fp == NULL) {
+      fprintf(stderr, "Cannot open indexFilename '%s'\n", *indexFilename);
+      exit(4);
+    }
+    fclose(fp);
+    return;
+  }
+
+  // the runs hold counts only
+  if (options->positions && options->memoryBudget > 0) {
+    fprintf(stderr, "--memory-mb cannot be used with --positions\n");
+    exit(2);
+  }
+
+  // the workers share a concurrent index of counts, fed by the loader
+  if (options->workers > 1
+      && (options->positions || options->memoryBudget > 0
+          || options->queue == 0)) {
+    fprintf(stderr, "--workers cannot be used with --positions, "
+            "--memory-mb or --queue 0\n");
     exit(2);
   }
 
-  *pageDirectory = argv[1];
-  *indexFilename = argv[2];
+  *pageDirectory = argv[arg];
+  *indexFilename = argv[arg + 1];
 
   // validate address
   if (!pagedir_validate(*pageDirectory)) {
@@ -65,8 +281,8 @@ static void parseArgs(int argc, char* argv[],
     exit(3);
   }
 
-  // check if you can write into indexFilename
-  FILE* fp = fopen(*indexFilename, "w");
+  // check if you can write into indexFilename; an update keeps what is there
+  FILE* fp = fopen(*indexFilename, (options->changes != NULL) ? "r+" : "w");
   if (fp == NULL) {
     fprintf(stderr, "Cannot open indexFilename '%s'\n", *indexFilename);
     exit(4);
@@ -74,38 +290,255 @@ static void parseArgs(int argc, char* argv[],
   fclose(fp);
 }
 
-// create indicies starting from docID 1 and incrementing
-static void buildIndex(const char* pageDirectory, index_t* index)
+// an option's count, at least min; exits if it is not one
+static int parseCount(const char* option, const char* value, const int min)
+{
+  char* end;
+  long count = strtol(value, &end, 10);
+  if (*end != '\0' || end == value || count < min || count > 1000000) {
+    fprintf(stderr, "Invalid %s '%s'\n", option, value);
+    exit(2);
+  }
+  return (int)count;
+}
+
+// the index file's lexicon beside it; the querier does without one, so
+//   failing to write it is not an error
+static bool saveLexicon(const char* indexFilename)
+{
+  if (!lexicon_build(indexFilename)) {
+    fprintf(stderr, "indexer: cannot write lexicon '%s.lex'\n", indexFilename);
+    return false;
+  }
+  return true;
+}
+
+// hashtable slots for the words of count pages: roughly one per distinct
+//   word, which grows with the square root of the text (Heaps' law)
+static int indexSlots(const pageInfo_t* pages, const int count)
+{
+  size_t bytes = 0;
+  for (int i = 0; i < count; i++) {
+    bytes += pages[i].size;
+  }
+  size_t root = 0;
+  while ((root + 1) * (root + 1) <= bytes) {
+    root++;
+  }
+  size_t slots = 10 * root;
+  if (slots < 500) {
+    return 500;
+  }
+  return (slots > (1 << 20)) ? (1 << 20) : (int)slots;
+}
+
+// index the pages listed in changesFile into a delta segment of
+//   indexFilename; a listed page that no longer loads was removed
+static int updateIndex(const char* pageDirectory, const char* indexFilename,
+                       const char* changesFile)
+{
+  int count;
+  int* docIDs = readChanges(changesFile, &count);
+  if (docIDs == NULL) {
+    return 2;
+  }
+
+  // the delta has positions if the base does, so phrases span both
+  char posFilename[1024];
+  snprintf(posFilename, sizeof(posFilename), "%s.pos", indexFilename);
+  FILE* posFp = fopen(posFilename, "r");
+  builder_t builder = { index_new(500), NULL, NULL, NULL };
+  if (builder.index == NULL
+      || (posFp != NULL && !index_enablePositions(builder.index))) {
+    fprintf(stderr, "indexer: cannot create index\n");
+    exit(1);
+  }
+  if (posFp != NULL) {
+    fclose(posFp);
+  }
+
+  int indexed = 0;
+  for (int i = 0; i < count; i++) {
+    webpage_t* page = pagedir_load(pageDirectory, docIDs[i]);
+    if (page != NULL) {
+      indexPage(page, docIDs[i], &builder);
+      webpage_delete(page);
+      indexed++;
+    }
+  }
+
+  int delta = segindex_addDelta(indexFilename, builder.index, docIDs, count);
+  if (delta > 0) {
+    fprintf(stderr, "indexer: %d pages indexed, %d removed, delta segment %d\n",
+            indexed, count - indexed, delta);
+  }
+  index_delete(builder.index);
+  free(docIDs);
+  return (delta > 0) ? 0 : 6;
+}
+
+// the docIDs in changesFile, sorted and each once, in a new array;
+//   NULL (with a message) if it cannot be read or holds a bad docID
+static int* readChanges(const char* changesFile, int* count)
+{
+  FILE* fp = fopen(changesFile, "r");
+  if (fp == NULL) {
+    fprintf(stderr, "Cannot open changesFile '%s'\n", changesFile);
+    return NULL;
+  }
+  int cap = 64;
+  int* docIDs = malloc(cap * sizeof(int));
+  *count = 0;
+  int docID;
+  int nread = EOF;
+  while (docIDs != NULL && (nread = fscanf(fp, "%d", &docID)) == 1
+         && docID > 0) {
+    if (*count == cap) {
+      cap *= 2;
+      int* grown = realloc(docIDs, cap * sizeof(int));
+      if (grown == NULL) {
+        free(docIDs);
+        docIDs = NULL;
+        break;
+      }
+      docIDs = grown;
+    }
+    docIDs[(*count)++] = docID;
+  }
+  bool bad = docIDs != NULL && (nread != EOF || ferror(fp));
+  fclose(fp);
+  if (docIDs == NULL || bad) {
+    fprintf(stderr, "Invalid changesFile '%s'\n", changesFile);
+    free(docIDs);
+    return NULL;
+  }
+
+  // a docID listed twice is indexed once
+  if (*count > 1) {
+    qsort(docIDs, *count, sizeof(int), compareDocIDs);
+    int out = 1;
+    for (int i = 1; i < *count; i++) {
+      if (docIDs[i] != docIDs[out - 1]) {
+        docIDs[out++] = docIDs[i];
+      }
+    }
+    *count = out;
+  }
+  return docIDs;
+}
+
+// for qsort of docIDs
+static int compareDocIDs(const void* a, const void* b)
+{
+  int x = *(const int*)a;
+  int y = *(const int*)b;
+  return (x > y) - (x < y);
+}
+
+// index every listed page, from files or whole segments when packed;
+//   with a queue, reader threads load the pages ahead of indexPage
+static void buildIndex(const char* pageDirectory, const pageInfo_t* pages,
+                       const int count, builder_t* builder,
+                       const options_t* options)
 {
-  int docID = 1;
-  while (true) {
-    // load a page
-    webpage_t* page = pagedir_load(pageDirectory, docID);
-
-    // ran out of pages
-    if (page == NULL) {
-      break;
+  if (options->queue == 0) {
+    pagedir_scan(pageDirectory, builder, indexPageItem);
+    return;
+  }
+
+  pageloader_t* loader = pageloader_new(pageDirectory, pages, count,
+                                        options->readers, options->queue);
+  if (loader == NULL) {
+    fprintf(stderr, "indexer: cannot start page loader\n");
+    exit(5);
+  }
+  if (builder->conc != NULL) {
+    buildConcurrent(loader, builder->conc, options->workers);
+  } else {
+    webpage_t* page;
+    int docID;
+    while ((page = pageloader_next(loader, &docID)) != NULL) {
+      indexPage(page, docID, builder);
+      webpage_delete(page);
     }
+  }
+  pageloader_printStats(loader, stderr);
+  pageloader_delete(loader);
+}
 
-    // index page
-    indexPage(page, docID, index);
+// index the loader's pages with workers threads, each with its own buffer
+static void buildConcurrent(pageloader_t* loader, concindex_t* conc,
+                            const int workers)
+{
+  worker_t* pool = calloc(workers, sizeof(worker_t));
+  if (pool == NULL) {
+    fprintf(stderr, "indexer: cannot start workers\n");
+    exit(1);
+  }
+  for (int w = 0; w < workers; w++) {
+    pool[w].loader = loader;
+    pool[w].builder = (builder_t){ NULL, NULL, conc, concbuffer_new() };
+    if (pool[w].builder.buffer == NULL
+        || pthread_create(&pool[w].thread, NULL, indexPages, &pool[w]) != 0) {
+      fprintf(stderr, "indexer: cannot start worker %d\n", w + 1);
+      exit(1);
+    }
+  }
+  for (int w = 0; w < workers; w++) {
+    pthread_join(pool[w].thread, NULL);
+    concbuffer_delete(pool[w].builder.buffer);
+  }
+  free(pool);
+}
 
-    // cleanup
+// a worker: take pages from the loader until there are none
+static void* indexPages(void* arg)
+{
+  worker_t* worker = arg;
+  webpage_t* page;
+  int docID;
+  while ((page = pageloader_next(worker->loader, &docID)) != NULL) {
+    indexPage(page, docID, &worker->builder);
     webpage_delete(page);
-    docID++;
   }
+  return NULL;
+}
+
+// pagedir_scan's callback
+static void indexPageItem(void* arg, webpage_t* page, const int docID)
+{
+  indexPage(page, docID, arg);
 }
 
 // gets words from webpageand puts them into the index after normalizing them
-static void indexPage(webpage_t* page, int docID, index_t* index)
+static void indexPage(webpage_t* page, int docID, builder_t* builder)
 {
   int pos = 0; // tracksposition
+  int wordNum = 0; // counts every word, even short ones, so phrases stay exact
   char* word;
   while ((word = webpage_getNextWord(page, &pos)) != NULL) {
     if (normalizeWord(word)) {
       // insert word into the index
-      index_insert(index, word, docID);
+      if (builder->conc != NULL) {
+        if (!concbuffer_add(builder->buffer, word)) {
+          fprintf(stderr, "indexer: out of memory\n");
+          exit(6);
+        }
+      } else if (builder->spill != NULL) {
+        if (!spillindex_insert(builder->spill, word, docID)) {
+          fprintf(stderr, "indexer: cannot spill index\n");
+          exit(6);
+        }
+      } else {
+        index_insertAt(builder->index, word, docID, wordNum);
+      }
     }
+    wordNum++;
     free(word); // allocated into webpage_getNextWord
   }
+  if (builder->conc != NULL
+      && !concindex_flush(builder->conc, builder->buffer, docID)) {
+    fprintf(stderr, "indexer: out of memory\n");
+    exit(6);
+  }
 }
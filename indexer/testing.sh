@@ -7,6 +7,14 @@
 #   3. Indexer tests on various directories
 #   4. Uses indextest to load each index file, saves to another file,
 #      then compares them with indexcmp.
+#   5. Builds a positional index (--positions) and round-trips it
+#   6. Indexes a packed page directory, and a compressed one
+#   7. Loads pages ahead with reader threads (--queue, --readers)
+#   8. Indexes a directory with a page file missing
+#   9. Builds an index within a memory budget (--memory-mb)
+#  10. Updates an index with a delta segment (--update), then compacts it
+#  11. Indexes with several threads into a concurrent index (--workers)
+#  12. Checks the lexicon file written beside each index
 #
 # Usage:
 #   bash -v testing.sh
@@ -17,6 +25,7 @@
 
 PROGRAM_INDEXER=./indexer
 PROGRAM_TESTER=./indextest
+PROGRAM_QUERIER=../querier/querier
 
 # crawler produced directory locations
 DATADIR=../data
@@ -53,6 +62,26 @@ echo
 echo "5) Invalid indexFilename (cannot open for writing):"
 $PROGRAM_INDEXER $DATADIR/letters-0 /no-permission-dir/index.out
 
+echo
+echo "6) Invalid --queue and --readers:"
+$PROGRAM_INDEXER --queue -1 $DATADIR/letters-0 $INDEXDIR/test.index
+$PROGRAM_INDEXER --readers 0 $DATADIR/letters-0 $INDEXDIR/test.index
+
+echo
+echo "7) Invalid --memory-mb, and --memory-mb with --positions:"
+$PROGRAM_INDEXER --memory-mb 0 $DATADIR/letters-0 $INDEXDIR/test.index
+$PROGRAM_INDEXER --memory-mb 1 --positions $DATADIR/letters-0 $INDEXDIR/test.index
+
+echo
+echo "8) Missing changesFile for --update, and --update with --compact:"
+$PROGRAM_INDEXER --update no-such-file $DATADIR/letters-0 $INDEXDIR/letters-0.index
+$PROGRAM_INDEXER --update no-such-file --compact $INDEXDIR/letters-0.index
+
+echo
+echo "9) Invalid --workers, and --workers with --positions:"
+$PROGRAM_INDEXER --workers 0 $DATADIR/letters-0 $INDEXDIR/test.index
+$PROGRAM_INDEXER --workers 2 --positions $DATADIR/letters-0 $INDEXDIR/test.index
+
 # 2. Valgrind test
 ################################
 echo
@@ -137,5 +166,125 @@ for dir in "${ALL_DIRS[@]}"; do
 done
 
 
+# 4. Positional index test
+########################################
+echo
+echo "----- POSITIONAL INDEX TEST (letters-10) -----"
+POSFILE=$INDEXDIR/letters-10-pos.index
+rm -f "$POSFILE" "$POSFILE.pos"
+$PROGRAM_INDEXER --positions $DATADIR/letters-10 "$POSFILE"
+
+# word counts must be the same as without positions
+diff <(sort "$INDEXDIR/letters-10.index") <(sort "$POSFILE") && echo "word counts match"
+
+# indextest carries the positions through a load/save round trip
+$PROGRAM_TESTER "$POSFILE" "$POSFILE-copy"
+ls "$POSFILE.pos" "$POSFILE-copy.pos"
+
+# 5. Packed page directory test
+########################################
+echo
+echo "----- PACKED DIRECTORY TEST (toscrape-1-packed) -----"
+PACKFILE=$INDEXDIR/toscrape-1-packed.index
+rm -f "$PACKFILE"
+$PROGRAM_INDEXER $DATADIR/toscrape-1-packed "$PACKFILE"
+
+# same pages as toscrape-1, so the same index
+diff <(sort "$INDEXDIR/toscrape-1.index") <(sort "$PACKFILE") && echo "packed index matches"
+
+# 6. Compressed page directory test
+########################################
+echo
+echo "----- COMPRESSED DIRECTORY TEST (toscrape-1-lz4) -----"
+LZ4FILE=$INDEXDIR/toscrape-1-lz4.index
+rm -f "$LZ4FILE"
+$PROGRAM_INDEXER $DATADIR/toscrape-1-lz4 "$LZ4FILE"
+diff <(sort "$INDEXDIR/toscrape-1.index") <(sort "$LZ4FILE") && echo "compressed index matches"
+
+# 7. Prefetch test
+########################################
+echo
+echo "----- PREFETCH TEST (toscrape-1, toscrape-1-packed) -----"
+# loading ahead must not change the index, however many readers race
+for dir in toscrape-1 toscrape-1-packed
+do
+  $PROGRAM_INDEXER --queue 0 $DATADIR/$dir "$INDEXDIR/$dir-noqueue.index"
+  $PROGRAM_INDEXER --queue 2 --readers 4 $DATADIR/$dir "$INDEXDIR/$dir-queue.index"
+  cmp "$INDEXDIR/$dir-noqueue.index" "$INDEXDIR/$dir-queue.index" && echo "$dir: prefetched index matches"
+done
+
+# 8. Missing page test
+########################################
+echo
+echo "----- MISSING PAGE TEST (toscrape-1 without page 2) -----"
+# the manifest lists every page, so the pages after a missing one are indexed
+GAPDIR=$DATADIR/toscrape-1-gap
+rm -rf "$GAPDIR"
+cp -r $DATADIR/toscrape-1 "$GAPDIR"
+rm "$GAPDIR/2"
+$PROGRAM_INDEXER "$GAPDIR" "$INDEXDIR/toscrape-1-gap.index"
+grep -c " 3 " "$INDEXDIR/toscrape-1-gap.index"
+
+# 9. Memory budget test
+########################################
+echo
+echo "----- MEMORY BUDGET TEST (wikipedia-2) -----"
+# a budget far smaller than the index spills many runs; the merged index
+#   is the same file, as both are sorted, and no runs are left
+BUDGETFILE=$INDEXDIR/wikipedia-2-budget.index
+$PROGRAM_INDEXER --memory-mb 1 $DATADIR/wikipedia-2 "$BUDGETFILE"
+cmp "$INDEXDIR/wikipedia-2.index" "$BUDGETFILE" && echo "budget index matches"
+ls "$BUDGETFILE".run-* 2>/dev/null | wc -l
+
+# 10. Incremental update test
+########################################
+echo
+echo "----- INCREMENTAL UPDATE TEST (letters-10, page 3 changed, page 2 removed) -----"
+# a delta for the two pages, compacted, gives the same words and counts
+#   as indexing the changed directory from scratch, and the same file
+UPDDIR=$DATADIR/letters-10-upd
+UPDFILE=$INDEXDIR/letters-10-upd.index
+rm -rf "$UPDDIR" "$UPDFILE"*
+cp -r $DATADIR/letters-10 "$UPDDIR"
+$PROGRAM_INDEXER "$UPDDIR" "$UPDFILE"
+(head -2 "$UPDDIR/3"; echo "<html>a changed page about marmalade</html>") > "$UPDDIR/3.new"
+mv "$UPDDIR/3.new" "$UPDDIR/3"
+rm "$UPDDIR/2"
+printf '3\n2\n' > "$INDEXDIR/letters-10-upd.changes"
+$PROGRAM_INDEXER --update "$INDEXDIR/letters-10-upd.changes" "$UPDDIR" "$UPDFILE"
+ls "$UPDFILE".delta-*
+$PROGRAM_INDEXER --compact "$UPDFILE"
+$PROGRAM_INDEXER "$UPDDIR" "$INDEXDIR/letters-10-full.index"
+pairs() { awk '{for (i = 2; i < NF; i += 2) print $1, $i, $(i+1)}' "$1" | sort; }
+diff <(pairs "$UPDFILE") <(pairs "$INDEXDIR/letters-10-full.index") && echo "compacted index matches"
+cmp "$UPDFILE" "$INDEXDIR/letters-10-full.index" && echo "compacted index file matches"
+
+# 11. Concurrent index test
+########################################
+echo
+echo "----- WORKERS TEST (wikipedia-2, toscrape-1-packed) -----"
+# however the workers interleave their pages, the saved index is the file
+#   a single thread writes
+for dir in wikipedia-2 toscrape-1-packed
+do
+  $PROGRAM_INDEXER --workers 4 --readers 2 $DATADIR/$dir "$INDEXDIR/$dir-workers.index"
+  cmp "$INDEXDIR/$dir.index" "$INDEXDIR/$dir-workers.index" && echo "$dir: workers index matches"
+done
+
+# 12. Lexicon test
+########################################
+echo
+echo "----- LEXICON TEST (wikipedia-2, letters-10-upd) -----"
+# every way of building an index leaves its lexicon beside it, and so does
+#   a compaction; an index indextest copies has none
+for file in wikipedia-2 wikipedia-2-budget wikipedia-2-workers letters-10-upd
+do
+  [ -s "$INDEXDIR/$file.index.lex" ] && echo "$file: lexicon written"
+done
+ls "$INDEXDIR/wikipedia-2-copy.index.lex" 2>/dev/null | wc -l
+# the compaction's new word sorts mid-lexicon, and is found through it
+cut -d' ' -f1 "$UPDFILE" | LC_ALL=C sort -c && echo "letters-10-upd: words sorted"
+echo marmalade | $PROGRAM_QUERIER --lazy 1 "$UPDDIR" "$UPDFILE" | grep "doc   3:"
+
 echo
 echo "Done"
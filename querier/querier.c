@@ -1,33 +1,70 @@
 /* querier.c - The Querier module of TSE
  *
- * Usage: ./querier pageDirectory indexFilename
+ * Usage: ./querier [--lazy N] [--profile] [--stats file] pageDirectory indexFilename
  *
  * This program reads an index file produced by indexer and a pageDirectory produced
  *   by crawler that corresponds to it. After this it accepts queries from stdin.
  *   The queries are words and 'and'/'or' operators ('and' takes precedence), querier
  *   returns set of matching documents.
  *
+ * A run of words in double quotes ("depth first search") is a phrase; it matches
+ *   documents holding those words consecutively, and needs an index built with
+ *   indexer --positions.
+ *
+ * A word ending in '*' (comput*) stands for every indexed word starting
+ *   with what comes before it, as if they were joined by 'or': their docs
+ *   are merged into one set, counts added up. At most MAX_EXPANSIONS words
+ *   are used (the first in strcmp order), and the query reports how many
+ *   there were.
+ *
+ * A query is answered in two steps. First the matching docs are found as
+ *   sets (roaring bitmaps, see roaring.h): the words of each 'and' run are
+ *   intersected rarest first, and the runs united. Then only those docs are
+ *   scored, from each word's postings in docID order.
+ *
+ * The index is read together with any delta segments that indexer --update
+ *   wrote beside it (see segindex.h), so updated pages are searched in their
+ *   newest version and removed pages not at all.
+ *
+ * With --lazy N only the index's lexicon is read at startup (see
+ *   lazyindex.h), or just mapped if the indexer saved one beside it, so
+ *   the first query is answered at once; each word is read when first
+ *   queried and kept in a cache of about N MB.
+ *
+ * With --profile each query's results are followed by how it was answered:
+ *   its runs of terms in the order they were intersected, with each term's
+ *   document frequency, the docs left after it and the time to look it up,
+ *   then how many postings scoring sought, and the nanoseconds spent in
+ *   each phase (parse, lookup, sets, match, score, print). With --stats
+ *   file the same numbers go to file, a tab-separated line per query, and
+ *   a summary of them all (latency percentiles, mean per phase) at the end.
+ *
  * (Ranking not implemented)
  *
  * Author: Jacob Bacus
  * Feburary 2025
  */
 
+#define _POSIX_C_SOURCE 200809L
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 #include <stdbool.h>
 #include <ctype.h>
+#include <time.h>
 #include <unistd.h> // for isatty
-#include "../common/index.h"
+#include "../common/segindex.h"
 #include "../common/pagedir.h"
 #include "../common/word.h"
-#include "../libcs50/counters.h"
+#include "../common/postings.h"
+#include "../common/roaring.h"
 #include "../libcs50/mem.h"
 
 // local constants used for max lengths
 #define MAX_QUERY_LINE 1000
 #define MAX_QUERY_WORDS 200
+// most words a wildcard is expanded to
+#define MAX_EXPANSIONS 100
 
 // store docID with score for sorting
 typedef struct docscore {
@@ -35,53 +72,126 @@ typedef struct docscore {
   int score;
 } docscore_t;
 
+// the postings of a wildcard's words, for segindex_prefix
+typedef struct expansion {
+  segindex_t* index;
+  postings_t** lists;
+  int nlists;
+  bool failed;          // out of memory
+} expansion_t;
+
+// what the user asked for on the command line
+typedef struct options {
+  size_t cacheBytes;    // --lazy: cache budget, 0 to load the whole index
+  bool profile;         // --profile: print how each query was answered
+  char* statsFile;      // --stats: file for each query's numbers, or NULL
+} options_t;
+
+// what answering one query cost, in nanoseconds and postings
+typedef struct profile {
+  long parseNs;         // reading the query
+  long lookupNs;        // finding each term's postings
+  long setNs;           // making each term's docID set
+  long matchNs;         // 'and' and 'or' of the sets
+  long scoreNs;         // counting each match's score
+  long printNs;         // sorting, and loading each match's URL
+  int nterms;
+  int nruns;
+  int matched;
+  long seeks;           // postings_seek calls while scoring
+  long passed;          // postings pairs the cursors moved past
+} profile_t;
+
+// the numbers of every query, for --stats
+typedef struct stats {
+  FILE* fp;
+  profile_t sum;
+  long* totals;         // each query's total ns
+  int n;
+  int cap;
+} stats_t;
+
+// one word (or phrase, or wildcard) of a query
+typedef struct term {
+  const char* word;     // as the query has it
+  postings_t* postings; // its docIDs in order, with counts
+  roaring_t* docs;      // its docIDs as a set
+  int at;               // where scoring is in its postings
+  long lookupNs;        // time to find its postings
+  int step;             // when its run intersected it (0 first), or -1
+  int left;             // docs left in its run after it
+} term_t;
+
+// a query: runs of terms joined by 'and', the runs joined by 'or'
+typedef struct plan {
+  term_t* terms;        // in query order
+  int nterms;
+  int* runEnd;          // run r is terms runEnd[r - 1] up to runEnd[r]
+  int* runDocs;         // docs each run matched
+  int nruns;
+  profile_t* profile;   // where the phases' times go
+} plan_t;
+
 // function prototypes
-static void parseArgs(int argc, char*argv[], char** pageDir, char** indexFilename);
+static void parseArgs(int argc, char*argv[], char** pageDir, char** indexFilename,
+                      options_t* options);
 static void prompt(void);
 static bool readQueryLine(char* buffer, FILE* fp);
 static char** parseQuery(char* line, int* nwords);
 static bool validateQuery(char** words, int nwords);
-static counters_t* handleQuery(char** words, int nwords, index_t* index);
-static counters_t* parseOrSequence(char** words, int* pos,
-                                   int nwords, index_t* index);
-static counters_t* parseAndSequence(char** words, int* pos,
-                                    int nwords, index_t* index);
-static counters_t* getCountersForWord(const char* word, index_t* index);
-static void countersAndCombine(counters_t* dest, counters_t* src);
-static void countersOrCombine(counters_t* dest, counters_t* src);
-static void printResults(counters_t* results, const char* pageDir);
-
-// counters_iterate functions
-static void foundNonZeroFn(void* arg, const int key, const int count);
-static void copyCountFn(void* arg, const int key, const int count);
-static void andCombineHelper1(void* arg, const int key, const int countDest);
-static void andCombineHelper2(void* arg, const int key, const int countSrc);
-static void orCombineHelper(void* arg, const int key, const int countSrc);
-
-// helper functions for sorting docscore, counting docs
-static int countNonZeroDocs(counters_t* ctrs);
-static void addIfNonZero(void* arg, const int docID, const int score);
+static docscore_t* handleQuery(char** words, int nwords, segindex_t* index,
+                               int* nDocs, profile_t* profile, bool explain);
+static bool makePlan(char** words, int nwords, segindex_t* index, plan_t* plan);
+static roaring_t* matchPlan(plan_t* plan);
+static roaring_t* matchRun(plan_t* plan, const int first, const int end,
+                           bool* owned);
+static docscore_t* scorePlan(plan_t* plan, roaring_t* matches, int* nDocs);
+static void printPlan(plan_t* plan, FILE* fp);
+static void deletePlan(plan_t* plan);
+static int compareTermSize(const void* a, const void* b);
+static postings_t* getPostingsForWord(const char* word, segindex_t* index);
+static postings_t* getPostingsForPhrase(const char* phrase, segindex_t* index);
+static postings_t* getPostingsForPrefix(const char* word, segindex_t* index);
+static void addExpansion(void* arg, const char* word);
+static bool hasPhrase(char** words, int nwords);
+static void collapseSpaces(char* text);
+static void printResults(docscore_t* array, int nDocs, const char* pageDir);
+static void printProfile(profile_t* profile, FILE* fp);
+static bool stats_open(stats_t* stats, const char* filename);
+static void stats_add(stats_t* stats, char** words, int nwords,
+                      profile_t* profile);
+static void stats_close(stats_t* stats);
+static long totalNs(profile_t* profile);
+static int compareLong(const void* a, const void* b);
+static long nowNs(void);
+
+// helper function for sorting docscore
 static int compareDocscore(const void* a, const void* b);
 
-// struct for counters_iterate that fills docscore array
-typedef struct fillData {
-  docscore_t* array;
-  int index;
-} fillData_t;
-
 // main function that runs querier
 int main(int argc, char* argv[])
 {
   char* pageDirectory = NULL;
   char* indexFilename = NULL;
+  options_t options = { 0, false, NULL }; // cacheBytes 0: load the whole index
 
   // read arguments
-  parseArgs(argc, argv, &pageDirectory, &indexFilename);
+  parseArgs(argc, argv, &pageDirectory, &indexFilename, &options);
 
-  // load the index given by user
-  index_t* idx = index_load(indexFilename);
+  // each query's numbers, if asked for
+  stats_t stats = { NULL, { 0 }, NULL, 0, 0 };
+  if (options.statsFile != NULL && !stats_open(&stats, options.statsFile)) {
+    fprintf(stderr, "Error: cannot write stats file '%s'\n", options.statsFile);
+    exit(5);
+  }
+
+  // load the index given by user, with its delta segments
+  size_t cacheBytes = options.cacheBytes;
+  segindex_t* idx = (cacheBytes > 0) ? segindex_open(indexFilename, cacheBytes)
+                                     : segindex_load(indexFilename);
   if (idx == NULL) {
     fprintf(stderr, "Error: could not load index from file '%s'\n", indexFilename);
+    stats_close(&stats);
     exit(4);
   }
 
@@ -95,6 +205,8 @@ int main(int argc, char* argv[])
     }
 
     // turn line into array of words
+    profile_t profile = { 0 };
+    long start = nowNs();
     int nwords = 0;
     char** words = parseQuery(buffer, &nwords);
     if (words == NULL || nwords == 0) {
@@ -110,22 +222,43 @@ int main(int argc, char* argv[])
       continue;
     }
 
+    // phrases can only be answered from positions
+    if (hasPhrase(words, nwords) && !segindex_hasPositions(idx)) {
+      fprintf(stderr, "Error: phrase queries need an index built with "
+              "'indexer --positions'\n");
+      free(words);
+      continue;
+    }
+
     // give the user their final query
     printf("Query:");
     for (int i = 0; i < nwords; i++) {
-      printf(" %s", words[i]);
+      if (words[i][0] == '"') {
+        printf(" %s\"", words[i]); // phrase keeps only its opening quote
+      } else {
+        printf(" %s", words[i]);
+      }
     }
     printf("\n");
+    profile.parseNs = nowNs() - start;
 
-    // performs the query analysis; creates counters object mapping docIDs to scores
-    counters_t* results = handleQuery(words, nwords, idx);
+    // performs the query analysis; the matching docIDs with their scores
+    int nDocs = 0;
+    docscore_t* results = handleQuery(words, nwords, idx, &nDocs, &profile,
+                                      options.profile);
 
     // print the results
-    if (results == NULL) {
-      printf("No documents match.\n");
-    } else {
-      printResults(results, pageDirectory);
-      counters_delete(results);
+    start = nowNs();
+    printResults(results, nDocs, pageDirectory);
+    free(results);
+    profile.printNs = nowNs() - start;
+
+    // and what they cost
+    if (options.profile) {
+      printProfile(&profile, stdout);
+    }
+    if (stats.fp != NULL) {
+      stats_add(&stats, words, nwords, &profile);
     }
 
     // line :)
@@ -135,19 +268,45 @@ int main(int argc, char* argv[])
   }
 
   // finished
-  index_delete(idx);
+  stats_close(&stats);
+  segindex_delete(idx);
+  pagedir_close();
   return 0;
 }
 
 
-static void parseArgs(int argc, char* argv[], char** pageDir, char** indexFilename)
+static void parseArgs(int argc, char* argv[], char** pageDir, char** indexFilename,
+                      options_t* options)
 {
-  if (argc != 3) {
-    fprintf(stderr, "Usage: %s pageDirectory indexFilename\n", argv[0]);
+  // options come before the positional arguments
+  int arg = 1;
+  while (arg < argc && strncmp(argv[arg], "--", 2) == 0) {
+    if (strcmp(argv[arg], "--lazy") == 0 && arg + 1 < argc) {
+      char* end;
+      long mb = strtol(argv[arg + 1], &end, 10);
+      if (*end != '\0' || end == argv[arg + 1] || mb < 1 || mb > 1000000) {
+        fprintf(stderr, "Invalid --lazy '%s'\n", argv[arg + 1]);
+        exit(1);
+      }
+      options->cacheBytes = (size_t)mb << 20;
+      arg += 2;
+    } else if (strcmp(argv[arg], "--profile") == 0) {
+      options->profile = true;
+      arg++;
+    } else if (strcmp(argv[arg], "--stats") == 0 && arg + 1 < argc) {
+      options->statsFile = argv[arg + 1];
+      arg += 2;
+    } else {
+      break; // unknown, so the usage below
+    }
+  }
+  if (argc - arg != 2) {
+    fprintf(stderr, "Usage: %s [--lazy N] [--profile] [--stats file] "
+            "pageDirectory indexFilename\n", argv[0]);
     exit(1);
   }
-  *pageDir = argv[1];
-  *indexFilename = argv[2];
+  *pageDir = argv[arg];
+  *indexFilename = argv[arg + 1];
 
   // validate pageDirectory with method from common
   if (!pagedir_validate(*pageDir)) {
@@ -200,6 +359,11 @@ static bool readQueryLine(char* buffer, FILE* fp)
  * Convert the line to an array of lowercase words
  * Return NULL if no words are valid
  * Nwords is updated via the passed pointer to nwords
+ *
+ * A quoted phrase becomes a single entry that starts with '"', followed by its
+ *   words separated by single spaces (the closing quote is dropped)
+ *
+ * A '*' may only end a plain word, after at least one letter
  */
 static char** parseQuery(char* line, int* nwords)
 {
@@ -209,7 +373,8 @@ static char** parseQuery(char* line, int* nwords)
   for (int i = 0; i < length; i++) {
     if (isupper((unsigned char)line[i])) {
       line[i] = tolower(line[i]);
-    } else if (!isalpha((unsigned char)line[i]) && !isspace((unsigned char)line[i])) {
+    } else if (!isalpha((unsigned char)line[i]) && !isspace((unsigned char)line[i])
+               && line[i] != '"' && line[i] != '*') {
       // this chracter is not valid
       if (line[i] != '\0' && line[i] != '\n') {
         fprintf(stderr, "Error: bad char '%c' in query.\n", line[i]);
@@ -230,18 +395,83 @@ static char** parseQuery(char* line, int* nwords)
     return NULL;
   }
 
+  // tokenizes based on whitespace, keeping quoted phrases together
   int count = 0;
-  char* token = strtok(line, " \t\r\n"); // tokenizes based on whitespace (r is carriage return)
-  while (token != NULL) {
+  char* p = line;
+  while (true) {
+    while (isspace((unsigned char)*p)) {
+      p++;
+    }
+    if (*p == '\0') {
+      break; // end of line
+    }
     if (count >= MAX_QUERY_WORDS) {
       fprintf(stderr, "Error: too many words in query (max %d)", MAX_QUERY_WORDS);
       free(words);
       *nwords = 0;
       return NULL;
     }
-    words[count] = token;
-    count++;
-    token = strtok(NULL, " \t\r\n"); // repeat loop!
+
+    if (*p == '"') {
+      // phrase runs through the closing quote
+      char* close = strchr(p + 1, '"');
+      if (close == NULL) {
+        fprintf(stderr, "Error: unmatched '\"' in query.\n");
+        free(words);
+        *nwords = 0;
+        return NULL;
+      }
+      *close = '\0';
+      if (strchr(p + 1, '*') != NULL) {
+        fprintf(stderr, "Error: '*' cannot be used in a phrase.\n");
+        free(words);
+        *nwords = 0;
+        return NULL;
+      }
+      collapseSpaces(p + 1);
+      if (p[1] == '\0') {
+        fprintf(stderr, "Error: empty phrase in query.\n");
+        free(words);
+        *nwords = 0;
+        return NULL;
+      }
+      // a phrase's words are looked up together, so they have the same limit
+      int phraseWords = 1;
+      for (char* c = p + 1; *c != '\0'; c++) {
+        phraseWords += (*c == ' ');
+      }
+      if (phraseWords > MAX_QUERY_WORDS) {
+        fprintf(stderr, "Error: too many words in query (max %d)\n",
+                MAX_QUERY_WORDS);
+        free(words);
+        *nwords = 0;
+        return NULL;
+      }
+      words[count++] = p;
+      p = close + 1;
+    } else {
+      // plain word runs to whitespace
+      words[count++] = p;
+      while (*p != '\0' && !isspace((unsigned char)*p)) {
+        if (*p == '"') {
+          fprintf(stderr, "Error: '\"' must start a phrase.\n");
+          free(words);
+          *nwords = 0;
+          return NULL;
+        }
+        if (*p == '*' && (p == words[count - 1]
+                          || (p[1] != '\0' && !isspace((unsigned char)p[1])))) {
+          fprintf(stderr, "Error: '*' must end a word.\n");
+          free(words);
+          *nwords = 0;
+          return NULL;
+        }
+        p++;
+      }
+      if (*p != '\0') {
+        *p++ = '\0';
+      }
+    }
   }
   *nwords = count;
   if (count == 0) {
@@ -298,265 +528,447 @@ static bool validateQuery(char** words, int nwords)
 
 /*
  * Takes input of an array of words and an index
- * Returns counters of docIDs with score for each docID
+ * Returns an array of the matching docIDs with their scores (*nDocs of
+ *   them), or NULL if none match
+ *
+ * Each word's docIDs are made a set (see roaring.h); the sets of each run
+ *   of words between 'or's are intersected, and those results united,
+ *   before anything is scored. Counts are then looked up only for the
+ *   docIDs that match: a doc scores the least count of the words of each
+ *   run it matches, added up over the runs.
  *
- * Evaluatess and operators first by calling parseOrSequence
- *   whic calls parseAndSequence
+ * The time of each step goes into profile; if explain, the plan is
+ *   printed as it was carried out.
  */
-static counters_t* handleQuery(char** words, int nwords, index_t* index)
+static docscore_t* handleQuery(char** words, int nwords, segindex_t* index,
+                               int* nDocs, profile_t* profile, bool explain)
 {
-  int pos = 0;
-  counters_t* result = parseOrSequence(words, &pos, nwords, index);
-
-  if (result == NULL) {
-    return NULL; // failed to get a result
+  *nDocs = 0;
+  plan_t plan;
+  plan.profile = profile;
+  if (!makePlan(words, nwords, index, &plan)) {
+    deletePlan(&plan);
+    return NULL; // out of memory
   }
 
-  // see if any docID has non-zer count
-  bool anyNonZero = false;
-
-  // check for non zeros
-  counters_iterate(result, &anyNonZero, foundNonZeroFn);
-  if (!anyNonZero) {
-    counters_delete(result);
-    return NULL;
+  long start = nowNs();
+  roaring_t* matches = matchPlan(&plan);
+  profile->matchNs = nowNs() - start;
+  start = nowNs();
+  docscore_t* array = (matches == NULL) ? NULL
+                                        : scorePlan(&plan, matches, nDocs);
+  profile->scoreNs = nowNs() - start;
+  profile->nterms = plan.nterms;
+  profile->nruns = plan.nruns;
+  profile->matched = *nDocs;
+  if (explain) {
+    printPlan(&plan, stdout);
   }
-
-  return result;
+  roaring_delete(matches);
+  deletePlan(&plan);
+  if (array != NULL && *nDocs == 0) {
+    free(array);
+    array = NULL;
+  }
+  return array;
 }
 
 /*
- * Parse 'and' blocks separated by 'or'
- *   (doesn't necessarily mean there is an 'and' present)
- * 
- * Unions counters
- *
+ * Splits the words into runs at each 'or', skipping 'and', and looks up
+ *   every other word's postings and docID set
+ * Returns false if out of memory (the plan must be deleted still)
  */
-static counters_t* parseOrSequence(char** words, int* pos, int nwords, index_t* index)
+static bool makePlan(char** words, int nwords, segindex_t* index, plan_t* plan)
 {
-  //start with first 'and' block
-  counters_t* result = parseAndSequence(words, pos, nwords, index);
-
-  // while next word is 'or' apply union with next 'and' block
-  while (*pos < nwords && strcmp(words[*pos], "or") == 0) {
-    (*pos)++; //skips the actual world 'or'
-
-    // constructs counters for next section
-    counters_t* next = parseAndSequence(words, pos, nwords, index);
-    if (result == NULL) {
-      result = next; // just add it if it's first
-    } else if (next != NULL) {
-      countersOrCombine(result, next); // combine the next portion
-      counters_delete(next);
+  plan->terms = calloc(nwords + 1, sizeof(term_t));
+  plan->runEnd = calloc(nwords + 1, sizeof(int));
+  plan->runDocs = calloc(nwords + 1, sizeof(int));
+  plan->nterms = 0;
+  plan->nruns = 0;
+  if (plan->terms == NULL || plan->runEnd == NULL || plan->runDocs == NULL) {
+    return false;
+  }
+  for (int i = 0; i < nwords; i++) {
+    if (strcmp(words[i], "or") == 0) {
+      plan->runEnd[plan->nruns++] = plan->nterms;
+    } else if (strcmp(words[i], "and") != 0) {
+      term_t* term = &plan->terms[plan->nterms++];
+      term->word = words[i];
+      term->step = -1;
+      long start = nowNs();
+      term->postings = getPostingsForWord(words[i], index);
+      term->lookupNs = nowNs() - start;
+      plan->profile->lookupNs += term->lookupNs;
+      if (term->postings == NULL) {
+        return false;
+      }
+      start = nowNs();
+      term->docs = roaring_fromSorted(postings_docIDs(term->postings),
+                                      postings_count(term->postings));
+      plan->profile->setNs += nowNs() - start;
+      if (term->docs == NULL) {
+        return false;
+      }
     }
   }
-
-  return result;
+  plan->runEnd[plan->nruns++] = plan->nterms;
+  return true;
 }
 
 /*
- * Parse words separated by 'and'
- *
- * 'and' is assumed to be operator when others are lacking
- *
- * intersects counters of blocks separated by 'and'
+ * Unites the docID sets of every run of the plan
+ * Returns a new set, or NULL if out of memory
  */
-static counters_t* parseAndSequence(char** words, int* pos,
-                                    int nwords, index_t* index)
+static roaring_t* matchPlan(plan_t* plan)
 {
-  // deal with first word
-  while (*pos < nwords &&
-         (strcmp(words[*pos], "and") == 0 || strcmp(words[*pos], "or") == 0)) {
-    // skip extra operators
-    (*pos)++;
+  roaring_t* matches = roaring_fromSorted(NULL, 0);
+  int first = 0;
+  for (int r = 0; r < plan->nruns && matches != NULL; r++) {
+    bool owned;
+    roaring_t* runDocs = matchRun(plan, first, plan->runEnd[r], &owned);
+    plan->runDocs[r] = roaring_count(runDocs);
+    roaring_t* next = (runDocs == NULL) ? NULL : roaring_or(matches, runDocs);
+    if (owned) {
+      roaring_delete(runDocs);
+    }
+    roaring_delete(matches);
+    matches = next;
+    first = plan->runEnd[r];
   }
+  return matches;
+}
 
-  // out of bounds
-  if (*pos >= nwords) {
+/*
+ * Intersects the docID sets of terms first..end-1, smallest first so the
+ *   result shrinks as soon as it can, stopping once it is empty
+ * Returns the set, or NULL if out of memory; *owned says whether it is
+ *   new (the user deletes it) or a term's own (a run of one word)
+ */
+static roaring_t* matchRun(plan_t* plan, const int first, const int end,
+                           bool* owned)
+{
+  *owned = false;
+  int n = end - first;
+  term_t** order = malloc(n * sizeof(term_t*));
+  if (order == NULL) {
     return NULL;
   }
-
-  // get counters for a given word
-  counters_t* result = getCountersForWord(words[*pos], index);
-  (*pos)++;
-
-  // unless next word is or, interpret as and
-  while (*pos < nwords &&  strcmp(words[*pos], "or") != 0) {
-    if (strcmp(words[*pos], "and") == 0) {
-      // skip!
-      (*pos)++;
-      if (*pos >= nwords) break; // at end
+  for (int t = 0; t < n; t++) {
+    order[t] = &plan->terms[first + t];
+  }
+  qsort(order, n, sizeof(term_t*), compareTermSize);
+
+  roaring_t* docs = order[0]->docs;
+  order[0]->step = 0;
+  order[0]->left = roaring_count(docs);
+  for (int t = 1; t < n && roaring_count(docs) > 0; t++) {
+    roaring_t* next = roaring_and(docs, order[t]->docs);
+    if (*owned) {
+      roaring_delete(docs);
     }
-
-    // combine with next word
-    counters_t* next = getCountersForWord(words[*pos], index);
-    countersAndCombine(result, next);
-    counters_delete(next);
-    (*pos)++;
+    docs = next;
+    *owned = true;
+    if (docs == NULL) {
+      break; // out of memory
+    }
+    order[t]->step = t;
+    order[t]->left = roaring_count(docs);
   }
-
-  return result;
+  free(order);
+  return docs;
 }
 
 /*
- * For a given word, find the counters that represents that words
- *   appearance in a given document
- *
+ * Scores every matching docID: for each run of the plan, the least count
+ *   of its words in the doc (0 unless all are there), added up. Each term
+ *   has a cursor into its postings that only moves forward, as the docIDs
+ *   come in order.
+ * Returns a new array of *nDocs docscores, or NULL if out of memory
  */
-static counters_t* getCountersForWord(const char* word, index_t* index)
+static docscore_t* scorePlan(plan_t* plan, roaring_t* matches, int* nDocs)
 {
-  // if 'and' or 'or', NULL
-  if (strcmp(word, "and") == 0 || strcmp(word, "or") == 0) {
+  int n = roaring_count(matches);
+  int* docIDs = malloc((n + 1) * sizeof(int));
+  docscore_t* array = malloc((n + 1) * sizeof(docscore_t));
+  if (docIDs == NULL || array == NULL) {
+    free(docIDs);
+    free(array);
     return NULL;
   }
+  roaring_toArray(matches, docIDs);
+  for (int t = 0; t < plan->nterms; t++) {
+    plan->terms[t].at = 0;
+  }
 
-  // already normalized, but check length
-  if (strlen(word) < 3) {
-    return counters_new(); // there will be no match so it is empty
+  for (int i = 0; i < n; i++) {
+    int score = 0;
+    int first = 0;
+    for (int r = 0; r < plan->nruns; r++) {
+      int least = 0;
+      for (int t = first; t < plan->runEnd[r]; t++) {
+        term_t* term = &plan->terms[t];
+        int was = term->at;
+        int count = postings_seek(term->postings, docIDs[i], &term->at);
+        plan->profile->seeks++;
+        plan->profile->passed += term->at - was;
+        if (count == 0) {
+          least = 0;
+          break;
+        }
+        if (t == first || count < least) {
+          least = count;
+        }
+      }
+      score += least;
+      first = plan->runEnd[r];
+    }
+    array[i].docID = docIDs[i];
+    array[i].score = score;
   }
+  free(docIDs);
+  *nDocs = n;
+  return array;
+}
 
-  counters_t* ctrs = index_find(index, word);
-  if (ctrs == NULL) {
-    // no matches
-    return counters_new(); // empty
+/*
+ * Prints the plan as it was carried out: each run with the docs it matched,
+ *   and its terms in the order they were intersected (rarest first), with
+ *   the docs each has (df), the docs left after it, and its lookup time.
+ *   A term after the run came up empty is never intersected.
+ */
+static void printPlan(plan_t* plan, FILE* fp)
+{
+  fprintf(fp, "Plan: %d term%s in %d run%s\n", plan->nterms,
+          (plan->nterms == 1) ? "" : "s", plan->nruns,
+          (plan->nruns == 1) ? "" : "s");
+  int first = 0;
+  for (int r = 0; r < plan->nruns; r++) {
+    int end = plan->runEnd[r];
+    fprintf(fp, "  run %d, %d doc%s:\n", r + 1, plan->runDocs[r],
+            (plan->runDocs[r] == 1) ? "" : "s");
+    // steps 0, 1... then the terms never reached (step -1)
+    for (int step = 0; step <= end - first; step++) {
+      for (int t = first; t < end; t++) {
+        term_t* term = &plan->terms[t];
+        bool reached = (step < end - first);
+        if ((reached && term->step != step) || (!reached && term->step >= 0)) {
+          continue;
+        }
+        char label[64];
+        if (term->word[0] == '"') {
+          snprintf(label, sizeof(label), "%s\"", term->word);
+        } else {
+          snprintf(label, sizeof(label), "%s", term->word);
+        }
+        if (reached) {
+          fprintf(fp, "    %2d. ", step + 1);
+        } else {
+          fprintf(fp, "     -  ");
+        }
+        fprintf(fp, "%-24s df %7d  ", label, postings_count(term->postings));
+        if (reached) {
+          fprintf(fp, "left %7d", term->left);
+        } else {
+          fprintf(fp, "%-12s", "not needed");
+        }
+        fprintf(fp, "  lookup %9ld ns\n", term->lookupNs);
+      }
+    }
+    first = end;
   }
+}
 
-  // create a copy so original is preserved
-  counters_t* copy = counters_new();
-  if (copy == NULL) return NULL; // bad generation
+// frees what the plan holds
+static void deletePlan(plan_t* plan)
+{
+  for (int t = 0; plan->terms != NULL && t < plan->nterms; t++) {
+    postings_delete(plan->terms[t].postings);
+    roaring_delete(plan->terms[t].docs);
+  }
+  free(plan->terms);
+  free(plan->runEnd);
+  free(plan->runDocs);
+}
 
-  // iterates over counters and calls copyCountFn
-  counters_iterate(ctrs, copy, copyCountFn);
-  return copy;
+// qsort comparison of two terms by how many docIDs they have
+static int compareTermSize(const void* a, const void* b)
+{
+  int x = postings_count((*(term_t* const*)a)->postings);
+  int y = postings_count((*(term_t* const*)b)->postings);
+  return (x > y) - (x < y);
 }
 
 /*
- * Inserct for the 'and' operator:
- *   for each docID in dest, the new value is the min of
- *   the old count and src
- *
- *   (if it's not in src, then just 0)
+ * For a given word, find the postings (docIDs in order, with counts) that
+ *   represent that word's appearance in each document
+ * Returns NULL if out of memory
  */
-static void countersAndCombine(counters_t* dest, counters_t* src)
+static postings_t* getPostingsForWord(const char* word, segindex_t* index)
 {
-  if (dest == NULL || src == NULL) {
-    return; // empty parameter
+  // phrases are marked by their opening quote
+  if (word[0] == '"') {
+    return getPostingsForPhrase(word + 1, index);
   }
 
-  // update src to hold new intersection coutns
-  counters_iterate(dest, src, andCombineHelper1);
+  // a trailing '*' stands for every word with that prefix
+  size_t len = strlen(word);
+  if (word[len - 1] == '*') {
+    return getPostingsForPrefix(word, index);
+  }
 
-  // copy src into dest
-  counters_iterate(src, dest, andCombineHelper2);
+  // already normalized, but check length
+  if (len < 3) {
+    return postings_fromCounters(NULL); // there will be no match so it is empty
+  }
+
+  // gathered across the segments, empty if no matches
+  return segindex_find(index, word);
 }
 
 /*
- * Combines counters via the 'or' operator using union
- *
- * Simply sums the values of each docID in src and dest
- * (if a value is not in src, but in dest, the sum is just the value
- *  already in dest)
+ * For a phrase of space-separated words, find the postings of each docID
+ *   with the number of times the phrase occurs in it
  *
+ * Short words are never indexed, so a phrase holding one cannot match
  */
-static void countersOrCombine(counters_t* dest, counters_t* src)
+static postings_t* getPostingsForPhrase(const char* phrase, segindex_t* index)
 {
-  if (dest == NULL || src == NULL) {
-    return; // empty!
+  // split a copy of the phrase into words
+  char* copy = malloc(strlen(phrase) + 1);
+  char** words = calloc(MAX_QUERY_WORDS, sizeof(char*));
+  if (copy == NULL || words == NULL) {
+    free(copy);
+    free(words);
+    return NULL;
+  }
+  strcpy(copy, phrase);
+
+  // the parser has refused a phrase of more than MAX_QUERY_WORDS words
+  int nwords = 0;
+  bool shortWord = false;
+  for (char* w = strtok(copy, " "); w != NULL && nwords < MAX_QUERY_WORDS;
+       w = strtok(NULL, " ")) {
+    if (strlen(w) < 3) {
+      shortWord = true;
+    }
+    words[nwords++] = w;
   }
 
-  // use orCombineHelper to union
-  counters_iterate(src, dest, orCombineHelper);
-}
+  postings_t* result;
+  if (shortWord) {
+    result = postings_fromCounters(NULL); // no match possible
+  } else if (nwords == 1) {
+    // one word phrase is just that word, even 'and' or 'or'
+    result = segindex_find(index, words[0]);
+  } else {
+    result = segindex_findPhrase(index, words, nwords);
+  }
 
-/**************Functions for counters_iterate******************/
+  free(words);
+  free(copy);
+  return result;
+}
 
-// if you find a non-zero docID, mark bool to true
-static void foundNonZeroFn(void* arg, const int key, const int count)
+/*
+ * For a word ending in '*', find the postings of every indexed word that
+ *   starts with the rest of it, counts added up, as 'or' would
+ *
+ * Prints how many words it stands for, and how many of them were used if
+ *   there were more than MAX_EXPANSIONS. Their postings are merged all at
+ *   once (see postings.h) rather than combined into the result one by one.
+ */
+static postings_t* getPostingsForPrefix(const char* word, segindex_t* index)
 {
-  bool* found = (bool*) arg;
-  if (count > 0) {
-    *found = true;
+  // the prefix, without its '*'
+  size_t len = strlen(word) - 1;
+  char* prefix = malloc(len + 1);
+  expansion_t expansion = { index, calloc(MAX_EXPANSIONS, sizeof(postings_t*)),
+                            0, false };
+  if (prefix == NULL || expansion.lists == NULL) {
+    free(prefix);
+    free(expansion.lists);
+    return NULL;
+  }
+  memcpy(prefix, word, len);
+  prefix[len] = '\0';
+
+  int total = segindex_prefix(index, prefix, MAX_EXPANSIONS, &expansion,
+                              addExpansion);
+  if (total > MAX_EXPANSIONS) {
+    printf("Expanded %s to the first %d of %d words\n", word,
+           MAX_EXPANSIONS, total);
+  } else {
+    printf("Expanded %s to %d word%s\n", word, total, (total == 1) ? "" : "s");
   }
-}
 
-// Copy from one counter to another
-static void copyCountFn(void* arg, const int key, const int count)
-{
-  counters_t* dst = (counters_t*) arg;
-  counters_set(dst, key, count);
+  postings_t* result = NULL;
+  if (!expansion.failed) {
+    result = postings_union(expansion.lists, expansion.nlists);
+  }
+  for (int i = 0; i < expansion.nlists; i++) {
+    postings_delete(expansion.lists[i]);
+  }
+  free(expansion.lists);
+  free(prefix);
+  return result;
 }
 
-// logic for intersection of counters takes the lowest of two counts
-static void andCombineHelper1(void* arg, const int key, const int countDest)
+// segindex_prefix helper: look up one of a wildcard's words
+static void addExpansion(void* arg, const char* word)
 {
-  // arg is src
-  counters_t* srcCtrs = (counters_t*) arg;
-  int countSrc = counters_get(srcCtrs, key);
-  int newCount = (countDest < countSrc) ? countDest : countSrc;
-  if (countSrc == 0) { // if not present we can assume 0
-    newCount = 0;
-  }
-  counters_set(srcCtrs, key, newCount); // updates source
+  expansion_t* expansion = arg;
+  if (expansion->failed || expansion->nlists == MAX_EXPANSIONS) {
+    return;
+  }
+  postings_t* list = segindex_find(expansion->index, word);
+  if (list == NULL) {
+    expansion->failed = true;
+    return;
+  }
+  expansion->lists[expansion->nlists++] = list;
 }
 
-// actually copies source into destination
-static void andCombineHelper2(void* arg, const int key, const int countSrc)
+// does the query hold a quoted phrase?
+static bool hasPhrase(char** words, int nwords)
 {
-  counters_t* destCtrs = (counters_t*) arg;
-  counters_set(destCtrs, key, countSrc);
+  for (int i = 0; i < nwords; i++) {
+    if (words[i][0] == '"') {
+      return true;
+    }
+  }
+  return false;
 }
 
-// union logic for adding values of two counters
-static void orCombineHelper(void* arg, const int key, const int countSrc)
+// squeeze whitespace runs in text to single spaces, trimming both ends
+static void collapseSpaces(char* text)
 {
-  counters_t* destCtrs = (counters_t*) arg;
-  int countDest = counters_get(destCtrs, key);
-  int newCount = countDest + countSrc;
-  counters_set(destCtrs, key, newCount);
+  char* out = text;
+  bool pendingSpace = false;
+  for (char* in = text; *in != '\0'; in++) {
+    if (isspace((unsigned char)*in)) {
+      pendingSpace = (out != text);
+    } else {
+      if (pendingSpace) {
+        *out++ = ' ';
+        pendingSpace = false;
+      }
+      *out++ = *in;
+    }
+  }
+  *out = '\0';
 }
 
-
-
 /*
- * Takes a final counters of results, and prints them out for the user
- *   also prints out the URL for the user to see.
- *
- * The results are not currently ordered by how well they match.
+ * Takes the matching docs and their scores, and prints them out for the
+ *   user, best score first, also printing the URL for the user to see.
  */
-static void printResults(counters_t* results, const char* pageDir)
+static void printResults(docscore_t* array, int nDocs, const char* pageDir)
 {
-  if (results == NULL) {
-    printf("No documents match.\n");
-    return;
-  }
-
-  // check that we don't have 0 docs with a match
-  bool anyNonZero = false;
-  counters_iterate(results, &anyNonZero, foundNonZeroFn);
-  if (!anyNonZero) {
-    printf("No documents match.\n");
-    return;
-  }
-
-  // for creating the proper size struct
-  int nDocs = countNonZeroDocs(results);
-  if (nDocs == 0) {
+  if (array == NULL || nDocs == 0) {
     printf("No documents match.\n");
     return;
   }
 
-  docscore_t* array = calloc(nDocs, sizeof(docscore_t));
-  if (!array) {
-    fprintf(stderr, "Error: out of memory for docscore array.\n");
-    return;
-  }
-
-  // fills the array
-  fillData_t data;
-  data.array = array;
-  data.index = 0;
-  counters_iterate(results, &data, addIfNonZero);
-
   // actually sorts the array
   qsort(array, nDocs, sizeof(docscore_t), compareDocscore);
 
@@ -567,61 +979,140 @@ static void printResults(counters_t* results, const char* pageDir)
     int docID = array[i].docID;
     int score = array[i].score;
 
-    // print filename
-    char filename[1024];
-    snprintf(filename, sizeof(filename), "%s/%d", pageDir, docID);
-
-    FILE* fp = fopen(filename, "r");
-    if (!fp) continue;
-    char url[1024];
-    if (!fgets(url, sizeof(url), fp)) {
-      fclose(fp);
-      continue;
-    }
-    fclose(fp);
-    // strip newline
-    char* nl = strchr(url, '\n');
-    if (nl) *nl = '\0';
+    // first line of the page (file or packed store)
+    char* url = pagedir_loadURL(pageDir, docID);
+    if (url == NULL) continue;
 
     // actually print the score and URL
     printf("score\t%d doc %3d: %s\n", score, docID, url);
+    free(url);
   }
+}
 
-  free(array);
+// compares the scores of two docs to see which is bigger (then by docID)
+static int compareDocscore(const void* a, const void* b)
+{
+  const docscore_t* da = a;
+  const docscore_t* db = b;
+  if (da->score != db->score) {
+    return (db->score - da->score); // descending by score
+  }
+  return (da->docID > db->docID) - (da->docID < db->docID);
 }
 
-// helps iterate through and see if score is nonZero value with simple check
-static void countNonZeroHelper(void* arg, const int docID, const int score)
+// what scoring took, and the time of each phase
+static void printProfile(profile_t* profile, FILE* fp)
+{
+  fprintf(fp, "Profile: %d doc%s scored with %ld postings seeks, "
+          "%ld pairs passed\n", profile->matched,
+          (profile->matched == 1) ? "" : "s", profile->seeks, profile->passed);
+  fprintf(fp, "  ns: parse %ld, lookup %ld, sets %ld, match %ld, score %ld, "
+          "print %ld, total %ld\n", profile->parseNs, profile->lookupNs,
+          profile->setNs, profile->matchNs, profile->scoreNs,
+          profile->printNs, totalNs(profile));
+}
+
+/*
+ * Opens the stats file and writes its column names
+ * Returns false if it cannot be written
+ */
+static bool stats_open(stats_t* stats, const char* filename)
 {
-  if (score > 0) {
-    int* c = arg;
-    (*c)++;
+  stats->fp = fopen(filename, "w");
+  if (stats->fp == NULL) {
+    return false;
   }
+  fprintf(stats->fp, "query\tterms\truns\tmatched\tseeks\tpassed\t"
+          "parse_ns\tlookup_ns\tsets_ns\tmatch_ns\tscore_ns\tprint_ns\t"
+          "total_ns\n");
+  return true;
 }
 
-// Counts the number of non zero docs by iterating
-static int countNonZeroDocs(counters_t* ctrs)
+// one line for the query, and its numbers kept for the summary
+static void stats_add(stats_t* stats, char** words, int nwords,
+                      profile_t* profile)
 {
-  int count = 0;
-  counters_iterate(ctrs, &count, countNonZeroHelper);
-  return count;
+  for (int i = 0; i < nwords; i++) {
+    fprintf(stats->fp, "%s%s%s", (i > 0) ? " " : "", words[i],
+            (words[i][0] == '"') ? "\"" : "");
+  }
+  fprintf(stats->fp, "\t%d\t%d\t%d\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\t%ld\t"
+          "%ld\t%ld\n", profile->nterms, profile->nruns, profile->matched,
+          profile->seeks, profile->passed, profile->parseNs,
+          profile->lookupNs, profile->setNs, profile->matchNs,
+          profile->scoreNs, profile->printNs, totalNs(profile));
+
+  profile_t* sum = &stats->sum;
+  sum->parseNs += profile->parseNs;
+  sum->lookupNs += profile->lookupNs;
+  sum->setNs += profile->setNs;
+  sum->matchNs += profile->matchNs;
+  sum->scoreNs += profile->scoreNs;
+  sum->printNs += profile->printNs;
+  if (stats->n == stats->cap) {
+    int cap = (stats->cap == 0) ? 64 : 2 * stats->cap;
+    long* totals = realloc(stats->totals, cap * sizeof(long));
+    if (totals == NULL) {
+      return; // the summary leaves this one out
+    }
+    stats->totals = totals;
+    stats->cap = cap;
+  }
+  stats->totals[stats->n++] = totalNs(profile);
 }
 
-// adds a doc to data's array if it is nonZero score
-static void addIfNonZero(void* arg, const int docID, const int score)
+/*
+ * Writes the summary: the queries' total times at the 50th, 90th and 99th
+ *   percentile (nearest rank) and the most, then the mean of each phase;
+ *   summary lines start with '#'. Then closes the file.
+ */
+static void stats_close(stats_t* stats)
 {
-  fillData_t* data = arg;
-  if (score > 0) {
-    data->array[data->index].docID = docID;
-    data->array[data->index].score = score;
-    data->index++;
+  if (stats->fp == NULL) {
+    return;
+  }
+  int n = stats->n;
+  fprintf(stats->fp, "# %d quer%s\n", n, (n == 1) ? "y" : "ies");
+  if (n > 0) {
+    qsort(stats->totals, n, sizeof(long), compareLong);
+    const int percents[] = { 50, 90, 99 };
+    fprintf(stats->fp, "# total ns:");
+    for (int p = 0; p < 3; p++) {
+      int rank = (percents[p] * n + 99) / 100; // ceil(p% of n)
+      fprintf(stats->fp, " p%d %ld,", percents[p], stats->totals[rank - 1]);
+    }
+    fprintf(stats->fp, " max %ld\n", stats->totals[n - 1]);
+    profile_t* sum = &stats->sum;
+    fprintf(stats->fp, "# mean ns: parse %ld, lookup %ld, sets %ld, "
+            "match %ld, score %ld, print %ld, total %ld\n",
+            sum->parseNs / n, sum->lookupNs / n, sum->setNs / n,
+            sum->matchNs / n, sum->scoreNs / n, sum->printNs / n,
+            totalNs(sum) / n);
   }
+  fclose(stats->fp);
+  free(stats->totals);
+  stats->fp = NULL;
 }
 
-// compares the scores of two docs to see which is bigger
-static int compareDocscore(const void* a, const void* b)
+// the phases added up
+static long totalNs(profile_t* profile)
 {
-  const docscore_t* da = a;
-  const docscore_t* db = b;
-  return (db->score - da->score); // descending by score
+  return profile->parseNs + profile->lookupNs + profile->setNs
+         + profile->matchNs + profile->scoreNs + profile->printNs;
+}
+
+// qsort comparison of two longs
+static int compareLong(const void* a, const void* b)
+{
+  long x = *(const long*)a;
+  long y = *(const long*)b;
+  return (x > y) - (x < y);
+}
+
+// monotonic clock in nanoseconds
+static long nowNs(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec * 1000000000L + ts.tv_nsec;
 }
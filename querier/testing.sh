@@ -8,6 +8,16 @@
 #    using three query files: testquery1, testquery2, testquery3
 #    each fed into the querier, with output sent to testing.out
 #    (files are made in file and deleted afterward)
+#    plus testquery4 of quoted phrases, run against a positional index
+#    (built here with indexer --positions) and against the plain one
+#    plus testquery1 against an index with a delta segment (indexer --update)
+#    plus testquery5 of wildcards (comput*), against the plain index and the
+#    one with a delta segment
+#    plus testquery1, testquery4 and testquery5 with the index opened lazily (--lazy),
+#    which must give the same output as loading it whole, whether words are
+#    found in the lexicon file beside the index or it is out of date
+#    plus testquery3 with --profile, whose results must be the same as
+#    without it, and --stats, which must write a line for each query
 # 3. Valgrind test
 #
 # Usage:
@@ -20,10 +30,11 @@
 PROGRAM=./querier
 PAGEDIR=../data/letters-10
 INDEXFILE=../data/indexes/letters-10.index
+POSINDEXFILE=../data/indexes/letters-10-pos.index
 OUTFILE=testing.out
 
 # clean up before we start
-rm -f testquery1 testquery2 testquery3 $OUTFILE
+rm -f testquery1 testquery2 testquery3 testquery4 testquery5 $OUTFILE
 
 echo "----- Argument Tests -----" | tee -a $OUTFILE
 
@@ -43,6 +54,14 @@ echo
 echo "4) Bad index file" | tee -a $OUTFILE
 $PROGRAM $PAGEDIR not-a-index >> $OUTFILE 2>&1
 
+echo
+echo "5) Invalid --lazy cache size" | tee -a $OUTFILE
+$PROGRAM --lazy 0 $PAGEDIR $INDEXFILE >> $OUTFILE 2>&1
+
+echo
+echo "6) Unwritable --stats file" | tee -a $OUTFILE
+$PROGRAM --stats /no-such-dir/stats $PAGEDIR $INDEXFILE < /dev/null >> $OUTFILE 2>&1
+
 
 echo "------- Querier Tests -------" >> $OUTFILE
 
@@ -94,6 +113,103 @@ $PROGRAM $PAGEDIR $INDEXFILE < testquery3 >> $OUTFILE 2>&1
 
 
 
+# Phrase queries need the positional index
+cat > testquery4 <<EOF
+# testquery4 - Phrases
+"home page"
+"breadth first search" or "depth first"
+"the home" and algorithm
+"for" or "page home"
+"unmatched
+""
+"$(printf 'one %.0s' $(seq 201))"
+EOF
+
+echo "" >> $OUTFILE
+echo "Running testquery4 (positional index):" >> $OUTFILE
+../indexer/indexer --positions $PAGEDIR $POSINDEXFILE
+$PROGRAM $PAGEDIR $POSINDEXFILE < testquery4 >> $OUTFILE 2>&1
+
+echo "" >> $OUTFILE
+echo "Running testquery4 (no positions):" >> $OUTFILE
+$PROGRAM $PAGEDIR $INDEXFILE < testquery4 >> $OUTFILE 2>&1
+
+# A delta segment: page 3 replaced, page 2 removed
+DELTADIR=../data/letters-10-delta
+DELTAINDEX=../data/indexes/letters-10-delta.index
+rm -rf $DELTADIR $DELTAINDEX*
+cp -r $PAGEDIR $DELTADIR
+../indexer/indexer $DELTADIR $DELTAINDEX
+(head -2 $DELTADIR/3; echo "<html>this page is now about the home algorithm</html>") > $DELTADIR/3.new
+mv $DELTADIR/3.new $DELTADIR/3
+rm $DELTADIR/2
+printf '2\n3\n' > $DELTAINDEX.changes
+../indexer/indexer --update $DELTAINDEX.changes $DELTADIR $DELTAINDEX
+
+echo "" >> $OUTFILE
+echo "Running testquery1 (base and delta segment):" >> $OUTFILE
+$PROGRAM $DELTADIR $DELTAINDEX < testquery1 >> $OUTFILE 2>&1
+
+# Wildcards stand for every word with their prefix
+cat > testquery5 <<EOF
+# testquery5 - Wildcards
+comput*
+f* and home
+depth or brea*
+a*
+zzz*
+*
+c*ing
+"first sea*"
+EOF
+
+echo "" >> $OUTFILE
+echo "Running testquery5:" >> $OUTFILE
+$PROGRAM $PAGEDIR $INDEXFILE < testquery5 >> $OUTFILE 2>&1
+
+echo "" >> $OUTFILE
+echo "Running testquery5 (base and delta segment):" >> $OUTFILE
+$PROGRAM $DELTADIR $DELTAINDEX < testquery5 >> $OUTFILE 2>&1
+
+# Lazily opened indexes answer exactly as loaded ones
+echo "" >> $OUTFILE
+echo "Running testquery1, testquery4 and testquery5 (--lazy 1):" >> $OUTFILE
+for run in "$PAGEDIR $INDEXFILE testquery1" "$PAGEDIR $POSINDEXFILE testquery4" \
+           "$DELTADIR $DELTAINDEX testquery1" "$PAGEDIR $INDEXFILE testquery5" \
+           "$DELTADIR $DELTAINDEX testquery5"; do
+  set -- $run
+  diff <($PROGRAM $1 $2 < $3 2>&1) <($PROGRAM --lazy 1 $1 $2 < $3 2>&1) \
+    >> $OUTFILE && echo "$2 $3: same output" >> $OUTFILE
+done
+
+# a copied index is newer than the lexicon copied with it, which is not used
+cp $INDEXFILE $INDEXFILE-copy
+cp $INDEXFILE.lex $INDEXFILE-copy.lex
+diff <($PROGRAM $PAGEDIR $INDEXFILE < testquery1 2>&1) \
+     <($PROGRAM --lazy 1 $PAGEDIR $INDEXFILE-copy < testquery1 2>&1) \
+  >> $OUTFILE && echo "$INDEXFILE-copy testquery1 (old lexicon): same output" >> $OUTFILE
+rm -f $INDEXFILE-copy $INDEXFILE-copy.lex
+
+# Profiling prints the plan before the results and the times after them,
+#   and changes nothing else
+echo "" >> $OUTFILE
+echo "Running testquery3 (--profile --stats):" >> $OUTFILE
+STATSFILE=testing.stats
+$PROGRAM --profile --stats $STATSFILE $PAGEDIR $INDEXFILE < testquery3 > testing.profile 2>&1
+cat testing.profile >> $OUTFILE
+unprofiled() {
+  grep -v -e '^Plan:' -e '^Profile:' -e '^  '
+}
+diff <($PROGRAM $PAGEDIR $INDEXFILE < testquery3 2>&1 | unprofiled) \
+     <(unprofiled < testing.profile) \
+  >> $OUTFILE && echo "testquery3 --profile: same results" >> $OUTFILE
+queries=$(grep -c 'Query: ' testing.profile)
+lines=$(grep -v -c -e '^#' -e '^query' $STATSFILE)
+echo "$STATSFILE: $lines lines for $queries queries" >> $OUTFILE
+cat $STATSFILE >> $OUTFILE
+rm -f testing.profile $STATSFILE
+
+
 # Simple valgrind test using testquery1
 echo "" >> $OUTFILE
 echo "------- Valgrind Test ------" >> $OUTFILE
@@ -101,7 +217,7 @@ valgrind --leak-check=full --show-leak-kinds=all $PROGRAM $PAGEDIR $INDEXFILE <
 
 
 # Cleanup
-rm -f testquery1 testquery2 testquery3
+rm -f testquery1 testquery2 testquery3 testquery4 testquery5
 
 echo "" >> $OUTFILE
 echo "Done" >> $OUTFILE